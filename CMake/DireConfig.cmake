@@ -2,6 +2,7 @@ include(CMakeFindDependencyMacro)
 
 # Same syntax as find_package
 find_dependency(RapidJSON REQUIRED)
+find_dependency(Threads REQUIRED)
 
 # Any extra setup
 
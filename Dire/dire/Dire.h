@@ -3,9 +3,17 @@
 #include <dire/Types/DireTypeInfoDatabase.h>
 #include <dire/Types/DireTypeInfo.h>
 #include <dire/Utils/DireString.h>
+#include <dire/Utils/DireArena.h>
+#include <dire/Utils/DireThreadPool.h>
 #include <dire/DireProperty.h>
 #include <dire/DireReflectable.h>
+#include <dire/DireAllocationContext.h>
+#include <dire/DireFunctionHandle.h>
+#include <dire/DirePropertyPath.h>
 
+#include <dire/Serialization/DireSerializationSink.h>
+#include <dire/Serialization/DireDelta.h>
+#include <dire/Serialization/DireBatchSerialization.h>
 #include <dire/Serialization/DireJSONSerializer.h>
 #include <dire/Serialization/DireJSONDeserializer.h>
 #include <dire/Serialization/DireBinarySerializer.h>
@@ -0,0 +1,241 @@
+#include "DireAllocationContext.h"
+#include "dire/DireReflectable.h"
+
+#include <algorithm> // max
+#include <cstdint> // uintptr_t
+
+namespace
+{
+	size_t	RoundUp(size_t pValue, size_t pAlignment)
+	{
+		return (pValue + pAlignment - 1) & ~(pAlignment - 1);
+	}
+}
+
+namespace DIRE_NS
+{
+	void AllocationContext::Destroy(Reflectable* pObject)
+	{
+		if (pObject == nullptr)
+			return;
+
+		ObjectHeader& header = EditHeader(pObject);
+		DIRE_ASSERT(header.LiveIndex < myLiveObjects.size() && myLiveObjects[header.LiveIndex] == pObject); // not instantiated in this context!
+		const TypeInfo& typeInfo = *header.Type;
+
+		// Swap and pop to keep the live objects array compact.
+		Reflectable* lastObject = myLiveObjects.back();
+		myLiveObjects[header.LiveIndex] = lastObject;
+		EditHeader(lastObject).LiveIndex = header.LiveIndex;
+		myLiveObjects.pop_back();
+
+		pObject->~Reflectable();
+		FreeSlot(typeInfo, reinterpret_cast<std::byte*>(pObject) - GetHeaderSize(GetSlotAlignment(typeInfo)));
+	}
+
+	void AllocationContext::DestroyAll()
+	{
+		for (Reflectable* object : myLiveObjects)
+		{
+			object->~Reflectable();
+		}
+
+		myLiveObjects.clear();
+		ReleaseAllSlots();
+	}
+
+	Reflectable* AllocationContext::Instantiate(const TypeInfo& pTypeInfo, ReflectableFactory::InstantiateFunction pInstantiateFunction, const std::any& pParameters)
+	{
+		const size_t slotAlignment = GetSlotAlignment(pTypeInfo);
+		const size_t headerSize = GetHeaderSize(slotAlignment);
+
+		auto* slot = static_cast<std::byte*>(AllocateSlot(pTypeInfo, GetSlotSize(pTypeInfo), slotAlignment));
+		Reflectable* object = pInstantiateFunction(pParameters, slot + headerSize);
+		if (object == nullptr) // bad parameters
+		{
+			FreeSlot(pTypeInfo, slot);
+			return nullptr;
+		}
+
+		ObjectHeader& header = EditHeader(object);
+		header.Type = &pTypeInfo;
+		header.LiveIndex = myLiveObjects.size();
+		myLiveObjects.push_back(object);
+
+		return object;
+	}
+
+	size_t AllocationContext::GetSlotSize(const TypeInfo& pTypeInfo)
+	{
+		return GetHeaderSize(GetSlotAlignment(pTypeInfo)) + pTypeInfo.GetTypeSize();
+	}
+
+	size_t AllocationContext::GetSlotAlignment(const TypeInfo& pTypeInfo)
+	{
+		return std::max(pTypeInfo.GetTypeAlignment(), alignof(ObjectHeader));
+	}
+
+	size_t AllocationContext::GetHeaderSize(size_t pSlotAlignment)
+	{
+		return RoundUp(sizeof(ObjectHeader), pSlotAlignment);
+	}
+
+	AllocationContext::ObjectHeader& AllocationContext::EditHeader(Reflectable* pObject)
+	{
+		return *(reinterpret_cast<ObjectHeader*>(pObject) - 1);
+	}
+
+
+	ReflectablePool::ReflectablePool(size_t pSlotsPerBlock) :
+		mySlotsPerBlock(pSlotsPerBlock)
+	{
+		DIRE_ASSERT(mySlotsPerBlock != 0);
+	}
+
+	ReflectablePool::~ReflectablePool()
+	{
+		DestroyAll();
+
+		DIRE_ALLOCATOR<std::byte> allocator;
+		for (auto& [typeInfo, pool] : myTypePools)
+		{
+			for (const Block& block : pool.Blocks)
+			{
+				allocator.deallocate(block.Memory, block.Size);
+			}
+		}
+	}
+
+	void ReflectablePool::Reserve(ReflectableID pClassID, size_t pCount)
+	{
+		const TypeInfo* typeInfo = TypeInfoDatabase::GetSingleton().GetTypeInfo(pClassID);
+		if (typeInfo == nullptr || pCount == 0)
+			return;
+
+		TypePool& pool = EditTypePool(*typeInfo, GetSlotSize(*typeInfo), GetSlotAlignment(*typeInfo));
+		PushBlock(pool, pCount);
+	}
+
+	size_t ReflectablePool::GetCapacity(ReflectableID pClassID) const
+	{
+		auto it = myTypePools.find(TypeInfoDatabase::GetSingleton().GetTypeInfo(pClassID));
+		if (it == myTypePools.end())
+			return 0;
+
+		size_t capacity = 0;
+		for (const Block& block : it->second.Blocks)
+		{
+			capacity += (block.Size - (it->second.SlotAlignment - 1)) / it->second.SlotSize;
+		}
+
+		return capacity;
+	}
+
+	void* ReflectablePool::AllocateSlot(const TypeInfo& pTypeInfo, size_t pSlotSize, size_t pSlotAlignment)
+	{
+		TypePool& pool = EditTypePool(pTypeInfo, pSlotSize, pSlotAlignment);
+		if (pool.FreeList == nullptr)
+		{
+			PushBlock(pool, pool.SlotsPerBlock);
+		}
+
+		void* slot = pool.FreeList;
+		pool.FreeList = *static_cast<void**>(slot);
+		return slot;
+	}
+
+	void ReflectablePool::FreeSlot(const TypeInfo& pTypeInfo, void* pSlot)
+	{
+		auto it = myTypePools.find(&pTypeInfo);
+		DIRE_ASSERT(it != myTypePools.end());
+
+		*static_cast<void**>(pSlot) = it->second.FreeList;
+		it->second.FreeList = pSlot;
+	}
+
+	void ReflectablePool::ReleaseAllSlots()
+	{
+		// Rebuild every free list from scratch, threading all the slots of all the blocks.
+		for (auto& [typeInfo, pool] : myTypePools)
+		{
+			pool.FreeList = nullptr;
+			for (const Block& block : pool.Blocks)
+			{
+				std::byte* firstSlot = GetFirstSlot(pool, block);
+				const size_t nbSlots = (block.Size - (pool.SlotAlignment - 1)) / pool.SlotSize;
+				for (size_t iSlot = nbSlots; iSlot != 0; --iSlot)
+				{
+					void* slot = firstSlot + (iSlot - 1) * pool.SlotSize;
+					*static_cast<void**>(slot) = pool.FreeList;
+					pool.FreeList = slot;
+				}
+			}
+		}
+	}
+
+	ReflectablePool::TypePool& ReflectablePool::EditTypePool(const TypeInfo& pTypeInfo, size_t pSlotSize, size_t pSlotAlignment)
+	{
+		auto [it, inserted] = myTypePools.try_emplace(&pTypeInfo);
+		TypePool& pool = it->second;
+		if (inserted)
+		{
+			// Free slots have to be able to store a pointer to the next free slot.
+			pool.SlotAlignment = std::max(pSlotAlignment, alignof(void*));
+			pool.SlotSize = RoundUp(std::max(pSlotSize, sizeof(void*)), pool.SlotAlignment);
+			pool.SlotsPerBlock = mySlotsPerBlock;
+		}
+
+		return pool;
+	}
+
+	void ReflectablePool::PushBlock(TypePool& pPool, size_t pNbSlots)
+	{
+		Block newBlock;
+		newBlock.Size = pNbSlots * pPool.SlotSize + pPool.SlotAlignment - 1; // leave room to align the first slot
+
+		DIRE_ALLOCATOR<std::byte> allocator;
+		newBlock.Memory = allocator.allocate(newBlock.Size);
+		DIRE_ASSERT(newBlock.Memory != nullptr);
+		pPool.Blocks.push_back(newBlock);
+
+		// Thread the new slots in front of the free list, in address order.
+		std::byte* firstSlot = GetFirstSlot(pPool, newBlock);
+		for (size_t iSlot = pNbSlots; iSlot != 0; --iSlot)
+		{
+			void* slot = firstSlot + (iSlot - 1) * pPool.SlotSize;
+			*static_cast<void**>(slot) = pPool.FreeList;
+			pPool.FreeList = slot;
+		}
+	}
+
+	std::byte* ReflectablePool::GetFirstSlot(const TypePool& pPool, const Block& pBlock)
+	{
+		const auto blockAddress = reinterpret_cast<uintptr_t>(pBlock.Memory);
+		return pBlock.Memory + (RoundUp(blockAddress, pPool.SlotAlignment) - blockAddress);
+	}
+
+
+	ArenaContext::ArenaContext(size_t pChunkSize) :
+		myArena(pChunkSize)
+	{}
+
+	ArenaContext::~ArenaContext()
+	{
+		DestroyAll();
+	}
+
+	void* ArenaContext::AllocateSlot(const TypeInfo& /*pTypeInfo*/, size_t pSlotSize, size_t pSlotAlignment)
+	{
+		return myArena.Allocate(pSlotSize, pSlotAlignment);
+	}
+
+	void ArenaContext::FreeSlot(const TypeInfo& /*pTypeInfo*/, void* /*pSlot*/)
+	{
+		// Nothing to do: the memory is only reclaimed by DestroyAll.
+	}
+
+	void ArenaContext::ReleaseAllSlots()
+	{
+		myArena.Reset();
+	}
+}
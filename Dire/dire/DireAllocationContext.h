@@ -0,0 +1,165 @@
+#pragma once
+
+#include "DireDefines.h"
+#include "dire/DireReflectableID.h"
+#include "dire/Types/DireTypeInfoDatabase.h"
+#include "dire/Utils/DireArena.h"
+
+#include <cstddef> // byte
+#include <unordered_map>
+#include <vector>
+
+namespace DIRE_NS
+{
+	class Reflectable;
+	class TypeInfo;
+
+	/**
+	 * \brief Base class of the memory sources reflectables can be instantiated into, with TypeInfoDatabase::TryInstantiate.
+	 * A context keeps track of every object it instantiated: DestroyAll destroys all of them at once, running their destructors
+	 * without giving their memory back one by one.
+	 * Objects instantiated in a context must be destroyed through it, never with delete.
+	 */
+	class Dire_EXPORT AllocationContext
+	{
+	public:
+		AllocationContext() = default;
+		virtual ~AllocationContext() = default;
+
+		AllocationContext(const AllocationContext&) = delete;
+		AllocationContext& operator=(const AllocationContext&) = delete;
+
+		/**
+		 * \brief Destroys an object instantiated in this context and gives its memory back to the context.
+		 */
+		void	Destroy(Reflectable* pObject);
+
+		/**
+		 * \brief Runs the destructor of every object still alive in this context, then makes all of its memory available again.
+		 */
+		void	DestroyAll();
+
+		[[nodiscard]] size_t	GetLiveObjectCount() const { return myLiveObjects.size(); }
+
+	protected:
+		/**
+		 * \brief Provides the memory of one object slot.
+		 * \param pTypeInfo The type of the object that will live in the slot
+		 * \param pSlotSize The size of the slot (always the same for a given type)
+		 * \param pSlotAlignment The alignment of the slot (always the same for a given type)
+		 */
+		virtual void*	AllocateSlot(const TypeInfo& pTypeInfo, size_t pSlotSize, size_t pSlotAlignment) = 0;
+
+		/**
+		 * \brief Called when a single object has been destroyed and its slot can be reused.
+		 */
+		virtual void	FreeSlot(const TypeInfo& pTypeInfo, void* pSlot) = 0;
+
+		/**
+		 * \brief Called by DestroyAll once every object has been destroyed: every slot can be reused.
+		 */
+		virtual void	ReleaseAllSlots() = 0;
+
+		/**
+		 * \brief The size and alignment of the slots of a type: the object itself, preceded by some bookkeeping data.
+		 */
+		static size_t	GetSlotSize(const TypeInfo& pTypeInfo);
+		static size_t	GetSlotAlignment(const TypeInfo& pTypeInfo);
+
+	private:
+		friend class TypeInfoDatabase;
+
+		Reflectable*	Instantiate(const TypeInfo& pTypeInfo, ReflectableFactory::InstantiateFunction pInstantiateFunction, const std::any& pParameters);
+
+		// Stored right before each object, so that objects can be destroyed in O(1).
+		struct ObjectHeader
+		{
+			const TypeInfo*	Type = nullptr;
+			size_t			LiveIndex = 0;
+		};
+
+		static size_t			GetHeaderSize(size_t pSlotAlignment);
+		static ObjectHeader&	EditHeader(Reflectable* pObject);
+
+		std::vector<Reflectable*, DIRE_ALLOCATOR<Reflectable*>>	myLiveObjects;
+	};
+
+	/**
+	 * \brief An allocation context made of one pool per reflectable type, keyed by type info (IDs can change when a database is imported).
+	 * Slots are sized from the type size recorded in the TypeInfo, and allocated by blocks. Destroyed objects are recycled through a free list.
+	 */
+	class Dire_EXPORT ReflectablePool final : public AllocationContext
+	{
+	public:
+		static const size_t	DEFAULT_SLOTS_PER_BLOCK = 64;
+
+		explicit ReflectablePool(size_t pSlotsPerBlock = DEFAULT_SLOTS_PER_BLOCK);
+		~ReflectablePool() override;
+
+		/**
+		 * \brief Makes sure pCount more objects of the given type can be instantiated without allocating.
+		 */
+		void	Reserve(ReflectableID pClassID, size_t pCount);
+
+		/**
+		 * \brief Returns the number of object slots allocated for the given type, be they used or not.
+		 */
+		[[nodiscard]] size_t	GetCapacity(ReflectableID pClassID) const;
+
+	protected:
+		void*	AllocateSlot(const TypeInfo& pTypeInfo, size_t pSlotSize, size_t pSlotAlignment) override;
+		void	FreeSlot(const TypeInfo& pTypeInfo, void* pSlot) override;
+		void	ReleaseAllSlots() override;
+
+	private:
+
+		struct Block
+		{
+			std::byte*	Memory = nullptr; // as allocated, not necessarily aligned on the slot alignment
+			size_t		Size = 0;
+		};
+
+		struct TypePool
+		{
+			size_t	SlotSize = 0; // rounded up to the slot alignment
+			size_t	SlotAlignment = 0;
+			size_t	SlotsPerBlock = 0;
+			void*	FreeList = nullptr; // free slots store the address of the next free slot
+			std::vector<Block, DIRE_ALLOCATOR<Block>>	Blocks;
+		};
+
+		TypePool&	EditTypePool(const TypeInfo& pTypeInfo, size_t pSlotSize, size_t pSlotAlignment);
+
+		static void		PushBlock(TypePool& pPool, size_t pNbSlots);
+
+		static std::byte*	GetFirstSlot(const TypePool& pPool, const Block& pBlock);
+
+		using TypePoolsHashTable =
+			std::unordered_map<const TypeInfo*, TypePool, std::hash<const TypeInfo*>, std::equal_to<const TypeInfo*>,
+			DIRE_ALLOCATOR<std::pair<const TypeInfo* const, TypePool>>>;
+
+		TypePoolsHashTable	myTypePools;
+		size_t				mySlotsPerBlock = DEFAULT_SLOTS_PER_BLOCK;
+	};
+
+	/**
+	 * \brief An allocation context backed by a bump arena, for short-lived reflectables (e.g. per-frame objects).
+	 * Destroying a single object doesn't give its memory back: all the memory is reclaimed at once by DestroyAll.
+	 */
+	class Dire_EXPORT ArenaContext final : public AllocationContext
+	{
+	public:
+		explicit ArenaContext(size_t pChunkSize = Arena::DEFAULT_CHUNK_SIZE);
+		~ArenaContext() override;
+
+		[[nodiscard]] const Arena&	GetArena() const { return myArena; }
+
+	protected:
+		void*	AllocateSlot(const TypeInfo& pTypeInfo, size_t pSlotSize, size_t pSlotAlignment) override;
+		void	FreeSlot(const TypeInfo& pTypeInfo, void* pSlot) override;
+		void	ReleaseAllSlots() override;
+
+	private:
+		Arena	myArena;
+	};
+}
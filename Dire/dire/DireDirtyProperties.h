@@ -0,0 +1,115 @@
+#pragma once
+
+#include "DireDefines.h"
+#include "dire/DireEnums.h" // FindFirstSetBit
+
+#include <algorithm> // fill
+#include <cstdint>
+#include <vector>
+
+namespace DIRE_NS
+{
+	/**
+	 * \brief The properties of a reflectable modified since the set was last cleared, as bits indexed by property ordinal
+	 * (the index of the property in the flattened property layout of the reflectable type).
+	 * Reflectable types opt in to dirty tracking with DIRE_DIRTY_TRACKING: each of their instances then holds a set.
+	 */
+	class DirtyPropertySet
+	{
+	public:
+		void	Mark(size_t pOrdinal)
+		{
+			if (pOrdinal < BITS_PER_WORD)
+			{
+				myFirstWord |= (uint64_t(1) << pOrdinal);
+				return;
+			}
+
+			const size_t iWord = pOrdinal / BITS_PER_WORD - 1;
+			if (iWord >= myOtherWords.size())
+			{
+				myOtherWords.resize(iWord + 1, 0);
+			}
+			myOtherWords[iWord] |= (uint64_t(1) << (pOrdinal % BITS_PER_WORD));
+		}
+
+		[[nodiscard]] bool	IsMarked(size_t pOrdinal) const
+		{
+			const uint64_t word = GetWord(pOrdinal / BITS_PER_WORD);
+			return (word & (uint64_t(1) << (pOrdinal % BITS_PER_WORD))) != 0;
+		}
+
+		[[nodiscard]] bool	IsEmpty() const
+		{
+			for (const uint64_t word : myOtherWords)
+			{
+				if (word != 0)
+					return false;
+			}
+
+			return myFirstWord == 0;
+		}
+
+		/**
+		 * \brief The number of marked properties.
+		 */
+		[[nodiscard]] size_t	Count() const
+		{
+			size_t count = 0;
+			ForEachMarked([&count](size_t) { count++; });
+			return count;
+		}
+
+		/**
+		 * \brief Clears the marks, keeping the memory of the set (if any) for the next ones.
+		 */
+		void	Clear()
+		{
+			myFirstWord = 0;
+			std::fill(myOtherWords.begin(), myOtherWords.end(), 0);
+		}
+
+		/**
+		 * \brief Calls pFunc with the ordinal of every marked property, in increasing order.
+		 */
+		template <typename Func>
+		void	ForEachMarked(Func&& pFunc) const
+		{
+			for (size_t iWord = 0; iWord <= myOtherWords.size(); ++iWord)
+			{
+				for (uint64_t word = GetWord(iWord); word != 0; word &= word - 1) // clears the lowest set bit
+				{
+					pFunc(iWord * BITS_PER_WORD + FindFirstSetBit(word));
+				}
+			}
+		}
+
+	private:
+		static constexpr size_t	BITS_PER_WORD = 64;
+
+		[[nodiscard]] uint64_t	GetWord(size_t pWord) const
+		{
+			if (pWord == 0)
+				return myFirstWord;
+
+			return (pWord <= myOtherWords.size() ? myOtherWords[pWord - 1] : 0);
+		}
+
+		uint64_t										myFirstWord = 0; // the first 64 properties are enough for most types: no allocation for them
+		std::vector<uint64_t, DIRE_ALLOCATOR<uint64_t>>	myOtherWords;
+	};
+}
+
+/**
+ * \brief Opts a reflectable type (and its children) in to dirty tracking. Use it once per hierarchy, after DIRE_REFLECTABLE_INFO.
+ */
+#define DIRE_DIRTY_TRACKING() \
+	::DIRE_NS::DirtyPropertySet	DIRE_DirtyProperties;\
+	[[nodiscard]] virtual const ::DIRE_NS::DirtyPropertySet* GetDirtyProperties() const override\
+	{\
+		return &DIRE_DirtyProperties;\
+	}\
+	[[nodiscard]] virtual ::DIRE_NS::DirtyPropertySet* EditDirtyProperties() override\
+	{\
+		return &DIRE_DirtyProperties;\
+	}
@@ -5,7 +5,8 @@
 
 #include <type_traits> // enable_if
 
-#include <cstring> // strcmp
+#include <climits> // CHAR_BIT
+#include <cstring> // memcpy
 
 namespace DIRE_NS
 {
@@ -15,10 +16,78 @@ namespace DIRE_NS
 
 	template <typename T>
 	constexpr bool IsEnum = std::is_enum_v<T> || std::is_base_of_v<Enum, T>;
+
+	/**
+	 * \brief A hash table of the names of an enum, built at compile time to find a name in constant time, without allocating.
+	 * It uses open addressing with linear probing and is kept at most half full: a lookup hashes the name once,
+	 * and only compares strings when the 64-bit hashes match, which is almost always for the right name.
+	 * \tparam N The number of names
+	 */
+	template <size_t N>
+	class EnumNameTable
+	{
+	public:
+		/**
+		 * \param pNamePairs The pairs the names are taken from, as their first member
+		 */
+		template <typename Pair>
+		constexpr explicit EnumNameTable(const Pair (&pNamePairs)[N])
+		{
+			for (size_t iName = 0; iName < N; ++iName)
+			{
+				const String::HashType hash = String::Hash(pNamePairs[iName].first);
+				size_t iSlot = size_t(hash) & (SIZE - 1);
+				while (mySlots[iSlot].Name != nullptr)
+				{
+					iSlot = (iSlot + 1) & (SIZE - 1);
+				}
+				mySlots[iSlot] = { hash, pNamePairs[iName].first, iName };
+			}
+		}
+
+		/**
+		 * \return The index of the name in the pairs the table was built from, or N if it is not one of them
+		 */
+		[[nodiscard]] constexpr size_t	Find(DIRE_STRING_VIEW pName) const
+		{
+			const String::HashType hash = String::Hash(pName);
+			// The table is never full: probing always ends on an empty slot.
+			for (size_t iSlot = size_t(hash) & (SIZE - 1); mySlots[iSlot].Name != nullptr; iSlot = (iSlot + 1) & (SIZE - 1))
+			{
+				if (mySlots[iSlot].Hash == hash && pName == mySlots[iSlot].Name)
+				{
+					return mySlots[iSlot].Index;
+				}
+			}
+			return N;
+		}
+
+	private:
+		static constexpr size_t	ComputeSize()
+		{
+			size_t size = 1;
+			while (size < 2 * N)
+			{
+				size *= 2;
+			}
+			return size;
+		}
+
+		static constexpr size_t	SIZE = ComputeSize(); // a power of two, for the modulo to be a mask
+
+		struct Slot
+		{
+			String::HashType	Hash = 0;
+			const char*			Name = nullptr;
+			size_t				Index = 0;
+		};
+
+		Slot	mySlots[SIZE]{};
+	};
 }
 
 #define DIRE_SEQUENTIAL_ENUM(EnumName, UnderlyingType, ...) \
-	class EnumName : public DIRE_NS::Enum \
+	class EnumName : public ::DIRE_NS::Enum \
 	{\
 	public:\
 		using Underlying = UnderlyingType; \
@@ -77,6 +146,11 @@ namespace DIRE_NS
 		{ \
 			return nameEnumPairs[int(enumValue)].first; \
 		}\
+		/* Same interface as the bitmask enums one, but names of sequential values are static strings: the buffer is not needed. */\
+		static DIRE_STRING_VIEW	ToChars(Values enumValue, char* /*pBuffer*/, size_t /*pBufferSize*/)\
+		{\
+			return GetStringFromSafeEnum(enumValue);\
+		}\
 		/* We have the guarantee that linear enums values start from 0 and increase 1 by 1 so we can make this function O(1).*/ \
 		static const char *	GetStringFromEnum(Values enumValue) \
 		{ \
@@ -86,25 +160,18 @@ namespace DIRE_NS
 			}\
 			return GetStringFromSafeEnum(enumValue);\
 		}\
+		/* Names are looked up in a hash table built at compile time, so this is O(1) too. */ \
 		static const Values *	GetValueFromString(const char * enumStr) \
 		{ \
-			for (auto const& pair : nameEnumPairs)\
-			{\
-				if (strcmp(pair.first, enumStr) == 0)\
-					return &pair.second;\
-			}\
-			return nullptr;\
+			const size_t index = nameTable.Find(enumStr);\
+			return (index < DIRE_NARGS(__VA_ARGS__) ? &nameEnumPairs[index].second : nullptr);\
 		}\
 		static Values	GetValueFromSafeString(DIRE_STRING_VIEW enumStr) \
 		{ \
-			for (auto const& pair : nameEnumPairs)\
-			{\
-				if (enumStr == pair.first)\
-					return pair.second;\
-			}\
+			const size_t index = nameTable.Find(enumStr);\
 			/* should never happen!*/\
-			DIRE_ASSERT(false);\
-			return Values();\
+			DIRE_ASSERT(index < DIRE_NARGS(__VA_ARGS__));\
+			return (index < DIRE_NARGS(__VA_ARGS__) ? Values(index) : Values());\
 		}\
 		template <typename F>\
 		static void	Enumerate(F&& pEnumerator)\
@@ -117,7 +184,8 @@ namespace DIRE_NS
 			return DIRE_STRINGIZE(EnumName);\
 		}\
 	private:\
-		inline static std::pair<const char*, Values> nameEnumPairs[]{DIRE_VA_MACRO(DIRE_BRACES_STRINGIZE_COMMA_VALUE, __VA_ARGS__)}; \
+		inline static constexpr std::pair<const char*, Values> nameEnumPairs[]{DIRE_VA_MACRO(DIRE_BRACES_STRINGIZE_COMMA_VALUE, __VA_ARGS__)}; \
+		inline static constexpr ::DIRE_NS::EnumNameTable<DIRE_NARGS(__VA_ARGS__)> nameTable{ nameEnumPairs }; \
 	};\
 	static_assert(sizeof(EnumName) == sizeof(UnderlyingType));
 
@@ -179,12 +247,85 @@ namespace DIRE_NS
 #endif
 }
 
+namespace DIRE_NS
+{
+	/**
+	 * \brief Calls a function with the name of every bit set in a bitmask enum value, from the lowest bit to the highest.
+	 * Only the set bits are visited, found by counting trailing zeros. Bits without a name are ignored.
+	 */
+	template <typename T, typename Pair, size_t N, typename F>
+	void	ForEachBitName(T pValue, const Pair (&pNamePairs)[N], F&& pFunc)
+	{
+		using Bits = std::make_unsigned_t<T>;
+		auto bits = Bits(pValue);
+		if constexpr (N < sizeof(Bits) * CHAR_BIT)
+		{
+			bits = Bits(bits & ((Bits(1) << N) - 1));
+		}
 
+		for (; bits != 0; bits = Bits(bits & (bits - 1))) // clears the lowest set bit
+		{
+			pFunc(pNamePairs[FindFirstSetBit(bits)].first);
+		}
+	}
+
+	/**
+	 * \brief Writes the names of the bits set in a bitmask enum value, separated by " | ", in the provided buffer instead of allocating.
+	 * \return The string, or a view with a nullptr data if it does not fit in the buffer
+	 */
+	template <typename T, typename Pair, size_t N>
+	DIRE_STRING_VIEW	BitmaskToChars(T pValue, const Pair (&pNamePairs)[N], char* pBuffer, size_t pBufferSize)
+	{
+		size_t length = 0;
+		bool fits = true;
+		ForEachBitName(pValue, pNamePairs, [&](DIRE_STRING_VIEW pName)
+		{
+			const DIRE_STRING_VIEW separator = (length != 0 ? " | " : "");
+			if (!fits || length + separator.size() + pName.size() > pBufferSize)
+			{
+				fits = false;
+				return;
+			}
+
+			memcpy(pBuffer + length, separator.data(), separator.size());
+			length += separator.size();
+			memcpy(pBuffer + length, pName.data(), pName.size());
+			length += pName.size();
+		});
+
+		if (!fits)
+			return {};
+
+		return { pBuffer, length };
+	}
+
+	/**
+	 * \brief Parses names of bitmask enum values separated by " | ", looking each of them up in the name table of the enum, without allocating.
+	 * \return The value with the bits of all the names set, or 0 if one of them is not a name of the enum
+	 */
+	template <typename T, typename Pair, size_t N>
+	T	ParseBitmask(DIRE_STRING_VIEW pStr, const EnumNameTable<N>& pNameTable, const Pair (&pNamePairs)[N])
+	{
+		T value = 0;
+		while (true)
+		{
+			const size_t pipePos = pStr.find(" | ");
+			const size_t index = pNameTable.Find(pStr.substr(0, pipePos));
+			if (index == N) // not found? error
+				return 0;
 
+			value = T(value | T(pNamePairs[index].second));
+			if (pipePos == pStr.npos)
+				return value;
+
+			pStr.remove_prefix(pipePos + 3);
+		}
+	}
+}
 
 // This idea of storing a "COUNTER_BASE" has been stolen from https://stackoverflow.com/a/52770279/1987466
 #define DIRE_BITMASK_ENUM(EnumName, UnderlyingType, ...) \
-	class EnumName : public DIRE_NS::Enum\
+	class EnumName : public ::DIRE_NS::Enum\
 	{ \
 		private:\
 		enum LocalCounter_t { COUNTER_BASE = __COUNTER__, OFFSET = (1) };\
@@ -312,7 +453,7 @@ namespace DIRE_NS
 		/*This one assumes that the parameter value is guaranteed to be within bounds and thus doesn't even bounds check. */\
 		static const char*	GetStringFromSafeEnum(Values pEnumValue) \
 		{ \
-			return nameEnumPairs[DIRE_NS::FindFirstSetBit((UnderlyingType)pEnumValue)].first; \
+			return nameEnumPairs[::DIRE_NS::FindFirstSetBit((UnderlyingType)pEnumValue)].first; \
 		}\
 		/* We have the guarantee that bitflags enums values are powers of 2 so we can make this function O(1).*/ \
 		static DIRE_STRING	GetStringFromEnum(Values pEnumValue)\
@@ -324,49 +465,20 @@ namespace DIRE_NS
 			}\
 			return GetStringFromSafeEnum(pEnumValue);\
 		}\
-		static const Values GetValueFromString(DIRE_STRING_VIEW enumStr) \
-		{ \
-			/* Happy path: there's no pipe in the string, directly search values */\
-			if (enumStr.find('|') == enumStr.npos)\
-			{\
-				for (const auto& pair : nameEnumPairs)\
-				{\
-					if (enumStr == pair.first)\
-						return pair.second;\
-				}\
-				return (Values)0;\
-			}\
-			else\
+		/* Same as GetString, but writes the string in the provided buffer instead of allocating it. Returns a view with a nullptr data if it does not fit. */\
+		static DIRE_STRING_VIEW	ToChars(Values pEnumValue, char* pBuffer, size_t pBufferSize)\
+		{\
+			/* If value is 0, it cannot be valid */\
+			if ((UnderlyingType)pEnumValue == 0)\
 			{\
-				/* Find each ' | ', then search each token separately*/\
-				size_t tokenPos = 0;\
-				Underlying val = 0;\
-				while (tokenPos != enumStr.npos)\
-				{\
-					DIRE_STRING_VIEW token;\
-					size_t pipePos = enumStr.find(" | ", tokenPos);\
-					if (pipePos != enumStr.npos)\
-						token = enumStr.substr(tokenPos, pipePos - tokenPos);\
-					else\
-						token = enumStr.substr(tokenPos, enumStr.length() - tokenPos);\
-					Underlying oldVal = val;\
-					for (const auto& pair : nameEnumPairs)\
-					{\
-						if (token == pair.first)\
-						{\
-							val = val | pair.second;\
-							break;\
-						}\
-					}\
-					if (oldVal == val) /* not found? error*/\
-						return (Values)0;\
-					if (pipePos != enumStr.npos)\
-						tokenPos = pipePos + 3;\
-					else\
-						tokenPos = enumStr.npos;\
-				}\
-				return (Values)val;\
+				return "invalid";\
 			}\
+			return ::DIRE_NS::BitmaskToChars((UnderlyingType)pEnumValue, nameEnumPairs, pBuffer, pBufferSize);\
+		}\
+		/* Each name is looked up in a hash table built at compile time, and the string is never copied. */\
+		static const Values GetValueFromString(DIRE_STRING_VIEW enumStr) \
+		{ \
+			return (Values)::DIRE_NS::ParseBitmask<Underlying>(enumStr, nameTable, nameEnumPairs);\
 		}\
 		static Values	GetValueFromSafeString(DIRE_STRING_VIEW enumStr) \
 		{ \
@@ -391,19 +503,16 @@ namespace DIRE_NS
 				return "invalid";\
 			}\
 			DIRE_STRING oredValues;\
-			for (unsigned i = DIRE_NS::FindFirstSetBit((UnderlyingType)pEnumValue); i < DIRE_NARGS(__VA_ARGS__); ++i)\
+			::DIRE_NS::ForEachBitName((UnderlyingType)pEnumValue, nameEnumPairs, [&oredValues](DIRE_STRING_VIEW pName)\
 			{\
-				const auto& enumNamePair = nameEnumPairs[i];\
-				if ((UnderlyingType)pEnumValue & (UnderlyingType)enumNamePair.second)\
-				{\
-					if (!oredValues.empty())\
-						oredValues += " | ";\
-					oredValues += enumNamePair.first;\
-				}\
-			}\
+				if (!oredValues.empty())\
+					oredValues += " | ";\
+				oredValues += pName;\
+			});\
 			return oredValues;\
 		}\
-		inline static std::pair<const char*, Values> nameEnumPairs[] {DIRE_VA_MACRO(DIRE_BRACES_STRINGIZE_COMMA_VALUE, __VA_ARGS__)};\
+		inline static constexpr std::pair<const char*, Values> nameEnumPairs[] {DIRE_VA_MACRO(DIRE_BRACES_STRINGIZE_COMMA_VALUE, __VA_ARGS__)};\
+		inline static constexpr ::DIRE_NS::EnumNameTable<DIRE_NARGS(__VA_ARGS__)> nameTable{ nameEnumPairs };\
 	};\
 	static_assert(sizeof(EnumName) == sizeof(UnderlyingType));
 
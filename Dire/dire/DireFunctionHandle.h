@@ -0,0 +1,104 @@
+#pragma once
+
+#include "dire/Types/DireTypeInfo.h"
+
+#include <utility> // forward
+
+namespace DIRE_NS
+{
+	/**
+	 * \brief A member function resolved once from a TypeInfo and a name, then called with no name lookup and no std::any boxing.
+	 * Binding checks the return and parameter types of the function against the handle signature: first their metatypes,
+	 * then the exact C++ signature, so that calling through the handle is as type-safe as calling the member function directly.
+	 * Calls go through a direct function pointer (about the cost of a virtual call), which makes it fit for hot reflected callbacks.
+	 * Like for InvokeWithArgs, the object passed to the handle must be an instance of the class declaring the function (or of a child of it).
+	 * \tparam Ret The return type of the function
+	 * \tparam Args The exact parameter types of the function
+	 */
+	template <typename Ret, typename... Args>
+	class FunctionHandle<Ret(Args...)>
+	{
+	public:
+		FunctionHandle() = default;
+
+		/**
+		 * \brief Binds a handle to a member function of the given type (or one of its parents).
+		 * \param pTypeInfo The type info to look the function up in
+		 * \param pFuncName The function name
+		 * \return The bound handle. It is invalid if the function could not be found or has a different signature.
+		 */
+		[[nodiscard]] static FunctionHandle	Bind(const TypeInfo& pTypeInfo, DIRE_STRING_VIEW pFuncName)
+		{
+			FunctionHandle handle;
+			const FunctionInfo* function = pTypeInfo.FindFunctionInHierarchy(pFuncName);
+			if (function != nullptr && HasMatchingSignature(*function))
+			{
+				handle.myFunction = function;
+				handle.myThunk = reinterpret_cast<ThunkSignature>(function->Thunk);
+			}
+			return handle;
+		}
+
+		[[nodiscard]] bool	IsValid() const
+		{
+			return myFunction != nullptr;
+		}
+
+		explicit operator bool() const
+		{
+			return IsValid();
+		}
+
+		[[nodiscard]] const FunctionInfo*	GetFunctionInfo() const
+		{
+			return myFunction;
+		}
+
+		/**
+		 * \brief Calls the bound function. The handle must be valid.
+		 * \param pObject The object the member function should use as this
+		 * \param pArgs The arguments
+		 * \return The function return value
+		 */
+		Ret	operator()(void* pObject, Args... pArgs) const
+		{
+			DIRE_ASSERT(IsValid());
+			return myThunk(*myFunction, pObject, std::forward<Args>(pArgs)...);
+		}
+
+		/**
+		 * \brief Checks a function against the handle signature.
+		 */
+		[[nodiscard]] static bool	HasMatchingSignature(const FunctionInfo& pFunction)
+		{
+			if (pFunction.GetReturnType() != FromActualTypeToEnumType<Ret>::EnumType)
+			{
+				return false;
+			}
+
+			constexpr MetaType::Values expectedParams[] = { FromActualTypeToEnumType<Args>::EnumType..., MetaType::Unknown };
+			const FunctionInfo::ParameterList& params = pFunction.GetParametersTypes();
+			if (params.size() != sizeof...(Args))
+			{
+				return false;
+			}
+
+			for (size_t iParam = 0; iParam < params.size(); ++iParam)
+			{
+				if (params[iParam] != expectedParams[iParam])
+				{
+					return false;
+				}
+			}
+
+			// Metatypes can't tell apart two references or two objects of different types: the exact signature can.
+			return pFunction.GetSignatureHash() == GetFunctionSignatureHash<Ret(Args...)>();
+		}
+
+	private:
+		using ThunkSignature = Ret (*)(const FunctionInfo&, void*, Args...);
+
+		const FunctionInfo*	myFunction = nullptr;
+		ThunkSignature		myThunk = nullptr;
+	};
+}
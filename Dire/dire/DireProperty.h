@@ -83,9 +83,13 @@ namespace DIRE_NS
 	class TypedProperty final : public PropertyTypeInfo
 	{
 	public:
-		TypedProperty(const char* pName, std::ptrdiff_t pOffset) :
+		TypedProperty(const char* pName, std::ptrdiff_t pOffset, [[maybe_unused]] const char* pMetadataName) :
 			PropertyTypeInfo(pName, pOffset, sizeof(TProp))
 		{
+#ifdef DIRE_SERIALIZATION_ENABLED
+			SetMetadataName(pMetadataName);
+#endif
+
 			TypeInfo& typeInfo = TOwner::EditTypeInfo();
 			typeInfo.PushTypeInfo(*this);
 
@@ -142,7 +146,7 @@ namespace DIRE_NS
 		} \
     }; \
 	::DIRE_NS::GetParenthesizedType<void  DIRE_LPAREN DIRE_UNPAREN(type) DIRE_RPAREN>::Type name{ std::make_from_tuple< DIRE_UNPAREN(type) >(name##_tag::ParamExtractor::CtorParameters(std::make_tuple(__VA_ARGS__))) };\
-	inline static ::DIRE_NS::TypedProperty<Self, DIRE_UNPAREN(type), name##_tag::ParamExtractor::MetadataType> name##_TYPEINFO_PROPERTY{DIRE_STRINGIZE(name), name##_tag::Offset() };
+	inline static ::DIRE_NS::TypedProperty<Self, DIRE_UNPAREN(type), name##_tag::ParamExtractor::MetadataType> name##_TYPEINFO_PROPERTY{DIRE_STRINGIZE(name), name##_tag::Offset(), DIRE_STRINGIZE(name) "_metadata" };
 
 #define DIRE_ARRAY_PROPERTY(type, name, size, ...) \
 	struct name##_tag\
@@ -155,4 +159,4 @@ namespace DIRE_NS
 		} \
 	}; \
 	::DIRE_NS::GetParenthesizedType<void DIRE_LPAREN DIRE_UNPAREN(type) DIRE_RPAREN>::Type name size{ }; \
-	inline static ::DIRE_NS::TypedProperty<Self, DIRE_UNPAREN(type) size, name##_tag::ParamExtractor::MetadataType> name##_TYPEINFO_PROPERTY{ DIRE_STRINGIZE(name), name##_tag::Offset()};
+	inline static ::DIRE_NS::TypedProperty<Self, DIRE_UNPAREN(type) size, name##_tag::ParamExtractor::MetadataType> name##_TYPEINFO_PROPERTY{ DIRE_STRINGIZE(name), name##_tag::Offset(), DIRE_STRINGIZE(name) "_metadata" };
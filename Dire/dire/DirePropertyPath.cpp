@@ -0,0 +1,188 @@
+#include "DirePropertyPath.h"
+
+#include <cstdio> // snprintf
+
+namespace DIRE_NS
+{
+	PropertyPath PropertyPath::Compile(const TypeInfo& pTypeInfo, DIRE_STRING_VIEW pPath)
+	{
+		PropertyPath path;
+		path.myOwnerTypeInfo = &pTypeInfo;
+
+		// Describes the value we have reached so far in the path.
+		const TypeInfo* currentTypeInfo = &pTypeInfo;
+		MetaType currentMetatype = MetaType::Object;
+		DataStructureHandler currentHandler;
+
+		bool expectName = true;
+		size_t pos = 0;
+		while (pos < pPath.size())
+		{
+			if (expectName)
+			{
+				const size_t nameEnd = std::min(pPath.find_first_of(".[", pos), pPath.size());
+				const DIRE_STRING_VIEW name = pPath.substr(pos, nameEnd - pos);
+				if (name.empty())
+				{
+					return path.SetError("Syntax error: empty property name in '%.*s'.", pPath);
+				}
+
+				if (currentTypeInfo == nullptr) // compound type that is not Reflectable...
+				{
+					return path.SetError("Property %.*s is not in a Reflectable.", name);
+				}
+
+				const PropertyTypeInfo* prop = currentTypeInfo->FindPropertyInHierarchy(name);
+				if (prop == nullptr)
+				{
+					return path.SetError("Property %.*s not found.", name);
+				}
+
+				if (currentTypeInfo == &pTypeInfo)
+				{
+					// The layouts of children types start with the one of their parent: the ordinal holds for them too.
+					path.myRootOrdinal = pTypeInfo.GetPropertyLayout().FindIndex(*prop);
+				}
+
+				path.PushOffset(prop->GetOffset());
+				path.myLeafProperty = prop;
+				currentMetatype = prop->GetMetatype();
+				currentHandler = prop->GetDataStructureHandler();
+				currentTypeInfo = TypeInfoDatabase::GetSingleton().GetTypeInfo(prop->GetReflectableID());
+
+				pos = nameEnd;
+				expectName = false;
+			}
+			else if (pPath[pos] == '.')
+			{
+				pos++;
+				expectName = true;
+			}
+			else if (pPath[pos] == '[')
+			{
+				const size_t rightBrackPos = pPath.find(']', pos);
+				if (rightBrackPos == pPath.npos || rightBrackPos == pos + 1)
+				{
+					return path.SetError("Syntax error: Mismatched bracket or empty brackets in '%.*s'.", pPath);
+				}
+
+				const DIRE_STRING_VIEW key = pPath.substr(pos + 1, rightBrackPos - pos - 1);
+				Step& step = path.mySteps.emplace_back();
+
+				if (currentMetatype == MetaType::Array && currentHandler.GetArrayHandler() != nullptr)
+				{
+					const ConvertResult<size_t> index = FromCharsConverter<size_t>::Convert(key);
+					if (index.HasError())
+					{
+						path.myError = index.GetError();
+						return path;
+					}
+
+					const IArrayDataStructureHandler* arrayHandler = currentHandler.GetArrayHandler();
+					step.StepKind = Step::Kind::ArrayIndex;
+					step.ArrayHandler = arrayHandler;
+					step.OffsetOrIndex = index.GetValue();
+
+					currentMetatype = arrayHandler->ElementType();
+					currentHandler = arrayHandler->ElementHandler();
+					currentTypeInfo = TypeInfoDatabase::GetSingleton().GetTypeInfo(arrayHandler->ElementReflectableID());
+				}
+				else if (currentMetatype == MetaType::Map && currentHandler.GetMapHandler() != nullptr)
+				{
+					const IMapDataStructureHandler* mapHandler = currentHandler.GetMapHandler();
+					if (mapHandler->SizeofKey() > MAX_BINARY_KEY_SIZE || !mapHandler->ConvertKey(key, step.BinaryKey))
+					{
+						return path.SetError("Map key '%.*s' cannot be converted to the map key type.", key);
+					}
+
+					step.StepKind = Step::Kind::MapKey;
+					step.MapHandler = mapHandler;
+
+					currentMetatype = mapHandler->ValueMetaType();
+					currentHandler = mapHandler->ValueDataHandler();
+					currentTypeInfo = TypeInfoDatabase::GetSingleton().GetTypeInfo(mapHandler->ValueReflectableID());
+				}
+				else
+				{
+					return path.SetError("This type doesn't support array indexing: '%.*s'.", pPath);
+				}
+
+				path.myLeafProperty = nullptr;
+				pos = rightBrackPos + 1;
+			}
+			else
+			{
+				return path.SetError("Syntax error: unexpected character in '%.*s'.", pPath);
+			}
+		}
+
+		if (expectName) // empty path, or path ending with a dot
+		{
+			return path.SetError("Syntax error: empty property name in '%.*s'.", pPath);
+		}
+
+		path.myLeafMetatype = currentMetatype;
+		return path;
+	}
+
+	const void* PropertyPath::Resolve(const Reflectable& pInstance) const
+	{
+		if (!IsValid())
+		{
+			return nullptr;
+		}
+
+		DIRE_ASSERT(myOwnerTypeInfo->IsParentOf(pInstance.GetReflectableClassID()));
+
+		auto address = reinterpret_cast<const std::byte*>(&pInstance);
+		for (const Step& step : mySteps)
+		{
+			switch (step.StepKind)
+			{
+			case Step::Kind::Offset:
+				address += step.OffsetOrIndex;
+				break;
+			case Step::Kind::ArrayIndex:
+				address = static_cast<const std::byte*>(step.ArrayHandler->Read(address, step.OffsetOrIndex));
+				break;
+			case Step::Kind::MapKey:
+				address = static_cast<const std::byte*>(step.MapHandler->BinaryRead(address, step.BinaryKey));
+				break;
+			}
+
+			if (address == nullptr)
+			{
+				return nullptr;
+			}
+		}
+
+		return address;
+	}
+
+	void PropertyPath::PushOffset(size_t pOffset)
+	{
+		// Consecutive compound accesses can be merged into a single offset.
+		if (!mySteps.empty() && mySteps.back().StepKind == Step::Kind::Offset)
+		{
+			mySteps.back().OffsetOrIndex += pOffset;
+			return;
+		}
+
+		Step& step = mySteps.emplace_back();
+		step.StepKind = Step::Kind::Offset;
+		step.OffsetOrIndex = pOffset;
+	}
+
+	PropertyPath& PropertyPath::SetError(const char* pFormat, DIRE_STRING_VIEW pToken)
+	{
+		const int tokenLength = int(pToken.size());
+		const int toWrite = std::snprintf(nullptr, 0, pFormat, tokenLength, pToken.data());
+		myError.resize(size_t(toWrite + 1)); // +1 for \0
+		std::snprintf(myError.data(), myError.size(), pFormat, tokenLength, pToken.data());
+		myError.pop_back();
+
+		mySteps.clear();
+		myLeafProperty = nullptr;
+		return *this;
+	}
+}
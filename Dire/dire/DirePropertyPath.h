@@ -0,0 +1,149 @@
+#pragma once
+
+#include "DireReflectable.h"
+
+#include <cstddef> // max_align_t
+#include <vector>
+
+namespace DIRE_NS
+{
+	/**
+	 * \brief A property path (e.g. "mega.toto[2].titi[4]" or "aFatMap[42].leet") compiled once against a TypeInfo.
+	 * Compiling resolves every name to its property offset, every array index to a constant index and every map key to its binary representation,
+	 * so that reading or writing the property on any instance of that type (or of one of its children) doesn't need to do any string processing anymore.
+	 * It follows the same semantics as Reflectable::GetProperty (e.g. reading out of a vector-like array grows it, reading a map key creates it).
+	 * Keep in mind a compiled path is bound to the TypeInfo it was compiled against: using it on an unrelated instance is undefined behaviour.
+	 * Map keys are converted once, into a small inline buffer: only the keys Reflectable::GetProperty supports (arithmetic types and Dire enums)
+	 * can be compiled. String-keyed maps are not supported, neither here nor by Reflectable::GetProperty.
+	 */
+	class PropertyPath
+	{
+	public:
+		using ParseError = Reflectable::ParseError;
+
+		PropertyPath() = default;
+
+		/**
+		 * \brief Compiles a property path against the given type info.
+		 * \param pTypeInfo The type info of the Reflectable this path will be used on
+		 * \param pPath The path, using the same syntax as Reflectable::GetProperty
+		 * \return The compiled path. Check IsValid to know if the compilation went well, or GetError to know why it failed.
+		 */
+		[[nodiscard]] Dire_EXPORT static PropertyPath	Compile(const TypeInfo& pTypeInfo, DIRE_STRING_VIEW pPath);
+
+		template <typename T>
+		[[nodiscard]] static PropertyPath	Compile(DIRE_STRING_VIEW pPath)
+		{
+			static_assert(std::is_base_of_v<Reflectable, T>, "PropertyPath can only be compiled for Reflectable-derived class types.");
+			return Compile(T::GetTypeInfo(), pPath);
+		}
+
+		[[nodiscard]] bool	IsValid() const
+		{
+			return myOwnerTypeInfo != nullptr && myError.empty();
+		}
+
+		[[nodiscard]] const ParseError*	GetError() const
+		{
+			return myError.empty() ? nullptr : &myError;
+		}
+
+		/**
+		 * \brief Returns the property type info of the last named property of the path, or nullptr if the path ends with an array or map access.
+		 */
+		[[nodiscard]] const PropertyTypeInfo*	GetLeafProperty() const
+		{
+			return myLeafProperty;
+		}
+
+		/**
+		 * \brief Returns the metatype of the value this path points to.
+		 */
+		[[nodiscard]] MetaType	GetLeafMetatype() const
+		{
+			return myLeafMetatype;
+		}
+
+		[[nodiscard]] const TypeInfo*	GetOwnerTypeInfo() const
+		{
+			return myOwnerTypeInfo;
+		}
+
+		/**
+		 * \brief Walks the compiled path on the given instance.
+		 * \return The address of the value this path points to, or nullptr if the path is invalid or an intermediate data structure couldn't be read.
+		 */
+		[[nodiscard]] Dire_EXPORT const void*	Resolve(const Reflectable& pInstance) const;
+
+		template <typename TProp = void>
+		[[nodiscard]] const TProp*	Get(const Reflectable& pInstance) const
+		{
+			return static_cast<const TProp*>(Resolve(pInstance));
+		}
+
+		/**
+		 * \brief Resolves the path for writing: the property the path starts with is marked dirty in the instance.
+		 */
+		template <typename TProp>
+		[[nodiscard]] TProp*	Edit(Reflectable& pInstance) const
+		{
+			TProp* propPtr = const_cast<TProp*>(Get<TProp>(pInstance));
+			if (propPtr != nullptr)
+			{
+				pInstance.MarkPropertyDirty(myRootOrdinal);
+			}
+			return propPtr;
+		}
+
+		template <typename TProp>
+		bool	Set(Reflectable& pInstance, TProp&& pSetValue) const
+		{
+			using ValueType = std::remove_cv_t<std::remove_reference_t<TProp>>;
+			ValueType* propPtr = Edit<ValueType>(pInstance);
+			if (propPtr == nullptr)
+			{
+				return false;
+			}
+
+			(*propPtr) = std::forward<TProp>(pSetValue);
+			return true;
+		}
+
+	private:
+
+		// Big enough for any arithmetic or Dire enum map key (the only keys ConvertKey supports).
+		static const size_t MAX_BINARY_KEY_SIZE = 16;
+
+		struct Step
+		{
+			enum class Kind : uint8_t
+			{
+				Offset,
+				ArrayIndex,
+				MapKey
+			};
+
+			Kind	StepKind = Kind::Offset;
+			union
+			{
+				const IArrayDataStructureHandler*	ArrayHandler = nullptr;
+				const IMapDataStructureHandler*		MapHandler;
+			};
+			size_t	OffsetOrIndex = 0;
+			alignas(std::max_align_t) std::byte	BinaryKey[MAX_BINARY_KEY_SIZE]{};
+		};
+
+		void	PushOffset(size_t pOffset);
+
+		PropertyPath&	SetError(const char* pFormat, DIRE_STRING_VIEW pToken);
+
+		using StepList = std::vector<Step, DIRE_ALLOCATOR<Step>>;
+
+		StepList					mySteps;
+		const TypeInfo*				myOwnerTypeInfo = nullptr;
+		const PropertyTypeInfo*		myLeafProperty = nullptr;
+		size_t						myRootOrdinal = 0; // the ordinal of the property the path starts with, in the property layout
+		MetaType					myLeafMetatype = MetaType::Unknown;
+		ParseError					myError;
+	};
+}
@@ -1,4 +1,5 @@
 #include "DireReflectable.h"
+#include "dire/Utils/DireArena.h"
 
 namespace DIRE_NS
 {
@@ -52,26 +53,56 @@ namespace DIRE_NS
 			return {}; // Didn't find the property or it's of a type that we don't know how to handle in this context.
 		}
 
-		// Otherwise: search for a "normal" property
-		for (PropertyTypeInfo const& prop : thisTypeInfo->GetPropertyList())
+		// Otherwise: search for a "normal" property (in this class or in the parent classes)
+		if (const PropertyTypeInfo* prop = thisTypeInfo->FindPropertyInHierarchy(pFullPath))
 		{
-			if (prop.GetName() == pFullPath)
-			{
-				return GetPropertyResult(propertyAddr + prop.GetOffset(), &prop);
-			}
+			return GetPropertyResult(propertyAddr + prop->GetOffset(), prop);
 		}
 
-		// Maybe in the parent classes?
-		auto [parentClass, parentProperty] = thisTypeInfo->FindParentClassProperty(pFullPath);
-		if (parentClass != nullptr && parentProperty != nullptr) // A parent property was found
+		return {};
+	}
+
+	void Reflectable::MarkDirtyAt(const void* pMemberAddr)
+	{
+		const auto* objectAddr = reinterpret_cast<const std::byte*>(this);
+		const auto* memberAddr = static_cast<const std::byte*>(pMemberAddr);
+		if (memberAddr < objectAddr)
+			return;
+
+		const PropertyLayout& layout = GetReflectableTypeInfo()->GetPropertyLayout();
+		const size_t ordinal = layout.FindIndexAtOffset(static_cast<size_t>(memberAddr - objectAddr));
+		if (ordinal != layout.GetCount())
 		{
-			return GetPropertyResult(propertyAddr + parentProperty->GetOffset(), parentProperty);
+			MarkPropertyDirty(ordinal);
 		}
+	}
 
-		return {};
+	void Reflectable::MarkPathDirty(DIRE_STRING_VIEW pPath)
+	{
+		if (EditDirtyProperties() == nullptr)
+			return;
+
+		// The ordinal comes straight from the hashed name index of the layout: this runs on every SetProperty.
+		const PropertyLayout& layout = GetReflectableTypeInfo()->GetPropertyLayout();
+		const size_t ordinal = layout.FindIndexByName(pPath.substr(0, pPath.find_first_of(".[")));
+		if (ordinal < layout.GetCount())
+		{
+			MarkPropertyDirty(ordinal);
+		}
 	}
 
 	[[nodiscard]] bool Reflectable::EraseProperty(DIRE_STRING_VIEW pName)
+	{
+		const bool erased = EraseContainerProperty(pName);
+		if (erased)
+		{
+			MarkPathDirty(pName);
+		}
+
+		return erased;
+	}
+
+	bool Reflectable::EraseContainerProperty(DIRE_STRING_VIEW pName)
 	{
 		// if we're trying to erase from an array or a map, search for the array or map property first.
 		if (pName.back() == ']')
@@ -541,24 +572,57 @@ namespace DIRE_NS
 		return RecurseFindArrayProperty(arrayHandler, pName, pRemainingPath, pArrayIdx, pPropPtr);
 	}
 
+#ifdef DIRE_STATS_ENABLED
+	void Reflectable::RecordPropertyLookup(DIRE_STRING_VIEW pPath, bool pFound) const
+	{
+		const TypeInfo* thisTypeInfo = GetReflectableTypeInfo();
+		DIRE_STATS_ADD(thisTypeInfo, PropertyLookups, 1);
+		if (!pFound)
+		{
+			DIRE_STATS_ADD(thisTypeInfo, FailedPropertyLookups, 1);
+		}
+
+		TypeInfoDatabase::GetSingleton().RecordPropertyPath(pPath);
+	}
+#endif
+
 	const FunctionInfo * Reflectable::GetFunction(DIRE_STRING_VIEW pMemberFuncName) const
 	{
 		const TypeInfo * thisTypeInfo = GetReflectableTypeInfo();
-		for (const FunctionInfo & aFuncInfo : thisTypeInfo->GetFunctionList())
+		return thisTypeInfo->FindFunctionInHierarchy(pMemberFuncName);
+	}
+
+	Span<Reflectable*> CloneBatch(const Reflectable& pCloned, size_t pCount, Arena& pArena)
+	{
+		const TypeInfo* typeInfo = pCloned.GetReflectableTypeInfo();
+		if (typeInfo == nullptr || pCount == 0)
+			return {};
+
+		TypeInfo::PlacementInstantiateFunction instantiator = typeInfo->GetPlacementInstantiator();
+		if (instantiator == nullptr)
+			return {};
+
+		const CopyPlan& copyPlan = typeInfo->GetCache().GetCopyPlan();
+		const size_t typeSize = typeInfo->GetTypeSize();
+
+		auto* clones = static_cast<Reflectable**>(pArena.Allocate(sizeof(Reflectable*) * pCount, alignof(Reflectable*)));
+		auto* clonesMemory = static_cast<std::byte*>(pArena.Allocate(typeSize * pCount, typeInfo->GetTypeAlignment()));
+
+		for (size_t iClone = 0; iClone < pCount; ++iClone)
 		{
-			if (aFuncInfo.GetName() == pMemberFuncName)
-			{
-				return &aFuncInfo;
-			}
+			clones[iClone] = instantiator(clonesMemory + iClone * typeSize);
+			copyPlan.Copy(clones[iClone], &pCloned);
 		}
+		DIRE_STATS_ADD(typeInfo, Clones, pCount);
 
-		// Maybe in parent classes?
-		auto [_, functionInfo] = thisTypeInfo->FindParentFunction(pMemberFuncName);
-		if (functionInfo != nullptr)
+		return { clones, pCount };
+	}
+
+	void DestroyBatch(Span<Reflectable*> pBatch)
+	{
+		for (Reflectable* reflectable : pBatch)
 		{
-			return functionInfo;
+			reflectable->~Reflectable();
 		}
-
-		return nullptr;
 	}
 }
@@ -3,7 +3,9 @@
 #include "Handlers/DireArrayDataStructureHandler.h"
 #include "Utils/DireMacros.h"
 #include "Utils/DireString.h"
+#include "Utils/DireSpan.h"
 #include "DireReflectableID.h"
+#include "DireDirtyProperties.h"
 
 #include <any>
 
@@ -40,7 +42,7 @@ namespace DIRE_NS
 			TypeInfoDatabase::EditSingleton().RegisterInstantiateFunction(T::GetTypeInfo().GetID(), &Instantiate);
 		}
 
-		static Reflectable* Instantiate(const std::any & pCtorParams)
+		static Reflectable* Instantiate(const std::any & pCtorParams, void* pMemory)
 		{
 			using ArgumentPackTuple = std::tuple<Args...>;
 			const ArgumentPackTuple * argsTuple = std::any_cast<ArgumentPackTuple>(&pCtorParams);
@@ -48,8 +50,12 @@ namespace DIRE_NS
 			{
 				return nullptr;
 			}
-			auto f = [](Args... pCtorArgs) -> T*
+			auto f = [pMemory](Args... pCtorArgs) -> T*
 			{
+				if (pMemory != nullptr)
+				{
+					return new (pMemory) T(pCtorArgs...);
+				}
 				return AllocateReflectable<T>(pCtorArgs...);
 			};
 			T* result = std::apply(f, *argsTuple);
@@ -84,9 +90,11 @@ namespace DIRE_NS
 			{
 				return true;
 			}
-
-			TypeInfo const& parentTypeInfo = TRefl::GetTypeInfo();
-			return (parentTypeInfo.GetID() == GetReflectableClassID() || parentTypeInfo.IsParentOf(GetReflectableClassID()));
+			else
+			{
+				const TypeInfo* typeInfo = GetReflectableTypeInfo();
+				return (typeInfo != nullptr && TRefl::GetTypeInfo().IsParentOf(*typeInfo));
+			}
 		}
 
 		template <typename T = Reflectable>
@@ -107,6 +115,7 @@ namespace DIRE_NS
 			}
 
 			thisTypeInfo->CloneHierarchyPropertiesOf(*clone, *this);
+			DIRE_STATS_ADD(thisTypeInfo, Clones, 1);
 
 			return (T*)clone;
 		}
@@ -181,6 +190,9 @@ namespace DIRE_NS
 		[[nodiscard]] PropertyAccessor<TProp> GetProperty(DIRE_STRING_VIEW pName) const
 		{
 			GetPropertyResult result = GetPropertyImpl(pName);
+#ifdef DIRE_STATS_ENABLED
+			RecordPropertyLookup(pName, result.Error.empty());
+#endif
 			if (result.Error.empty())
 			{
 				return PropertyAccessor<TProp>(static_cast<const TProp*>(result.Address));
@@ -213,11 +225,51 @@ namespace DIRE_NS
 
 			TProp* editablePropPtr = const_cast<TProp*>(propPtr);
 			(*editablePropPtr) = std::forward<TProp>(pSetValue);
+			MarkPathDirty(pName);
 			return true;
 		}
 
 		[[nodiscard]] Dire_EXPORT bool EraseProperty(DIRE_STRING_VIEW pName);
 
+		/**
+		 * \brief Returns the properties modified since the set was last cleared, or nullptr if the type doesn't use DIRE_DIRTY_TRACKING.
+		 * SetProperty, EraseProperty and PropertyPath::Edit mark the properties they modify:
+		 * other writes (to members directly, or through data structure handlers) have to be marked with MarkDirty.
+		 */
+		[[nodiscard]] virtual const DirtyPropertySet*	GetDirtyProperties() const
+		{
+			return nullptr;
+		}
+
+		[[nodiscard]] virtual DirtyPropertySet*	EditDirtyProperties()
+		{
+			return nullptr;
+		}
+
+		/**
+		 * \brief Marks the property containing the given member as dirty (e.g. player.MarkDirty(player.transform.position)).
+		 * Does nothing if the type doesn't track dirty properties, or if the member is not in a reflected property.
+		 */
+		template <typename T>
+		void	MarkDirty(const T& pMember)
+		{
+			if (EditDirtyProperties() != nullptr)
+			{
+				MarkDirtyAt(&pMember);
+			}
+		}
+
+		/**
+		 * \brief Marks a property as dirty by its ordinal in the property layout of the type.
+		 */
+		void	MarkPropertyDirty(size_t pOrdinal)
+		{
+			if (DirtyPropertySet* dirtyProperties = EditDirtyProperties())
+			{
+				dirtyProperties->Mark(pOrdinal);
+			}
+		}
+
 		[[nodiscard]] Dire_EXPORT const FunctionInfo * GetFunction(DIRE_STRING_VIEW pMemberFuncName) const;
 
 		template <typename... Args>
@@ -229,6 +281,7 @@ namespace DIRE_NS
 				return {};
 			}
 
+			DIRE_STATS_ADD(GetReflectableTypeInfo(), FunctionInvocations, 1);
 			return theFunction->InvokeWithArgs(this, std::forward<Args>(pFuncArgs)...);
 		}
 
@@ -270,6 +323,20 @@ namespace DIRE_NS
 
 		[[nodiscard]] Dire_EXPORT GetPropertyResult GetPropertyImpl(DIRE_STRING_VIEW pFullPath) const;
 
+#ifdef DIRE_STATS_ENABLED
+		/**
+		 * \brief Counts a property lookup for the type of this object, and gives the path to the property path sampler.
+		 */
+		Dire_EXPORT void	RecordPropertyLookup(DIRE_STRING_VIEW pPath, bool pFound) const;
+#endif
+
+		Dire_EXPORT void	MarkDirtyAt(const void* pMemberAddr);
+
+		bool	EraseContainerProperty(DIRE_STRING_VIEW pName);
+
+		/* Marks the property a path starts with as dirty. */
+		Dire_EXPORT void	MarkPathDirty(DIRE_STRING_VIEW pPath);
+
 		[[nodiscard]] GetPropertyResult GetArrayProperty(const TypeInfo * pTypeInfoOwner, DIRE_STRING_VIEW pName, DIRE_STRING_VIEW pRemainingPath, int pArrayIdx, const std::byte * pPropPtr) const;
 
 		[[nodiscard]] GetPropertyResult RecurseFindArrayProperty(const IArrayDataStructureHandler * pArrayHandler,
@@ -288,6 +355,40 @@ namespace DIRE_NS
 
 		[[nodiscard]] GetPropertyResult GetCompoundProperty(const TypeInfo * pTypeInfoOwner, DIRE_STRING_VIEW pName, DIRE_STRING_VIEW pFullPath, const std::byte * propertyAddr) const;
 	};
+
+	/**
+	 * \brief Casts a reflectable down (or up) its class hierarchy without RTTI: a static_cast checked with IsA, in constant time.
+	 * \return The cast object, or nullptr if it is not a T (or pObject is nullptr)
+	 */
+	template <typename T>
+	[[nodiscard]] T*	Cast(Reflectable* pObject)
+	{
+		return (pObject != nullptr && pObject->IsA<T>() ? static_cast<T*>(pObject) : nullptr);
+	}
+
+	template <typename T>
+	[[nodiscard]] const T*	Cast(const Reflectable* pObject)
+	{
+		return (pObject != nullptr && pObject->IsA<T>() ? static_cast<const T*>(pObject) : nullptr);
+	}
+
+	class Arena;
+
+	/**
+	 * \brief Clones a reflectable many times at once. Unlike calling Clone in a loop, the copy plan of the type is only resolved once,
+	 * and all the clones are default-constructed next to each other in arena memory before their properties get copied.
+	 * The clones must be destroyed with DestroyBatch before the arena gets reset or destroyed.
+	 * \param pCloned The reflectable to clone. Its type must be default constructible.
+	 * \param pCount The number of clones to make
+	 * \param pArena The arena that provides the memory for the clones and for the returned array of pointers
+	 * \return The clones, or an empty span if the type cannot be instantiated this way
+	 */
+	[[nodiscard]] Dire_EXPORT Span<Reflectable*>	CloneBatch(const Reflectable& pCloned, size_t pCount, Arena& pArena);
+
+	/**
+	 * \brief Runs the destructor of every reflectable of the batch, without freeing their memory (it belongs to the arena they were created in).
+	 */
+	Dire_EXPORT void	DestroyBatch(Span<Reflectable*> pBatch);
 }
 
 #define dire_reflectable(ObjectType, ...) \
@@ -31,10 +31,21 @@ namespace DIRE_NS
 		virtual bool					Erase(void* pArray, size_t pIndex) const = 0;
 		virtual void					Clear(void* pArray) const = 0;
 		virtual size_t					Size(const void* pArray) const = 0;
+
+		/**
+		 * \brief Resizes an array-like data structure to the given number of elements. Static arrays cannot be resized: it does nothing for them.
+		 */
+		virtual void					Resize(void* pArray, size_t pNewSize) const = 0;
 		virtual DataStructureHandler	ElementHandler() const = 0;
 		virtual ReflectableID			ElementReflectableID() const = 0;
 		virtual MetaType				ElementType() const = 0;
 		virtual size_t					ElementSize() const = 0;
+
+		/**
+		 * \brief Gives the address of the first element if the elements are stored contiguously in memory (static arrays, std::vector...),
+		 * which allows to read or write them all at once. Returns nullptr for other data structures (std::deque, std::vector<bool>...).
+		 */
+		virtual const void*				ContiguousData(const void* pArray) const = 0;
 	};
 
 
@@ -99,6 +110,8 @@ namespace DIRE_NS
 
 		virtual size_t					Size(const void* pArray) const override;
 
+		virtual void					Resize(void* pArray, size_t pNewSize) const override;
+
 		virtual DataStructureHandler	ElementHandler() const override
 		{
 			return GetTypedElementHandler<ElementValueType>();
@@ -119,6 +132,8 @@ namespace DIRE_NS
 			return sizeof(ElementValueType);
 		}
 
+		virtual const void*				ContiguousData(const void* pArray) const override;
+
 		static TypedArrayDataStructureHandler const& GetInstance()
 		{
 			static TypedArrayDataStructureHandler instance{};
@@ -159,6 +174,9 @@ namespace DIRE_NS
 			return ARRAY_SIZE;
 		}
 
+		virtual void		Resize(void* /*pArray*/, size_t /*pNewSize*/) const override
+		{}
+
 		virtual DataStructureHandler	ElementHandler() const override
 		{
 			return GetTypedElementHandler<ElementValueType>();
@@ -179,6 +197,11 @@ namespace DIRE_NS
 			return sizeof(ElementValueType);
 		}
 
+		virtual const void*				ContiguousData(const void* pArray) const override
+		{
+			return pArray;
+		}
+
 		static const TypedArrayDataStructureHandler & GetInstance()
 		{
 			static TypedArrayDataStructureHandler instance{};
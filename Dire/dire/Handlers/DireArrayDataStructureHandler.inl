@@ -109,6 +109,32 @@ namespace DIRE_NS
 	}
 
 
+	template <typename T>
+	void TypedArrayDataStructureHandler<T, std::enable_if_t<HasArraySemantics_v<T> && !std::is_array_v<T>, void>>::Resize(void* pArray, size_t pNewSize) const
+	{
+		if (pArray != nullptr)
+		{
+			T* thisArray = static_cast<T*>(pArray);
+			thisArray->resize(pNewSize);
+		}
+	}
+
+	template <typename T>
+	const void* TypedArrayDataStructureHandler<T, std::enable_if_t<HasArraySemantics_v<T> && !std::is_array_v<T>, void>>::ContiguousData([[maybe_unused]] const void* pArray) const
+	{
+		// Containers providing data() (like std::vector, but not std::vector<bool>) store their elements contiguously.
+		if constexpr (has_data_v<const T>)
+		{
+			if (pArray != nullptr)
+			{
+				return static_cast<T const*>(pArray)->data();
+			}
+		}
+
+		return nullptr;
+	}
+
+
 	template <typename T>
 	const void* TypedArrayDataStructureHandler<T, std::enable_if_t<std::is_array_v<T>, void>>::Read(const void* pArray, size_t pIndex) const
 	{
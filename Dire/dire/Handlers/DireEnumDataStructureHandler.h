@@ -12,6 +12,12 @@ namespace DIRE_NS
 	{
 	public:
 		virtual const char*			EnumToString(const void*) const = 0;
+
+		/**
+		 * \brief Used by serialization code. Unlike EnumToString, writes all the set bits of bitmask enums, in the provided buffer instead of allocating.
+		 * \return The enum string, or a view with a nullptr data if it does not fit in the buffer: retry with a bigger one then.
+		 */
+		virtual DIRE_STRING_VIEW	EnumToChars(const void*, char* pBuffer, size_t pBufferSize) const = 0;
 		virtual void				SetFromString(const char*, void*) const = 0;
 		virtual MetaType::Values	EnumMetaType() const = 0;
 
@@ -33,6 +39,11 @@ namespace DIRE_NS
 			return T::GetStringFromSafeEnum(*(const typename T::Values*)pVal);
 		}
 
+		virtual DIRE_STRING_VIEW	EnumToChars(const void* pVal, char* pBuffer, size_t pBufferSize) const override
+		{
+			return T::ToChars(*(const typename T::Values*)pVal, pBuffer, pBufferSize);
+		}
+
 		virtual void	SetFromString(const char* pEnumStr, void* pEnumAddr) const override
 		{
 			T* theEnum = static_cast<T*>(pEnumAddr);
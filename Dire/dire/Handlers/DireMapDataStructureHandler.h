@@ -5,6 +5,9 @@
 #include "dire/Utils/DireTypeTraits.h"
 #include "dire/DireReflectableID.h"
 
+#include <charconv> // to_chars
+#include <cstring> // memcpy
+
 namespace DIRE_NS
 {
 	class DataStructureHandler;
@@ -30,6 +33,30 @@ namespace DIRE_NS
 		 */
 		virtual const void*				Read(const void* pMap, const DIRE_STRING_VIEW& pKey) const = 0;
 
+		/**
+		 * \brief Same as Read, except that the key is already in binary format (can be cast directly into the key type).
+		 * \param pMap Pointer to the map
+		 * \param pBinaryKey Pointer to the key, as previously produced by ConvertKey.
+		 * \return A pointer to the associated value inside the map, or nullptr if the map is null
+		 */
+		virtual const void*				BinaryRead(const void* pMap, void const* pBinaryKey) const = 0;
+
+		/**
+		 * \brief Looks a key in binary format up, without creating it if it doesn't exist (unlike BinaryRead).
+		 * \param pMap Pointer to the map
+		 * \param pBinaryKey Pointer to the key, in binary format
+		 * \return A pointer to the associated value inside the map, or nullptr if the key does not exist
+		 */
+		virtual const void*				BinaryFind(const void* pMap, void const* pBinaryKey) const = 0;
+
+		/**
+		 * \brief Converts a string key to the binary representation of the actual key type, so it can be reused later without any string parsing.
+		 * \param pKey The key to convert
+		 * \param pBinaryKeyStorage Where to write the converted key. Must be at least SizeofKey() bytes large and suitably aligned.
+		 * \return True if the conversion succeeded. Only trivially destructible key types can be converted.
+		 */
+		virtual bool					ConvertKey(const DIRE_STRING_VIEW& pKey, void* pBinaryKeyStorage) const = 0;
+
 		/**
 		 * \brief Updates the entry in the map at the provided key with the provided value. If it doesn't exist, will create it.
 		 * \param pMap Pointer to the map
@@ -65,6 +92,14 @@ namespace DIRE_NS
 		 */
 		virtual bool					Erase(void* pMap, const DIRE_STRING_VIEW& pKey) const = 0;
 
+		/**
+		 * \brief Same as Erase, except that the key is already in binary format (can be cast directly into the key type).
+		 * \param pMap Pointer to the map
+		 * \param pBinaryKey Key to erase
+		 * \return True if the key was erased.
+		 */
+		virtual bool					BinaryErase(void* pMap, void const* pBinaryKey) const = 0;
+
 		/**
 		 * \brief Wipes everything in the map.
 		 * \param pMap Pointer to the map
@@ -109,6 +144,13 @@ namespace DIRE_NS
 		 * \brief Used by serialization code. Will return the string representation of the given key in binary format.
 		 */
 		virtual DIRE_STRING	KeyToString(OpaqueKeyType) const = 0;
+
+		/**
+		 * \brief Used by serialization code. Same as KeyToString, but writes the string in the provided buffer instead of allocating it
+		 * (integer, C++ enum and floating point keys are formatted with std::to_chars, Dire enum keys are copied from their static name).
+		 * \return The key string, or a view with a nullptr data if it does not fit in the buffer: use KeyToString then.
+		 */
+		virtual DIRE_STRING_VIEW	KeyToChars(OpaqueKeyType, char* pBuffer, size_t pBufferSize) const = 0;
 #endif
 	};
 
@@ -136,6 +178,12 @@ namespace DIRE_NS
 	public:
 		virtual const void* Read(const void* pMap, const DIRE_STRING_VIEW& pKey) const override;
 
+		virtual const void* BinaryRead(const void* pMap, void const* pBinaryKey) const override;
+
+		virtual const void* BinaryFind(const void* pMap, void const* pBinaryKey) const override;
+
+		virtual bool		ConvertKey(const DIRE_STRING_VIEW& pKey, void* pBinaryKeyStorage) const override;
+
 		virtual void		Update(void* pMap, const DIRE_STRING_VIEW& pKey, const void* pNewData) const override;
 
 		virtual void*		Create(void* pMap, const DIRE_STRING_VIEW& pKey, const void* pInitData) const override;
@@ -144,6 +192,8 @@ namespace DIRE_NS
 
 		virtual bool		Erase(void* pMap, const DIRE_STRING_VIEW& pKey) const override;
 
+		virtual bool		BinaryErase(void* pMap, void const* pBinaryKey) const override;
+
 		virtual void		Clear(void* pMap) const override;
 
 		virtual size_t		Size(const void* pMap) const override;
@@ -193,6 +243,58 @@ namespace DIRE_NS
 			auto& keyRef = *static_cast<const KeyType*>(pKey);
 			return DIRE_NS::String::to_string(keyRef);
 		}
+
+		virtual DIRE_STRING_VIEW	KeyToChars(OpaqueKeyType pKey, char* pBuffer, size_t pBufferSize) const override
+		{
+			auto& keyRef = *static_cast<const KeyType*>(pKey);
+			if constexpr (std::is_integral_v<KeyType> && !std::is_same_v<KeyType, bool>)
+			{
+				return ToCharsResultView(pBuffer, std::to_chars(pBuffer, pBuffer + pBufferSize, keyRef));
+			}
+			else if constexpr (std::is_enum_v<KeyType>)
+			{
+				return ToCharsResultView(pBuffer, std::to_chars(pBuffer, pBuffer + pBufferSize, static_cast<std::underlying_type_t<KeyType>>(keyRef)));
+			}
+#if defined(__cpp_lib_to_chars)
+			else if constexpr (std::is_floating_point_v<KeyType>)
+			{
+				// Same formatting as std::to_string (printf's %f), so that both functions give the same key.
+				return ToCharsResultView(pBuffer, std::to_chars(pBuffer, pBuffer + pBufferSize, keyRef, std::chars_format::fixed, 6));
+			}
+#endif
+			else if constexpr (std::is_base_of_v<Enum, KeyType>)
+			{
+				// The name is a static string: copy it, like to_string does.
+				const char* keyName = KeyType::GetStringFromSafeEnum(keyRef.Value);
+				const size_t keyLength = strlen(keyName);
+				if (keyLength > pBufferSize)
+					return {};
+
+				memcpy(pBuffer, keyName, keyLength);
+				return { pBuffer, keyLength };
+			}
+			else
+			{
+				// Other keys have no allocation-free formatting, but their strings are usually short enough not to allocate either.
+				const DIRE_STRING keyStr = DIRE_NS::String::to_string(keyRef);
+				if (keyStr.size() > pBufferSize)
+					return {};
+
+				memcpy(pBuffer, keyStr.data(), keyStr.size());
+				return { pBuffer, keyStr.size() };
+			}
+		}
+
+	private:
+		static DIRE_STRING_VIEW	ToCharsResultView(char* pBuffer, std::to_chars_result pResult)
+		{
+			if (pResult.ec != std::errc())
+				return {};
+
+			return { pBuffer, size_t(pResult.ptr - pBuffer) };
+		}
+
+	public:
 #endif
 
 		static const TypedMapDataStructureHandler & GetInstance()
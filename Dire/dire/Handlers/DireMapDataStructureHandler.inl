@@ -17,6 +17,51 @@ namespace DIRE_NS
 		return &(*thisMap)[key.GetValue()];
 	}
 
+	template <typename T>
+	const void* TypedMapDataStructureHandler<T, std::enable_if_t<HasMapSemantics_v<T>, void>>::BinaryRead(const void* pMap, void const* pBinaryKey) const
+	{
+		if (pMap == nullptr || pBinaryKey == nullptr)
+		{
+			return nullptr;
+		}
+
+		KeyType const& key = *static_cast<const KeyType*>(pBinaryKey);
+		T* thisMap = const_cast<T*>(static_cast<const T*>(pMap));
+		return &(*thisMap)[key];
+	}
+
+	template <typename T>
+	const void* TypedMapDataStructureHandler<T, std::enable_if_t<HasMapSemantics_v<T>, void>>::BinaryFind(const void* pMap, void const* pBinaryKey) const
+	{
+		if (pMap == nullptr || pBinaryKey == nullptr)
+		{
+			return nullptr;
+		}
+
+		const T* thisMap = static_cast<const T*>(pMap);
+		auto it = thisMap->find(*static_cast<const KeyType*>(pBinaryKey));
+		return (it != thisMap->end() ? &it->second : nullptr);
+	}
+
+	template <typename T>
+	bool TypedMapDataStructureHandler<T, std::enable_if_t<HasMapSemantics_v<T>, void>>::ConvertKey(const std::string_view& pKey, void* pBinaryKeyStorage) const
+	{
+		// The converted key is never destroyed: only accept keys that don't need to be.
+		if constexpr (std::is_trivially_destructible_v<KeyType>)
+		{
+			const ConvertResult<KeyType> key = DIRE_NS::FromCharsConverter<KeyType>::Convert(pKey);
+			if (key.HasError() || pBinaryKeyStorage == nullptr)
+				return false;
+
+			new (pBinaryKeyStorage) KeyType(key.GetValue());
+			return true;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
 	template <typename T>
 	void TypedMapDataStructureHandler<T, std::enable_if_t<HasMapSemantics_v<T>, void>>::Update(void* pMap, const std::string_view& pKey, const void* pNewData) const
 	{
@@ -98,6 +143,18 @@ namespace DIRE_NS
 		return false;
 	}
 
+	template <typename T>
+	bool TypedMapDataStructureHandler<T, std::enable_if_t<HasMapSemantics_v<T>, void>>::BinaryErase(void* pMap, void const* pBinaryKey) const
+	{
+		if (pMap == nullptr || pBinaryKey == nullptr)
+		{
+			return false;
+		}
+
+		T* thisMap = static_cast<T*>(pMap);
+		return thisMap->erase(*static_cast<const KeyType*>(pBinaryKey));
+	}
+
 	template <typename T>
 	void TypedMapDataStructureHandler<T, std::enable_if_t<HasMapSemantics_v<T>, void>>::Clear(void* pMap) const
 	{
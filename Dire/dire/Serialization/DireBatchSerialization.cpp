@@ -0,0 +1,172 @@
+#include "DireBatchSerialization.h"
+
+#ifdef DIRE_SERIALIZATION_ENABLED
+
+#include "dire/Types/DireTypeInfoDatabase.h"
+
+#include <algorithm> // min
+#include <cstring> // memcpy
+
+namespace
+{
+	/* Appends the serialized bytes to the buffer of a chunk. */
+	class ByteVectorSink : public DIRE_NS::ISerializationSink
+	{
+	public:
+		explicit ByteVectorSink(DIRE_NS::ISerializer::Result::ByteVector& pBytes) :
+			myBytes(pBytes)
+		{}
+
+		virtual bool	Write(const char* pBytes, size_t pNbBytes) override
+		{
+			const auto* bytes = reinterpret_cast<const std::byte*>(pBytes);
+			myBytes.insert(myBytes.end(), bytes, bytes + pNbBytes);
+			return true;
+		}
+
+	private:
+		DIRE_NS::ISerializer::Result::ByteVector&	myBytes;
+	};
+}
+
+namespace DIRE_NS
+{
+	BatchSerializer::BatchSerializer(ThreadPool& pPool, SerializerFactory pFactory) :
+		myPool(pPool)
+	{
+		mySerializers.reserve(myPool.GetThreadCount());
+		for (size_t iWorker = 0; iWorker < myPool.GetThreadCount(); ++iWorker)
+		{
+			mySerializers.push_back(pFactory());
+		}
+	}
+
+	ISerializer::Result BatchSerializer::Serialize(Span<const Reflectable* const> pObjects, SerializedBatch& pBatch)
+	{
+		const size_t nbObjects = pObjects.Size();
+		const size_t nbChunks = (nbObjects + myChunkSize - 1) / myChunkSize;
+		pBatch.Offsets.resize(nbObjects + 1);
+		pBatch.ClassIDs.resize(nbObjects);
+		if (myChunkBuffers.size() < nbChunks)
+		{
+			myChunkBuffers.resize(nbChunks);
+		}
+		myChunkOffsets.resize(nbChunks + 1);
+		myErrors.assign(nbChunks, {});
+
+		// Serialize each chunk in its own buffer: offsets are relative to the chunk for now.
+		myPool.ParallelFor(nbObjects, myChunkSize, [&](size_t pWorker, size_t pBegin, size_t pEnd)
+		{
+			const size_t iChunk = pBegin / myChunkSize;
+			ISerializer::Result::ByteVector& chunkBytes = myChunkBuffers[iChunk];
+			chunkBytes.clear();
+			ByteVectorSink sink(chunkBytes);
+			ISerializer& serializer = *mySerializers[pWorker];
+			for (size_t iObject = pBegin; iObject < pEnd; ++iObject)
+			{
+				pBatch.Offsets[iObject] = chunkBytes.size();
+				pBatch.ClassIDs[iObject] = pObjects[iObject]->GetReflectableClassID();
+
+				ISerializer::Result result = serializer.SerializeTo(*pObjects[iObject], sink);
+				if (result.HasError() && !myErrors[iChunk].HasError())
+				{
+					myErrors[iChunk] = std::move(result);
+				}
+			}
+		});
+
+		for (ISerializer::Result& error : myErrors)
+		{
+			if (error.HasError())
+				return std::move(error);
+		}
+
+		myChunkOffsets[0] = 0;
+		for (size_t iChunk = 0; iChunk < nbChunks; ++iChunk)
+		{
+			myChunkOffsets[iChunk + 1] = myChunkOffsets[iChunk] + myChunkBuffers[iChunk].size();
+		}
+
+		// Then copy the chunks to their place in the batch.
+		pBatch.Bytes.resize(myChunkOffsets[nbChunks]);
+		pBatch.Offsets[nbObjects] = pBatch.Bytes.size();
+		myPool.ParallelFor(nbChunks, 1, [&](size_t /*pWorker*/, size_t pBegin, size_t pEnd)
+		{
+			for (size_t iChunk = pBegin; iChunk < pEnd; ++iChunk)
+			{
+				const ISerializer::Result::ByteVector& chunkBytes = myChunkBuffers[iChunk];
+				const size_t chunkOffset = myChunkOffsets[iChunk];
+				if (!chunkBytes.empty())
+				{
+					memcpy(pBatch.Bytes.data() + chunkOffset, chunkBytes.data(), chunkBytes.size());
+				}
+
+				const size_t objectsEnd = std::min((iChunk + 1) * myChunkSize, nbObjects);
+				for (size_t iObject = iChunk * myChunkSize; iObject < objectsEnd; ++iObject)
+				{
+					pBatch.Offsets[iObject] += chunkOffset;
+				}
+			}
+		});
+
+		return {};
+	}
+
+	BatchDeserializer::BatchDeserializer(ThreadPool& pPool, DeserializerFactory pFactory) :
+		myPool(pPool)
+	{
+		myDeserializers.reserve(myPool.GetThreadCount());
+		for (size_t iWorker = 0; iWorker < myPool.GetThreadCount(); ++iWorker)
+		{
+			myDeserializers.push_back(pFactory());
+		}
+	}
+
+	IDeserializer::Result BatchDeserializer::Deserialize(const SerializedBatch& pBatch, Span<Reflectable*> pObjects)
+	{
+		DIRE_ASSERT(pObjects.Size() >= pBatch.GetCount());
+
+		const size_t nbObjects = pBatch.GetCount();
+		const size_t nbChunks = (nbObjects + myChunkSize - 1) / myChunkSize;
+		myErrors.assign(nbChunks, {});
+
+		myPool.ParallelFor(nbObjects, myChunkSize, [&](size_t pWorker, size_t pBegin, size_t pEnd)
+		{
+			const size_t iChunk = pBegin / myChunkSize;
+			IDeserializer& deserializer = *myDeserializers[pWorker];
+			for (size_t iObject = pBegin; iObject < pEnd; ++iObject)
+			{
+				Reflectable* object = TypeInfoDatabase::GetSingleton().TryInstantiate(pBatch.ClassIDs[iObject], {});
+				IDeserializer::Result result;
+				if (object == nullptr)
+				{
+					result = { "Could not instantiate an object of the batch." };
+				}
+				else
+				{
+					result = deserializer.DeserializeInto(pBatch.GetObjectData(iObject), pBatch.GetObjectSize(iObject), *object);
+					if (result.HasError())
+					{
+						delete object;
+						object = nullptr;
+					}
+				}
+
+				pObjects[iObject] = object;
+				if (result.HasError() && !myErrors[iChunk].HasError())
+				{
+					myErrors[iChunk] = std::move(result);
+				}
+			}
+		});
+
+		for (IDeserializer::Result& error : myErrors)
+		{
+			if (error.HasError())
+				return std::move(error);
+		}
+
+		return {};
+	}
+}
+#endif
@@ -0,0 +1,146 @@
+#pragma once
+#include "DireDefines.h"
+
+#ifdef DIRE_SERIALIZATION_ENABLED
+#include "DireSerialization.h"
+#include "dire/Utils/DireSpan.h"
+#include "dire/Utils/DireThreadPool.h"
+
+#include <algorithm> // max
+#include <memory> // unique_ptr
+#include <vector>
+
+namespace DIRE_NS
+{
+	/**
+	 * \brief Many objects serialized one after the other in a single stream, with the index to find each of them back.
+	 */
+	struct SerializedBatch
+	{
+		template <typename T>
+		using Array = std::vector<T, DIRE_ALLOCATOR<T>>;
+
+		ISerializer::Result::ByteVector	Bytes;
+		Array<size_t>					Offsets; // where each object starts in Bytes, followed by the size of Bytes
+		Array<ReflectableID>			ClassIDs; // the type of each object, to instantiate it back
+
+		[[nodiscard]] size_t	GetCount() const
+		{
+			return ClassIDs.size();
+		}
+
+		[[nodiscard]] const char*	GetObjectData(size_t pIndex) const
+		{
+			return reinterpret_cast<const char*>(Bytes.data()) + Offsets[pIndex];
+		}
+
+		[[nodiscard]] size_t	GetObjectSize(size_t pIndex) const
+		{
+			return Offsets[pIndex + 1] - Offsets[pIndex];
+		}
+	};
+
+	/**
+	 * \brief Serializes collections of objects on all the threads of a pool, each thread having its own serializer and buffers.
+	 * Threads serialize chunks of consecutive objects in buffers of their own, then copy them to their final place in the batch:
+	 * the stream is the same as when serializing the objects one by one, in order, with a single thread.
+	 */
+	class Dire_EXPORT BatchSerializer
+	{
+	public:
+		using SerializerFactory = std::unique_ptr<ISerializer> (*)();
+
+		static const size_t	DEFAULT_CHUNK_SIZE = 64;
+
+		/**
+		 * \param pPool The threads to serialize on
+		 * \param pFactory Creates the serializer of a thread (serializers are stateful: each thread needs its own)
+		 */
+		BatchSerializer(ThreadPool& pPool, SerializerFactory pFactory);
+
+		/**
+		 * \brief Serializes objects into a batch. The memory of the batch and of the thread buffers is reused from one call to the next.
+		 * \param pObjects The objects to serialize
+		 * \param pBatch The batch to fill
+		 * \return On success, a result holding no bytes (they all went to the batch). Otherwise, the error of the first object that failed.
+		 */
+		ISerializer::Result	Serialize(Span<const Reflectable* const> pObjects, SerializedBatch& pBatch);
+
+		/**
+		 * \brief The serializer of a thread, e.g. to configure it.
+		 */
+		[[nodiscard]] ISerializer&	EditSerializer(size_t pWorker)
+		{
+			return *mySerializers[pWorker];
+		}
+
+		/**
+		 * \brief The number of consecutive objects given to a thread at once. Smaller chunks balance the work better, bigger ones cost less to schedule.
+		 * Chunks have at least one object.
+		 */
+		void	SetChunkSize(size_t pChunkSize)
+		{
+			myChunkSize = std::max<size_t>(pChunkSize, 1);
+		}
+
+	private:
+		template <typename T>
+		using Array = std::vector<T, DIRE_ALLOCATOR<T>>;
+
+		ThreadPool&								myPool;
+		Array<std::unique_ptr<ISerializer>>		mySerializers; // one per thread
+		Array<ISerializer::Result::ByteVector>	myChunkBuffers; // one per chunk, each object being serialized in the buffer of its chunk
+		Array<size_t>							myChunkOffsets; // where each chunk goes in the batch
+		Array<ISerializer::Result>				myErrors; // one per chunk
+		size_t									myChunkSize = DEFAULT_CHUNK_SIZE;
+	};
+
+	/**
+	 * \brief Instantiates and deserializes the objects of a batch on all the threads of a pool, each thread having its own deserializer.
+	 */
+	class Dire_EXPORT BatchDeserializer
+	{
+	public:
+		using DeserializerFactory = std::unique_ptr<IDeserializer> (*)();
+
+		static const size_t	DEFAULT_CHUNK_SIZE = 64;
+
+		/**
+		 * \param pPool The threads to deserialize on
+		 * \param pFactory Creates the deserializer of a thread (deserializers are stateful: each thread needs its own)
+		 */
+		BatchDeserializer(ThreadPool& pPool, DeserializerFactory pFactory);
+
+		/**
+		 * \brief Instantiates every object of a batch with its default constructor, and deserializes it.
+		 * \param pBatch The batch to deserialize
+		 * \param pObjects Receives the objects, owned by the caller: it has to be as big as the batch.
+		 * Objects that fail to instantiate or deserialize are nullptr.
+		 * \return On success, a result holding no reflectable. Otherwise, the error of the first object that failed.
+		 */
+		IDeserializer::Result	Deserialize(const SerializedBatch& pBatch, Span<Reflectable*> pObjects);
+
+		/**
+		 * \brief The deserializer of a thread, e.g. to configure it.
+		 */
+		[[nodiscard]] IDeserializer&	EditDeserializer(size_t pWorker)
+		{
+			return *myDeserializers[pWorker];
+		}
+
+		void	SetChunkSize(size_t pChunkSize)
+		{
+			myChunkSize = std::max<size_t>(pChunkSize, 1);
+		}
+
+	private:
+		template <typename T>
+		using Array = std::vector<T, DIRE_ALLOCATOR<T>>;
+
+		ThreadPool&								myPool;
+		Array<std::unique_ptr<IDeserializer>>	myDeserializers; // one per thread
+		Array<IDeserializer::Result>			myErrors; // one per chunk
+		size_t									myChunkSize = DEFAULT_CHUNK_SIZE;
+	};
+}
+#endif
@@ -3,61 +3,410 @@
 
 #include "dire/DireReflectable.h"
 #include "dire/Types/DireTypeInfoDatabase.h"
-#include "DireBinaryHeaders.h"
+
+#include "dire/Utils/DireMappedFile.h"
+
+#include "DireDelta.h"
+
+#include <algorithm> // min
+#include <cstring> // memcpy
+#include <limits>
 
 #define BINARY_DESERIALIZE_VALUE_CASE(TypeEnum) \
 case MetaType::TypeEnum:\
-{\
-	using ActualType = FromEnumTypeToActualType<MetaType::TypeEnum>::ActualType;\
-	*static_cast<ActualType*>(pPropPtr) = ReadFromBytes<ActualType>();\
-	break;\
+	ReadValue<FromEnumTypeToActualType<MetaType::TypeEnum>::ActualType>(pPropPtr);\
+	break;
+
+#define BINARY_DESERIALIZE_VARINT_ARRAY_CASE(TypeEnum) \
+case MetaType::TypeEnum:\
+	ReadValues<FromEnumTypeToActualType<MetaType::TypeEnum>::ActualType>(pArrayData, pArraySize);\
+	return true;
+
+namespace
+{
+	const size_t	DISCARD_THRESHOLD = 1024 * 1024;
 }
 
 namespace DIRE_NS
 {
 	IDeserializer::Result BinaryReflectorDeserializer::DeserializeInto(const char * pSerialized, Reflectable& pDeserializedObject)
+	{
+		if (myFormat == BinaryFormat::Schema)
+			return { "The schema binary format cannot be read without the size of the data." };
+
+		return DeserializeInto(pSerialized, std::numeric_limits<size_t>::max(), pDeserializedObject);
+	}
+
+	IDeserializer::Result BinaryReflectorDeserializer::DeserializeInto(const char* pSerialized, size_t pSerializedSize, Reflectable& pDeserializedObject)
 	{
 		if (pSerialized == nullptr)
 			return {"The binary string is nullptr."};
 
 		mySerializedBytes = pSerialized;
+		mySerializedSize = pSerializedSize;
 		myReadingOffset = 0;
+		myIsTruncated = false;
+		myIsMismatched = false;
+
+		Result result = (myFormat != BinaryFormat::Schema || ReadSchemaBlock() ? DeserializeObject(pDeserializedObject) : Result());
+		DIRE_STATS_ADD(pDeserializedObject.GetReflectableTypeInfo(), BinaryBytesDeserialized, myReadingOffset);
+
+		mySerializedBytes = nullptr;
+		mySerializedSize = 0;
+		mySchemas.clear();
+
+		if (myIsMismatched)
+			return { "The binary data does not match the properties of the reflectable to be deserialized into." };
+
+		if (myIsTruncated)
+			return { "The binary data is truncated." };
+
+		return result;
+	}
+
+	IDeserializer::Result BinaryReflectorDeserializer::ApplyDelta(const char* pSerialized, Reflectable& pDeserializedObject)
+	{
+		return ApplyDelta(pSerialized, std::numeric_limits<size_t>::max(), pDeserializedObject);
+	}
+
+	IDeserializer::Result BinaryReflectorDeserializer::ApplyDelta(const char* pSerialized, size_t pSerializedSize, Reflectable& pDeserializedObject)
+	{
+		if (pSerialized == nullptr)
+			return {"The binary string is nullptr."};
+
+		if (myFormat == BinaryFormat::Schema)
+			return { "The schema binary format does not support deltas." };
+
+		mySerializedBytes = pSerialized;
+		mySerializedSize = pSerializedSize;
+		myReadingOffset = 0;
+		myIsTruncated = false;
+		myIsMismatched = false;
+
+		DeserializeReflectableDelta(pDeserializedObject);
+		DIRE_STATS_ADD(pDeserializedObject.GetReflectableTypeInfo(), BinaryBytesDeserialized, myReadingOffset);
+
+		mySerializedBytes = nullptr;
+		mySerializedSize = 0;
+
+		if (myIsMismatched)
+			return { "The binary data does not match the properties of the reflectable to be deserialized into." };
+
+		if (myIsTruncated)
+			return { "The binary data is truncated." };
+
+		return &pDeserializedObject;
+	}
+
+	IDeserializer::Result BinaryReflectorDeserializer::DeserializeFileInto(DIRE_STRING_VIEW pFilePath, Reflectable& pDeserializedObject)
+	{
+		const MappedFile mappedFile(pFilePath);
+		if (!mappedFile.IsOpen())
+			return { "The binary file could not be opened." };
+
+		if (mappedFile.GetData() == nullptr)
+			return { "The binary file is empty." };
+
+		myMappedFile = &mappedFile;
+		Result result = DeserializeInto(mappedFile.GetData(), mappedFile.GetSize(), pDeserializedObject);
+		myMappedFile = nullptr;
+		return result;
+	}
+
+	bool BinaryReflectorDeserializer::ReadObjectHeader(ReflectableID& pID, uint32_t& pPropertiesCount) const
+	{
+		if (myFormat == BinaryFormat::Compact)
+		{
+			pID = static_cast<ReflectableID>(ReadVarint());
+			pPropertiesCount = static_cast<uint32_t>(ReadVarint());
+			return !myIsTruncated;
+		}
+
+		const auto* header = ReadFromBytes<BinarySerializationHeaders::Object>();
+		if (header == nullptr)
+			return false;
+
+		pID = header->ID;
+		pPropertiesCount = header->PropertiesCount;
+		return true;
+	}
+
+	bool BinaryReflectorDeserializer::ReadPropertyHeader(uint32_t& pOffset, MetaType& pType) const
+	{
+		if (myFormat == BinaryFormat::Compact)
+		{
+			pOffset = static_cast<uint32_t>(ReadVarint());
+			pType = MetaType::Unknown;
+			return !myIsTruncated;
+		}
+
+		const auto* header = ReadFromBytes<BinarySerializationHeaders::Property>();
+		if (header == nullptr)
+			return false;
+
+		pOffset = header->PropertyOffset;
+		pType = header->PropertyType;
+		return true;
+	}
+
+	bool BinaryReflectorDeserializer::ReadVarintArray(MetaType pElementType, void* pArrayData, size_t pArraySize) const
+	{
+		switch (pElementType.Value)
+		{
+			BINARY_DESERIALIZE_VARINT_ARRAY_CASE(Short)
+			BINARY_DESERIALIZE_VARINT_ARRAY_CASE(UShort)
+			BINARY_DESERIALIZE_VARINT_ARRAY_CASE(Int)
+			BINARY_DESERIALIZE_VARINT_ARRAY_CASE(Uint)
+			BINARY_DESERIALIZE_VARINT_ARRAY_CASE(Int64)
+			BINARY_DESERIALIZE_VARINT_ARRAY_CASE(Uint64)
+		default:
+			return false;
+		}
+	}
+
+	bool BinaryReflectorDeserializer::ReadSchemaBlock()
+	{
+		// No translation is in use between two deserializations: it is the time to forget them if there are too many.
+		if (myTranslations.size() >= MAX_SCHEMA_TRANSLATIONS)
+		{
+			ClearSchemaTranslations();
+		}
+
+		using BlockOffset = BinarySerializationHeaders::SchemaBlockOffset;
+
+		BlockOffset blockOffset = 0;
+		if (mySerializedSize < sizeof(blockOffset))
+		{
+			myIsTruncated = true;
+			return false;
+		}
+
+		const size_t dataSize = mySerializedSize - sizeof(blockOffset);
+		memcpy(&blockOffset, mySerializedBytes + dataSize, sizeof(blockOffset));
+		if (blockOffset > dataSize)
+		{
+			myIsTruncated = true;
+			return false;
+		}
+
+		mySerializedSize = dataSize;
+		myReadingOffset = static_cast<size_t>(blockOffset);
+
+		// Each schema takes at least a byte: check the count before allocating anything from it.
+		const uint64_t schemaCount = ReadVarint();
+		if (myIsTruncated || schemaCount > mySerializedSize - myReadingOffset)
+		{
+			myIsTruncated = true;
+			return false;
+		}
+
+		// Only find where each schema is for now: the properties are read when translating the schema, which is rarely needed.
+		constexpr size_t propertyHashesSize = sizeof(String::HashType) + sizeof(uint32_t); // name hash and type signature
+		mySchemas.resize(static_cast<size_t>(schemaCount));
+		for (StreamSchema& schema : mySchemas)
+		{
+			const uint64_t propertyCount = ReadVarint();
+			if (myIsTruncated || propertyCount > (mySerializedSize - myReadingOffset) / (propertyHashesSize + 1))
+			{
+				myIsTruncated = true;
+				return false;
+			}
+
+			const size_t definitionStart = myReadingOffset;
+			for (uint64_t iProp = 0; iProp < propertyCount && !myIsTruncated; ++iProp)
+			{
+				ReadBytes(propertyHashesSize);
+				ReadVarint();
+			}
+
+			schema.Definition = DIRE_STRING_VIEW(mySerializedBytes + definitionStart, myReadingOffset - definitionStart);
+			schema.PropertiesCount = static_cast<uint32_t>(propertyCount);
+			schema.Hash = String::Hash(schema.Definition);
+			schema.Translation = nullptr;
+		}
+
+		if (myIsTruncated)
+			return false;
+
+		// The objects are what precedes the schema block.
+		mySerializedSize = static_cast<size_t>(blockOffset);
+		myReadingOffset = 0;
+		return true;
+	}
+
+	const BinaryReflectorDeserializer::SchemaTranslation& BinaryReflectorDeserializer::GetSchemaTranslation(const StreamSchema& pSchema, const TypeInfo& pLocalType) const
+	{
+		const String::HashType translationHash = (pSchema.Hash ^ pLocalType.GetID()) * 0x100000001b3ull; // FNV prime
+		SchemaTranslation& translation = myTranslations[translationHash];
+		if (translation.LocalType == &pLocalType && translation.SchemaHash == pSchema.Hash)
+			return translation;
+
+		const PropertyLayout& layout = pLocalType.GetPropertyLayout();
+
+		Array<BinarySerializationHeaders::SchemaProperty> localProperties(layout.GetCount());
+		for (size_t iProp = 0; iProp < layout.GetCount(); ++iProp)
+		{
+			localProperties[iProp].NameHash = String::Hash(layout.GetProperty(iProp).GetName());
+			localProperties[iProp].TypeSignature = ComputeSchemaTypeSignature(layout.GetMetatype(iProp), &layout.GetDataStructureHandler(iProp));
+		}
+
+		translation.SchemaHash = pSchema.Hash;
+		translation.LocalType = &pLocalType;
+		translation.LocalIndices.assign(pSchema.PropertiesCount, NO_PROPERTY);
+		translation.FixedSizes.assign(pSchema.PropertiesCount, 0);
+
+		// Properties of the same name in different classes of the hierarchy come in the same order in the schema and the layout:
+		// take the first match not already taken.
+		Array<bool> isTranslated(layout.GetCount(), false);
+		const char* definition = pSchema.Definition.data();
+		for (size_t iSchemaProp = 0; iSchemaProp < pSchema.PropertiesCount; ++iSchemaProp)
+		{
+			BinarySerializationHeaders::SchemaProperty property;
+			memcpy(&property.NameHash, definition, sizeof(property.NameHash));
+			definition += sizeof(property.NameHash);
+			memcpy(&property.TypeSignature, definition, sizeof(property.TypeSignature));
+			definition += sizeof(property.TypeSignature);
+
+			// The definition has been checked when reading the schema block: its varints are known to end in time.
+			uint64_t fixedSize = 0;
+			definition += Varint::Decode(definition, Varint::MAX_SIZE, fixedSize);
+			translation.FixedSizes[iSchemaProp] = static_cast<uint32_t>(fixedSize);
+
+			for (size_t iLocalProp = 0; iLocalProp < localProperties.size(); ++iLocalProp)
+			{
+				if (!isTranslated[iLocalProp] && localProperties[iLocalProp].NameHash == property.NameHash
+					&& localProperties[iLocalProp].TypeSignature == property.TypeSignature)
+				{
+					translation.LocalIndices[iSchemaProp] = static_cast<uint32_t>(iLocalProp);
+					isTranslated[iLocalProp] = true;
+					break;
+				}
+			}
+		}
+
+		return translation;
+	}
+
+	void BinaryReflectorDeserializer::DeserializeSchemaRecords(Reflectable& pDeserializedObject, uint32_t pSchemaIndex) const
+	{
+		if (pSchemaIndex >= mySchemas.size())
+		{
+			myIsTruncated = true;
+			return;
+		}
+
+		const TypeInfo* localType = TypeInfoDatabase::GetSingleton().GetTypeInfo(pDeserializedObject.GetReflectableClassID());
+		StreamSchema& schema = mySchemas[pSchemaIndex];
+		if (schema.Translation == nullptr || schema.Translation->LocalType != localType)
+		{
+			schema.Translation = &GetSchemaTranslation(schema, *localType);
+		}
+
+		const SchemaTranslation& translation = *schema.Translation;
+		char* objectPtr = reinterpret_cast<char*>(&pDeserializedObject);
+		const PropertyLayout& layout = localType->GetPropertyLayout();
+		for (size_t iSchemaProp = 0; iSchemaProp < schema.PropertiesCount && !myIsTruncated; ++iSchemaProp)
+		{
+			size_t recordSize = translation.FixedSizes[iSchemaProp];
+			if (recordSize == 0)
+			{
+				const uint64_t readSize = ReadVarint();
+				if (myIsTruncated)
+					return;
+
+				recordSize = (readSize <= std::numeric_limits<BinarySerializationHeaders::RecordSize>::max() ? static_cast<size_t>(readSize) : SIZE_MAX);
+			}
+
+			if (recordSize > mySerializedSize - myReadingOffset)
+			{
+				myIsTruncated = true;
+				return;
+			}
+
+			const size_t recordEnd = myReadingOffset + recordSize;
+			const uint32_t iLocalProp = translation.LocalIndices[iSchemaProp];
+			if (iLocalProp != NO_PROPERTY)
+			{
+				// Reading past the record would mean the data is corrupted: pretend the data ends with it.
+				const size_t serializedSize = mySerializedSize;
+				mySerializedSize = recordEnd;
+				DeserializeValue(layout.GetMetatype(iLocalProp), objectPtr + layout.GetOffset(iLocalProp), &layout.GetDataStructureHandler(iLocalProp));
+				mySerializedSize = serializedSize;
+			}
+
+			// Whatever was read, the next record starts there (unknown records are skipped at once).
+			myReadingOffset = recordEnd;
+		}
+	}
+
+	IDeserializer::Result BinaryReflectorDeserializer::DeserializeObject(Reflectable& pDeserializedObject)
+	{
+		// Schemas are matched by property name: the data can go in any type, provided it has properties of the same names.
+		if (myFormat == BinaryFormat::Schema)
+		{
+			const auto schemaIndex = static_cast<uint32_t>(ReadVarint());
+			if (!myIsTruncated)
+			{
+				DeserializeSchemaRecords(pDeserializedObject, schemaIndex);
+			}
+			return &pDeserializedObject;
+		}
 
 		// should start with a header...
-		auto& header = ReadFromBytes<BinarySerializationHeaders::Object>();
-		if (header.PropertiesCount == 0)
+		ReflectableID serializedID = INVALID_REFLECTABLE_ID;
+		uint32_t propertiesCount = 0;
+		if (!ReadObjectHeader(serializedID, propertiesCount))
+			return { "The binary data is truncated." };
+
+		if (propertiesCount == 0)
 			return &pDeserializedObject; // just an empty object. Doesn't count like an error I guess?
 
-		const TypeInfo* deserializedTypeInfo = TypeInfoDatabase::GetSingleton().GetTypeInfo(header.ID);
+		const TypeInfo* deserializedTypeInfo = TypeInfoDatabase::GetSingleton().GetTypeInfo(serializedID);
 		const TypeInfo* objTypeInfo = TypeInfoDatabase::GetSingleton().GetTypeInfo(pDeserializedObject.GetReflectableClassID());
 
 		// cannot dump properties into incompatible reflectable type
-		if (!deserializedTypeInfo->IsParentOf(objTypeInfo->GetID()))
+		if (deserializedTypeInfo == nullptr || !deserializedTypeInfo->IsParentOf(*objTypeInfo))
 			return { "The serialized data is incompatible with the reflectable to be deserialized into." };
 
-		const auto* nextPropertyHeader = &ReadFromBytes<BinarySerializationHeaders::Property>();
+		DeserializeProperties(pDeserializedObject, objTypeInfo->GetPropertyLayout(), propertiesCount);
 
+		return &pDeserializedObject;
+	}
+
+	void BinaryReflectorDeserializer::DeserializeProperties(Reflectable& pDeserializedObject, const PropertyLayout& pLayout, uint32_t pPropertiesCount) const
+	{
 		char* objectPtr = reinterpret_cast<char*>(&pDeserializedObject);
+
+		uint32_t nextPropertyOffset = 0;
+		MetaType nextPropertyType = MetaType::Unknown;
+		bool hasNextProperty = ReadPropertyHeader(nextPropertyOffset, nextPropertyType);
 		unsigned iProp = 0; // cppcheck-suppress variableScope
 
-		objTypeInfo->ForEachPropertyInHierarchy([&](const PropertyTypeInfo& pProperty)
+		for (size_t iLayoutProp = 0; iLayoutProp < pLayout.GetCount() && hasNextProperty && !myIsTruncated; ++iLayoutProp)
 		{
 			// In theory, property will come in ascending order of offset so we should not be missing any.
-			if (pProperty.GetOffset() == nextPropertyHeader->PropertyOffset)
+			if (pLayout.GetOffset(iLayoutProp) == nextPropertyOffset)
 			{
-				void* propPtr = objectPtr + pProperty.GetOffset();
-				DeserializeValue(nextPropertyHeader->PropertyType, propPtr, &pProperty.GetDataStructureHandler());
+				// Stale or corrupted data can give a property another type than the one it has: reading it with that type would write out of it.
+				const MetaType propType = pLayout.GetMetatype(iLayoutProp);
+				if (myFormat != BinaryFormat::Compact && nextPropertyType != propType)
+				{
+					myIsMismatched = true;
+					myIsTruncated = true; // nothing more can be read safely
+					return;
+				}
+
+				void* propPtr = objectPtr + pLayout.GetOffset(iLayoutProp);
+				DeserializeValue(propType, propPtr, &pLayout.GetDataStructureHandler(iLayoutProp));
 
 				iProp++;
-				if (iProp < header.PropertiesCount)
+				if (iProp < pPropertiesCount)
 				{
 					// Only read a following property header if we're sure there are more properties coming
-					nextPropertyHeader = &ReadFromBytes<BinarySerializationHeaders::Property>();
+					hasNextProperty = ReadPropertyHeader(nextPropertyOffset, nextPropertyType);
 				}
 			}
-		});
-
-		return &pDeserializedObject;
+		}
 	}
 
 
@@ -66,18 +415,101 @@ namespace DIRE_NS
 		if (pArrayHandler != nullptr)
 		{
 			DataStructureHandler elemHandler = pArrayHandler->ElementHandler();
-			auto& arrayHeader = ReadFromBytes<BinarySerializationHeaders::Array>();
+			MetaType elementType = pArrayHandler->ElementType();
+			size_t sizeofElement = pArrayHandler->ElementSize();
+			size_t arraySize = 0;
 
-			DIRE_ASSERT(pArrayHandler->ElementType() == arrayHeader.ElementType
-			&& pArrayHandler->ElementSize() == arrayHeader.SizeofElement);
-			if (arrayHeader.ElementType != MetaType::Unknown)
+			if (myFormat != BinaryFormat::Native)
 			{
-				for (size_t iElem = 0; iElem < arrayHeader.ArraySize; ++iElem)
-				{
-					void* elemVal = const_cast<void*>(pArrayHandler->Read(pPropPtr, iElem));
-					DeserializeValue(arrayHeader.ElementType, elemVal, &elemHandler);
-				}
+				if (elementType == MetaType::Unknown)
+					return;
+
+				arraySize = static_cast<size_t>(ReadVarint());
+			}
+			else
+			{
+				const auto* arrayHeader = ReadFromBytes<BinarySerializationHeaders::Array>();
+				if (arrayHeader == nullptr)
+					return;
+
+				DIRE_ASSERT(elementType == arrayHeader->ElementType && sizeofElement == arrayHeader->SizeofElement);
+				if (arrayHeader->ElementType == MetaType::Unknown)
+					return;
+
+				elementType = arrayHeader->ElementType;
+				sizeofElement = arrayHeader->SizeofElement;
+				arraySize = arrayHeader->ArraySize;
+			}
+
+			// Any element takes at least a byte: a corrupted array size must not make us grow the array to an absurd size.
+			if (arraySize > mySerializedSize - myReadingOffset)
+			{
+				myIsTruncated = true;
+				return;
+			}
+
+			const bool isBulkSerialized = IsBulkSerializable(elementType, myFormat) && sizeofElement == pArrayHandler->ElementSize();
+
+			// Check the size first: a corrupted array size must not make us grow the array to an absurd size.
+			if (isBulkSerialized && arraySize > (mySerializedSize - myReadingOffset) / sizeofElement)
+			{
+				myIsTruncated = true;
+				return;
+			}
+
+			// Make resizable arrays the same size as the serialized one (static arrays keep their size).
+			pArrayHandler->Resize(pPropPtr, arraySize);
+
+			if (pArrayHandler->Size(pPropPtr) >= arraySize)
+			{
+				ReadArrayElements(pPropPtr, pArrayHandler, 0, arraySize);
+				return;
+			}
+
+			for (size_t iElem = 0; iElem < arraySize && !myIsTruncated; ++iElem)
+			{
+				void* elemVal = const_cast<void*>(pArrayHandler->Read(pPropPtr, iElem));
+				DeserializeValue(elementType, elemVal, &elemHandler);
+			}
+		}
+	}
+
+	void BinaryReflectorDeserializer::ReadArrayElements(void* pPropPtr, const IArrayDataStructureHandler* pArrayHandler, size_t pFirstElem, size_t pCount) const
+	{
+		if (pCount == 0)
+			return;
+
+		const MetaType elementType = pArrayHandler->ElementType();
+		const size_t sizeofElement = pArrayHandler->ElementSize();
+		auto* arrayData = static_cast<char*>(const_cast<void*>(pArrayHandler->ContiguousData(pPropPtr)));
+
+		if (arrayData != nullptr && IsBulkSerializable(elementType, myFormat))
+		{
+			if (pCount > (mySerializedSize - myReadingOffset) / sizeofElement)
+			{
+				myIsTruncated = true;
+				return;
+			}
+
+			const size_t arrayBytes = pCount * sizeofElement;
+			memcpy(arrayData + pFirstElem * sizeofElement, ReadBytes(arrayBytes), arrayBytes);
+
+			// Big arrays are the bulk of big files: don't keep both the file pages and the deserialized copy in memory.
+			if (myMappedFile != nullptr && arrayBytes >= DISCARD_THRESHOLD)
+			{
+				myMappedFile->DiscardUntil(myReadingOffset);
 			}
+			return;
+		}
+
+		if (arrayData != nullptr && myFormat != BinaryFormat::Native && ReadVarintArray(elementType, arrayData + pFirstElem * sizeofElement, pCount))
+			return;
+
+		const DataStructureHandler elemHandler = pArrayHandler->ElementHandler();
+		for (size_t iElem = pFirstElem; iElem < pFirstElem + pCount && !myIsTruncated; ++iElem)
+		{
+			void* elemVal = const_cast<void*>(pArrayHandler->Read(pPropPtr, iElem));
+			DeserializeValue(elementType, elemVal, &elemHandler);
 		}
 	}
 
@@ -88,16 +520,35 @@ namespace DIRE_NS
 
 		const DataStructureHandler valueHandler = pMapHandler->ValueDataHandler();
 		const MetaType valueType = pMapHandler->ValueMetaType();
-		const size_t sizeofKeyType = pMapHandler->SizeofKey();
 
-		auto& mapHeader = ReadFromBytes<BinarySerializationHeaders::Map>();
+		size_t mapSize = 0;
+		if (myFormat != BinaryFormat::Native)
+		{
+			mapSize = static_cast<size_t>(ReadVarint());
+		}
+		else
+		{
+			const auto* mapHeader = ReadFromBytes<BinarySerializationHeaders::Map>();
+			if (mapHeader == nullptr)
+				return;
+
+			DIRE_ASSERT(valueType == mapHeader->ValueType && mapHeader->SizeofValueType == pMapHandler->SizeofValue()
+				&& mapHeader->KeyType == pMapHandler->KeyMetaType() && mapHeader->SizeofKeyType == pMapHandler->SizeofKey());
+			mapSize = mapHeader->MapSize;
+		}
 
-		DIRE_ASSERT(valueType == mapHeader.ValueType && mapHeader.SizeofValueType == pMapHandler->SizeofValue()
-			&& mapHeader.KeyType == pMapHandler->KeyMetaType() && mapHeader.SizeofKeyType == sizeofKeyType);
+		const DataStructureHandler keyHandler = pMapHandler->KeyDataHandler();
+		alignas(std::max_align_t) char keyStorage[sizeof(uint64_t)];
 
-		for (size_t i = 0; i < mapHeader.MapSize; ++i)
+		// Like arrays are resized, maps end up with the serialized entries only, even when deserializing into a replica that had others.
+		pMapHandler->Clear(pPropPtr);
+
+		for (size_t i = 0; i < mapSize && !myIsTruncated; ++i)
 		{
-			const char* keyData = ReadBytes(sizeofKeyType);
+			const void* keyData = ReadMapKey(*pMapHandler, keyHandler, keyStorage);
+			if (keyData == nullptr)
+				return;
+
 			void* createdValue = pMapHandler->BinaryCreate(pPropPtr, keyData, nullptr);
 
 			if (createdValue != nullptr)
@@ -108,45 +559,195 @@ namespace DIRE_NS
 	}
 
 
-	void BinaryReflectorDeserializer::DeserializeCompoundValue(void* pPropPtr) const
+	const void* BinaryReflectorDeserializer::ReadMapKey(const IMapDataStructureHandler& pMapHandler, const DataStructureHandler& pKeyHandler, void* pKeyStorage) const
 	{
-		if (pPropPtr == nullptr)
+		if (myFormat == BinaryFormat::Native)
+			return ReadBytes(pMapHandler.SizeofKey());
+
+		// Compact keys are varints: they have to be decoded somewhere before being used.
+		DIRE_ASSERT(pMapHandler.SizeofKey() <= sizeof(uint64_t));
+		DeserializeValue(pMapHandler.KeyMetaType(), pKeyStorage, &pKeyHandler);
+		return (myIsTruncated ? nullptr : pKeyStorage);
+	}
+
+	void BinaryReflectorDeserializer::DeserializeReflectableDelta(Reflectable& pDeserializedObject) const
+	{
+		const TypeInfo * typeInfo = TypeInfoDatabase::GetSingleton().GetTypeInfo(pDeserializedObject.GetReflectableClassID());
+		DIRE_ASSERT(typeInfo != nullptr);
+
+		const PropertyLayout& layout = typeInfo->GetPropertyLayout();
+		std::byte* objectAddr = reinterpret_cast<std::byte*>(&pDeserializedObject);
+		while (true)
+		{
+			const uint64_t propIndex = ReadVarint();
+			if (propIndex == 0 || myIsTruncated)
+				return;
+
+			// An index out of the layout can only be corrupted data.
+			if (propIndex > layout.GetCount())
+			{
+				myIsTruncated = true;
+				return;
+			}
+
+			const auto iProp = static_cast<size_t>(propIndex - 1);
+			DeserializeValueDelta(layout.GetMetatype(iProp), objectAddr + layout.GetOffset(iProp), &layout.GetDataStructureHandler(iProp));
+		}
+	}
+
+	void BinaryReflectorDeserializer::DeserializeValueDelta(MetaType pPropType, void* pPropPtr, const DataStructureHandler* pHandler) const
+	{
+		switch (pPropType.Value)
+		{
+		case MetaType::Array:
+			DeserializeArrayDelta(pPropPtr, pHandler->GetArrayHandler());
+			break;
+		case MetaType::Map:
+			DeserializeMapDelta(pPropPtr, pHandler->GetMapHandler());
+			break;
+		case MetaType::Object:
+			DeserializeReflectableDelta(*static_cast<Reflectable*>(pPropPtr));
+			break;
+		default:
+			DeserializeValue(pPropType, pPropPtr, pHandler);
+		}
+	}
+
+	void BinaryReflectorDeserializer::DeserializeArrayDelta(void* pPropPtr, const IArrayDataStructureHandler* pArrayHandler) const
+	{
+		const auto arraySize = static_cast<size_t>(ReadVarint());
+		const size_t baselineSize = pArrayHandler->Size(pPropPtr);
+		if (myIsTruncated)
 			return;
 
-		// should start with a header...
-		const auto& header = ReadFromBytes<BinarySerializationHeaders::Object>();
-		if (header.PropertiesCount == 0)
+		// New elements are written in full and take at least a byte: a corrupted array size must not make us grow the array to an absurd size.
+		if (arraySize > baselineSize && arraySize - baselineSize > mySerializedSize - myReadingOffset)
+		{
+			myIsTruncated = true;
 			return;
+		}
 
-		Reflectable& reflectable = *static_cast<Reflectable*>(pPropPtr);
-		const TypeInfo* objTypeInfo = TypeInfoDatabase::GetSingleton().GetTypeInfo(reflectable.GetReflectableClassID());
+		pArrayHandler->Resize(pPropPtr, arraySize);
+		if (pArrayHandler->Size(pPropPtr) != arraySize)
+		{
+			myIsTruncated = true;
+			return;
+		}
 
-		const TypeInfo* deserializedTypeInfo = TypeInfoDatabase::GetSingleton().GetTypeInfo(header.ID);
+		const MetaType elemType = pArrayHandler->ElementType();
+		const DataStructureHandler elemHandler = pArrayHandler->ElementHandler();
+		const size_t commonSize = std::min(arraySize, baselineSize);
+		size_t runsEnd = 0;
+		while (true)
+		{
+			const uint64_t skippedElems = ReadVarint();
+			if (skippedElems == 0 || myIsTruncated)
+				return;
 
-		// cannot dump properties into incompatible reflectable type
-		if (!deserializedTypeInfo->IsParentOf(objTypeInfo->GetID()))
-			return;
+			const uint64_t runSize = ReadVarint();
+			if (myIsTruncated || skippedElems - 1 > arraySize - runsEnd || runSize > arraySize - runsEnd - (skippedElems - 1))
+			{
+				myIsTruncated = true;
+				return;
+			}
 
-		char* objectPtr = reinterpret_cast<char*>(pPropPtr);
+			const size_t runStart = runsEnd + static_cast<size_t>(skippedElems - 1);
+			runsEnd = runStart + static_cast<size_t>(runSize);
+			if (!IsPatchedByDeltas(elemType))
+			{
+				ReadArrayElements(pPropPtr, pArrayHandler, runStart, runsEnd - runStart);
+				continue;
+			}
 
-		const auto* nextPropertyHeader = &ReadFromBytes<BinarySerializationHeaders::Property>();
-		unsigned iProp = 0; // cppcheck-suppress variableScope
+			for (size_t iElem = runStart; iElem < runsEnd && !myIsTruncated; ++iElem)
+			{
+				void* elemVal = const_cast<void*>(pArrayHandler->Read(pPropPtr, iElem));
+				if (iElem < commonSize)
+				{
+					DeserializeValueDelta(elemType, elemVal, &elemHandler);
+				}
+				else
+				{
+					DeserializeValue(elemType, elemVal, &elemHandler);
+				}
+			}
+		}
+	}
+
+	void BinaryReflectorDeserializer::DeserializeMapDelta(void* pPropPtr, const IMapDataStructureHandler* pMapHandler) const
+	{
+		using Operation = BinarySerializationHeaders::MapDeltaOperation;
+
+		const MetaType valueType = pMapHandler->ValueMetaType();
+		const DataStructureHandler valueHandler = pMapHandler->ValueDataHandler();
+		const DataStructureHandler keyHandler = pMapHandler->KeyDataHandler();
+		alignas(std::max_align_t) char keyStorage[sizeof(uint64_t)];
 
-		deserializedTypeInfo->ForEachPropertyInHierarchy([&](const PropertyTypeInfo& pProperty)
+		while (true)
 		{
-			// In theory, property will come in ascending order of offset so we should not be missing any.
-			if (pProperty.GetOffset() == nextPropertyHeader->PropertyOffset)
+			const uint64_t operation = ReadVarint();
+			if (operation == Operation::End || myIsTruncated)
+				return;
+
+			const void* keyData = ReadMapKey(*pMapHandler, keyHandler, keyStorage);
+			if (keyData == nullptr)
+				return;
+
+			switch (operation)
 			{
-				void* propPtr = objectPtr + pProperty.GetOffset();
-				DeserializeValue(nextPropertyHeader->PropertyType, propPtr, &pProperty.GetDataStructureHandler());
-				iProp++;
-				if (iProp < header.PropertiesCount)
+			case Operation::Set:
+				if (void* value = pMapHandler->BinaryCreate(pPropPtr, keyData, nullptr))
 				{
-					// Only read a following property header if we're sure there are more properties coming
-					nextPropertyHeader = &ReadFromBytes<BinarySerializationHeaders::Property>();
+					DeserializeValue(valueType, value, &valueHandler);
 				}
+				break;
+			case Operation::Patch:
+				if (void* value = pMapHandler->BinaryCreate(pPropPtr, keyData, nullptr))
+				{
+					DeserializeValueDelta(valueType, value, &valueHandler);
+				}
+				break;
+			case Operation::Erase:
+				pMapHandler->BinaryErase(pPropPtr, keyData);
+				break;
+			default:
+				myIsTruncated = true;
+				return;
+			}
+		}
+	}
+
+	void BinaryReflectorDeserializer::DeserializeCompoundValue(void* pPropPtr) const
+	{
+		if (pPropPtr == nullptr)
+			return;
+
+		if (myFormat == BinaryFormat::Schema)
+		{
+			const auto schemaIndex = static_cast<uint32_t>(ReadVarint());
+			if (!myIsTruncated)
+			{
+				DeserializeSchemaRecords(*static_cast<Reflectable*>(pPropPtr), schemaIndex);
 			}
-		});
+			return;
+		}
+
+		// should start with a header...
+		ReflectableID serializedID = INVALID_REFLECTABLE_ID;
+		uint32_t propertiesCount = 0;
+		if (!ReadObjectHeader(serializedID, propertiesCount) || propertiesCount == 0)
+			return;
+
+		Reflectable& reflectable = *static_cast<Reflectable*>(pPropPtr);
+		const TypeInfo* objTypeInfo = TypeInfoDatabase::GetSingleton().GetTypeInfo(reflectable.GetReflectableClassID());
+
+		const TypeInfo* deserializedTypeInfo = TypeInfoDatabase::GetSingleton().GetTypeInfo(serializedID);
+
+		// cannot dump properties into incompatible reflectable type
+		if (deserializedTypeInfo == nullptr || !deserializedTypeInfo->IsParentOf(*objTypeInfo))
+			return;
+
+		DeserializeProperties(reflectable, deserializedTypeInfo->GetPropertyLayout(), propertiesCount);
 	}
 
 	void	BinaryReflectorDeserializer::DeserializeValue(MetaType pPropType, void* pPropPtr, const DataStructureHandler* pHandler) const
@@ -180,11 +781,12 @@ namespace DIRE_NS
 			DeserializeCompoundValue(pPropPtr);
 			break;
 		case MetaType::Enum:
-		{
-			MetaType underlyingType = pHandler->GetEnumHandler()->EnumMetaType();
-			DeserializeValue(underlyingType, pPropPtr);
-		}
-		break;
+			if (pHandler != nullptr && pHandler->GetEnumHandler() != nullptr)
+			{
+				MetaType underlyingType = pHandler->GetEnumHandler()->EnumMetaType();
+				DeserializeValue(underlyingType, pPropPtr);
+			}
+			break;
 		default:
 			// Unmanaged type in DeserializeValue!
 			DIRE_ASSERT(false);
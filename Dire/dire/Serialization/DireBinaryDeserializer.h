@@ -3,36 +3,197 @@
 #include "DireDefines.h"
 #ifdef DIRE_COMPILE_BINARY_SERIALIZATION
 #include "DireSerialization.h"
+#include "DireBinaryHeaders.h"
 #include "dire/Types/DireTypes.h"
 
+#include <cstring> // memcpy
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
 namespace DIRE_NS
 {
 	class DataStructureHandler;
+	class MappedFile;
 	class IMapDataStructureHandler;
 	class IArrayDataStructureHandler;
 
 	class Dire_EXPORT BinaryReflectorDeserializer : public IDeserializer
 	{
 	public:
+		/**
+		 * \brief Deserializes binary data whose size is unknown: reads are not bounds-checked, so the data has to be trusted.
+		 */
 		virtual Result	DeserializeInto(const char * pSerialized, Reflectable& pDeserializedObject) override;
 
+		/**
+		 * \brief Deserializes binary data, checking every read against the data size:
+		 * truncated or corrupted data gives an error instead of reading out of bounds.
+		 * \param pSerialized The binary data
+		 * \param pSerializedSize The binary data size, in bytes
+		 * \param pDeserializedObject The reflectable to deserialize into
+		 */
+		virtual Result	DeserializeInto(const char * pSerialized, size_t pSerializedSize, Reflectable& pDeserializedObject) override;
+
+		/**
+		 * \brief Deserializes a binary file by mapping it in memory instead of reading it into a buffer first.
+		 * Reads are bounds-checked against the file size.
+		 * \param pFilePath The binary file path
+		 * \param pDeserializedObject The reflectable to deserialize into
+		 */
+		Result	DeserializeFileInto(DIRE_STRING_VIEW pFilePath, Reflectable& pDeserializedObject);
+
+		/**
+		 * \brief Applies a delta whose size is unknown: reads are not bounds-checked, so the data has to be trusted.
+		 */
+		virtual Result	ApplyDelta(const char * pSerialized, Reflectable& pDeserializedObject) override;
+
+		/**
+		 * \brief Applies a delta made by BinaryReflectorSerializer::SerializeDelta in the same format,
+		 * to an object holding the baseline of the delta. Reads are bounds-checked against the delta size.
+		 * \param pSerialized The delta
+		 * \param pSerializedSize The delta size, in bytes
+		 * \param pDeserializedObject The reflectable to apply the delta to
+		 */
+		Result	ApplyDelta(const char * pSerialized, size_t pSerializedSize, Reflectable& pDeserializedObject);
+
+		/**
+		 * \brief Sets the wire format of the data to deserialize (the native one by default).
+		 */
+		void	SetFormat(BinaryFormat pFormat)
+		{
+			myFormat = pFormat;
+		}
+
+		[[nodiscard]] BinaryFormat	GetFormat() const
+		{
+			return myFormat;
+		}
+
+		/**
+		 * \brief Forgets how the schemas met so far translate to the local types.
+		 * They are also forgotten once MAX_SCHEMA_TRANSLATIONS of them are kept, at the start of a deserialization.
+		 */
+		void	ClearSchemaTranslations()
+		{
+			myTranslations.clear();
+		}
+
+		static constexpr size_t	MAX_SCHEMA_TRANSLATIONS = 1024;
+
 	private:
 
 		template <typename T>
-		const T& ReadFromBytes() const
+		const T* ReadFromBytes() const
 		{
-			auto Tptr = reinterpret_cast<const T*>(mySerializedBytes + myReadingOffset);
-			myReadingOffset += sizeof(T);
-			return *Tptr;
+			return reinterpret_cast<const T*>(ReadBytes(sizeof(T)));
 		}
 
+		/**
+		 * \brief Returns the address of the next pNbBytesRead bytes and skips them,
+		 * or nullptr (and remembers the data is truncated) if there are not enough bytes left.
+		 */
 		const char* ReadBytes(size_t pNbBytesRead) const
 		{
+			if (pNbBytesRead > mySerializedSize - myReadingOffset)
+			{
+				myIsTruncated = true;
+				return nullptr;
+			}
+
 			const char* dataPtr = mySerializedBytes + myReadingOffset;
 			myReadingOffset += pNbBytesRead;
 			return dataPtr;
 		}
 
+		/**
+		 * \brief Reads a varint, or returns 0 (and remembers the data is truncated) if there is no valid varint left.
+		 */
+		uint64_t	ReadVarint() const
+		{
+			uint64_t value = 0;
+			const size_t nbBytesRead = Varint::Decode(mySerializedBytes + myReadingOffset, mySerializedSize - myReadingOffset, value);
+			if (nbBytesRead == 0)
+			{
+				myIsTruncated = true;
+				return 0;
+			}
+
+			myReadingOffset += nbBytesRead;
+			return value;
+		}
+
+		template <typename T>
+		void	ReadValue(void* pValuePtr) const
+		{
+			if constexpr (std::is_integral_v<T> && sizeof(T) > 1)
+			{
+				if (myFormat != BinaryFormat::Native)
+				{
+					T value;
+					if constexpr (std::is_signed_v<T>)
+					{
+						value = static_cast<T>(Varint::ZigZagDecode(ReadVarint()));
+					}
+					else
+					{
+						value = static_cast<T>(ReadVarint());
+					}
+					memcpy(pValuePtr, &value, sizeof(T));
+					return;
+				}
+			}
+
+			if (const char* valueBytes = ReadBytes(sizeof(T)))
+			{
+				memcpy(pValuePtr, valueBytes, sizeof(T));
+			}
+		}
+
+		template <typename T>
+		void	ReadValues(void* pValues, size_t pCount) const
+		{
+			T* values = static_cast<T*>(pValues);
+			for (size_t iValue = 0; iValue < pCount && !myIsTruncated; ++iValue)
+			{
+				ReadValue<T>(&values[iValue]);
+			}
+		}
+
+		/**
+		 * \brief Reads a contiguous array of varint integers in one go, without going through the array handler for each element.
+		 * \return false if the elements are not integers
+		 */
+		bool	ReadVarintArray(MetaType pElementType, void* pArrayData, size_t pArraySize) const;
+
+		/**
+		 * \brief Reads the header of an object.
+		 * \return false if the data is truncated
+		 */
+		bool	ReadObjectHeader(ReflectableID& pID, uint32_t& pPropertiesCount) const;
+
+		/**
+		 * \brief Reads the header of a property. In the compact format, the type is left to Unknown:
+		 * it is the one of the property found at the read offset.
+		 * \return false if the data is truncated
+		 */
+		bool	ReadPropertyHeader(uint32_t& pOffset, MetaType& pType) const;
+
+		/**
+		 * \brief Reads the schema block ending the data in the schema format, and restricts the data to what precedes it.
+		 * \return false if the data is truncated
+		 */
+		bool	ReadSchemaBlock();
+
+		/**
+		 * \brief Reads the records of an object in the schema format, whose schema index has already been read.
+		 */
+		void	DeserializeSchemaRecords(Reflectable& pDeserializedObject, uint32_t pSchemaIndex) const;
+
+		Result	DeserializeObject(Reflectable& pDeserializedObject);
+
+		void	DeserializeProperties(Reflectable& pDeserializedObject, const PropertyLayout& pLayout, uint32_t pPropertiesCount) const;
+
 		void	DeserializeArrayValue(void* pPropPtr, const IArrayDataStructureHandler * pArrayHandler) const;
 
 		void	DeserializeMapValue(void* pPropPtr, const IMapDataStructureHandler * pMapHandler) const;
@@ -41,8 +202,72 @@ namespace DIRE_NS
 
 		void	DeserializeValue(MetaType pPropType, void* pPropPtr, const DataStructureHandler* pHandler = nullptr) const;
 
-		const char*		mySerializedBytes = nullptr;
-		mutable size_t	myReadingOffset = 0;
+		/**
+		 * \brief Reads pCount elements of an array from pFirstElem, in one go when the elements are contiguous fundamental values.
+		 */
+		void	ReadArrayElements(void* pPropPtr, const IArrayDataStructureHandler * pArrayHandler, size_t pFirstElem, size_t pCount) const;
+
+		/**
+		 * \brief Reads a map key. Compact keys are varints: they are decoded into pKeyStorage, native keys are used in place.
+		 * \return The key address, or nullptr if the data is truncated
+		 */
+		const void*	ReadMapKey(const IMapDataStructureHandler& pMapHandler, const DataStructureHandler& pKeyHandler, void* pKeyStorage) const;
+
+		void	DeserializeReflectableDelta(Reflectable& pDeserializedObject) const;
+
+		void	DeserializeValueDelta(MetaType pPropType, void* pPropPtr, const DataStructureHandler* pHandler) const;
+
+		void	DeserializeArrayDelta(void* pPropPtr, const IArrayDataStructureHandler * pArrayHandler) const;
+
+		void	DeserializeMapDelta(void* pPropPtr, const IMapDataStructureHandler * pMapHandler) const;
+
+		template <typename T>
+		using Array = std::vector<T, DIRE_ALLOCATOR<T>>;
+
+		static constexpr uint32_t	NO_PROPERTY = UINT32_MAX;
+
+		/**
+		 * \brief How the properties of a schema found in the data translate to the layout of the type deserialized into.
+		 * It only depends on the schema and the local type: translations are kept from one deserialization to the next,
+		 * so that loading data written with an older layout is as fast as loading current data.
+		 */
+		struct SchemaTranslation
+		{
+			String::HashType	SchemaHash = 0;
+			const TypeInfo*		LocalType = nullptr;
+			Array<uint32_t>		LocalIndices; // for each schema property, its index in the local layout, or NO_PROPERTY to skip its records
+			Array<uint32_t>		FixedSizes; // for each schema property, the size of its records, or 0 if they're length-prefixed
+		};
+
+		/**
+		 * \brief A schema as found in the data.
+		 */
+		struct StreamSchema
+		{
+			DIRE_STRING_VIEW			Definition; // the schema properties, as written
+			uint32_t					PropertiesCount = 0;
+			String::HashType			Hash = 0;
+			const SchemaTranslation*	Translation = nullptr; // the translation last used with this schema
+		};
+
+		/**
+		 * \brief Finds the translation of a schema for a type, or builds it: properties are matched by name hash and type signature.
+		 */
+		const SchemaTranslation&	GetSchemaTranslation(const StreamSchema& pSchema, const TypeInfo& pLocalType) const;
+
+		using TranslationHashTable =
+			std::unordered_map<String::HashType, SchemaTranslation, std::hash<String::HashType>, std::equal_to<String::HashType>,
+			DIRE_ALLOCATOR<std::pair<const String::HashType, SchemaTranslation>>>;
+
+		const char*						mySerializedBytes = nullptr;
+		mutable size_t					mySerializedSize = 0;
+		const MappedFile*				myMappedFile = nullptr; // set when deserializing a file, to release the pages already read
+		mutable size_t					myReadingOffset = 0;
+		mutable bool					myIsTruncated = false;
+		mutable bool					myIsMismatched = false; // a property of the data has another type than in the layout
+		BinaryFormat					myFormat = BinaryFormat::Native;
+		mutable Array<StreamSchema>		mySchemas;
+		mutable TranslationHashTable	myTranslations; // indexed by the combined hash of the schema and the local type
 	};
 }
 #endif
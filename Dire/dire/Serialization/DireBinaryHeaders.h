@@ -2,12 +2,38 @@
 
 #ifdef DIRE_COMPILE_BINARY_SERIALIZATION
 
+#include <cstddef>
 #include <cstdint>
 #include "dire/Types/DireTypes.h"
 #include "dire/DireReflectableID.h"
+#include "dire/Handlers/DireArrayDataStructureHandler.h"
+#include "dire/Handlers/DireMapDataStructureHandler.h"
+#include "dire/Handlers/DireEnumDataStructureHandler.h"
+#include "dire/Utils/DireString.h"
 
 namespace DIRE_NS
 {
+	/**
+	 * \brief The binary wire formats. The serializer and the deserializer have to agree on the format in use.
+	 * - Native: fixed-size headers that describe every value, and values stored as they are in memory.
+	 * - Compact: every header field the reflected types already describe is left out, counts and offsets are varints,
+	 * integers are (zigzag) varints, and nothing is padded. Much smaller, especially for small properties, but it can only
+	 * be read back with the exact same reflected types.
+	 * - Schema: values are encoded like in the compact format, but properties are identified by name instead of offset.
+	 * Objects refer to the schema of their type (the name hash, type signature and encoded size of its properties), written once
+	 * in a schema block at the end of the data, and every property record of variable size is length-prefixed. Properties the reader
+	 * doesn't have (or whose type changed) are skipped in constant time, and the others are read through a translation table built
+	 * once per type: data stays readable after adding, removing or moving members around.
+	 * The schema block comes last so that the data can still be written to a sink as it's produced: it is located through
+	 * the fixed-size offset ending the data, which means the data size has to be known to read it.
+	 */
+	enum class BinaryFormat : uint8_t
+	{
+		Native,
+		Compact,
+		Schema
+	};
+
 	class BinarySerializationHeaders
 	{
 		friend class BinaryReflectorSerializer;
@@ -15,8 +41,8 @@ namespace DIRE_NS
 
 		struct Object
 		{
-			explicit Object(const ReflectableID pID) :
-				ID(pID)
+			Object(const ReflectableID pID, const uint32_t pPropertiesCount) :
+				ID(pID), PropertiesCount(pPropertiesCount)
 			{}
 
 			ReflectableID	ID = 0;
@@ -30,6 +56,7 @@ namespace DIRE_NS
 			{}
 
 			MetaType	PropertyType = MetaType::Unknown;
+			uint8_t		Padding[alignof(uint32_t) - sizeof(MetaType)]{};
 			uint32_t	PropertyOffset = 0;
 		};
 
@@ -41,6 +68,7 @@ namespace DIRE_NS
 
 			// ElementType and SizeofElement are not strictly necessary for now, but let's keep them here for debug purposes
 			MetaType	ElementType = MetaType::Unknown;
+			uint8_t		Padding[alignof(size_t) - sizeof(MetaType)]{};
 			size_t		SizeofElement = 0;
 			size_t		ArraySize = 0;
 		};
@@ -52,14 +80,205 @@ namespace DIRE_NS
 			{}
 
 			// Key/ValueType and Sizeofs are not strictly necessary for now, but let's keep them here for debug purposes
-			// Maybe think of an "optimized" mode that omits them.
+			// (the compact format omits them).
 			MetaType	KeyType = MetaType::Unknown;
+			uint8_t		KeyPadding[alignof(size_t) - sizeof(MetaType)]{};
 			size_t		SizeofKeyType = 0;
 			MetaType	ValueType = MetaType::Unknown;
+			uint8_t		ValuePadding[alignof(size_t) - sizeof(MetaType)]{};
 			size_t		SizeofValueType = 0;
 			size_t		MapSize = 0;
 		};
+
+		// Headers are written as is: their padding is explicit so that it is always zeroed by their constructor
+		// (zeroing the bytes before constructing a header in them is not enough, compilers may drop it).
+		static_assert(sizeof(Object) == sizeof(ReflectableID) + sizeof(uint32_t));
+		static_assert(sizeof(Property) == 2 * sizeof(uint32_t));
+		static_assert(sizeof(Array) == 3 * sizeof(size_t));
+		static_assert(sizeof(Map) == 5 * sizeof(size_t));
+
+		// What the schema of a type says about one of its properties. Written without padding.
+		struct SchemaProperty
+		{
+			String::HashType	NameHash = 0;
+			uint32_t			TypeSignature = 0;
+			uint32_t			FixedSize = 0; // the encoded size of the property value, or 0 if it varies (its records are then length-prefixed)
+		};
+
+		using RecordSize = uint32_t; // the largest length-prefixed record, whose length is written as a varint
+		using SchemaBlockOffset = uint64_t;
+
+		// What a delta does to a map entry.
+		enum MapDeltaOperation : uint8_t
+		{
+			End,	// no more changes
+			Set,	// the entry is new, or its value is replaced
+			Patch,	// the value is a delta to apply to the one of the entry
+			Erase	// the entry is removed
+		};
 	};
+
+	/**
+	 * \brief Arrays of these types are serialized as a raw copy of their elements (no header per element),
+	 * so contiguous arrays of them can be written and read back with a single copy.
+	 * In the compact format, integers bigger than a byte are varints, so only single bytes and floating-point values qualify.
+	 */
+	inline bool	IsBulkSerializable(MetaType pType, BinaryFormat pFormat = BinaryFormat::Native)
+	{
+		switch (pType.Value)
+		{
+		case MetaType::Bool:
+		case MetaType::Char:
+		case MetaType::UChar:
+		case MetaType::Float:
+		case MetaType::Double:
+			return true;
+		case MetaType::Short:
+		case MetaType::UShort:
+		case MetaType::Int:
+		case MetaType::Uint:
+		case MetaType::Int64:
+		case MetaType::Uint64:
+			return pFormat == BinaryFormat::Native;
+		default:
+			return false;
+		}
+	}
+
+	/**
+	 * \brief LEB128 variable-length integers of the compact format: 7 bits per byte, the high bit telling whether more bytes follow.
+	 * Signed values are zigzag-encoded first, so that small negative values stay small too.
+	 */
+	namespace Varint
+	{
+		constexpr size_t	MAX_SIZE = 10; // a 64-bit value needs at most 10 groups of 7 bits
+
+		inline uint64_t	ZigZagEncode(int64_t pValue)
+		{
+			return (static_cast<uint64_t>(pValue) << 1) ^ static_cast<uint64_t>(pValue >> 63);
+		}
+
+		inline int64_t	ZigZagDecode(uint64_t pValue)
+		{
+			return static_cast<int64_t>(pValue >> 1) ^ -static_cast<int64_t>(pValue & 1);
+		}
+
+		/**
+		 * \brief The number of bytes Encode writes for a value.
+		 */
+		constexpr size_t	EncodedSize(uint64_t pValue)
+		{
+			size_t nbBytes = 1;
+			while (pValue >= 0x80)
+			{
+				pValue >>= 7;
+				nbBytes++;
+			}
+			return nbBytes;
+		}
+
+		/**
+		 * \brief Encodes a value, writing at most MAX_SIZE bytes to pDest.
+		 * \return The number of bytes written
+		 */
+		inline size_t	Encode(uint64_t pValue, char* pDest)
+		{
+			size_t nbBytes = 0;
+			while (pValue >= 0x80)
+			{
+				pDest[nbBytes++] = static_cast<char>((pValue & 0x7F) | 0x80);
+				pValue >>= 7;
+			}
+			pDest[nbBytes++] = static_cast<char>(pValue);
+			return nbBytes;
+		}
+
+		/**
+		 * \brief Decodes a value from at most pAvailable bytes.
+		 * \return The number of bytes read, or 0 if the value is truncated or longer than MAX_SIZE.
+		 */
+		inline size_t	Decode(const char* pSrc, size_t pAvailable, uint64_t& pValue)
+		{
+			uint64_t value = 0;
+			for (size_t iByte = 0; iByte < pAvailable && iByte < MAX_SIZE; ++iByte)
+			{
+				const auto byte = static_cast<uint8_t>(pSrc[iByte]);
+				value |= static_cast<uint64_t>(byte & 0x7F) << (7 * iByte);
+				if ((byte & 0x80) == 0)
+				{
+					pValue = value;
+					return iByte + 1;
+				}
+			}
+			return 0;
+		}
+	}
+
+	/**
+	 * \brief Computes the signature the schema format uses to tell whether a property kept the same type:
+	 * its metatype, and recursively the ones of its elements for arrays and maps (compounds have their own schema).
+	 */
+	inline uint32_t	ComputeSchemaTypeSignature(MetaType pType, const DataStructureHandler* pHandler)
+	{
+		String::HashType signature = String::Hash({});
+		auto mix = [&signature](uint64_t pValue)
+		{
+			signature = (signature ^ pValue) * 0x100000001b3ull; // FNV prime
+		};
+
+		mix(static_cast<uint64_t>(pType.Value));
+		if (pHandler != nullptr)
+		{
+			switch (pType.Value)
+			{
+			case MetaType::Array:
+			{
+				const IArrayDataStructureHandler* arrayHandler = pHandler->GetArrayHandler();
+				const DataStructureHandler elemHandler = arrayHandler->ElementHandler();
+				mix(ComputeSchemaTypeSignature(arrayHandler->ElementType(), &elemHandler));
+				break;
+			}
+			case MetaType::Map:
+			{
+				const IMapDataStructureHandler* mapHandler = pHandler->GetMapHandler();
+				const DataStructureHandler keyHandler = mapHandler->KeyDataHandler();
+				const DataStructureHandler valueHandler = mapHandler->ValueDataHandler();
+				mix(ComputeSchemaTypeSignature(mapHandler->KeyMetaType(), &keyHandler));
+				mix(ComputeSchemaTypeSignature(mapHandler->ValueMetaType(), &valueHandler));
+				break;
+			}
+			case MetaType::Enum:
+				mix(static_cast<uint64_t>(pHandler->GetEnumHandler()->EnumMetaType()));
+				break;
+			default:
+				break;
+			}
+		}
+
+		return static_cast<uint32_t>(signature ^ (signature >> 32));
+	}
+
+	/**
+	 * \brief The size of a value in the schema format if it is always the same, 0 if it varies.
+	 */
+	inline uint32_t	GetSchemaFixedSize(MetaType pType, const DataStructureHandler* pHandler)
+	{
+		switch (pType.Value)
+		{
+		case MetaType::Bool:
+		case MetaType::Char:
+		case MetaType::UChar:
+			return 1;
+		case MetaType::Float:
+			return sizeof(float);
+		case MetaType::Double:
+			return sizeof(double);
+		case MetaType::Enum:
+			return pHandler != nullptr ? GetSchemaFixedSize(pHandler->GetEnumHandler()->EnumMetaType(), nullptr) : 0;
+		default:
+			return 0;
+		}
+	}
 }
 
 #endif
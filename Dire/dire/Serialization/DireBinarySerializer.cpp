@@ -2,38 +2,108 @@
 
 #ifdef DIRE_COMPILE_BINARY_SERIALIZATION
 
-#include "DireBinaryHeaders.h"
+#include "DireDelta.h"
+
+#include <algorithm> // min
+#include <limits>
 
 #define BINARY_SERIALIZE_VALUE_CASE(TypeEnum) \
 case MetaType::TypeEnum:\
 {\
 	using ActualType = FromEnumTypeToActualType<MetaType::TypeEnum>::ActualType;\
-	WriteAsBytes<ActualType>(*static_cast<const ActualType*>(pPropPtr)); \
+	WriteValue<ActualType>(*static_cast<const ActualType*>(pPropPtr)); \
 	break;\
 }
 
+#define BINARY_SERIALIZE_VARINT_ARRAY_CASE(TypeEnum) \
+case MetaType::TypeEnum:\
+	WriteValues<FromEnumTypeToActualType<MetaType::TypeEnum>::ActualType>(pArrayData, pArraySize);\
+	return true;
+
 namespace DIRE_NS
 {
 	ISerializer::Result BinaryReflectorSerializer::Serialize(const Reflectable & serializedObject)
 	{
-		// write the header last because we don't know in advance the total number of props
-		auto objectHandle = WriteAsBytes<BinarySerializationHeaders::Object>(serializedObject.GetReflectableClassID());
+		myOutput.Reset();
 
-		const std::byte * reflectableAddr = reinterpret_cast<const std::byte *>(&serializedObject);
+		SerializeRoot(serializedObject);
 
-		TypeInfoDatabase::GetSingleton().GetTypeInfo(serializedObject.GetReflectableClassID())->ForEachPropertyInHierarchy([this, &objectHandle, reflectableAddr](const PropertyTypeInfo & pProperty)
-		{
-			const std::byte * propertyAddr = reflectableAddr + pProperty.GetOffset();
+		DIRE_STATS_ADD(serializedObject.GetReflectableTypeInfo(), BinaryBytesSerialized, myOutput.GetWrittenSize());
+		return Result(myOutput.TakeBytes());
+	}
 
-			// Uniquely identify props by their offset. Not "change proof", will need a reconcile method it case something changed location (TODO)
-			WriteAsBytes<BinarySerializationHeaders::Property>(pProperty.GetMetatype(), static_cast<uint32_t>(pProperty.GetOffset()));
-			this->SerializeValue(pProperty.GetMetatype(), propertyAddr, &pProperty.GetDataStructureHandler());
+	ISerializer::Result BinaryReflectorSerializer::SerializeTo(const Reflectable& pSerializedObject, ISerializationSink& pSink)
+	{
+		myOutput.Reset(&pSink, myStagingSize);
 
-			// Dont forget to count properties
-			objectHandle.Edit().PropertiesCount++;
-		});
+		SerializeRoot(pSerializedObject);
+
+		DIRE_STATS_ADD(pSerializedObject.GetReflectableTypeInfo(), BinaryBytesSerialized, myOutput.GetWrittenSize());
+		if (!myOutput.Finish())
+			return { SerializationError("The serialization sink refused the serialized data.") };
+
+		return {};
+	}
+
+	ISerializer::Result BinaryReflectorSerializer::SerializeDelta(const Reflectable& pSerializedObject, const Reflectable& pBaseline)
+	{
+		if (const char* error = CheckDeltaBaseline(pSerializedObject, pBaseline))
+			return { SerializationError(error) };
+
+		myOutput.Reset();
+
+		SerializeReflectableDelta(pSerializedObject, pBaseline);
+
+		DIRE_STATS_ADD(pSerializedObject.GetReflectableTypeInfo(), BinaryBytesSerialized, myOutput.GetWrittenSize());
+		return Result(myOutput.TakeBytes());
+	}
+
+	ISerializer::Result BinaryReflectorSerializer::SerializeDeltaTo(const Reflectable& pSerializedObject, const Reflectable& pBaseline, ISerializationSink& pSink)
+	{
+		if (const char* error = CheckDeltaBaseline(pSerializedObject, pBaseline))
+			return { SerializationError(error) };
+
+		myOutput.Reset(&pSink, myStagingSize);
+
+		SerializeReflectableDelta(pSerializedObject, pBaseline);
+
+		DIRE_STATS_ADD(pSerializedObject.GetReflectableTypeInfo(), BinaryBytesSerialized, myOutput.GetWrittenSize());
+		if (!myOutput.Finish())
+			return { SerializationError("The serialization sink refused the serialized data.") };
+
+		return {};
+	}
+
+	ISerializer::Result BinaryReflectorSerializer::SerializeDirty(Reflectable& pSerializedObject)
+	{
+		if (const char* error = CheckDirtyTracking(pSerializedObject))
+			return { SerializationError(error) };
+
+		myOutput.Reset();
 
-		return Result(std::move(mySerializedBuffer));
+		SerializeDirtyProperties(pSerializedObject);
+		pSerializedObject.EditDirtyProperties()->Clear();
+
+		DIRE_STATS_ADD(pSerializedObject.GetReflectableTypeInfo(), BinaryBytesSerialized, myOutput.GetWrittenSize());
+		return Result(myOutput.TakeBytes());
+	}
+
+	ISerializer::Result BinaryReflectorSerializer::SerializeDirtyTo(Reflectable& pSerializedObject, ISerializationSink& pSink)
+	{
+		if (const char* error = CheckDirtyTracking(pSerializedObject))
+			return { SerializationError(error) };
+
+		myOutput.Reset(&pSink, myStagingSize);
+
+		SerializeDirtyProperties(pSerializedObject);
+
+		DIRE_STATS_ADD(pSerializedObject.GetReflectableTypeInfo(), BinaryBytesSerialized, myOutput.GetWrittenSize());
+		// Properties stay dirty if they could not be sent.
+		if (!myOutput.Finish())
+			return { SerializationError("The serialization sink refused the serialized data.") };
+
+		pSerializedObject.EditDirtyProperties()->Clear();
+		return {};
 	}
 
 	void BinaryReflectorSerializer::SerializeValue(MetaType pPropType, const void * pPropPtr, const DataStructureHandler * pHandler)
@@ -89,15 +159,47 @@ namespace DIRE_NS
 		{
 			size_t arraySize = pArrayHandler->Size(pPropPtr);
 			size_t elemSize = pArrayHandler->ElementSize();
-			WriteAsBytes<BinarySerializationHeaders::Array>(elemType, elemSize, arraySize);
-			DataStructureHandler elemHandler = pArrayHandler->ElementHandler();
+			if (myFormat != BinaryFormat::Native)
+			{
+				WriteVarint(arraySize);
+			}
+			else
+			{
+				WriteAsBytes<BinarySerializationHeaders::Array>(elemType, elemSize, arraySize);
+			}
+
+			WriteArrayElements(pPropPtr, pArrayHandler, 0, arraySize);
+		}
+	}
+
+	void BinaryReflectorSerializer::WriteArrayElements(const void* pPropPtr, const IArrayDataStructureHandler* pArrayHandler, size_t pFirstElem, size_t pCount)
+	{
+		const MetaType elemType = pArrayHandler->ElementType();
+		const size_t elemSize = pArrayHandler->ElementSize();
 
-			for (size_t iElem = 0; iElem < arraySize; ++iElem)
+		// Contiguous arrays of fundamental types are written all at once rather than element by element.
+		if (pCount != 0 && IsBulkSerializable(elemType, myFormat))
+		{
+			if (const void* arrayData = pArrayHandler->ContiguousData(pPropPtr))
 			{
-				void const* elemVal = pArrayHandler->Read(pPropPtr, iElem);
-				SerializeValue(elemType, elemVal, &elemHandler);
+				WriteRawBytes(static_cast<const char*>(arrayData) + pFirstElem * elemSize, pCount * elemSize);
+				return;
 			}
 		}
+		else if (pCount != 0 && myFormat != BinaryFormat::Native)
+		{
+			const void* arrayData = pArrayHandler->ContiguousData(pPropPtr);
+			if (arrayData != nullptr && WriteVarintArray(elemType, static_cast<const char*>(arrayData) + pFirstElem * elemSize, pCount))
+				return;
+		}
+
+		DataStructureHandler elemHandler = pArrayHandler->ElementHandler();
+
+		for (size_t iElem = pFirstElem; iElem < pFirstElem + pCount; ++iElem)
+		{
+			void const* elemVal = pArrayHandler->Read(pPropPtr, iElem);
+			SerializeValue(elemType, elemVal, &elemHandler);
+		}
 	}
 
 	void BinaryReflectorSerializer::SerializeMapValue(const void * pPropPtr, const IMapDataStructureHandler * pMapHandler)
@@ -110,7 +212,14 @@ namespace DIRE_NS
 		const size_t mapSize = pMapHandler->Size(pPropPtr);
 		const size_t keySize = pMapHandler->SizeofKey();
 		const size_t valueSize = pMapHandler->SizeofValue();
-		WriteAsBytes<BinarySerializationHeaders::Map>(keyType, keySize, valueType, valueSize, mapSize);
+		if (myFormat != BinaryFormat::Native)
+		{
+			WriteVarint(mapSize);
+		}
+		else
+		{
+			WriteAsBytes<BinarySerializationHeaders::Map>(keyType, keySize, valueType, valueSize, mapSize);
+		}
 
 		pMapHandler->SerializeForEachPair(pPropPtr, this, [](void* pSerializer, const void* pKey, const void* pVal, const IMapDataStructureHandler& pMap,
 			const DataStructureHandler & pKeyHandler, const DataStructureHandler & pValueHandler)
@@ -128,36 +237,411 @@ namespace DIRE_NS
 
 	void BinaryReflectorSerializer::SerializeCompoundValue(const void * pPropPtr)
 	{
-		auto* reflectableProp = static_cast<const Reflectable *>(pPropPtr);
-		const TypeInfo * compTypeInfo = TypeInfoDatabase::GetSingleton().GetTypeInfo(reflectableProp->GetReflectableClassID());
-		DIRE_ASSERT(compTypeInfo != nullptr);
+		SerializeReflectable(*static_cast<const Reflectable *>(pPropPtr));
+	}
+
+	void BinaryReflectorSerializer::SerializeRoot(const Reflectable& pReflectable)
+	{
+		SerializeReflectable(pReflectable);
+
+		if (myFormat == BinaryFormat::Schema)
+		{
+			WriteSchemaBlock();
+		}
+	}
+
+	void BinaryReflectorSerializer::SerializeReflectable(const Reflectable& pReflectable)
+	{
+		const TypeInfo * typeInfo = TypeInfoDatabase::GetSingleton().GetTypeInfo(pReflectable.GetReflectableClassID());
+		DIRE_ASSERT(typeInfo != nullptr);
+
+		if (myFormat == BinaryFormat::Schema)
+		{
+			SerializeSchemaRecords(pReflectable, *typeInfo);
+			return;
+		}
 
-		const std::byte * reflectableAddr = reinterpret_cast<const std::byte *>(reflectableProp);
+		const std::byte * reflectableAddr = reinterpret_cast<const std::byte *>(&pReflectable);
 
-		auto objectHandle = WriteAsBytes<BinarySerializationHeaders::Object>(reflectableProp->GetReflectableClassID());
-		compTypeInfo->ForEachPropertyInHierarchy([&](const PropertyTypeInfo & pProperty)
+		// All the properties are written, so the header can be written first: the output never has to be patched afterwards,
+		// which is what lets it go to a sink as it's being produced.
+		const PropertyLayout& layout = typeInfo->GetPropertyLayout();
+		WriteObjectHeader(pReflectable.GetReflectableClassID(), static_cast<uint32_t>(layout.GetCount()));
+		for (size_t iProp = 0; iProp < layout.GetCount(); ++iProp)
 		{
-			const std::byte * propertyAddr = reflectableAddr + pProperty.GetOffset();
+			SerializeProperty(reflectableAddr, layout, iProp);
+		}
+	}
+
+	void BinaryReflectorSerializer::SerializeProperty(const std::byte* pReflectableAddr, const PropertyLayout& pLayout, size_t pPropIndex)
+	{
+		const std::byte * propertyAddr = pReflectableAddr + pLayout.GetOffset(pPropIndex);
+
+		// Uniquely identify props by their offset. Not "change proof": the schema format identifies them by name instead.
+		WritePropertyHeader(pLayout.GetMetatype(pPropIndex), static_cast<uint32_t>(pLayout.GetOffset(pPropIndex)));
+		this->SerializeValue(pLayout.GetMetatype(pPropIndex), propertyAddr, &pLayout.GetDataStructureHandler(pPropIndex));
+	}
+
+	const char* BinaryReflectorSerializer::CheckDirtyTracking(Reflectable& pSerializedObject) const
+	{
+		if (myFormat == BinaryFormat::Schema)
+			return "The schema binary format does not support dirty-only serialization.";
+
+		if (pSerializedObject.EditDirtyProperties() == nullptr)
+			return "The type of the serialized object does not track its dirty properties.";
+
+		return nullptr;
+	}
 
-			// Uniquely identify props by their offset. TODO: Not "change proof", will need a reconcile method it case something changed location
-			WriteAsBytes<BinarySerializationHeaders::Property>(pProperty.GetMetatype(), static_cast<uint32_t>(pProperty.GetOffset()));
-			this->SerializeValue(pProperty.GetMetatype(), propertyAddr, &pProperty.GetDataStructureHandler());
+	void BinaryReflectorSerializer::SerializeDirtyProperties(Reflectable& pReflectable)
+	{
+		const TypeInfo * typeInfo = pReflectable.GetReflectableTypeInfo();
+		DIRE_ASSERT(typeInfo != nullptr);
 
-			// Dont forget to count properties
-			objectHandle.Edit().PropertiesCount++;
+		DirtyPropertySet& dirtyProperties = *pReflectable.EditDirtyProperties();
+		const PropertyLayout& layout = typeInfo->GetPropertyLayout();
+		const std::byte * reflectableAddr = reinterpret_cast<const std::byte *>(&pReflectable);
+		WriteObjectHeader(pReflectable.GetReflectableClassID(), static_cast<uint32_t>(dirtyProperties.Count()));
+		dirtyProperties.ForEachMarked([&](size_t pDirtyProp)
+		{
+			DIRE_ASSERT(pDirtyProp < layout.GetCount());
+			SerializeProperty(reflectableAddr, layout, pDirtyProp);
 		});
 	}
 
+	void BinaryReflectorSerializer::SerializeSchemaRecords(const Reflectable& pReflectable, const TypeInfo& pTypeInfo)
+	{
+		WriteVarint(GetSchemaIndex(pTypeInfo));
+
+		const std::byte * reflectableAddr = reinterpret_cast<const std::byte *>(&pReflectable);
+		const PropertyLayout& layout = pTypeInfo.GetPropertyLayout();
+		for (size_t iProp = 0; iProp < layout.GetCount(); ++iProp)
+		{
+			const std::byte * propertyAddr = reflectableAddr + layout.GetOffset(iProp);
+			const MetaType propType = layout.GetMetatype(iProp);
+			const DataStructureHandler& handler = layout.GetDataStructureHandler(iProp);
+
+			// The schema tells the size of fixed-size records.
+			if (GetSchemaFixedSize(propType, &handler) != 0)
+			{
+				SerializeValue(propType, propertyAddr, &handler);
+				continue;
+			}
+
+			const size_t recordSize = ComputeRecordSize(propType, propertyAddr, handler);
+			if (recordSize != 0)
+			{
+				WriteVarint(recordSize);
+				SerializeValue(propType, propertyAddr, &handler);
+				continue;
+			}
+
+			// Otherwise, the size is only known once the record is written: mark room for the longest varint to fill it afterwards,
+			// and give back what the actual varint does not need.
+			constexpr size_t maxSizeVarint = Varint::EncodedSize(std::numeric_limits<BinarySerializationHeaders::RecordSize>::max());
+			const size_t mark = myOutput.PushMark(maxSizeVarint);
+			const size_t recordStart = myOutput.GetWrittenSize();
+			SerializeValue(propType, propertyAddr, &handler);
+
+			const size_t writtenSize = myOutput.GetWrittenSize() - recordStart;
+			DIRE_ASSERT(writtenSize <= std::numeric_limits<BinarySerializationHeaders::RecordSize>::max());
+			char* sizeBytes = myOutput.PopMark(mark, maxSizeVarint, Varint::EncodedSize(writtenSize));
+			Varint::Encode(writtenSize, sizeBytes);
+		}
+	}
+
+	size_t BinaryReflectorSerializer::ComputeRecordSize(MetaType pPropType, const void* pPropPtr, const DataStructureHandler& pHandler) const
+	{
+		if (pPropType != MetaType::Array || pHandler.GetArrayHandler() == nullptr)
+			return 0;
+
+		// Big arrays usually are contiguous arrays of fundamental types: knowing their size beforehand avoids keeping them in the writer.
+		const IArrayDataStructureHandler* arrayHandler = pHandler.GetArrayHandler();
+		const size_t arraySize = arrayHandler->Size(pPropPtr);
+		if (!IsBulkSerializable(arrayHandler->ElementType(), myFormat) || (arraySize != 0 && arrayHandler->ContiguousData(pPropPtr) == nullptr))
+			return 0;
+
+		const size_t recordSize = Varint::EncodedSize(arraySize) + arraySize * arrayHandler->ElementSize();
+		return (recordSize <= std::numeric_limits<BinarySerializationHeaders::RecordSize>::max() ? recordSize : 0);
+	}
+
+	uint32_t BinaryReflectorSerializer::GetSchemaIndex(const TypeInfo& pTypeInfo)
+	{
+		const ReflectableID typeID = pTypeInfo.GetID();
+		if (typeID >= mySchemaIndices.size())
+		{
+			mySchemaIndices.resize(typeID + 1, NO_SCHEMA);
+		}
+
+		if (mySchemaIndices[typeID] == NO_SCHEMA)
+		{
+			mySchemaIndices[typeID] = static_cast<uint32_t>(mySchemaTypes.size());
+			mySchemaTypes.push_back(&pTypeInfo);
+		}
+
+		return mySchemaIndices[typeID];
+	}
+
+	void BinaryReflectorSerializer::WriteSchemaBlock()
+	{
+		const BinarySerializationHeaders::SchemaBlockOffset blockOffset = myOutput.GetWrittenSize();
+
+		WriteVarint(mySchemaTypes.size());
+		for (const TypeInfo* schemaType : mySchemaTypes)
+		{
+			const PropertyLayout& layout = schemaType->GetPropertyLayout();
+			WriteVarint(layout.GetCount());
+			for (size_t iProp = 0; iProp < layout.GetCount(); ++iProp)
+			{
+				const MetaType propType = layout.GetMetatype(iProp);
+				const DataStructureHandler& handler = layout.GetDataStructureHandler(iProp);
+				WriteAsBytes<String::HashType>(String::Hash(layout.GetProperty(iProp).GetName()));
+				WriteAsBytes<uint32_t>(ComputeSchemaTypeSignature(propType, &handler));
+				WriteVarint(GetSchemaFixedSize(propType, &handler));
+			}
+
+			// Only the types used by this serialization need to forget their schema for the next one.
+			mySchemaIndices[schemaType->GetID()] = NO_SCHEMA;
+		}
+		mySchemaTypes.clear();
+
+		WriteAsBytes<BinarySerializationHeaders::SchemaBlockOffset>(blockOffset);
+	}
+
+	const char* BinaryReflectorSerializer::CheckDeltaBaseline(const Reflectable& pSerializedObject, const Reflectable& pBaseline) const
+	{
+		if (myFormat == BinaryFormat::Schema)
+			return "The schema binary format does not support deltas.";
+
+		if (pSerializedObject.GetReflectableClassID() != pBaseline.GetReflectableClassID())
+			return "The baseline of a delta must be of the same type as the serialized object.";
+
+		return nullptr;
+	}
+
+	void BinaryReflectorSerializer::SerializeReflectableDelta(const Reflectable& pReflectable, const Reflectable& pBaseline)
+	{
+		const TypeInfo * typeInfo = TypeInfoDatabase::GetSingleton().GetTypeInfo(pReflectable.GetReflectableClassID());
+		DIRE_ASSERT(typeInfo != nullptr);
+
+		// The index (plus one) of each changed property followed by its delta, until a zero.
+		const std::byte * reflectableAddr = reinterpret_cast<const std::byte *>(&pReflectable);
+		const std::byte * baselineAddr = reinterpret_cast<const std::byte *>(&pBaseline);
+		const PropertyLayout& layout = typeInfo->GetPropertyLayout();
+		ForEachChangedProperty(layout, reflectableAddr, baselineAddr, [&](size_t pChangedProp)
+		{
+			const size_t offset = layout.GetOffset(pChangedProp);
+			WriteVarint(pChangedProp + 1);
+			SerializeValueDelta(layout.GetMetatype(pChangedProp), reflectableAddr + offset, baselineAddr + offset, &layout.GetDataStructureHandler(pChangedProp));
+			return true;
+		});
+		WriteVarint(0);
+	}
+
+	void BinaryReflectorSerializer::SerializeValueDelta(MetaType pPropType, const void* pPropPtr, const void* pBaselinePtr, const DataStructureHandler* pHandler)
+	{
+		switch (pPropType.Value)
+		{
+		case MetaType::Array:
+			SerializeArrayDelta(pPropPtr, pBaselinePtr, pHandler->GetArrayHandler());
+			break;
+		case MetaType::Map:
+			SerializeMapDelta(pPropPtr, pBaselinePtr, pHandler->GetMapHandler());
+			break;
+		case MetaType::Object:
+			SerializeReflectableDelta(*static_cast<const Reflectable*>(pPropPtr), *static_cast<const Reflectable*>(pBaselinePtr));
+			break;
+		default:
+			SerializeValue(pPropType, pPropPtr, pHandler);
+		}
+	}
+
+	void BinaryReflectorSerializer::SerializeArrayDelta(const void* pPropPtr, const void* pBaselinePtr, const IArrayDataStructureHandler* pArrayHandler)
+	{
+		const MetaType elemType = pArrayHandler->ElementType();
+		const DataStructureHandler elemHandler = pArrayHandler->ElementHandler();
+		const size_t elemSize = pArrayHandler->ElementSize();
+		const size_t arraySize = pArrayHandler->Size(pPropPtr);
+		const size_t commonSize = std::min(arraySize, pArrayHandler->Size(pBaselinePtr));
+
+		// Contiguous fundamental elements are compared without going through the array handler.
+		const auto* arrayData = static_cast<const char*>(pArrayHandler->ContiguousData(pPropPtr));
+		const auto* baselineData = static_cast<const char*>(pArrayHandler->ContiguousData(pBaselinePtr));
+		const bool isComparedBytewise = (arrayData != nullptr && baselineData != nullptr && IsBulkSerializable(elemType));
+		auto isElementEqual = [&](size_t pElem)
+		{
+			if (isComparedBytewise)
+				return memcmp(arrayData + pElem * elemSize, baselineData + pElem * elemSize, elemSize) == 0;
+
+			return AreValuesEqual(elemType, pArrayHandler->Read(pPropPtr, pElem), pArrayHandler->Read(pBaselinePtr, pElem), &elemHandler);
+		};
+
+		// The new size, then runs of changed elements (the number of unchanged elements before the run plus one, and the run size), until a zero.
+		// Elements that are not in the baseline are written in full.
+		WriteVarint(arraySize);
+
+		// Unchanged contiguous elements are skipped by blocks, one memcmp for many elements.
+		const size_t blockSize = (elemSize < COMPARED_BLOCK_SIZE ? COMPARED_BLOCK_SIZE / elemSize : 1);
+		size_t iElem = 0;
+		size_t runsEnd = 0;
+		while (true)
+		{
+			while (isComparedBytewise && blockSize <= commonSize - std::min(iElem, commonSize)
+				&& memcmp(arrayData + iElem * elemSize, baselineData + iElem * elemSize, blockSize * elemSize) == 0)
+			{
+				iElem += blockSize;
+			}
+
+			while (iElem < commonSize && isElementEqual(iElem))
+			{
+				iElem++;
+			}
+
+			if (iElem >= arraySize)
+				break;
+
+			const size_t runStart = iElem;
+			while (iElem < arraySize && (iElem >= commonSize || !isElementEqual(iElem)))
+			{
+				iElem++;
+			}
+
+			WriteVarint(runStart - runsEnd + 1);
+			WriteVarint(iElem - runStart);
+			if (!IsPatchedByDeltas(elemType))
+			{
+				WriteArrayElements(pPropPtr, pArrayHandler, runStart, iElem - runStart);
+			}
+			else
+			{
+				for (size_t iRunElem = runStart; iRunElem < iElem; ++iRunElem)
+				{
+					const void* elemVal = pArrayHandler->Read(pPropPtr, iRunElem);
+					if (iRunElem < commonSize)
+					{
+						SerializeValueDelta(elemType, elemVal, pArrayHandler->Read(pBaselinePtr, iRunElem), &elemHandler);
+					}
+					else
+					{
+						SerializeValue(elemType, elemVal, &elemHandler);
+					}
+				}
+			}
+
+			runsEnd = iElem;
+		}
+
+		WriteVarint(0);
+	}
+
+	void BinaryReflectorSerializer::SerializeMapDelta(const void* pPropPtr, const void* pBaselinePtr, const IMapDataStructureHandler* pMapHandler)
+	{
+		using Operation = BinarySerializationHeaders::MapDeltaOperation;
+
+		struct MapDelta
+		{
+			BinaryReflectorSerializer*	Serializer = nullptr;
+			const void*					OtherMap = nullptr;
+			size_t						NbKeptEntries = 0;
+		};
+
+		// An operation per changed entry (followed by the key, and the value or its delta), until an End operation.
+		MapDelta delta{ this, pBaselinePtr };
+		pMapHandler->SerializeForEachPair(pPropPtr, &delta, [](void* pDelta, const void* pKey, const void* pVal, const IMapDataStructureHandler& pMap,
+			const DataStructureHandler& pKeyHandler, const DataStructureHandler& pValueHandler)
+		{
+			auto* theDelta = static_cast<MapDelta*>(pDelta);
+			const MetaType valueType = pMap.ValueMetaType();
+			const void* baselineVal = pMap.BinaryFind(theDelta->OtherMap, pKey);
+			if (baselineVal != nullptr)
+			{
+				theDelta->NbKeptEntries++;
+				if (AreValuesEqual(valueType, pVal, baselineVal, &pValueHandler))
+					return;
+			}
+
+			const bool isPatched = (baselineVal != nullptr && IsPatchedByDeltas(valueType));
+			theDelta->Serializer->WriteVarint(isPatched ? Operation::Patch : Operation::Set);
+			theDelta->Serializer->SerializeValue(pMap.KeyMetaType(), pKey, &pKeyHandler);
+			if (isPatched)
+			{
+				theDelta->Serializer->SerializeValueDelta(valueType, pVal, baselineVal, &pValueHandler);
+			}
+			else
+			{
+				theDelta->Serializer->SerializeValue(valueType, pVal, &pValueHandler);
+			}
+		});
+
+		// Only look for erased entries if some baseline entries were not found.
+		if (delta.NbKeptEntries != pMapHandler->Size(pBaselinePtr))
+		{
+			delta.OtherMap = pPropPtr;
+			pMapHandler->SerializeForEachPair(pBaselinePtr, &delta, [](void* pDelta, const void* pKey, const void* /*pVal*/, const IMapDataStructureHandler& pMap,
+				const DataStructureHandler& pKeyHandler, const DataStructureHandler& /*pValueHandler*/)
+			{
+				auto* theDelta = static_cast<MapDelta*>(pDelta);
+				if (pMap.BinaryFind(theDelta->OtherMap, pKey) == nullptr)
+				{
+					theDelta->Serializer->WriteVarint(Operation::Erase);
+					theDelta->Serializer->SerializeValue(pMap.KeyMetaType(), pKey, &pKeyHandler);
+				}
+			});
+		}
+
+		WriteVarint(Operation::End);
+	}
+
+	bool BinaryReflectorSerializer::WriteVarintArray(MetaType pElementType, const void* pArrayData, size_t pArraySize)
+	{
+		switch (pElementType.Value)
+		{
+			BINARY_SERIALIZE_VARINT_ARRAY_CASE(Short)
+			BINARY_SERIALIZE_VARINT_ARRAY_CASE(UShort)
+			BINARY_SERIALIZE_VARINT_ARRAY_CASE(Int)
+			BINARY_SERIALIZE_VARINT_ARRAY_CASE(Uint)
+			BINARY_SERIALIZE_VARINT_ARRAY_CASE(Int64)
+			BINARY_SERIALIZE_VARINT_ARRAY_CASE(Uint64)
+		default:
+			return false;
+		}
+	}
+
+	void BinaryReflectorSerializer::WriteObjectHeader(ReflectableID pID, uint32_t pPropertiesCount)
+	{
+		if (myFormat == BinaryFormat::Compact)
+		{
+			WriteVarint(pID);
+			WriteVarint(pPropertiesCount);
+		}
+		else
+		{
+			WriteAsBytes<BinarySerializationHeaders::Object>(pID, pPropertiesCount);
+		}
+	}
+
+	void BinaryReflectorSerializer::WritePropertyHeader(MetaType pType, uint32_t pOffset)
+	{
+		// In the compact format, the property type is the one of the property found at this offset.
+		if (myFormat == BinaryFormat::Compact)
+		{
+			WriteVarint(pOffset);
+		}
+		else
+		{
+			WriteAsBytes<BinarySerializationHeaders::Property>(pType, pOffset);
+		}
+	}
 
 	void BinaryReflectorSerializer::SerializeString(DIRE_STRING_VIEW pSerializedString)
 	{
-		WriteAsBytes<size_t>(pSerializedString.size());
+		WriteValue<size_t>(pSerializedString.size());
 		WriteRawBytes(pSerializedString.data(), pSerializedString.size());
 	}
 
 	void BinaryReflectorSerializer::SerializeInt(int32_t pSerializedInt)
 	{
-		WriteAsBytes<int32_t>(pSerializedInt);
+		WriteValue<int32_t>(pSerializedInt);
 	}
 
 	void BinaryReflectorSerializer::SerializeFloat(float pSerializedFloat)
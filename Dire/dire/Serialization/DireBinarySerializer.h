@@ -5,9 +5,12 @@
 
 #include "dire/Types/DireTypes.h"
 #include "DireSerialization.h"
+#include "DireBinaryHeaders.h"
 #include "dire/DireReflectable.h"
 
 #include <string.h> // memcpy
+#include <type_traits>
+#include <vector>
 
 /* Export the whole class with GCC, otherwise it won't export the vtable and user will fail linking */
 #ifdef __GNUG__
@@ -24,6 +27,46 @@ namespace DIRE_NS
 
 		virtual Result	 Dire_EXPORT Serialize(Reflectable const& serializedObject) override;
 
+		virtual Result	 Dire_EXPORT SerializeTo(Reflectable const& pSerializedObject, ISerializationSink& pSink) override;
+
+		/**
+		 * \brief Serializes a delta. Values are encoded like in full serializations of the current format,
+		 * and the changes are located by varints: property indices in the layout, runs of array elements and map operations.
+		 * This means both ends need the same reflected types: the schema format does not support deltas.
+		 */
+		virtual Result	 Dire_EXPORT SerializeDelta(Reflectable const& pSerializedObject, Reflectable const& pBaseline) override;
+
+		virtual Result	 Dire_EXPORT SerializeDeltaTo(Reflectable const& pSerializedObject, Reflectable const& pBaseline, ISerializationSink& pSink) override;
+
+		/**
+		 * \brief Serializes the dirty properties of an object as an object of the current format holding only them.
+		 * The schema format does not support it, as its records are positional.
+		 */
+		virtual Result	 Dire_EXPORT SerializeDirty(Reflectable& pSerializedObject) override;
+
+		virtual Result	 Dire_EXPORT SerializeDirtyTo(Reflectable& pSerializedObject, ISerializationSink& pSink) override;
+
+		/**
+		 * \brief Sets the size of the block in which bytes are staged before being written to a sink.
+		 */
+		void	SetStagingSize(size_t pStagingSize)
+		{
+			myStagingSize = pStagingSize;
+		}
+
+		/**
+		 * \brief Sets the wire format of the next serializations (the native one by default).
+		 */
+		void	SetFormat(BinaryFormat pFormat)
+		{
+			myFormat = pFormat;
+		}
+
+		[[nodiscard]] BinaryFormat	GetFormat() const
+		{
+			return myFormat;
+		}
+
 		virtual bool	SerializesMetadata() const override
 		{
 			return false;
@@ -37,37 +80,100 @@ namespace DIRE_NS
 
 	private:
 
-		template <typename T>
-		class Handle
+		template <typename T, typename... Args>
+		void	WriteAsBytes(Args&&... pArgs)
 		{
-		public:
-			Handle(Result::ByteVector& pSerializedBytes, const size_t pOffset) :
-				SerializedData(pSerializedBytes), Offset(pOffset)
-			{}
+			// Headers have no implicit padding (see BinarySerializationHeaders): constructing them writes every byte.
+			new (myOutput.Reserve(sizeof(T))) T(std::forward<Args>(pArgs)...);
+		}
 
-			[[nodiscard]] T& Edit() const { return reinterpret_cast<T&>(SerializedData[Offset]); }
+		void	WriteRawBytes(const char* pBytes, const size_t pNbBytes)
+		{
+			myOutput.Write(pBytes, pNbBytes);
+		}
 
-		private:
-			Result::ByteVector& SerializedData;
-			size_t	Offset = 0;
-		};
+		void	WriteVarint(uint64_t pValue)
+		{
+			char* bytes = myOutput.Reserve(Varint::MAX_SIZE);
+			myOutput.Unreserve(Varint::MAX_SIZE - Varint::Encode(pValue, bytes));
+		}
 
-		template <typename T, typename... Args>
-		Handle<T>	WriteAsBytes(Args&&... pArgs)
+		template <typename T>
+		void	WriteValue(T pValue)
 		{
-			auto oldSize = mySerializedBuffer.size();
-			mySerializedBuffer.resize(mySerializedBuffer.size() + sizeof(T));
-			new (&mySerializedBuffer[oldSize]) T(std::forward<Args>(pArgs)...);
-			return Handle<T>(mySerializedBuffer, oldSize);
+			if constexpr (std::is_integral_v<T> && sizeof(T) > 1)
+			{
+				if (myFormat != BinaryFormat::Native)
+				{
+					if constexpr (std::is_signed_v<T>)
+					{
+						WriteVarint(Varint::ZigZagEncode(pValue));
+					}
+					else
+					{
+						WriteVarint(pValue);
+					}
+					return;
+				}
+			}
+
+			WriteAsBytes<T>(pValue);
 		}
 
-		void	WriteRawBytes(const char* pBytes, const size_t pNbBytes)
+		template <typename T>
+		void	WriteValues(const void* pValues, size_t pCount)
 		{
-			auto oldSize = mySerializedBuffer.size();
-			mySerializedBuffer.resize(mySerializedBuffer.size() + pNbBytes);
-			memcpy(&mySerializedBuffer[oldSize], pBytes, pNbBytes);
+			const T* values = static_cast<const T*>(pValues);
+			for (size_t iValue = 0; iValue < pCount; ++iValue)
+			{
+				WriteValue<T>(values[iValue]);
+			}
 		}
 
+		/**
+		 * \brief Writes a contiguous array of integers as varints in one go, without going through the array handler for each element.
+		 * \return false if the elements are not integers
+		 */
+		bool	WriteVarintArray(MetaType pElementType, const void* pArrayData, size_t pArraySize);
+
+		void	WriteObjectHeader(ReflectableID pID, uint32_t pPropertiesCount);
+
+		void	WritePropertyHeader(MetaType pType, uint32_t pOffset);
+
+		/**
+		 * \brief Serializes the root object, followed by the schema block in the schema format.
+		 */
+		void	SerializeRoot(const Reflectable& pReflectable);
+
+		void	SerializeReflectable(const Reflectable& pReflectable);
+
+		void	SerializeProperty(const std::byte* pReflectableAddr, const PropertyLayout& pLayout, size_t pPropIndex);
+
+		/**
+		 * \return An error if the dirty properties of this object cannot be serialized, or nullptr.
+		 */
+		const char*	CheckDirtyTracking(Reflectable& pSerializedObject) const;
+
+		void	SerializeDirtyProperties(Reflectable& pReflectable);
+
+		/**
+		 * \brief Writes an object in the schema format: the index of its schema, then a record per property.
+		 */
+		void	SerializeSchemaRecords(const Reflectable& pReflectable, const TypeInfo& pTypeInfo);
+
+		/**
+		 * \brief The record size of a property whose serialized size is known without serializing it (contiguous arrays of fundamental types),
+		 * or 0 if it's not known.
+		 */
+		size_t	ComputeRecordSize(MetaType pPropType, void const* pPropPtr, DataStructureHandler const& pHandler) const;
+
+		/**
+		 * \brief Returns the index of the schema of a type in the data, giving it the next index if it's the first object of this type.
+		 */
+		uint32_t	GetSchemaIndex(const TypeInfo& pTypeInfo);
+
+		void	WriteSchemaBlock();
+
 		void	SerializeValue(MetaType pPropType, void const* pPropPtr, DataStructureHandler const* pHandler = nullptr);
 
 		void	SerializeArrayValue(void const* pPropPtr, IArrayDataStructureHandler const* pArrayHandler);
@@ -76,7 +182,36 @@ namespace DIRE_NS
 
 		void	SerializeCompoundValue(void const* pPropPtr);
 
-		Result::ByteVector	mySerializedBuffer;
+		/**
+		 * \brief Writes pCount elements of an array from pFirstElem, in one go when the elements are contiguous fundamental values.
+		 */
+		void	WriteArrayElements(void const* pPropPtr, IArrayDataStructureHandler const* pArrayHandler, size_t pFirstElem, size_t pCount);
+
+		/**
+		 * \return An error if no delta can be serialized from this baseline, or nullptr.
+		 */
+		const char*	CheckDeltaBaseline(const Reflectable& pSerializedObject, const Reflectable& pBaseline) const;
+
+		void	SerializeReflectableDelta(const Reflectable& pReflectable, const Reflectable& pBaseline);
+
+		void	SerializeValueDelta(MetaType pPropType, void const* pPropPtr, void const* pBaselinePtr, DataStructureHandler const* pHandler);
+
+		void	SerializeArrayDelta(void const* pPropPtr, void const* pBaselinePtr, IArrayDataStructureHandler const* pArrayHandler);
+
+		void	SerializeMapDelta(void const* pPropPtr, void const* pBaselinePtr, IMapDataStructureHandler const* pMapHandler);
+
+		static constexpr uint32_t	NO_SCHEMA = UINT32_MAX;
+
+		static constexpr size_t		COMPARED_BLOCK_SIZE = 256; // how many bytes of unchanged array elements deltas skip at once
+
+		template <typename T>
+		using Array = std::vector<T, DIRE_ALLOCATOR<T>>;
+
+		SerializationWriter		myOutput;
+		size_t					myStagingSize = SerializationWriter::DEFAULT_STAGING_SIZE;
+		BinaryFormat			myFormat = BinaryFormat::Native;
+		Array<uint32_t>			mySchemaIndices; // indexed by reflectable ID
+		Array<const TypeInfo*>	mySchemaTypes; // the types having a schema in the data, in schema index order
 	};
 }
 #endif
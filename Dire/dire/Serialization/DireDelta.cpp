@@ -0,0 +1,138 @@
+#include "DireDelta.h"
+
+#ifdef DIRE_SERIALIZATION_ENABLED
+
+#include "dire/DireReflectable.h"
+#include "dire/Handlers/DireArrayDataStructureHandler.h"
+#include "dire/Handlers/DireMapDataStructureHandler.h"
+#include "dire/Handlers/DireEnumDataStructureHandler.h"
+#include "dire/Types/DireTypeInfoDatabase.h"
+
+#define DELTA_FUNDAMENTAL_SIZE_CASE(TypeEnum) \
+case MetaType::TypeEnum:\
+	return sizeof(FromEnumTypeToActualType<MetaType::TypeEnum>::ActualType);
+
+namespace
+{
+	/* The size of values that can be compared bytewise, or 0. */
+	size_t	GetComparableSize(DIRE_NS::MetaType pType, const DIRE_NS::DataStructureHandler* pHandler)
+	{
+		using DIRE_NS::MetaType;
+		using DIRE_NS::FromEnumTypeToActualType;
+
+		switch (pType.Value)
+		{
+			DELTA_FUNDAMENTAL_SIZE_CASE(Bool)
+			DELTA_FUNDAMENTAL_SIZE_CASE(Char)
+			DELTA_FUNDAMENTAL_SIZE_CASE(UChar)
+			DELTA_FUNDAMENTAL_SIZE_CASE(Short)
+			DELTA_FUNDAMENTAL_SIZE_CASE(UShort)
+			DELTA_FUNDAMENTAL_SIZE_CASE(Int)
+			DELTA_FUNDAMENTAL_SIZE_CASE(Uint)
+			DELTA_FUNDAMENTAL_SIZE_CASE(Int64)
+			DELTA_FUNDAMENTAL_SIZE_CASE(Uint64)
+			DELTA_FUNDAMENTAL_SIZE_CASE(Float)
+			DELTA_FUNDAMENTAL_SIZE_CASE(Double)
+		case MetaType::Enum:
+			return (pHandler != nullptr ? GetComparableSize(pHandler->GetEnumHandler()->EnumMetaType(), nullptr) : 0);
+		default:
+			return 0;
+		}
+	}
+
+	struct MapComparison
+	{
+		const void*		OtherMap = nullptr;
+		bool			AreEqual = true;
+	};
+
+	bool	AreArraysEqual(const void* pLhs, const void* pRhs, const DIRE_NS::IArrayDataStructureHandler* pArrayHandler)
+	{
+		const size_t arraySize = pArrayHandler->Size(pLhs);
+		if (arraySize != pArrayHandler->Size(pRhs))
+			return false;
+
+		const DIRE_NS::MetaType elemType = pArrayHandler->ElementType();
+		const DIRE_NS::DataStructureHandler elemHandler = pArrayHandler->ElementHandler();
+		const size_t comparableSize = GetComparableSize(elemType, &elemHandler);
+		if (comparableSize != 0 && arraySize != 0)
+		{
+			const void* lhsData = pArrayHandler->ContiguousData(pLhs);
+			const void* rhsData = pArrayHandler->ContiguousData(pRhs);
+			if (lhsData != nullptr && rhsData != nullptr)
+				return memcmp(lhsData, rhsData, arraySize * comparableSize) == 0;
+		}
+
+		for (size_t iElem = 0; iElem < arraySize; ++iElem)
+		{
+			if (!DIRE_NS::AreValuesEqual(elemType, pArrayHandler->Read(pLhs, iElem), pArrayHandler->Read(pRhs, iElem), &elemHandler))
+				return false;
+		}
+
+		return true;
+	}
+
+	bool	AreMapsEqual(const void* pLhs, const void* pRhs, const DIRE_NS::IMapDataStructureHandler* pMapHandler)
+	{
+		if (pMapHandler->Size(pLhs) != pMapHandler->Size(pRhs))
+			return false;
+
+		// Same size: equal if every entry of one map is found in the other with an equal value.
+		MapComparison comparison{ pRhs };
+		pMapHandler->SerializeForEachPair(pLhs, &comparison, [](void* pComparison, const void* pKey, const void* pVal, const DIRE_NS::IMapDataStructureHandler& pMap,
+			const DIRE_NS::DataStructureHandler& /*pKeyHandler*/, const DIRE_NS::DataStructureHandler& pValueHandler)
+		{
+			auto* theComparison = static_cast<MapComparison*>(pComparison);
+			if (theComparison->AreEqual)
+			{
+				const void* otherVal = pMap.BinaryFind(theComparison->OtherMap, pKey);
+				theComparison->AreEqual = (otherVal != nullptr && DIRE_NS::AreValuesEqual(pMap.ValueMetaType(), pVal, otherVal, &pValueHandler));
+			}
+		});
+
+		return comparison.AreEqual;
+	}
+}
+
+namespace DIRE_NS
+{
+	bool AreValuesEqual(MetaType pType, const void* pLhs, const void* pRhs, const DataStructureHandler* pHandler)
+	{
+		if (pLhs == pRhs)
+			return true;
+
+		if (const size_t comparableSize = GetComparableSize(pType, pHandler))
+			return memcmp(pLhs, pRhs, comparableSize) == 0;
+
+		switch (pType.Value)
+		{
+		case MetaType::Array:
+			return (pHandler == nullptr || pHandler->GetArrayHandler() == nullptr || AreArraysEqual(pLhs, pRhs, pHandler->GetArrayHandler()));
+		case MetaType::Map:
+			return (pHandler == nullptr || pHandler->GetMapHandler() == nullptr || AreMapsEqual(pLhs, pRhs, pHandler->GetMapHandler()));
+		case MetaType::Object:
+			return AreReflectablesEqual(*static_cast<const Reflectable*>(pLhs), *static_cast<const Reflectable*>(pRhs));
+		default:
+			// Nothing to compare values with that are not reflected.
+			return true;
+		}
+	}
+
+	bool AreReflectablesEqual(const Reflectable& pLhs, const Reflectable& pRhs)
+	{
+		if (pLhs.GetReflectableClassID() != pRhs.GetReflectableClassID())
+			return false;
+
+		const TypeInfo* typeInfo = TypeInfoDatabase::GetSingleton().GetTypeInfo(pLhs.GetReflectableClassID());
+		DIRE_ASSERT(typeInfo != nullptr);
+
+		bool areEqual = true;
+		ForEachChangedProperty(typeInfo->GetPropertyLayout(), &pLhs, &pRhs, [&areEqual](size_t)
+		{
+			areEqual = false;
+			return false;
+		});
+		return areEqual;
+	}
+}
+#endif
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "DireDefines.h"
+
+#ifdef DIRE_SERIALIZATION_ENABLED
+#include "dire/Types/DireTypes.h"
+#include "dire/Types/DireTypeInfoCache.h"
+
+#include <cstring> // memcmp
+
+namespace DIRE_NS
+{
+	class DataStructureHandler;
+	class Reflectable;
+
+	/**
+	 * \brief Values of these types are patched by deltas (only what changed in them is written), the others are replaced.
+	 */
+	inline bool	IsPatchedByDeltas(MetaType pType)
+	{
+		return pType == MetaType::Array || pType == MetaType::Map || pType == MetaType::Object;
+	}
+
+	/**
+	 * \brief Compares two values of the same type through reflection, as delta serializers do to find what changed since a baseline.
+	 * Fundamental values and contiguous arrays of them are compared bytewise, maps are compared entry by entry whatever their order.
+	 * \param pType The type of both values
+	 * \param pLhs The first value
+	 * \param pRhs The second value
+	 * \param pHandler The data structure handler of the values, if any
+	 * \return true if the values are equal
+	 */
+	Dire_EXPORT bool	AreValuesEqual(MetaType pType, const void* pLhs, const void* pRhs, const DataStructureHandler* pHandler);
+
+	/**
+	 * \brief Compares every property of two reflectables. Reflectables of different types are never equal.
+	 */
+	Dire_EXPORT bool	AreReflectablesEqual(const Reflectable& pLhs, const Reflectable& pRhs);
+
+	/**
+	 * \brief Calls pFunc with the index of every property whose value differs between two objects of the same type.
+	 * Runs of trivially copyable properties are compared with a single memcmp first, so that unchanged runs are skipped at once.
+	 * \param pLayout The property layout of the objects type
+	 * \param pObject The address of the first object
+	 * \param pBaseline The address of the second object
+	 * \param pFunc The function to call, taking the index of the property in the layout. It can return false to stop the search.
+	 */
+	template <typename Func>
+	void	ForEachChangedProperty(const PropertyLayout& pLayout, const void* pObject, const void* pBaseline, Func&& pFunc)
+	{
+		const auto* objectAddr = static_cast<const std::byte*>(pObject);
+		const auto* baselineAddr = static_cast<const std::byte*>(pBaseline);
+		for (size_t iProp = 0; iProp < pLayout.GetCount();)
+		{
+			const size_t runEnd = pLayout.GetTrivialRunEnd(iProp);
+			if (runEnd != iProp)
+			{
+				const size_t runOffset = pLayout.GetOffset(iProp);
+				const size_t runSize = pLayout.GetOffset(runEnd - 1) + pLayout.GetSize(runEnd - 1) - runOffset;
+				if (memcmp(objectAddr + runOffset, baselineAddr + runOffset, runSize) == 0)
+				{
+					iProp = runEnd;
+					continue;
+				}
+			}
+
+			// Something changed in the run: find out which properties did.
+			for (const size_t propsEnd = (runEnd != iProp ? runEnd : iProp + 1); iProp < propsEnd; ++iProp)
+			{
+				const size_t offset = pLayout.GetOffset(iProp);
+				if (!AreValuesEqual(pLayout.GetMetatype(iProp), objectAddr + offset, baselineAddr + offset, &pLayout.GetDataStructureHandler(iProp))
+					&& !pFunc(iProp))
+				{
+					return;
+				}
+			}
+		}
+	}
+}
+#endif
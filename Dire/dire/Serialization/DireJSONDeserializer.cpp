@@ -10,8 +10,14 @@
 
 #include <rapidjson/error/en.h>
 #include <rapidjson/document.h>
+#include <rapidjson/memorystream.h>
 
+#include "DireDelta.h"
+
+#include <algorithm> // min
 #include <cassert>
+#include <charconv> // from_chars
+#include <cstring> // strlen
 
 /* This macro does a cast on the right side of the equal sign to silence warnings about casting char to int for example */
 #define JSON_DESERIALIZE_VALUE_CASE(TypeEnum, JsonFunc) \
@@ -19,29 +25,323 @@
 		*static_cast<FromEnumTypeToActualType<MetaType::TypeEnum>::ActualType *>(pPropPtr) = static_cast<FromEnumTypeToActualType<MetaType::TypeEnum>::ActualType>(jsonVal->Get##JsonFunc());\
 	break;
 
+/* Writes a streamed JSON number into a numeric property, converting it to the property type. */
+#define JSON_STREAM_NUMBER_CASE(TypeEnum) \
+	case MetaType::TypeEnum:\
+		*static_cast<FromEnumTypeToActualType<MetaType::TypeEnum>::ActualType *>(target.Ptr) = static_cast<FromEnumTypeToActualType<MetaType::TypeEnum>::ActualType>(pValue);\
+	break;
+
+namespace
+{
+	DIRE_NS::IDeserializer::Result	MakeParseError(const rapidjson::ParseResult& pResult)
+	{
+		auto neededSize = snprintf(nullptr, 0, "JSON parse error: %s (%zu)", GetParseError_En(pResult.Code()), pResult.Offset());
+		DIRE_STRING error(size_t(neededSize+1), '\0');
+		snprintf(error.data(), error.size(), "JSON parse error: %s (%zu)", GetParseError_En(pResult.Code()), pResult.Offset());
+
+		return { error };
+	}
+}
+
 namespace DIRE_NS
 {
-	IDeserializer::Result JsonReflectorDeserializer::DeserializeInto(char const* pJson, Reflectable& pDeserializedObject)
+	/**
+	 * \brief Receives the tokens of the JSON reader and writes them straight into the object memory.
+	 * Every value goes to a target: the property named by the last key, the map entry created for it, or the next array element.
+	 * Values without a target (unknown members, mismatching types...) are skipped, along with everything they contain.
+	 */
+	class JsonReflectorDeserializer::StreamHandler
 	{
-		rapidjson::Document doc;
-		rapidjson::ParseResult ok = doc.Parse(pJson);
-		if (doc.Parse(pJson).HasParseError())
+	public:
+		using Ch = char;
+
+		StreamHandler(Array<StreamFrame>& pFrames, Reflectable& pRoot) :
+			myFrames(pFrames),
+			myTarget{ MetaType::Object, &pRoot, nullptr }
+		{
+			myFrames.clear();
+		}
+
+		[[nodiscard]] bool	IsRootObject() const
+		{
+			return myIsRootObject;
+		}
+
+		bool	Null()
+		{
+			if (mySkipDepth == 0)
+			{
+				TakeTarget();
+			}
+			return true;
+		}
+
+		bool	Bool(bool pValue)
+		{
+			if (mySkipDepth == 0)
+			{
+				const Target target = TakeTarget();
+				if (target.Ptr != nullptr && target.Type == MetaType::Bool)
+				{
+					*static_cast<bool*>(target.Ptr) = pValue;
+				}
+			}
+			return true;
+		}
+
+		bool	Int(int pValue) { return Number(pValue); }
+		bool	Uint(unsigned pValue) { return Number(pValue); }
+		bool	Int64(int64_t pValue) { return Number(pValue); }
+		bool	Uint64(uint64_t pValue) { return Number(pValue); }
+		bool	Double(double pValue) { return Number(pValue); }
+
+		bool	RawNumber(const Ch* /*pStr*/, rapidjson::SizeType /*pLength*/, bool /*pCopy*/)
+		{
+			return Null(); // only sent with kParseNumbersAsStringsFlag, which is not used
+		}
+
+		bool	String(const Ch* pStr, rapidjson::SizeType /*pLength*/, bool /*pCopy*/)
+		{
+			if (mySkipDepth == 0)
+			{
+				const Target target = TakeTarget();
+				if (target.Ptr != nullptr && target.Type == MetaType::Enum && target.Handler != nullptr)
+				{
+					target.Handler->GetEnumHandler()->SetFromString(pStr, target.Ptr); // the reader null-terminates strings
+				}
+			}
+			return true;
+		}
+
+		bool	Key(const Ch* pStr, rapidjson::SizeType pLength, bool /*pCopy*/)
+		{
+			if (mySkipDepth != 0)
+				return true;
+
+			StreamFrame& frame = myFrames.back();
+			const DIRE_STRING_VIEW key(pStr, pLength);
+			if (frame.Type == MetaType::Object)
+			{
+				const size_t iProp = frame.Layout->FindIndexByName(key);
+				if (iProp != frame.Layout->GetCount())
+				{
+					void* propPtr = static_cast<std::byte*>(frame.Ptr) + frame.Layout->GetOffset(iProp);
+					myTarget = { frame.Layout->GetMetatype(iProp), propPtr, &frame.Layout->GetDataStructureHandler(iProp) };
+				}
+			}
+			else
+			{
+				myTarget = { frame.MapHandler->ValueMetaType(), frame.MapHandler->Create(frame.Ptr, key, nullptr), &frame.ElementHandler };
+			}
+			return true;
+		}
+
+		bool	StartObject()
 		{
-			auto neededSize = snprintf(nullptr, 0, "JSON parse error: %s (%zu)", GetParseError_En(ok.Code()), ok.Offset());
-			DIRE_STRING error(size_t(neededSize+1), '\0');
-			snprintf(error.data(), error.size(), "JSON parse error: %s (%zu)", GetParseError_En(ok.Code()), ok.Offset());
+			if (mySkipDepth != 0)
+			{
+				mySkipDepth++;
+				return true;
+			}
+
+			myIsRootObject |= myFrames.empty();
 
-			return { error };
+			const Target target = TakeTarget();
+			if (target.Ptr != nullptr && target.Type == MetaType::Object)
+			{
+				auto* reflectable = static_cast<Reflectable*>(target.Ptr);
+				const TypeInfo* typeInfo = TypeInfoDatabase::GetSingleton().GetTypeInfo(reflectable->GetReflectableClassID());
+				DIRE_ASSERT(typeInfo != nullptr);
+
+				StreamFrame& frame = myFrames.emplace_back();
+				frame.Type = MetaType::Object;
+				frame.Ptr = target.Ptr;
+				frame.Layout = &typeInfo->GetPropertyLayout();
+			}
+			else if (target.Ptr != nullptr && target.Type == MetaType::Map && target.Handler != nullptr && target.Handler->GetMapHandler() != nullptr)
+			{
+				// Maps end up with the serialized entries only, even when deserializing into a replica that had others.
+				const IMapDataStructureHandler* mapHandler = target.Handler->GetMapHandler();
+				mapHandler->Clear(target.Ptr);
+
+				StreamFrame& frame = myFrames.emplace_back();
+				frame.Type = MetaType::Map;
+				frame.Ptr = target.Ptr;
+				frame.MapHandler = mapHandler;
+				frame.ElementHandler = mapHandler->ValueDataHandler();
+			}
+			else
+			{
+				mySkipDepth = 1;
+			}
+			return true;
+		}
+
+		bool	EndObject(rapidjson::SizeType /*pMemberCount*/)
+		{
+			return EndValue();
 		}
 
-		TypeInfoDatabase::GetSingleton().GetTypeInfo(pDeserializedObject.GetReflectableClassID())->ForEachPropertyInHierarchy([&pDeserializedObject, &doc, this](const PropertyTypeInfo& pProperty)
+		bool	StartArray()
 		{
-			Reflectable::PropertyAccessor<void> accessor = pDeserializedObject.GetProperty(pProperty.GetName());
-			void* propPtr = const_cast<void*>(accessor.GetPointer());
-			rapidjson::Value const& propValue = doc[pProperty.GetName().data()];
-			DeserializeValue(&propValue, pProperty.GetMetatype(), propPtr, &pProperty.GetDataStructureHandler());
-		});
+			if (mySkipDepth != 0)
+			{
+				mySkipDepth++;
+				return true;
+			}
+
+			const Target target = TakeTarget();
+			const IArrayDataStructureHandler* arrayHandler = (target.Ptr != nullptr && target.Type == MetaType::Array && target.Handler != nullptr ?
+				target.Handler->GetArrayHandler() : nullptr);
+			if (arrayHandler != nullptr && arrayHandler->ElementType() != MetaType::Unknown)
+			{
+				StreamFrame& frame = myFrames.emplace_back();
+				frame.Type = MetaType::Array;
+				frame.Ptr = target.Ptr;
+				frame.ArrayHandler = arrayHandler;
+				frame.ElementHandler = arrayHandler->ElementHandler();
+			}
+			else
+			{
+				mySkipDepth = 1;
+			}
+			return true;
+		}
 
+		bool	EndArray(rapidjson::SizeType /*pElementCount*/)
+		{
+			if (mySkipDepth == 0)
+			{
+				// Elements are created as they come: only shrink resizable arrays that had more (static arrays keep their size).
+				const StreamFrame& frame = myFrames.back();
+				frame.ArrayHandler->Resize(frame.Ptr, frame.NextElement);
+			}
+			return EndValue();
+		}
+
+	private:
+
+		struct Target
+		{
+			MetaType					Type = MetaType::Unknown;
+			void*						Ptr = nullptr; // nullptr to skip the value
+			const DataStructureHandler*	Handler = nullptr;
+		};
+
+		/**
+		 * \brief Returns where the value being read goes: the next element of an array, or the target of the last key.
+		 */
+		Target	TakeTarget()
+		{
+			if (!myFrames.empty() && myFrames.back().Type == MetaType::Array)
+			{
+				StreamFrame& frame = myFrames.back();
+				void* elemPtr = const_cast<void*>(frame.ArrayHandler->Read(frame.Ptr, frame.NextElement++));
+				return { frame.ArrayHandler->ElementType(), elemPtr, &frame.ElementHandler };
+			}
+
+			const Target target = myTarget;
+			myTarget = Target();
+			return target;
+		}
+
+		template <typename T>
+		bool	Number(T pValue)
+		{
+			if (mySkipDepth != 0)
+				return true;
+
+			// JSON doesn't have a concept of "small types" like char and short: numbers are converted to the property type.
+			const Target target = TakeTarget();
+			if (target.Ptr != nullptr)
+			{
+				switch (target.Type.Value)
+				{
+					JSON_STREAM_NUMBER_CASE(Char)
+					JSON_STREAM_NUMBER_CASE(UChar)
+					JSON_STREAM_NUMBER_CASE(Short)
+					JSON_STREAM_NUMBER_CASE(UShort)
+					JSON_STREAM_NUMBER_CASE(Int)
+					JSON_STREAM_NUMBER_CASE(Uint)
+					JSON_STREAM_NUMBER_CASE(Int64)
+					JSON_STREAM_NUMBER_CASE(Uint64)
+					JSON_STREAM_NUMBER_CASE(Float)
+					JSON_STREAM_NUMBER_CASE(Double)
+				default:
+					break; // not a number property
+				}
+			}
+			return true;
+		}
+
+		bool	EndValue()
+		{
+			if (mySkipDepth != 0)
+			{
+				mySkipDepth--;
+			}
+			else
+			{
+				myFrames.pop_back();
+			}
+			return true;
+		}
+
+		Array<StreamFrame>&	myFrames;
+		Target				myTarget;
+		size_t				mySkipDepth = 0; // the depth of the skipped value being read, if any
+		bool				myIsRootObject = false;
+	};
+
+	IDeserializer::Result JsonReflectorDeserializer::DeserializeInto(char const* pJson, Reflectable& pDeserializedObject)
+	{
+		rapidjson::StringStream stream(pJson);
+		return DeserializeStream<rapidjson::kParseDefaultFlags>(stream, pDeserializedObject);
+	}
+
+	IDeserializer::Result JsonReflectorDeserializer::DeserializeInto(char const* pJson, size_t pJsonSize, Reflectable& pDeserializedObject)
+	{
+		rapidjson::MemoryStream stream(pJson, pJsonSize);
+		return DeserializeStream<rapidjson::kParseDefaultFlags>(stream, pDeserializedObject);
+	}
+
+	IDeserializer::Result JsonReflectorDeserializer::DeserializeInsitu(char* pJson, Reflectable& pDeserializedObject)
+	{
+		rapidjson::InsituStringStream stream(pJson);
+		return DeserializeStream<rapidjson::kParseInsituFlag>(stream, pDeserializedObject);
+	}
+
+	template <unsigned ParseFlags, typename InputStream>
+	IDeserializer::Result JsonReflectorDeserializer::DeserializeStream(InputStream& pStream, Reflectable& pDeserializedObject)
+	{
+		StreamHandler handler(myFrames, pDeserializedObject);
+		const rapidjson::ParseResult ok = myReader.Parse<ParseFlags>(pStream, handler);
+		if (ok.IsError())
+			return MakeParseError(ok);
+
+		if (!handler.IsRootObject())
+			return { "The JSON is not an object." };
+
+		DIRE_STATS_ADD(pDeserializedObject.GetReflectableTypeInfo(), JsonBytesDeserialized, pStream.Tell());
+		return { &pDeserializedObject };
+	}
+
+	IDeserializer::Result JsonReflectorDeserializer::ApplyDelta(char const* pJson, Reflectable& pDeserializedObject)
+	{
+		// Values of the previous delta are not needed anymore: reuse their memory.
+		myDocumentAllocator.Clear();
+
+		rapidjson::Document doc(&myDocumentAllocator);
+		rapidjson::ParseResult ok = doc.Parse(pJson);
+		if (ok.IsError())
+			return MakeParseError(ok);
+
+		if (!doc.IsObject())
+			return { "The JSON delta is not an object." };
+
+		ApplyReflectableDelta(doc, pDeserializedObject);
+
+		DIRE_STATS_ADD(pDeserializedObject.GetReflectableTypeInfo(), JsonBytesDeserialized, strlen(pJson));
 		return { &pDeserializedObject };
 	}
 
@@ -56,6 +356,9 @@ namespace DIRE_NS
 			MetaType elemType = pArrayHandler->ElementType();
 			if (elemType != MetaType::Unknown)
 			{
+				// Make resizable arrays the same size as the serialized one (static arrays keep their size).
+				pArrayHandler->Resize(pPropPtr, pVal.Size());
+
 				for (auto iElem = 0u; iElem < pVal.Size(); ++iElem)
 				{
 					void* elemVal = const_cast<void*>(pArrayHandler->Read(pPropPtr, iElem));
@@ -90,13 +393,131 @@ namespace DIRE_NS
 		const TypeInfo * compTypeInfo = TypeInfoDatabase::GetSingleton().GetTypeInfo(reflectableProp->GetReflectableClassID());
 		DIRE_ASSERT(compTypeInfo != nullptr);
 
-		compTypeInfo->ForEachPropertyInHierarchy([this, &pVal, reflectableProp](const PropertyTypeInfo & pProperty)
+		const PropertyLayout& layout = compTypeInfo->GetPropertyLayout();
+		std::byte* objectAddr = reinterpret_cast<std::byte*>(reflectableProp);
+		for (size_t iProp = 0; iProp < layout.GetCount(); ++iProp)
+		{
+			const rapidjson::Value::ConstMemberIterator propItr = pVal.FindMember(layout.GetProperty(iProp).GetName().data());
+			if (propItr != pVal.MemberEnd())
+			{
+				void* propPtr = objectAddr + layout.GetOffset(iProp);
+				DeserializeValue(&propItr->value, layout.GetMetatype(iProp), propPtr, &layout.GetDataStructureHandler(iProp));
+			}
+		}
+	}
+
+	void JsonReflectorDeserializer::ApplyReflectableDelta(const rapidjson::Value& pVal, Reflectable& pDeserializedObject) const
+	{
+		DIRE_ASSERT(pVal.IsObject());
+		const TypeInfo * typeInfo = TypeInfoDatabase::GetSingleton().GetTypeInfo(pDeserializedObject.GetReflectableClassID());
+		DIRE_ASSERT(typeInfo != nullptr);
+
+		// Only the changed properties are in the delta: look them up by name rather than going through the whole layout.
+		std::byte* objectAddr = reinterpret_cast<std::byte*>(&pDeserializedObject);
+		for (rapidjson::Value::ConstMemberIterator itr = pVal.MemberBegin(); itr != pVal.MemberEnd(); ++itr)
+		{
+			const PropertyTypeInfo* property = typeInfo->FindPropertyInHierarchy({ itr->name.GetString(), itr->name.GetStringLength() });
+			if (property != nullptr)
 			{
-				Reflectable::PropertyAccessor<void> prop = reflectableProp->GetProperty(pProperty.GetName());
-				void* propPtr = const_cast<void*>(prop.GetPointer());
-				const rapidjson::Value & propValue = pVal[pProperty.GetName().data()];
-				DeserializeValue(&propValue, pProperty.GetMetatype(), propPtr, &pProperty.GetDataStructureHandler());
-			});
+				ApplyValueDelta(itr->value, property->GetMetatype(), objectAddr + property->GetOffset(), &property->GetDataStructureHandler());
+			}
+		}
+	}
+
+	void JsonReflectorDeserializer::ApplyValueDelta(const rapidjson::Value& pVal, MetaType pPropType, void* pPropPtr, const DataStructureHandler* pHandler) const
+	{
+		switch (pPropType.Value)
+		{
+		case MetaType::Array:
+			ApplyArrayDelta(pVal, pPropPtr, pHandler->GetArrayHandler());
+			break;
+		case MetaType::Map:
+			ApplyMapDelta(pVal, pPropPtr, pHandler->GetMapHandler());
+			break;
+		case MetaType::Object:
+			ApplyReflectableDelta(pVal, *static_cast<Reflectable*>(pPropPtr));
+			break;
+		default:
+			DeserializeValue(&pVal, pPropType, pPropPtr, pHandler);
+		}
+	}
+
+	void JsonReflectorDeserializer::ApplyArrayDelta(const rapidjson::Value& pVal, void* pPropPtr, const IArrayDataStructureHandler* pArrayHandler) const
+	{
+		DIRE_ASSERT(pVal.IsObject());
+		if (pArrayHandler == nullptr)
+			return;
+
+		const MetaType elemType = pArrayHandler->ElementType();
+		const DataStructureHandler elemHandler = pArrayHandler->ElementHandler();
+		const size_t baselineSize = pArrayHandler->Size(pPropPtr);
+
+		// Make resizable arrays the same size as the serialized one (static arrays keep their size).
+		const rapidjson::Value::ConstMemberIterator sizeItr = pVal.FindMember("size");
+		if (sizeItr != pVal.MemberEnd())
+		{
+			pArrayHandler->Resize(pPropPtr, static_cast<size_t>(sizeItr->value.GetUint64()));
+		}
+
+		const size_t arraySize = pArrayHandler->Size(pPropPtr);
+		const size_t commonSize = std::min(arraySize, baselineSize);
+		for (rapidjson::Value::ConstMemberIterator itr = pVal.MemberBegin(); itr != pVal.MemberEnd(); ++itr)
+		{
+			const char* indexStr = itr->name.GetString();
+			const char* indexEnd = indexStr + itr->name.GetStringLength();
+			size_t iElem = 0;
+			if (std::from_chars(indexStr, indexEnd, iElem).ptr != indexEnd || iElem >= arraySize)
+				continue; // the size, or an element out of the array
+
+			void* elemVal = const_cast<void*>(pArrayHandler->Read(pPropPtr, iElem));
+			if (iElem < commonSize)
+			{
+				ApplyValueDelta(itr->value, elemType, elemVal, &elemHandler);
+			}
+			else
+			{
+				DeserializeValue(&itr->value, elemType, elemVal, &elemHandler);
+			}
+		}
+	}
+
+	void JsonReflectorDeserializer::ApplyMapDelta(const rapidjson::Value& pVal, void* pPropPtr, const IMapDataStructureHandler* pMapHandler) const
+	{
+		DIRE_ASSERT(pVal.IsObject());
+		if (pMapHandler == nullptr)
+			return;
+
+		const MetaType valueType = pMapHandler->ValueMetaType();
+		const DataStructureHandler valueHandler = pMapHandler->ValueDataHandler();
+
+		const rapidjson::Value::ConstMemberIterator setItr = pVal.FindMember("set");
+		if (setItr != pVal.MemberEnd())
+		{
+			DeserializeMapValue(setItr->value, pPropPtr, pMapHandler);
+		}
+
+		const rapidjson::Value::ConstMemberIterator patchItr = pVal.FindMember("patch");
+		if (patchItr != pVal.MemberEnd())
+		{
+			const rapidjson::Value& patches = patchItr->value;
+			for (rapidjson::Value::ConstMemberIterator itr = patches.MemberBegin(); itr != patches.MemberEnd(); ++itr)
+			{
+				if (void* value = pMapHandler->Create(pPropPtr, itr->name.GetString(), nullptr))
+				{
+					ApplyValueDelta(itr->value, valueType, value, &valueHandler);
+				}
+			}
+		}
+
+		const rapidjson::Value::ConstMemberIterator eraseItr = pVal.FindMember("erase");
+		if (eraseItr != pVal.MemberEnd())
+		{
+			const rapidjson::Value& erasedKeys = eraseItr->value;
+			for (rapidjson::SizeType iKey = 0; iKey < erasedKeys.Size(); ++iKey)
+			{
+				pMapHandler->Erase(pPropPtr, erasedKeys[iKey].GetString());
+			}
+		}
 	}
 
 	void	JsonReflectorDeserializer::DeserializeValue(void const* pSerializedVal, MetaType pPropType, void* pPropPtr, const DataStructureHandler* pHandler) const
@@ -124,8 +545,11 @@ namespace DIRE_NS
 			}
 			break;
 		case MetaType::Map:
-			if (pHandler != nullptr)
+			if (pHandler != nullptr && pHandler->GetMapHandler() != nullptr)
 			{
+				// Like the binary deserializer, maps end up with the serialized entries only, even when deserializing into a replica that had others.
+				// Not done by DeserializeMapValue, as deltas use it to add their new entries to the existing ones.
+				pHandler->GetMapHandler()->Clear(pPropPtr);
 				DeserializeMapValue(*jsonVal, pPropPtr, pHandler->GetMapHandler());
 			}
 			break;
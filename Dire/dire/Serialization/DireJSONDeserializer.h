@@ -5,22 +5,62 @@
 
 #include "DireSerialization.h"
 #include "dire/Types/DireTypes.h"
+#include "dire/Handlers/DireTypeHandlers.h"
 
 #include <rapidjson/document.h>
+#include <rapidjson/reader.h>
+
+#include <vector>
 
 namespace DIRE_NS
 {
-	class DataStructureHandler;
 	class IMapDataStructureHandler;
 	class IArrayDataStructureHandler;
+	class PropertyLayout;
 
 	class Dire_EXPORT JsonReflectorDeserializer : public IDeserializer
 	{
 	public:
+		/**
+		 * \brief Deserializes JSON by streaming its tokens straight into the object, without building a document first.
+		 * Members are dispatched to properties by name hash: members that are not properties (e.g. metadata) are skipped,
+		 * and properties missing from the JSON keep their value. On a parse error, the properties read before it are already written.
+		 */
 		 virtual Result	DeserializeInto(char const* pJson, Reflectable& pDeserializedObject) override;
 
+		/**
+		 * \brief Deserializes JSON that is not null-terminated: the parsing stops at pJsonSize.
+		 */
+		virtual Result	DeserializeInto(char const* pJson, size_t pJsonSize, Reflectable& pDeserializedObject) override;
+
+		/**
+		 * \brief Deserializes a mutable, null-terminated JSON buffer in situ: strings are decoded in the buffer itself instead of
+		 * being copied, which leaves the buffer content unusable afterwards.
+		 * \param pJson The JSON buffer, modified by the deserialization
+		 * \param pDeserializedObject The reflectable to deserialize into
+		 */
+		Result	DeserializeInsitu(char* pJson, Reflectable& pDeserializedObject);
+
+		/**
+		 * \brief Applies a delta made by JsonReflectorSerializer::SerializeDelta to an object holding the baseline of the delta.
+		 */
+		 virtual Result	ApplyDelta(char const* pJson, Reflectable& pDeserializedObject) override;
+
 	private:
 
+		class StreamHandler;
+
+		template <unsigned ParseFlags, typename InputStream>
+		Result	DeserializeStream(InputStream& pStream, Reflectable& pDeserializedObject);
+
+		void	ApplyReflectableDelta(const rapidjson::Value& pVal, Reflectable& pDeserializedObject) const;
+
+		void	ApplyValueDelta(const rapidjson::Value& pVal, MetaType pPropType, void* pPropPtr, const DataStructureHandler* pHandler) const;
+
+		void	ApplyArrayDelta(const rapidjson::Value& pVal, void* pPropPtr, const IArrayDataStructureHandler * pArrayHandler) const;
+
+		void	ApplyMapDelta(const rapidjson::Value& pVal, void* pPropPtr, const IMapDataStructureHandler * pMapHandler) const;
+
 		void	DeserializeArrayValue(const rapidjson::Value& pVal, void* pPropPtr, const IArrayDataStructureHandler * pArrayHandler) const;
 
 		void	DeserializeMapValue(const rapidjson::Value& pVal, void* pPropPtr, const IMapDataStructureHandler * pMapHandler) const;
@@ -28,6 +68,30 @@ namespace DIRE_NS
 		void	DeserializeCompoundValue(const rapidjson::Value& pVal, void* pPropPtr) const;
 
 		void	DeserializeValue(void const* pSerializedVal, MetaType pPropType, void* pPropPtr, const DataStructureHandler* pHandler = nullptr) const;
+
+		/**
+		 * \brief A JSON object or array being streamed into, and where its values go.
+		 */
+		struct StreamFrame
+		{
+			MetaType							Type = MetaType::Unknown; // Object, Array or Map
+			void*								Ptr = nullptr;
+			const PropertyLayout*				Layout = nullptr; // of an object
+			const IArrayDataStructureHandler*	ArrayHandler = nullptr;
+			const IMapDataStructureHandler*		MapHandler = nullptr;
+			DataStructureHandler				ElementHandler; // of the array elements or map values
+			size_t								NextElement = 0; // of an array
+		};
+
+		template <typename T>
+		using Array = std::vector<T, DIRE_ALLOCATOR<T>>;
+
+		using Reader = rapidjson::GenericReader<rapidjson::UTF8<>, rapidjson::UTF8<>, DIRE_RAPIDJSON_ALLOCATOR>;
+
+		// The parse state is kept from one deserialization to the next, so that its memory is reused.
+		Reader								myReader;
+		Array<StreamFrame>					myFrames;
+		rapidjson::MemoryPoolAllocator<>	myDocumentAllocator; // holds the values of the documents parsed by ApplyDelta
 	};
 }
 #endif
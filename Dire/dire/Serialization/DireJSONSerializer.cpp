@@ -7,6 +7,11 @@
 #include "dire/Types/DireTypeInfo.h"
 #include "dire/DireReflectable.h"
 
+#include "DireDelta.h"
+
+#include <algorithm> // min, max
+#include <charconv> // to_chars
+
 namespace DIRE_NS
 {
 
@@ -18,12 +23,92 @@ case MetaType::TypeEnum:\
 
 	ISerializer::Result JsonReflectorSerializer::Serialize(const Reflectable& serializedObject)
 	{
-		myBuffer.Clear(); // to clean any previously written information
-		myJsonWriter.Reset(myBuffer); // to wipe the root of a previously serialized object
+		myOutput.Reset(); // to clean any previously written information
+		myJsonWriter.Reset(myStream); // to wipe the root of a previously serialized object
 
 		SerializeReflectable(serializedObject);
 
-		return { myBuffer.GetString(), myBuffer.GetSize() };
+		DIRE_STATS_ADD(serializedObject.GetReflectableTypeInfo(), JsonBytesSerialized, myOutput.GetWrittenSize());
+		return Result(myOutput.TakeBytes());
+	}
+
+	ISerializer::Result JsonReflectorSerializer::SerializeTo(const Reflectable& pSerializedObject, ISerializationSink& pSink)
+	{
+		myOutput.Reset(&pSink, myStagingSize);
+		myJsonWriter.Reset(myStream);
+
+		SerializeReflectable(pSerializedObject);
+
+		DIRE_STATS_ADD(pSerializedObject.GetReflectableTypeInfo(), JsonBytesSerialized, myOutput.GetWrittenSize());
+		if (!myOutput.Finish())
+			return { SerializationError("The serialization sink refused the serialized data.") };
+
+		return {};
+	}
+
+	ISerializer::Result JsonReflectorSerializer::SerializeDelta(const Reflectable& pSerializedObject, const Reflectable& pBaseline)
+	{
+		if (pSerializedObject.GetReflectableClassID() != pBaseline.GetReflectableClassID())
+			return { SerializationError("The baseline of a delta must be of the same type as the serialized object.") };
+
+		myOutput.Reset();
+		myJsonWriter.Reset(myStream);
+
+		SerializeReflectableDelta(pSerializedObject, pBaseline);
+
+		DIRE_STATS_ADD(pSerializedObject.GetReflectableTypeInfo(), JsonBytesSerialized, myOutput.GetWrittenSize());
+		return Result(myOutput.TakeBytes());
+	}
+
+	ISerializer::Result JsonReflectorSerializer::SerializeDeltaTo(const Reflectable& pSerializedObject, const Reflectable& pBaseline, ISerializationSink& pSink)
+	{
+		if (pSerializedObject.GetReflectableClassID() != pBaseline.GetReflectableClassID())
+			return { SerializationError("The baseline of a delta must be of the same type as the serialized object.") };
+
+		myOutput.Reset(&pSink, myStagingSize);
+		myJsonWriter.Reset(myStream);
+
+		SerializeReflectableDelta(pSerializedObject, pBaseline);
+
+		DIRE_STATS_ADD(pSerializedObject.GetReflectableTypeInfo(), JsonBytesSerialized, myOutput.GetWrittenSize());
+		if (!myOutput.Finish())
+			return { SerializationError("The serialization sink refused the serialized data.") };
+
+		return {};
+	}
+
+	ISerializer::Result JsonReflectorSerializer::SerializeDirty(Reflectable& pSerializedObject)
+	{
+		if (pSerializedObject.EditDirtyProperties() == nullptr)
+			return { SerializationError("The type of the serialized object does not track its dirty properties.") };
+
+		myOutput.Reset();
+		myJsonWriter.Reset(myStream);
+
+		SerializeDirtyProperties(pSerializedObject);
+		pSerializedObject.EditDirtyProperties()->Clear();
+
+		DIRE_STATS_ADD(pSerializedObject.GetReflectableTypeInfo(), JsonBytesSerialized, myOutput.GetWrittenSize());
+		return Result(myOutput.TakeBytes());
+	}
+
+	ISerializer::Result JsonReflectorSerializer::SerializeDirtyTo(Reflectable& pSerializedObject, ISerializationSink& pSink)
+	{
+		if (pSerializedObject.EditDirtyProperties() == nullptr)
+			return { SerializationError("The type of the serialized object does not track its dirty properties.") };
+
+		myOutput.Reset(&pSink, myStagingSize);
+		myJsonWriter.Reset(myStream);
+
+		SerializeDirtyProperties(pSerializedObject);
+
+		DIRE_STATS_ADD(pSerializedObject.GetReflectableTypeInfo(), JsonBytesSerialized, myOutput.GetWrittenSize());
+		// Properties stay dirty if they could not be sent.
+		if (!myOutput.Finish())
+			return { SerializationError("The serialization sink refused the serialized data.") };
+
+		pSerializedObject.EditDirtyProperties()->Clear();
+		return {};
 	}
 
 
@@ -61,8 +146,7 @@ case MetaType::TypeEnum:\
 				{
 					auto* myself = static_cast<JsonReflectorSerializer*>(pSerializer);
 
-					const DIRE_STRING keyStr = pMap.KeyToString(pKey);
-					myself->myJsonWriter.String(keyStr.data(), rapidjson::SizeType(keyStr.length()));
+					myself->SerializeMapKey(pMap, pKey);
 
 					MetaType valueType = pMap.ValueMetaType();
 					myself->SerializeValue(valueType, pVal, &pValueHandler);
@@ -72,6 +156,21 @@ case MetaType::TypeEnum:\
 		myJsonWriter.EndObject();
 	}
 
+	void JsonReflectorSerializer::SerializeMapKey(const IMapDataStructureHandler& pMapHandler, const void* pKey)
+	{
+		char keyChars[MAP_KEY_BUFFER_SIZE];
+		const DIRE_STRING_VIEW keyStr = pMapHandler.KeyToChars(pKey, keyChars, sizeof(keyChars));
+		if (keyStr.data() != nullptr)
+		{
+			myJsonWriter.String(keyStr.data(), rapidjson::SizeType(keyStr.size()));
+		}
+		else
+		{
+			const DIRE_STRING longKeyStr = pMapHandler.KeyToString(pKey);
+			myJsonWriter.String(longKeyStr.data(), rapidjson::SizeType(longKeyStr.size()));
+		}
+	}
+
 	void JsonReflectorSerializer::SerializeCompoundValue(const void * pPropPtr)
 	{
 		DIRE_ASSERT(pPropPtr != nullptr);
@@ -87,28 +186,238 @@ case MetaType::TypeEnum:\
 
 		myJsonWriter.StartObject();
 
-		typeInfo->ForEachPropertyInHierarchy([this, &pReflectable](const PropertyTypeInfo& pProperty)
+		const PropertyLayout& layout = typeInfo->GetPropertyLayout();
+		const std::byte* reflectableAddr = reinterpret_cast<const std::byte*>(&pReflectable);
+		for (size_t iProp = 0; iProp < layout.GetCount(); ++iProp)
+		{
+			SerializeProperty(reflectableAddr, layout, iProp);
+		}
+
+		myJsonWriter.EndObject();
+	}
+
+	void JsonReflectorSerializer::SerializeProperty(const std::byte* pReflectableAddr, const PropertyLayout& pLayout, size_t pPropIndex)
+	{
+		const PropertyTypeInfo& property = pLayout.GetProperty(pPropIndex);
+		PropertyTypeInfo::SerializationState serializableState = property.GetSerializableState();
+		if (serializableState.IsSerializable == true)
 		{
-			PropertyTypeInfo::SerializationState serializableState = pProperty.GetSerializableState();
-			if (serializableState.IsSerializable == true)
+			void const* propPtr = pReflectableAddr + pLayout.GetOffset(pPropIndex);
+			myJsonWriter.String(property.GetName().data(), rapidjson::SizeType(property.GetName().size()));
+			this->SerializeValue(pLayout.GetMetatype(pPropIndex), propPtr, &pLayout.GetDataStructureHandler(pPropIndex));
+
+			if (SerializesMetadata() && serializableState.HasAttributesToSerialize)
 			{
-				void const* propPtr = pReflectable.GetProperty(pProperty.GetName());
-				myJsonWriter.String(pProperty.GetName().data(), rapidjson::SizeType(pProperty.GetName().size()));
-				this->SerializeValue(pProperty.GetMetatype(), propPtr, &pProperty.GetDataStructureHandler());
+				const DIRE_STRING_VIEW metadataName = property.GetMetadataName();
+				myJsonWriter.String(metadataName.data(), rapidjson::SizeType(metadataName.size()));
 
-				if (SerializesMetadata() && serializableState.HasAttributesToSerialize)
-				{
-					const DIRE_STRING metadataName = DIRE_STRING(pProperty.GetName()) + "_metadata";
-					myJsonWriter.String(metadataName.data(), rapidjson::SizeType(metadataName.size()));
+				myJsonWriter.StartObject();
+
+				property.SerializeAttributes(*this);
+
+				myJsonWriter.EndObject();
+			}
+		}
+	}
+
+	void JsonReflectorSerializer::SerializeDirtyProperties(Reflectable& pReflectable)
+	{
+		const TypeInfo* typeInfo = pReflectable.GetReflectableTypeInfo();
+
+		DIRE_ASSERT(typeInfo != nullptr);
+
+		myJsonWriter.StartObject();
+
+		const PropertyLayout& layout = typeInfo->GetPropertyLayout();
+		const std::byte* reflectableAddr = reinterpret_cast<const std::byte*>(&pReflectable);
+		pReflectable.EditDirtyProperties()->ForEachMarked([&](size_t pDirtyProp)
+		{
+			SerializeProperty(reflectableAddr, layout, pDirtyProp);
+		});
+
+		myJsonWriter.EndObject();
+	}
+
+	void JsonReflectorSerializer::SerializeReflectableDelta(const Reflectable& pReflectable, const Reflectable& pBaseline)
+	{
+		const TypeInfo* typeInfo = pReflectable.GetReflectableTypeInfo();
+
+		DIRE_ASSERT(typeInfo != nullptr);
+
+		myJsonWriter.StartObject();
 
-					myJsonWriter.StartObject();
+		const PropertyLayout& layout = typeInfo->GetPropertyLayout();
+		const std::byte* reflectableAddr = reinterpret_cast<const std::byte*>(&pReflectable);
+		const std::byte* baselineAddr = reinterpret_cast<const std::byte*>(&pBaseline);
+		ForEachChangedProperty(layout, reflectableAddr, baselineAddr, [&](size_t pChangedProp)
+		{
+			const PropertyTypeInfo& property = layout.GetProperty(pChangedProp);
+			if (property.GetSerializableState().IsSerializable)
+			{
+				const size_t offset = layout.GetOffset(pChangedProp);
+				myJsonWriter.String(property.GetName().data(), rapidjson::SizeType(property.GetName().size()));
+				SerializeValueDelta(layout.GetMetatype(pChangedProp), reflectableAddr + offset, baselineAddr + offset, &layout.GetDataStructureHandler(pChangedProp));
+			}
+			return true;
+		});
+
+		myJsonWriter.EndObject();
+	}
+
+	void JsonReflectorSerializer::SerializeValueDelta(MetaType pPropType, const void* pPropPtr, const void* pBaselinePtr, const DataStructureHandler* pHandler)
+	{
+		switch (pPropType.Value)
+		{
+		case MetaType::Array:
+			SerializeArrayDelta(pPropPtr, pBaselinePtr, pHandler->GetArrayHandler());
+			break;
+		case MetaType::Map:
+			SerializeMapDelta(pPropPtr, pBaselinePtr, pHandler->GetMapHandler());
+			break;
+		case MetaType::Object:
+			SerializeReflectableDelta(*static_cast<const Reflectable*>(pPropPtr), *static_cast<const Reflectable*>(pBaselinePtr));
+			break;
+		default:
+			SerializeValue(pPropType, pPropPtr, pHandler);
+		}
+	}
+
+	void JsonReflectorSerializer::SerializeArrayDelta(const void* pPropPtr, const void* pBaselinePtr, const IArrayDataStructureHandler* pArrayHandler)
+	{
+		const MetaType elemType = pArrayHandler->ElementType();
+		const DataStructureHandler elemHandler = pArrayHandler->ElementHandler();
+		const size_t arraySize = pArrayHandler->Size(pPropPtr);
+		const size_t commonSize = std::min(arraySize, pArrayHandler->Size(pBaselinePtr));
+
+		myJsonWriter.StartObject();
+
+		myJsonWriter.String("size");
+		myJsonWriter.Uint64(arraySize);
+
+		for (size_t iElem = 0; iElem < arraySize; ++iElem)
+		{
+			const void* elemVal = pArrayHandler->Read(pPropPtr, iElem);
+			const void* baselineVal = (iElem < commonSize ? pArrayHandler->Read(pBaselinePtr, iElem) : nullptr);
+			if (baselineVal != nullptr && AreValuesEqual(elemType, elemVal, baselineVal, &elemHandler))
+				continue;
+
+			char indexStr[24];
+			const std::to_chars_result indexEnd = std::to_chars(std::begin(indexStr), std::end(indexStr), iElem);
+			myJsonWriter.String(indexStr, rapidjson::SizeType(indexEnd.ptr - indexStr));
+			if (baselineVal != nullptr)
+			{
+				SerializeValueDelta(elemType, elemVal, baselineVal, &elemHandler);
+			}
+			else
+			{
+				SerializeValue(elemType, elemVal, &elemHandler);
+			}
+		}
+
+		myJsonWriter.EndObject();
+	}
+
+	void JsonReflectorSerializer::SerializeMapDelta(const void* pPropPtr, const void* pBaselinePtr, const IMapDataStructureHandler* pMapHandler)
+	{
+		struct MapDelta
+		{
+			enum Section { Set, Patch, Erase };
 
-					pProperty.SerializeAttributes(*this);
+			JsonReflectorSerializer*	Serializer = nullptr;
+			const void*					OtherMap = nullptr;
+			Section						CurrentSection = Set;
+			bool						IsSectionStarted = false;
+			size_t						NbKeptEntries = 0;
+		};
 
+		auto writeSection = [](void* pDelta, const void* pKey, const void* pVal, const IMapDataStructureHandler& pMap,
+			const DataStructureHandler& /*pKeyHandler*/, const DataStructureHandler& pValueHandler)
+		{
+			auto* theDelta = static_cast<MapDelta*>(pDelta);
+			const MetaType valueType = pMap.ValueMetaType();
+			const void* otherVal = pMap.BinaryFind(theDelta->OtherMap, pKey);
+			bool isWritten = false;
+			switch (theDelta->CurrentSection)
+			{
+			case MapDelta::Set:
+				theDelta->NbKeptEntries += (otherVal != nullptr ? 1 : 0);
+				isWritten = (otherVal == nullptr || (!IsPatchedByDeltas(valueType) && !AreValuesEqual(valueType, pVal, otherVal, &pValueHandler)));
+				break;
+			case MapDelta::Patch:
+				isWritten = (otherVal != nullptr && !AreValuesEqual(valueType, pVal, otherVal, &pValueHandler));
+				break;
+			case MapDelta::Erase:
+				isWritten = (otherVal == nullptr);
+				break;
+			}
+
+			if (!isWritten)
+				return;
+
+			Writer& jsonWriter = theDelta->Serializer->myJsonWriter;
+			if (!theDelta->IsSectionStarted)
+			{
+				static const char* const SECTION_NAMES[] = { "set", "patch", "erase" };
+				jsonWriter.String(SECTION_NAMES[theDelta->CurrentSection]);
+				if (theDelta->CurrentSection == MapDelta::Erase)
+				{
+					jsonWriter.StartArray();
+				}
+				else
+				{
+					jsonWriter.StartObject();
+				}
+				theDelta->IsSectionStarted = true;
+			}
+
+			theDelta->Serializer->SerializeMapKey(pMap, pKey);
+			if (theDelta->CurrentSection == MapDelta::Set)
+			{
+				theDelta->Serializer->SerializeValue(valueType, pVal, &pValueHandler);
+			}
+			else if (theDelta->CurrentSection == MapDelta::Patch)
+			{
+				theDelta->Serializer->SerializeValueDelta(valueType, pVal, otherVal, &pValueHandler);
+			}
+		};
+
+		auto endSection = [this](MapDelta& pDelta)
+		{
+			if (pDelta.IsSectionStarted)
+			{
+				if (pDelta.CurrentSection == MapDelta::Erase)
+				{
+					myJsonWriter.EndArray();
+				}
+				else
+				{
 					myJsonWriter.EndObject();
 				}
+				pDelta.IsSectionStarted = false;
 			}
-		});
+		};
+
+		myJsonWriter.StartObject();
+
+		MapDelta delta{ this, pBaselinePtr };
+		pMapHandler->SerializeForEachPair(pPropPtr, &delta, writeSection);
+		endSection(delta);
+
+		if (IsPatchedByDeltas(pMapHandler->ValueMetaType()))
+		{
+			delta.CurrentSection = MapDelta::Patch;
+			pMapHandler->SerializeForEachPair(pPropPtr, &delta, writeSection);
+			endSection(delta);
+		}
+
+		// Only look for erased entries if some baseline entries were not found.
+		if (delta.NbKeptEntries != pMapHandler->Size(pBaselinePtr))
+		{
+			delta.CurrentSection = MapDelta::Erase;
+			delta.OtherMap = pPropPtr;
+			pMapHandler->SerializeForEachPair(pBaselinePtr, &delta, writeSection);
+			endSection(delta);
+		}
 
 		myJsonWriter.EndObject();
 	}
@@ -151,8 +460,16 @@ case MetaType::TypeEnum:\
 			break;
 		case MetaType::Enum:
 		{
-			const char* enumStr = pHandler->GetEnumHandler()->EnumToString(pPropPtr);
-			myJsonWriter.String(enumStr);
+			const IEnumDataStructureHandler* enumHandler = pHandler->GetEnumHandler();
+			char enumChars[ENUM_BUFFER_SIZE];
+			DIRE_STRING_VIEW enumStr = enumHandler->EnumToChars(pPropPtr, enumChars, sizeof(enumChars));
+			DIRE_STRING longEnumStr;
+			while (enumStr.data() == nullptr) // a bitmask enum with many long names: retry in a bigger buffer
+			{
+				longEnumStr.resize(std::max(longEnumStr.size(), sizeof(enumChars)) * 2);
+				enumStr = enumHandler->EnumToChars(pPropPtr, longEnumStr.data(), longEnumStr.size());
+			}
+			myJsonWriter.String(enumStr.data(), rapidjson::SizeType(enumStr.size()));
 		}
 		break;
 		default:
@@ -5,7 +5,6 @@
 #ifdef DIRE_COMPILE_JSON_SERIALIZATION
 
 # include <rapidjson/rapidjson.h>
-# include <rapidjson/stringbuffer.h>	// wrapper of C stream for prettywriter as output
 # include <rapidjson/prettywriter.h>	// for stringify JSON
 
 #include "DireSerialization.h"
@@ -28,6 +27,32 @@ namespace DIRE_NS
 
 		 virtual Result Dire_EXPORT Serialize(const Reflectable & serializedObject) override;
 
+		 virtual Result Dire_EXPORT SerializeTo(const Reflectable& pSerializedObject, ISerializationSink& pSink) override;
+
+		/**
+		 * \brief Serializes a delta as a JSON object of the changed serializable properties, by name (metadata is not serialized).
+		 * Arrays are patched by {"size": N, "<index>": element...} objects,
+		 * and maps by {"set": {key: value...}, "patch": {key: delta...}, "erase": [key...]} objects.
+		 */
+		 virtual Result Dire_EXPORT SerializeDelta(const Reflectable& pSerializedObject, const Reflectable& pBaseline) override;
+
+		 virtual Result Dire_EXPORT SerializeDeltaTo(const Reflectable& pSerializedObject, const Reflectable& pBaseline, ISerializationSink& pSink) override;
+
+		/**
+		 * \brief Serializes the dirty properties of an object as a JSON object holding only them.
+		 */
+		 virtual Result Dire_EXPORT SerializeDirty(Reflectable& pSerializedObject) override;
+
+		 virtual Result Dire_EXPORT SerializeDirtyTo(Reflectable& pSerializedObject, ISerializationSink& pSink) override;
+
+		/**
+		 * \brief Sets the size of the block in which bytes are staged before being written to a sink.
+		 */
+		void	SetStagingSize(size_t pStagingSize)
+		{
+			myStagingSize = pStagingSize;
+		}
+
 		virtual bool	SerializesMetadata() const override
 		{
 			return true;
@@ -51,11 +76,47 @@ namespace DIRE_NS
 
 		void	SerializeReflectable(const Reflectable& pReflectable);
 
-		using StringBuffer = rapidjson::GenericStringBuffer<rapidjson::UTF8<>, DIRE_RAPIDJSON_ALLOCATOR>;
-		using Writer = rapidjson::Writer<StringBuffer>;
+		/**
+		 * \brief Writes a map key, formatted in a stack buffer rather than in an allocated string when possible.
+		 */
+		void	SerializeMapKey(const IMapDataStructureHandler& pMapHandler, const void* pKey);
+
+		void	SerializeProperty(const std::byte* pReflectableAddr, const PropertyLayout& pLayout, size_t pPropIndex);
+
+		void	SerializeDirtyProperties(Reflectable& pReflectable);
+
+		void	SerializeReflectableDelta(const Reflectable& pReflectable, const Reflectable& pBaseline);
+
+		void	SerializeValueDelta(MetaType pPropType, const void * pPropPtr, const void * pBaselinePtr, const DataStructureHandler * pHandler);
+
+		void	SerializeArrayDelta(const void * pPropPtr, const void * pBaselinePtr, const IArrayDataStructureHandler * pArrayHandler);
+
+		void	SerializeMapDelta(const void * pPropPtr, const void * pBaselinePtr, const IMapDataStructureHandler * pMapHandler);
+
+		/* The RapidJSON output stream concept, over the serializer output. */
+		struct OutputStream
+		{
+			using Ch = char;
+
+			explicit OutputStream(SerializationWriter& pOutput) :
+				Output(pOutput)
+			{}
+
+			void	Put(char pChar) { Output.Put(pChar); }
+			void	Flush() {} // RapidJSON calls it once the root object is complete: we flush when the serialization ends.
+
+			SerializationWriter&	Output;
+		};
+
+		using Writer = rapidjson::Writer<OutputStream, rapidjson::UTF8<>, rapidjson::UTF8<>, DIRE_RAPIDJSON_ALLOCATOR>;
+
+		static constexpr size_t	MAP_KEY_BUFFER_SIZE = 64; // enough for any integer key
+		static constexpr size_t	ENUM_BUFFER_SIZE = 256; // enough for most combinations of bitmask enum values
 
-		StringBuffer	myBuffer;
-		Writer			myJsonWriter;
+		SerializationWriter	myOutput;
+		OutputStream		myStream{ myOutput };
+		Writer				myJsonWriter;
+		size_t				myStagingSize = SerializationWriter::DEFAULT_STAGING_SIZE;
 	};
 
 	void JsonReflectorSerializer::SerializeString(DIRE_STRING_VIEW pSerializedString)
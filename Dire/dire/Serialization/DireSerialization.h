@@ -6,6 +6,7 @@
 #include "dire/Types/DireTypeInfo.h"
 #include "dire/DireReflectableID.h"
 #include "dire/DireReflectable.h"
+#include "DireSerializationSink.h"
 #include <vector>
 #include <variant>
 
@@ -59,6 +60,55 @@ namespace DIRE_NS
 
 		virtual Result	Serialize(Reflectable const& serializedObject) = 0;
 
+		/**
+		 * \brief Serializes an object into a sink, handing the bytes over as they are produced instead of returning them all at once.
+		 * The default implementation serializes in memory and then writes everything to the sink:
+		 * serializers override it to stream their output through a staging block of bounded size.
+		 * \param pSerializedObject The object to serialize
+		 * \param pSink Where to write the serialized bytes
+		 * \return On success, a result holding no bytes (they all went to the sink). Otherwise, the error.
+		 */
+		virtual Result	SerializeTo(Reflectable const& pSerializedObject, ISerializationSink& pSink);
+
+		/**
+		 * \brief Serializes an object into a file, created or truncated, through SerializeTo:
+		 * serializers streaming their output only need their staging block in memory, whatever the file size.
+		 * \param pSerializedObject The object to serialize
+		 * \param pFilePath The path of the file to write
+		 * \return On success, a result holding no bytes. Otherwise, the error.
+		 */
+		Result	SerializeToFile(Reflectable const& pSerializedObject, DIRE_STRING_VIEW pFilePath);
+
+		/**
+		 * \brief Serializes only what differs between an object and a baseline of the same type (the previous snapshot sent over the network,
+		 * a default instance...): the properties, array elements and map entries that changed. Applying the delta on top of the baseline
+		 * with the matching deserializer gives back the object. Not all serializers support deltas: by default, it returns an error.
+		 * \param pSerializedObject The object to serialize
+		 * \param pBaseline The baseline to compare the object with
+		 * \return The delta, or the error.
+		 */
+		virtual Result	SerializeDelta(Reflectable const& pSerializedObject, Reflectable const& pBaseline);
+
+		/**
+		 * \brief Serializes a delta into a sink. The default implementation serializes the delta in memory and then writes it to the sink.
+		 */
+		virtual Result	SerializeDeltaTo(Reflectable const& pSerializedObject, Reflectable const& pBaseline, ISerializationSink& pSink);
+
+		/**
+		 * \brief Serializes only the dirty properties of an object (see Reflectable::GetDirtyProperties), in full, then clears them:
+		 * per-frame replication only pays for what changed since the previous frame. Deserializing the output into a replica
+		 * only overwrites these properties. Not all serializers support it: by default, it returns an error.
+		 * \param pSerializedObject The object to serialize. Its type has to use DIRE_DIRTY_TRACKING.
+		 * \return The serialized dirty properties, or the error.
+		 */
+		virtual Result	SerializeDirty(Reflectable& pSerializedObject);
+
+		/**
+		 * \brief Serializes the dirty properties of an object into a sink, then clears them.
+		 * The default implementation serializes them in memory and then writes them to the sink.
+		 */
+		virtual Result	SerializeDirtyTo(Reflectable& pSerializedObject, ISerializationSink& pSink);
+
 		virtual bool	SerializesMetadata() const = 0;
 
 		virtual void	SerializeString(DIRE_STRING_VIEW pSerializedString) = 0;
@@ -68,6 +118,12 @@ namespace DIRE_NS
 
 		using SerializedValueFiller = void (*)(ISerializer& pSerializer);
 		virtual void	SerializeValuesForObject(DIRE_STRING_VIEW pObjectName, SerializedValueFiller pFillerFunction) = 0;
+
+	private:
+		/**
+		 * \brief Writes serialized bytes to a sink, for the default implementations of the sink functions.
+		 */
+		static Result	WriteToSink(const Result& pSerialized, ISerializationSink& pSink);
 	};
 
 	class Dire_EXPORT IDeserializer
@@ -112,6 +168,29 @@ namespace DIRE_NS
 		Result Deserialize(const char* pSerialized, ReflectableID pReflectableClassID, Args&&... pArgs);
 
 		virtual Result	DeserializeInto(const char* /*pSerialized*/, Reflectable& /*pDeserializedObject*/) = 0;
+
+		/**
+		 * \brief Deserializes data of known size, which does not have to be terminated: e.g. one object out of many serialized one after the other.
+		 * The default implementation ignores the size: deserializers able to stop at it override it.
+		 * \param pSerialized The serialized data
+		 * \param pSerializedSize The serialized data size, in bytes
+		 * \param pDeserializedObject The reflectable to deserialize into
+		 */
+		virtual Result	DeserializeInto(const char* pSerialized, size_t /*pSerializedSize*/, Reflectable& pDeserializedObject)
+		{
+			return DeserializeInto(pSerialized, pDeserializedObject);
+		}
+
+		/**
+		 * \brief Applies a delta produced by ISerializer::SerializeDelta to an object holding the baseline of the delta.
+		 * Not all deserializers support deltas: by default, it returns an error.
+		 * \param pSerialized The delta
+		 * \param pDeserializedObject The object to apply the delta to
+		 */
+		virtual Result	ApplyDelta(const char* /*pSerialized*/, Reflectable& /*pDeserializedObject*/)
+		{
+			return { "This deserializer does not support deltas." };
+		}
 	};
 
 	template <typename T, typename ... Args>
@@ -160,6 +239,56 @@ namespace DIRE_NS
 		return serializedString;
 	}
 
+	inline ISerializer::Result ISerializer::SerializeTo(Reflectable const& pSerializedObject, ISerializationSink& pSink)
+	{
+		return WriteToSink(Serialize(pSerializedObject), pSink);
+	}
+
+	inline ISerializer::Result ISerializer::SerializeToFile(Reflectable const& pSerializedObject, DIRE_STRING_VIEW pFilePath)
+	{
+		FileSink sink(pFilePath);
+		if (!sink.IsOpen())
+			return { SerializationError("Could not open the file to serialize into.") };
+
+		Result result = SerializeTo(pSerializedObject, sink);
+		if (!sink.Close() && !result.HasError())
+			return { SerializationError("Could not close the file serialized into.") };
+
+		return result;
+	}
+
+	inline ISerializer::Result ISerializer::SerializeDelta(Reflectable const& /*pSerializedObject*/, Reflectable const& /*pBaseline*/)
+	{
+		return { SerializationError("This serializer does not support deltas.") };
+	}
+
+	inline ISerializer::Result ISerializer::SerializeDeltaTo(Reflectable const& pSerializedObject, Reflectable const& pBaseline, ISerializationSink& pSink)
+	{
+		return WriteToSink(SerializeDelta(pSerializedObject, pBaseline), pSink);
+	}
+
+	inline ISerializer::Result ISerializer::SerializeDirty(Reflectable& /*pSerializedObject*/)
+	{
+		return { SerializationError("This serializer does not support dirty-only serialization.") };
+	}
+
+	inline ISerializer::Result ISerializer::SerializeDirtyTo(Reflectable& pSerializedObject, ISerializationSink& pSink)
+	{
+		return WriteToSink(SerializeDirty(pSerializedObject), pSink);
+	}
+
+	inline ISerializer::Result ISerializer::WriteToSink(const Result& pSerialized, ISerializationSink& pSink)
+	{
+		if (pSerialized.HasError())
+			return pSerialized;
+
+		const Result::ByteVector& bytes = pSerialized.GetBytes();
+		if (!pSink.Write(reinterpret_cast<const char*>(bytes.data()), bytes.size()))
+			return { SerializationError("The serialization sink refused the serialized data.") };
+
+		return {};
+	}
+
 	inline SerializationError ISerializer::Result::GetError() const
 	{
 		if (const SerializationError* error = std::get_if<SerializationError>(&Value))
@@ -167,5 +296,12 @@ namespace DIRE_NS
 		return "";
 	}
 
+	inline SerializationError IDeserializer::Result::GetError() const
+	{
+		if (const SerializationError* error = std::get_if<SerializationError>(&Value))
+			return *error;
+		return "";
+	}
+
 }
 #endif
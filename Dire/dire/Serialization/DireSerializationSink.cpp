@@ -0,0 +1,251 @@
+#include "DireSerializationSink.h"
+
+#ifdef DIRE_SERIALIZATION_ENABLED
+
+#include <algorithm> // min, max
+#include <cerrno>
+#include <climits>
+#include <cstring> // memcpy
+
+#include <fcntl.h>
+#ifdef _WIN32
+# include <io.h>
+# include <share.h>
+# include <sys/stat.h>
+#else
+# include <unistd.h>
+#endif
+
+namespace DIRE_NS
+{
+	bool FileDescriptorSink::Write(const char* pBytes, size_t pNbBytes)
+	{
+		while (pNbBytes != 0)
+		{
+#ifdef _WIN32
+			const int written = _write(myFileDescriptor, pBytes, static_cast<unsigned>(std::min<size_t>(pNbBytes, INT_MAX)));
+#else
+			const ssize_t written = ::write(myFileDescriptor, pBytes, std::min<size_t>(pNbBytes, SSIZE_MAX));
+#endif
+			if (written < 0)
+			{
+				if (errno == EINTR)
+					continue;
+				return false;
+			}
+
+			pBytes += written;
+			pNbBytes -= static_cast<size_t>(written);
+		}
+
+		return true;
+	}
+
+	FileSink::FileSink(DIRE_STRING_VIEW pFilePath) :
+		FileDescriptorSink(-1)
+	{
+		const DIRE_STRING path(pFilePath); // the path has to be null-terminated
+#ifdef _WIN32
+		int fd = -1;
+		_sopen_s(&fd, path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _SH_DENYWR, _S_IREAD | _S_IWRITE);
+#else
+		const int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+		SetFileDescriptor(fd);
+	}
+
+	FileSink::~FileSink()
+	{
+		Close();
+	}
+
+	bool FileSink::Close()
+	{
+		if (!IsOpen())
+			return true;
+
+#ifdef _WIN32
+		const bool isClosed = (_close(GetFileDescriptor()) == 0);
+#else
+		const bool isClosed = (close(GetFileDescriptor()) == 0);
+#endif
+		SetFileDescriptor(-1);
+		return isClosed;
+	}
+
+	bool FixedBufferSink::Write(const char* pBytes, size_t pNbBytes)
+	{
+		if (pNbBytes > myCapacity - mySize)
+			return false;
+
+		memcpy(myBuffer + mySize, pBytes, pNbBytes);
+		mySize += pNbBytes;
+		return true;
+	}
+
+	ChunkedBufferSink::ChunkedBufferSink(size_t pChunkSize) :
+		myChunkSize(std::max<size_t>(pChunkSize, 1))
+	{}
+
+	bool ChunkedBufferSink::Write(const char* pBytes, size_t pNbBytes)
+	{
+		const auto* bytes = reinterpret_cast<const std::byte*>(pBytes);
+		while (pNbBytes != 0)
+		{
+			if (myChunks.empty() || myChunks.back().size() == myChunkSize)
+			{
+				myChunks.emplace_back().reserve(myChunkSize);
+			}
+
+			Chunk& chunk = myChunks.back();
+			const size_t copied = std::min(pNbBytes, myChunkSize - chunk.size());
+			chunk.insert(chunk.end(), bytes, bytes + copied);
+
+			bytes += copied;
+			pNbBytes -= copied;
+			mySize += copied;
+		}
+
+		return true;
+	}
+
+	void ChunkedBufferSink::Clear()
+	{
+		myChunks.clear();
+		mySize = 0;
+	}
+
+	bool CallbackSink::Write(const char* pBytes, size_t pNbBytes)
+	{
+		return myCallback(myUserData, pBytes, pNbBytes);
+	}
+
+
+	void SerializationWriter::Reset(ISerializationSink* pSink, size_t pStagingSize)
+	{
+		mySink = pSink;
+		myUsedSize = 0;
+		myFlushedSize = 0;
+		myMarkCount = 0;
+		myHasFailed = false;
+
+		if (mySink != nullptr)
+		{
+			// The only allocation of a sink serialization (and not even that one when reusing the writer).
+			myBuffer.resize(std::max(pStagingSize, MIN_STAGING_SIZE));
+		}
+	}
+
+	void SerializationWriter::Write(const char* pBytes, size_t pNbBytes)
+	{
+		if (mySink != nullptr && myMarkCount == 0 && pNbBytes >= myBuffer.size())
+		{
+			// No point in copying to the staging block bytes that would fill it anyway.
+			FlushStaging();
+			if (!myHasFailed && !mySink->Write(pBytes, pNbBytes))
+			{
+				myHasFailed = true;
+			}
+			myFlushedSize += pNbBytes;
+			return;
+		}
+
+		if (pNbBytes != 0)
+		{
+			memcpy(Reserve(pNbBytes), pBytes, pNbBytes);
+		}
+	}
+
+	size_t SerializationWriter::PushMark(size_t pNbBytes)
+	{
+		const size_t markPosition = GetWrittenSize();
+		Reserve(pNbBytes);
+
+		if (myMarkCount++ == 0)
+		{
+			myOldestMarkPosition = markPosition;
+		}
+		return markPosition;
+	}
+
+	char* SerializationWriter::PopMark(size_t pMarkPosition)
+	{
+		DIRE_ASSERT(myMarkCount != 0 && pMarkPosition >= myOldestMarkPosition);
+		myMarkCount--;
+		return reinterpret_cast<char*>(myBuffer.data()) + (pMarkPosition - myFlushedSize);
+	}
+
+	char* SerializationWriter::PopMark(size_t pMarkPosition, size_t pReservedSize, size_t pUsedSize)
+	{
+		DIRE_ASSERT(pUsedSize <= pReservedSize);
+		char* markBytes = PopMark(pMarkPosition);
+
+		// Nothing after the oldest mark has been flushed yet, so all that follows this mark is still in the staging block.
+		const size_t unusedSize = pReservedSize - pUsedSize;
+		if (unusedSize != 0)
+		{
+			char* stagingEnd = reinterpret_cast<char*>(myBuffer.data()) + myUsedSize;
+			char* followingBytes = markBytes + pReservedSize;
+			memmove(markBytes + pUsedSize, followingBytes, static_cast<size_t>(stagingEnd - followingBytes));
+			myUsedSize -= unusedSize;
+		}
+
+		return markBytes;
+	}
+
+	bool SerializationWriter::Finish()
+	{
+		if (mySink != nullptr)
+		{
+			FlushStaging();
+		}
+
+		return !myHasFailed;
+	}
+
+	SerializationWriter::ByteVector SerializationWriter::TakeBytes()
+	{
+		DIRE_ASSERT(mySink == nullptr);
+		myBuffer.resize(myUsedSize);
+		myUsedSize = 0;
+		return std::move(myBuffer);
+	}
+
+	void SerializationWriter::MakeRoom(size_t pNbBytes)
+	{
+		if (mySink != nullptr)
+		{
+			FlushStaging();
+			if (pNbBytes <= myBuffer.size() - myUsedSize)
+				return;
+
+			// Only marked bytes are left in the staging block: it has to grow.
+			DIRE_ASSERT(myMarkCount != 0 || pNbBytes <= MIN_STAGING_SIZE);
+		}
+
+		myBuffer.resize(std::max({ myBuffer.size() * 2, myUsedSize + pNbBytes, MIN_STAGING_SIZE }));
+	}
+
+	void SerializationWriter::FlushStaging()
+	{
+		// Marked bytes (and everything after them) have to stay.
+		const size_t flushedSize = (myMarkCount != 0 ? myOldestMarkPosition - myFlushedSize : myUsedSize);
+		if (flushedSize == 0)
+			return;
+
+		// After a failure, keep on consuming the staged bytes so that memory stays bounded until the serialization ends.
+		if (!myHasFailed && !mySink->Write(reinterpret_cast<const char*>(myBuffer.data()), flushedSize))
+		{
+			myHasFailed = true;
+		}
+
+		if (flushedSize != myUsedSize)
+		{
+			memmove(myBuffer.data(), myBuffer.data() + flushedSize, myUsedSize - flushedSize);
+		}
+
+		myFlushedSize += flushedSize;
+		myUsedSize -= flushedSize;
+	}
+}
+#endif
@@ -0,0 +1,251 @@
+#pragma once
+#include "DireDefines.h"
+
+#ifdef DIRE_SERIALIZATION_ENABLED
+#include "dire/Utils/DireString.h"
+
+#include <cstddef> // byte, size_t
+#include <vector>
+
+namespace DIRE_NS
+{
+	/**
+	 * \brief Destination of the bytes produced by a serializer, which hands them over piece by piece as it goes
+	 * instead of building the whole serialized data in memory first.
+	 */
+	class Dire_EXPORT ISerializationSink
+	{
+	public:
+		ISerializationSink() = default;
+		virtual ~ISerializationSink() = default;
+		ISerializationSink(const ISerializationSink&) = default;
+		ISerializationSink& operator=(const ISerializationSink&) = default;
+
+		/**
+		 * \brief Consumes the next bytes of the serialized data.
+		 * \param pBytes The bytes
+		 * \param pNbBytes The number of bytes
+		 * \return false if the sink could not take all the bytes: the serialization then fails.
+		 */
+		virtual bool	Write(const char* pBytes, size_t pNbBytes) = 0;
+	};
+
+	/**
+	 * \brief Writes to a file descriptor (a file, a pipe, a socket...) opened by the user. The sink does not close it.
+	 */
+	class Dire_EXPORT FileDescriptorSink : public ISerializationSink
+	{
+	public:
+		explicit FileDescriptorSink(int pFileDescriptor) :
+			myFileDescriptor(pFileDescriptor)
+		{}
+
+		bool	Write(const char* pBytes, size_t pNbBytes) override;
+
+	protected:
+		[[nodiscard]] int	GetFileDescriptor() const { return myFileDescriptor; }
+
+		void	SetFileDescriptor(int pFileDescriptor) { myFileDescriptor = pFileDescriptor; }
+
+	private:
+		int	myFileDescriptor = -1;
+	};
+
+	/**
+	 * \brief Creates (or truncates) a file and writes to it. The file is closed when the sink is destroyed.
+	 */
+	class Dire_EXPORT FileSink : public FileDescriptorSink
+	{
+	public:
+		explicit FileSink(DIRE_STRING_VIEW pFilePath);
+
+		~FileSink() override;
+
+		FileSink(const FileSink&) = delete;
+		FileSink& operator=(const FileSink&) = delete;
+
+		[[nodiscard]] bool	IsOpen() const { return GetFileDescriptor() != -1; }
+
+		/**
+		 * \brief Closes the file before the sink is destroyed.
+		 * \return false if the file could not be closed properly, in which case its content may be incomplete
+		 */
+		bool	Close();
+	};
+
+	/**
+	 * \brief Writes to a buffer provided by the user. Running out of space makes the serialization fail.
+	 */
+	class Dire_EXPORT FixedBufferSink : public ISerializationSink
+	{
+	public:
+		FixedBufferSink(char* pBuffer, size_t pCapacity) :
+			myBuffer(pBuffer), myCapacity(pCapacity)
+		{}
+
+		bool	Write(const char* pBytes, size_t pNbBytes) override;
+
+		[[nodiscard]] size_t	GetSize() const { return mySize; }
+
+		void	Clear() { mySize = 0; }
+
+	private:
+		char*	myBuffer = nullptr;
+		size_t	myCapacity = 0;
+		size_t	mySize = 0;
+	};
+
+	/**
+	 * \brief Writes to a list of fixed-size chunks allocated as needed.
+	 * Unlike a single growing buffer, written bytes are never moved again and no more than a chunk is ever left unused.
+	 */
+	class Dire_EXPORT ChunkedBufferSink : public ISerializationSink
+	{
+	public:
+		using Chunk = std::vector<std::byte, DIRE_ALLOCATOR<std::byte>>;
+		using ChunkList = std::vector<Chunk, DIRE_ALLOCATOR<Chunk>>;
+
+		static constexpr size_t	DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+		explicit ChunkedBufferSink(size_t pChunkSize = DEFAULT_CHUNK_SIZE);
+
+		bool	Write(const char* pBytes, size_t pNbBytes) override;
+
+		[[nodiscard]] const ChunkList&	GetChunks() const { return myChunks; }
+
+		[[nodiscard]] size_t	GetSize() const { return mySize; }
+
+		void	Clear();
+
+	private:
+		ChunkList	myChunks;
+		size_t		myChunkSize = DEFAULT_CHUNK_SIZE;
+		size_t		mySize = 0;
+	};
+
+	/**
+	 * \brief Forwards the bytes to a user function (to compress them, send them over the network...).
+	 */
+	class Dire_EXPORT CallbackSink : public ISerializationSink
+	{
+	public:
+		using Callback = bool (*)(void* pUserData, const char* pBytes, size_t pNbBytes);
+
+		CallbackSink(Callback pCallback, void* pUserData) :
+			myCallback(pCallback), myUserData(pUserData)
+		{}
+
+		bool	Write(const char* pBytes, size_t pNbBytes) override;
+
+	private:
+		Callback	myCallback = nullptr;
+		void*		myUserData = nullptr;
+	};
+
+	/**
+	 * \brief The output of the serializers.
+	 * Without a sink, bytes accumulate in a buffer that grows as needed, and that is moved out of the writer at the end.
+	 * With a sink, the buffer is a staging block of bounded size, handed over to the sink every time it is full:
+	 * memory usage stays the same whatever the size of the serialized data.
+	 * Writes bigger than the staging block go straight to the sink.
+	 * Marks keep bytes in the writer until they are filled (like a length prefix, only known once what follows is written):
+	 * while a mark is pushed, nothing from it onwards is handed over to the sink, and the staging block grows if needed.
+	 */
+	class Dire_EXPORT SerializationWriter
+	{
+	public:
+		using ByteVector = std::vector<std::byte, DIRE_ALLOCATOR<std::byte>>;
+
+		static constexpr size_t	DEFAULT_STAGING_SIZE = 64 * 1024;
+		static constexpr size_t	MIN_STAGING_SIZE = 256; // so that headers always fit in the staging block
+
+		/**
+		 * \brief Starts a new output.
+		 * \param pSink The sink to write to, or nullptr to write into the writer buffer
+		 * \param pStagingSize The staging block size when writing to a sink
+		 */
+		void	Reset(ISerializationSink* pSink = nullptr, size_t pStagingSize = DEFAULT_STAGING_SIZE);
+
+		/**
+		 * \brief Returns the address of the next pNbBytes bytes of output, to be filled by the caller.
+		 * When writing to a sink, pNbBytes cannot be bigger than MIN_STAGING_SIZE.
+		 */
+		char*	Reserve(size_t pNbBytes)
+		{
+			if (pNbBytes > myBuffer.size() - myUsedSize)
+			{
+				MakeRoom(pNbBytes);
+			}
+
+			char* reserved = reinterpret_cast<char*>(myBuffer.data()) + myUsedSize;
+			myUsedSize += pNbBytes;
+			return reserved;
+		}
+
+		/**
+		 * \brief Gives back the last pNbBytes reserved bytes, when fewer bytes than reserved were eventually needed.
+		 */
+		void	Unreserve(size_t pNbBytes)
+		{
+			DIRE_ASSERT(pNbBytes <= myUsedSize);
+			myUsedSize -= pNbBytes;
+		}
+
+		void	Put(char pChar)
+		{
+			*Reserve(1) = pChar;
+		}
+
+		void	Write(const char* pBytes, size_t pNbBytes);
+
+		/**
+		 * \brief Reserves pNbBytes bytes to be filled later, when popping the mark. Marks are popped in the reverse order they are pushed.
+		 * \return The position of the reserved bytes in the output
+		 */
+		size_t	PushMark(size_t pNbBytes);
+
+		/**
+		 * \brief Releases the last pushed mark.
+		 * \param pMarkPosition The position returned by PushMark
+		 * \return The address of the reserved bytes, to fill them. It is only valid until the next write.
+		 */
+		char*	PopMark(size_t pMarkPosition);
+
+		/**
+		 * \brief Releases the last pushed mark, keeping only the first pUsedSize of its pReservedSize bytes:
+		 * what was written after the mark is moved back to follow them.
+		 * \param pMarkPosition The position returned by PushMark
+		 * \return The address of the kept reserved bytes, to fill them. It is only valid until the next write.
+		 */
+		char*	PopMark(size_t pMarkPosition, size_t pReservedSize, size_t pUsedSize);
+
+		/**
+		 * \brief Hands the remaining staged bytes over to the sink, if any.
+		 * \return false if the sink refused some bytes
+		 */
+		bool	Finish();
+
+		/**
+		 * \brief Moves the output out of the writer, when not writing to a sink.
+		 */
+		[[nodiscard]] ByteVector	TakeBytes();
+
+		[[nodiscard]] bool	HasFailed() const { return myHasFailed; }
+
+		[[nodiscard]] size_t	GetWrittenSize() const { return myFlushedSize + myUsedSize; }
+
+	private:
+		void	MakeRoom(size_t pNbBytes);
+
+		void	FlushStaging();
+
+		ByteVector			myBuffer;
+		ISerializationSink*	mySink = nullptr;
+		size_t				myUsedSize = 0;
+		size_t				myFlushedSize = 0;
+		size_t				myMarkCount = 0;
+		size_t				myOldestMarkPosition = 0;
+		bool				myHasFailed = false;
+	};
+}
+#endif
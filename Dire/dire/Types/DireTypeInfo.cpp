@@ -1,7 +1,35 @@
 #include "DireTypeInfo.h"
 #include "dire/DireReflectable.h"
 #include <cstddef> // byte
-#include <algorithm> // find_if
+#include <mutex>
+
+namespace
+{
+	// Serializes the changes to the structure of types (hierarchies, properties, functions) and the cache builds,
+	// so that a cache is never built from a type being changed.
+	std::mutex	theRegistrationMutex;
+
+	DIRE_NS::TypeInfoCache*	AllocateCache(const DIRE_NS::TypeInfo& pTypeInfo)
+	{
+		DIRE_ALLOCATOR<DIRE_NS::TypeInfoCache> allocator;
+		DIRE_NS::TypeInfoCache* cache = allocator.allocate(1);
+		DIRE_ASSERT(cache != nullptr);
+		using traits_t = std::allocator_traits<DIRE_ALLOCATOR<DIRE_NS::TypeInfoCache>>;
+		traits_t::construct(allocator, cache, pTypeInfo);
+		return cache;
+	}
+
+	void	FreeCache(DIRE_NS::TypeInfoCache* pCache)
+	{
+		if (pCache == nullptr)
+			return;
+
+		DIRE_ALLOCATOR<DIRE_NS::TypeInfoCache> allocator;
+		using traits_t = std::allocator_traits<DIRE_ALLOCATOR<DIRE_NS::TypeInfoCache>>;
+		traits_t::destroy(allocator, pCache);
+		allocator.deallocate(pCache, 1);
+	}
+}
 
 bool dire::TypeInfo::IsParentOf(const dire::ReflectableID pChildClassID, bool pIncludingMyself) const
 {
@@ -11,111 +39,180 @@ bool dire::TypeInfo::IsParentOf(const dire::ReflectableID pChildClassID, bool pI
 		return pIncludingMyself;
 	}
 
-	auto predicate = [pChildClassID](const TypeInfo* pChildTypeInfo)
-	{
-		return pChildTypeInfo->myReflectableID == pChildClassID;
-	};
+	const TypeInfo* childTypeInfo = TypeInfoDatabase::GetSingleton().GetTypeInfo(pChildClassID);
+	return (childTypeInfo != nullptr && IsParentOf(*childTypeInfo, pIncludingMyself));
+}
 
-	return std::find_if(myChildrenClasses.begin(), myChildrenClasses.end(), predicate) != myChildrenClasses.end();
+DIRE_NS::TypeInfo::TypeInfo(const char* pTypename, TypeInfoDatabase& pDatabase) :
+	TypeInfo(pTypename, DeferredRegistration{})
+{
+	Register(pDatabase);
 }
 
-dire::TypeInfo::ParentPropertyInfo dire::TypeInfo::FindParentClassProperty(const std::string_view& pName) const
+void DIRE_NS::TypeInfo::Register(TypeInfoDatabase& pDatabase)
 {
-	for (const TypeInfo* parentClass : myParentClasses)
 	{
-		const PropertyTypeInfo* foundProp = parentClass->FindProperty(pName);
-		if (foundProp != nullptr)
+		std::lock_guard<std::mutex> lock(theRegistrationMutex);
+		for (TypeInfo* parent : myParentClasses)
 		{
-			return { parentClass, foundProp };
+			parent->myChildrenClasses.push_back(this);
 		}
+		NumberHierarchy();
 	}
 
-	return { nullptr, nullptr };
+	pDatabase.RegisterTypeInfo(this); // gives it its ID
 }
 
-const dire::PropertyTypeInfo* dire::TypeInfo::FindProperty(const std::string_view& pName) const
+void DIRE_NS::TypeInfo::PushTypeInfo(PropertyTypeInfo& pNewTypeInfo)
+{
+	std::lock_guard<std::mutex> lock(theRegistrationMutex);
+	myProperties.PushBackNewNode(pNewTypeInfo);
+	InvalidateCache();
+}
+
+void DIRE_NS::TypeInfo::PushFunctionInfo(FunctionInfo& pNewFunctionInfo)
+{
+	std::lock_guard<std::mutex> lock(theRegistrationMutex);
+	myMemberFunctions.PushBackNewNode(pNewFunctionInfo);
+	InvalidateCache();
+}
+
+void DIRE_NS::TypeInfo::AddParentClass(TypeInfo* pParent)
+{
+	std::lock_guard<std::mutex> lock(theRegistrationMutex);
+	myParentClasses.push_back(pParent);
+	InvalidateCache();
+}
+
+void DIRE_NS::TypeInfo::AddChildClass(TypeInfo* pChild)
+{
+	std::lock_guard<std::mutex> lock(theRegistrationMutex);
+	myChildrenClasses.push_back(pChild);
+}
+
+void DIRE_NS::TypeInfo::NumberHierarchy()
 {
-	for (const auto& prop : myProperties)
+	// The last parent of a type is the root of its hierarchy, and the children list holds all the descendants, not only the direct children.
+	TypeInfo& root = (myParentClasses.empty() ? *this : *myParentClasses.back());
+
+	// A seqlock: readers retry if the version is odd, or changed while they read.
+	// The indices are stored with release semantics, so that a reader seeing a new index also sees the odd version.
+	const uint32_t version = root.myHierarchyVersion.load(std::memory_order_relaxed);
+	root.myHierarchyVersion.store(version + 1, std::memory_order_relaxed);
+
+	const size_t endIndex = root.NumberSubHierarchy(0);
+	DIRE_ASSERT(endIndex == 1 + root.myChildrenClasses.size());
+	(void)endIndex;
+
+	root.myHierarchyVersion.store(version + 2, std::memory_order_release);
+}
+
+size_t DIRE_NS::TypeInfo::NumberSubHierarchy(size_t pIndex)
+{
+	myHierarchyIndex.store(pIndex++, std::memory_order_release);
+
+	for (TypeInfo* child : myChildrenClasses)
 	{
-		if (prop.GetName() == pName)
+		// The first parent of a type is its direct parent.
+		if (child->myParentClasses.front() == this)
 		{
-			return &prop;
+			pIndex = child->NumberSubHierarchy(pIndex);
 		}
 	}
 
-	return nullptr;
+	myHierarchyLastIndex.store(pIndex - 1, std::memory_order_release);
+	return pIndex;
+}
+
+dire::TypeInfo::ParentPropertyInfo dire::TypeInfo::FindParentClassProperty(const std::string_view& pName) const
+{
+	return GetCache().FindProperty(pName, TypeInfoCache::LookupScope::Parents);
+}
+
+const dire::PropertyTypeInfo* dire::TypeInfo::FindProperty(const std::string_view& pName) const
+{
+	return GetCache().FindProperty(pName, TypeInfoCache::LookupScope::Self).second;
 }
 
 const dire::PropertyTypeInfo* dire::TypeInfo::FindPropertyInHierarchy(const std::string_view& pName) const
 {
-	for (auto const& prop : myProperties)
-	{
-		if (prop.GetName() == pName)
-		{
-			return &prop;
-		}
-	}
+	return GetCache().FindProperty(pName, TypeInfoCache::LookupScope::Hierarchy).second;
+}
 
-	// Maybe in the parent classes?
-	auto [parentClass, parentProperty] = FindParentClassProperty(pName);
-	if (parentClass != nullptr && parentProperty != nullptr) // A parent property was found
+dire::FunctionInfo const* dire::TypeInfo::FindFunction(const std::string_view& pFuncName) const
+{
+	return GetCache().FindFunction(pFuncName, TypeInfoCache::LookupScope::Self).second;
+}
+
+dire::TypeInfo::ParentFunctionInfo dire::TypeInfo::FindParentFunction(const std::string_view& pFuncName) const
+{
+	return GetCache().FindFunction(pFuncName, TypeInfoCache::LookupScope::Parents);
+}
+
+dire::FunctionInfo const* dire::TypeInfo::FindFunctionInHierarchy(const std::string_view& pFuncName) const
+{
+	return GetCache().FindFunction(pFuncName, TypeInfoCache::LookupScope::Hierarchy).second;
+}
+
+DIRE_NS::TypeInfo::~TypeInfo()
+{
+	FreeCache(myCache.exchange(nullptr));
+	for (TypeInfoCache* retiredCache : myRetiredCaches)
 	{
-		return parentProperty;
+		FreeCache(retiredCache);
 	}
-
-	return nullptr;
 }
 
-dire::FunctionInfo const* dire::TypeInfo::FindFunction(const std::string_view& pFuncName) const
+const DIRE_NS::TypeInfoCache& DIRE_NS::TypeInfo::GetCache() const
 {
-	for (FunctionInfo const& aFuncInfo : myMemberFunctions)
+	TypeInfoCache* cache = myCache.load(std::memory_order_acquire);
+	if (cache == nullptr)
 	{
-		if (aFuncInfo.GetName() == pFuncName)
+		// Built under the registration lock, so that a type cannot change while its cache is built: an invalidation never misses a cache.
+		std::lock_guard<std::mutex> lock(theRegistrationMutex);
+		cache = myCache.load(std::memory_order_acquire);
+		if (cache == nullptr)
 		{
-			return &aFuncInfo;
+			cache = AllocateCache(*this);
+			myCache.store(cache, std::memory_order_release);
 		}
 	}
 
-	return nullptr;
+	return *cache;
 }
 
-dire::TypeInfo::ParentFunctionInfo dire::TypeInfo::FindParentFunction(const std::string_view& pFuncName) const
+void DIRE_NS::TypeInfo::InvalidateCache()
 {
-	for (const TypeInfo* parentClass : myParentClasses)
+	auto retireCache = [](TypeInfo& pTypeInfo)
 	{
-		const FunctionInfo* foundFunc = parentClass->FindFunction(pFuncName);
-		if (foundFunc != nullptr)
+		TypeInfoCache* oldCache = pTypeInfo.myCache.exchange(nullptr, std::memory_order_acq_rel);
+		if (oldCache != nullptr)
 		{
-			return { parentClass, foundFunc };
+			pTypeInfo.myRetiredCaches.push_back(oldCache);
 		}
-	}
+	};
 
-	return {};
-}
+	retireCache(*this);
 
-void DIRE_NS::TypeInfo::CloneHierarchyPropertiesOf(Reflectable& pNewClone, const Reflectable& pCloned) const
-{
-	for (auto rit = myParentClasses.rbegin(); rit != myParentClasses.rend(); ++rit)
+	// The children list holds all the descendants: the grandchildren are invalidated too.
+	for (TypeInfo* child : myChildrenClasses)
 	{
-		(*rit)->ClonePropertiesOf(pNewClone, pCloned);
+		retireCache(*child);
 	}
+}
 
-	ClonePropertiesOf(pNewClone, pCloned);
+void DIRE_NS::TypeInfo::CloneHierarchyPropertiesOf(Reflectable& pNewClone, const Reflectable& pCloned) const
+{
+	GetCache().GetCopyPlan().Copy(&pNewClone, &pCloned);
 }
 
 void DIRE_NS::TypeInfo::ClonePropertiesOf(Reflectable& pNewClone, const Reflectable& pCloned) const
 {
 	for (const PropertyTypeInfo& prop : myProperties)
 	{
-		Reflectable::PropertyAccessor<void> accessor = pCloned.GetProperty(prop.GetName());
-		const void* propPtr = accessor.GetPointer();
-		if (propPtr != nullptr)
+		if (prop.GetCopyConstructorFunction() != nullptr)
 		{
-			auto actualOffset = reinterpret_cast<const std::byte *>(propPtr) - reinterpret_cast<const std::byte*>(&pCloned);
-			if (prop.GetCopyConstructorFunction() != nullptr)
-			{
-				prop.GetCopyConstructorFunction()(&pNewClone, &pCloned, size_t(actualOffset));
-			}
+			prop.GetCopyConstructorFunction()(&pNewClone, &pCloned, prop.GetOffset());
 		}
 	}
 }
@@ -2,15 +2,23 @@
 
 #include "DireDefines.h"
 #include "dire/Utils/DireIntrusiveList.h"
+#include "dire/Utils/DireMacros.h"
 #include "dire/Utils/DireString.h"
 #include "dire/Handlers/DireTypeHandlers.h"
 #include "dire/Types/DireTypes.h"
 
 #include "DireTypeInfoDatabase.h"
+#include "DireTypeInfoCache.h"
+#include "DireTypeStats.h"
 
 #include "dire/DireReflectableID.h"
 
 #include <any>
+#include <atomic>
+#include <cstddef> // byte, max_align_t
+#include <cstring> // memcpy
+#include <memory> // addressof
+#include <utility> // index_sequence
 #include <vector>
 
 namespace DIRE_NS
@@ -58,6 +66,11 @@ namespace DIRE_NS
 
 		[[nodiscard]] CopyConstructorPtr		GetCopyConstructorFunction() const { return myCopyCtor; }
 
+		/**
+		 * \brief True if the property can be copied with a plain memcpy of GetSize() bytes.
+		 */
+		[[nodiscard]] bool						IsTriviallyCopyable() const { return myIsTriviallyCopyable; }
+
 #ifdef DIRE_SERIALIZATION_ENABLED
 		 virtual void	SerializeAttributes(class ISerializer& pSerializer) const = 0;
 
@@ -68,6 +81,11 @@ namespace DIRE_NS
 		};
 
 		 virtual SerializationState	GetSerializableState() const = 0;
+
+		/**
+		 * \brief The name under which serializers write the metadata of the property ("<name>_metadata"), built at compile time.
+		 */
+		[[nodiscard]] const DIRE_STRING_VIEW&	GetMetadataName() const { return myMetadataName; }
 #endif
 
 	protected:
@@ -92,6 +110,13 @@ namespace DIRE_NS
 			myMetatype = pType;
 		}
 
+#ifdef DIRE_SERIALIZATION_ENABLED
+		void	SetMetadataName(const char* pMetadataName)
+		{
+			myMetadataName = pMetadataName;
+		}
+#endif
+
 	private:
 
 		DIRE_STRING_VIEW		myName;
@@ -100,10 +125,15 @@ namespace DIRE_NS
 		std::size_t				mySize;
 		DataStructureHandler	myDataStructurePropertyHandler; // Useful for array-like or associative data structures, will stay null for other types.
 		CopyConstructorPtr		myCopyCtor = nullptr; // if null : this type is not copy-constructible
+		bool					myIsTriviallyCopyable = false;
 
 		// Storing the reflectable ID here could be considered a kind of hack.
 		// But given that it's an unsigned (by default), all other options would basically take more memory than "just" copying it everywhere!...
 		ReflectableID		myReflectableID = INVALID_REFLECTABLE_ID;
+
+#ifdef DIRE_SERIALIZATION_ENABLED
+		DIRE_STRING_VIEW	myMetadataName;
+#endif
 	};
 
 	/**
@@ -116,8 +146,31 @@ namespace DIRE_NS
 		virtual ~IFunctionTypeInfo() = default;
 
 		virtual std::any	Invoke(void* pObject, const std::any & pInvokeParams) const = 0;
+
+		/**
+		 * \brief Invokes the member function without any allocation: arguments are read from a buffer laid out from the parameter list
+		 * (see FunctionInfo::GetParameterOffsets), and the return value is constructed into caller-provided storage.
+		 * \param pObject The object the member function should use as this
+		 * \param pArgumentBuffer The arguments buffer, at least GetArgumentBufferSize() bytes big and aligned on ARGUMENT_BUFFER_ALIGNMENT
+		 * \param pReturnStorage Memory where the return value gets constructed (GetReturnSize() bytes aligned on GetReturnAlignment()),
+		 * or nullptr to discard it. Destroying the constructed value is up to the caller.
+		 */
+		virtual void	InvokeWithBuffer(void* pObject, const void* pArgumentBuffer, void* pReturnStorage) const = 0;
 	};
 
+	/**
+	 * \brief A hash identifying a function signature (e.g. int(float, const Foo&)), stable across translation units and modules
+	 * built with the same compiler since it is computed from the signature spelling.
+	 */
+	template <typename Signature>
+	constexpr String::HashType	GetFunctionSignatureHash()
+	{
+		return String::Hash(DIRE_FUNCTION_FULLNAME);
+	}
+
+	template <typename Signature>
+	class FunctionHandle; // defined in DireFunctionHandle.h (only for function signatures)
+
 	/**
 	 * \brief An abstract type that stores data and defines functions common to all types of function infos.
 	 * Never use directly: use DIRE_FUNCTION or DIRE_FUNCTION_TYPEINFO() macros for that.
@@ -127,11 +180,32 @@ namespace DIRE_NS
 	{
 	public:
 		using ParameterList = std::vector<MetaType, DIRE_ALLOCATOR<MetaType>>;
+		using ParameterOffsetList = std::vector<uint32_t, DIRE_ALLOCATOR<uint32_t>>;
 
-		FunctionInfo(const char* pName, MetaType pReturnType) :
-			Name(pName), ReturnType(pReturnType)
+		static constexpr size_t	ARGUMENT_BUFFER_ALIGNMENT = alignof(std::max_align_t);
+
+		FunctionInfo(const char* pName, MetaType pReturnType, size_t pReturnSize, size_t pReturnAlignment) :
+			Name(pName), ReturnType(pReturnType), ReturnSize(pReturnSize), ReturnAlignment(pReturnAlignment)
 		{}
 
+		/**
+		 * \brief Tells how a parameter is stored in an argument buffer: bool, integer and floating point parameters are stored by value,
+		 * and so are C++ enums, as their underlying integer. All the others (references, objects, containers, Dire enums...)
+		 * are stored as a pointer to the argument.
+		 */
+		static constexpr bool	IsBufferedByValue(MetaType::Values pType)
+		{
+			return GetBufferedSize(pType) != 0;
+		}
+
+		/**
+		 * \brief The size taken by a parameter in an argument buffer. Each parameter is aligned on its size.
+		 */
+		static constexpr size_t	GetBufferedParameterSize(MetaType::Values pType)
+		{
+			return IsBufferedByValue(pType) ? GetBufferedSize(pType) : sizeof(void*);
+		}
+
 		/**
 		 * \brief Allows to invoke the member function while directly providing the arguments of the function (it packs them into std::any for you)
 		 * \tparam Args The arguments variadic pack
@@ -153,22 +227,110 @@ namespace DIRE_NS
 		template <typename Ret, typename... Args>
 		Ret	TypedInvokeWithArgs(void* pCallerObject, Args&&... pFuncArgs) const;
 
-		const DIRE_STRING&		GetName() const { return Name; }
-		MetaType				GetReturnType() const { return ReturnType; }
-		const ParameterList&	GetParametersTypes() const { return Parameters; }
+		/**
+		 * \brief Fills an argument buffer for InvokeWithBuffer, following the parameter list of this function.
+		 * Arguments stored by pointer must outlive the invocation.
+		 * \return false if the number of arguments doesn't match, if a by-value argument cannot be converted to its parameter type,
+		 * or if the metatype of an argument stored by pointer is not the one of its parameter
+		 */
+		template <typename... Args>
+		bool	PackArguments(void* pArgumentBuffer, Args&&... pFuncArgs) const;
+
+		using IFunctionTypeInfo::InvokeWithBuffer;
+
+		const DIRE_STRING&			GetName() const { return Name; }
+		MetaType					GetReturnType() const { return ReturnType; }
+		const ParameterList&		GetParametersTypes() const { return Parameters; }
+
+		/**
+		 * \brief Where each parameter is stored in an argument buffer, in bytes.
+		 */
+		const ParameterOffsetList&	GetParameterOffsets() const { return ParameterOffsets; }
+		size_t						GetArgumentBufferSize() const { return ArgumentBufferSize; }
+
+		/**
+		 * \brief Size and alignment of the storage InvokeWithBuffer needs for the return value (0 for void functions).
+		 * Functions returning a reference store a pointer to the referenced object.
+		 */
+		size_t						GetReturnSize() const { return ReturnSize; }
+		size_t						GetReturnAlignment() const { return ReturnAlignment; }
+
+		/**
+		 * \brief The hash of the exact C++ signature of the function (see GetFunctionSignatureHash).
+		 */
+		String::HashType			GetSignatureHash() const { return SignatureHash; }
 
 	protected:
+		template <typename Signature>
+		friend class FunctionHandle;
+
+		// A pointer to a static function of signature Ret(const FunctionInfo&, void* pObject, Args...) calling the member function.
+		// Stored type-erased, it's only called back by a FunctionHandle after checking SignatureHash.
+		using ErasedThunk = void (*)();
 
-		void	PushBackParameterType(MetaType pNewParamType)
+		void	SetThunk(String::HashType pSignatureHash, ErasedThunk pThunk)
 		{
+			SignatureHash = pSignatureHash;
+			Thunk = pThunk;
+		}
+
+		/**
+		 * \param pNewParamType The metatype of the parameter (Reference for reference parameters)
+		 * \param pValueType The metatype of the value the parameter is or refers to
+		 */
+		void	PushBackParameterType(MetaType pNewParamType, MetaType pValueType)
+		{
+			const size_t paramSize = GetBufferedParameterSize(pNewParamType.Value);
+			const size_t paramOffset = (ArgumentBufferSize + paramSize - 1) & ~(paramSize - 1);
+
 			Parameters.push_back(pNewParamType);
+			ParameterValueTypes.push_back(pValueType);
+			ParameterOffsets.push_back(static_cast<uint32_t>(paramOffset));
+			ArgumentBufferSize = paramOffset + paramSize;
 		}
 
+		template <typename Arg>
+		static bool	WriteArgument(std::byte* pSlot, MetaType::Values pParamType, MetaType::Values pParamValueType, Arg&& pArg);
+
+		template <typename Target, typename Arg>
+		static void	WriteConvertedArgument(std::byte* pSlot, const Arg& pArg);
+
 	private:
 
-		DIRE_STRING		Name;
-		MetaType		ReturnType{ MetaType::Void };
-		ParameterList	Parameters;
+		static constexpr size_t	GetBufferedSize(MetaType::Values pType)
+		{
+			switch (pType)
+			{
+			case MetaType::Bool:
+			case MetaType::Char:
+			case MetaType::UChar:
+				return 1;
+			case MetaType::Short:
+			case MetaType::UShort:
+				return 2;
+			case MetaType::Int:
+			case MetaType::Uint:
+			case MetaType::Float:
+				return 4;
+			case MetaType::Int64:
+			case MetaType::Uint64:
+			case MetaType::Double:
+				return 8;
+			default:
+				return 0; // stored as a pointer
+			}
+		}
+
+		DIRE_STRING			Name;
+		MetaType			ReturnType{ MetaType::Void };
+		ParameterList		Parameters;
+		ParameterList		ParameterValueTypes; // what each parameter is or refers to, to check the arguments stored by pointer
+		ParameterOffsetList	ParameterOffsets;
+		size_t				ArgumentBufferSize = 0;
+		size_t				ReturnSize = 0;
+		size_t				ReturnAlignment = 0;
+		String::HashType	SignatureHash = 0;
+		ErasedThunk			Thunk = nullptr;
 	};
 
 	template <typename Ty >
@@ -190,12 +352,28 @@ namespace DIRE_NS
 		// The idea of using std::apply has been stolen from here : https://stackoverflow.com/a/36656413/1987466
 		std::any	Invoke(void* pObject, std::any const& pInvokeParams) const override;
 
+		void		InvokeWithBuffer(void* pObject, const void* pArgumentBuffer, void* pReturnStorage) const override;
+
 		MemberFunctionSignature	myMemberFunctionPtr = nullptr;
+
+	private:
+		static Ret	CallMemberFunction(const FunctionInfo& pFunction, void* pObject, Args... pArgs);
+		template <size_t... Indices>
+		void	InvokeWithBufferImpl(Class* pObject, const std::byte* pArgumentBuffer, void* pReturnStorage, std::index_sequence<Indices...>) const;
+
+		template <typename Arg>
+		static decltype(auto)	ReadArgument(const std::byte* pSlot);
+
+		static constexpr size_t	GetStoredReturnSize();
+		static constexpr size_t	GetStoredReturnAlignment();
 	};
 
 	template <typename Ret = void, typename T, typename... Args>
 	Ret	Invoke(const DIRE_STRING_VIEW& pFuncName, T& pObject, Args&&... pArgs);
 
+	template <typename T, typename... Args>
+	T*	AllocateReflectable(Args&&... pCtorArgs); // defined in DireReflectable.h
+
 
 
 	class TypeInfo
@@ -203,45 +381,114 @@ namespace DIRE_NS
 	public:
 		using TypeInfoList = std::vector<TypeInfo*, DIRE_ALLOCATOR<TypeInfo*>>;
 
+		/**
+		 * \brief Default-constructs an instance of the type in the provided memory, which must be at least GetTypeSize() bytes big and aligned on GetTypeAlignment().
+		 */
+		using PlacementInstantiateFunction = Reflectable* (*)(void* pMemory);
+
 		explicit TypeInfo(const char* pTypename) :
-			myReflectableID(TypeInfoDatabase::EditSingleton().RegisterTypeInfo(this)),
-			myTypeName(pTypename)
+			TypeInfo(pTypename, TypeInfoDatabase::EditSingleton())
 		{}
 
-		void	PushTypeInfo(PropertyTypeInfo& pNewTypeInfo)
-		{
-			myProperties.PushBackNewNode(pNewTypeInfo);
-		}
+		/**
+		 * \brief Creates a type registered in the given database instead of the singleton.
+		 */
+		Dire_EXPORT TypeInfo(const char* pTypename, TypeInfoDatabase& pDatabase);
 
-		void	PushFunctionInfo(FunctionInfo& pNewFunctionInfo)
-		{
-			myMemberFunctions.PushBackNewNode(pNewFunctionInfo);
-		}
+		Dire_EXPORT ~TypeInfo();
 
-		void	AddParentClass(TypeInfo* pParent)
-		{
-			myParentClasses.push_back(pParent);
-		}
+		TypeInfo(const TypeInfo&) = delete;
+		TypeInfo& operator=(const TypeInfo&) = delete;
 
-		void	AddChildClass(TypeInfo* pChild)
-		{
-			myChildrenClasses.push_back(pChild);
-		}
+		/**
+		 * \brief Adds a property to this type. It can be done while other threads use the type: the caches that depend on it get rebuilt.
+		 */
+		Dire_EXPORT void	PushTypeInfo(PropertyTypeInfo& pNewTypeInfo);
+
+		/**
+		 * \brief Adds a member function to this type. It can be done while other threads use the type: the caches that depend on it get rebuilt.
+		 */
+		Dire_EXPORT void	PushFunctionInfo(FunctionInfo& pNewFunctionInfo);
+
+		/**
+		 * \brief Adds an ancestor to this type, from the direct parent to the root. Only allowed before the type is registered (see Register).
+		 */
+		Dire_EXPORT void	AddParentClass(TypeInfo* pParent);
+
+		Dire_EXPORT void	AddChildClass(TypeInfo* pChild);
 
 		[[nodiscard]] Dire_EXPORT bool					IsParentOf(const ReflectableID pChildClassID, bool pIncludingMyself = true) const;
 
+		/**
+		 * \brief Tells if this type is an ancestor of another, in constant time: a type is the parent of the types whose hierarchy index
+		 * is in its interval. Prefer it over the ID version when the type info is at hand, as it does not have to look the type up.
+		 */
+		[[nodiscard]] bool	IsParentOf(const TypeInfo& pChildTypeInfo, bool pIncludingMyself = true) const
+		{
+			// same logic as std::is_base_of: class is parent of itself (unless we strictly want only children)
+			if (&pChildTypeInfo == this)
+			{
+				return pIncludingMyself;
+			}
+
+			// Each hierarchy is numbered on its own: types of different hierarchies are never related.
+			const TypeInfo& root = GetHierarchyRoot();
+			if (&pChildTypeInfo.GetHierarchyRoot() != &root)
+			{
+				return false;
+			}
+
+			// The hierarchy can be renumbered by a registration on another thread: retry until reading indices of the same numbering.
+			while (true)
+			{
+				const uint32_t version = root.myHierarchyVersion.load(std::memory_order_acquire);
+				if ((version & 1) != 0)
+				{
+					continue; // being renumbered
+				}
+
+				// Acquire loads: reading an index of a new numbering also makes the odd version visible, so the check below fails.
+				const size_t index = myHierarchyIndex.load(std::memory_order_acquire);
+				const size_t lastIndex = myHierarchyLastIndex.load(std::memory_order_acquire);
+				const size_t childIndex = pChildTypeInfo.myHierarchyIndex.load(std::memory_order_acquire);
+
+				if (root.myHierarchyVersion.load(std::memory_order_relaxed) == version)
+				{
+					return (index < childIndex && childIndex <= lastIndex);
+				}
+			}
+		}
+
 		using ParentPropertyInfo = std::pair< const TypeInfo*, const PropertyTypeInfo*>;
 		[[nodiscard]] ParentPropertyInfo				FindParentClassProperty(const DIRE_STRING_VIEW& pName) const;
 
 		[[nodiscard]] const PropertyTypeInfo *			FindProperty(const DIRE_STRING_VIEW& pName) const;
 
-		[[nodiscard]] const PropertyTypeInfo *			FindPropertyInHierarchy(const DIRE_STRING_VIEW& pName) const;
+		[[nodiscard]] Dire_EXPORT const PropertyTypeInfo *	FindPropertyInHierarchy(const DIRE_STRING_VIEW& pName) const;
 
 		[[nodiscard]] Dire_EXPORT const FunctionInfo *	FindFunction(const DIRE_STRING_VIEW& pFuncName) const;
 
 		using ParentFunctionInfo = std::pair<const TypeInfo*, const FunctionInfo*>;
 		[[nodiscard]] ParentFunctionInfo				FindParentFunction(const DIRE_STRING_VIEW& pFuncName) const;
 
+		[[nodiscard]] Dire_EXPORT const FunctionInfo *	FindFunctionInHierarchy(const DIRE_STRING_VIEW& pFuncName) const;
+
+		/**
+		 * \brief Returns the lookup cache of this type, building it if needed.
+		 * It is safe to call concurrently, even while types are registered: the cache stays valid until the type is destroyed,
+		 * but it only knows the properties and functions registered before it was built.
+		 */
+		[[nodiscard]] Dire_EXPORT const TypeInfoCache&	GetCache() const;
+
+		/**
+		 * \brief Returns the flattened properties of the whole class hierarchy, in the same order as ForEachPropertyInHierarchy.
+		 * Prefer it over ForEachPropertyInHierarchy in hot paths, as it reads contiguous memory.
+		 */
+		[[nodiscard]] const PropertyLayout&	GetPropertyLayout() const
+		{
+			return GetCache().GetPropertyLayout();
+		}
+
 		template <typename F>
 		void	ForEachPropertyInHierarchy(F&& pVisitorFunction) const;
 
@@ -250,14 +497,35 @@ namespace DIRE_NS
 			return myTypeName;
 		}
 
+		/**
+		 * \brief Changes the ID of this type. IDs are atomic, as importing a database changes them while other threads may look types up.
+		 */
 		void	SetID(const ReflectableID pNewID)
 		{
-			myReflectableID = pNewID;
+			myReflectableID.store(pNewID, std::memory_order_relaxed);
 		}
 
 		[[nodiscard]] ReflectableID	GetID() const
 		{
-			return myReflectableID;
+			return myReflectableID.load(std::memory_order_relaxed);
+		}
+
+		[[nodiscard]] size_t	GetTypeSize() const
+		{
+			return myTypeSize;
+		}
+
+		[[nodiscard]] size_t	GetTypeAlignment() const
+		{
+			return myTypeAlignment;
+		}
+
+		/**
+		 * \brief Returns the function constructing this type in place, or nullptr if it is not default constructible.
+		 */
+		[[nodiscard]] PlacementInstantiateFunction	GetPlacementInstantiator() const
+		{
+			return myPlacementInstantiator;
 		}
 
 		Dire_EXPORT void	CloneHierarchyPropertiesOf(Reflectable& pNewClone, const Reflectable& pCloned) const;
@@ -279,20 +547,97 @@ namespace DIRE_NS
 			return myParentClasses;
 		}
 
+		/**
+		 * \brief Returns all the descendants of this type, not only the direct children. Not to be used while types are registered.
+		 */
 		[[nodiscard]] const TypeInfoList& GetChildrenClasses() const
 		{
 			return myChildrenClasses;
 		}
 
+#ifdef DIRE_STATS_ENABLED
+		/**
+		 * \brief Returns the counters of this type. They can be incremented on a const type info, from any thread.
+		 */
+		[[nodiscard]] TypeStats&	GetStats() const
+		{
+			return myStats;
+		}
+#endif
+
 	protected:
-		ReflectableID							myReflectableID = INVALID_REFLECTABLE_ID;
+		struct DeferredRegistration {};
+
+		/**
+		 * \brief Creates a type that is not registered yet, so that it can be completed before other threads see it. Call Register when done.
+		 */
+		TypeInfo(const char* pTypename, DeferredRegistration) :
+			myTypeName(pTypename)
+		{}
+
+		/**
+		 * \brief Links this type to its parents, numbers its hierarchy and publishes it in the database, which gives it its ID.
+		 */
+		Dire_EXPORT void	Register(TypeInfoDatabase& pDatabase);
+
+		/**
+		 * \brief Throws away the cache of this type and of all its descendants, because they depend on the data of this type.
+		 * The old caches are only freed with the type, as other threads may still be reading them.
+		 * Has to be called with the registration lock held.
+		 */
+		void	InvalidateCache();
+
+		/**
+		 * \brief Returns the type at the top of the hierarchy of this type. The parents of a registered type never change, so neither does its root.
+		 */
+		[[nodiscard]] const TypeInfo&	GetHierarchyRoot() const
+		{
+			return (myParentClasses.empty() ? *this : *myParentClasses.back());
+		}
+
+		/**
+		 * \brief Gives new hierarchy indices to all the types of the hierarchy of this type, from its root, in pre-order:
+		 * the indices of the children of a type follow its own, so that they make an interval.
+		 * Readers of the indices are kept consistent by the version of the root, which is odd while renumbering.
+		 * Has to be called with the registration lock held, every time a type is added to a hierarchy.
+		 */
+		void	NumberHierarchy();
+
+		/**
+		 * \brief Numbers a type, then its direct children recursively.
+		 * \return The next index to give
+		 */
+		size_t	NumberSubHierarchy(size_t pIndex);
+
+		std::atomic<ReflectableID>				myReflectableID{ INVALID_REFLECTABLE_ID };
 		DIRE_STRING_VIEW						myTypeName;
 		IntrusiveLinkedList<PropertyTypeInfo>	myProperties;
 		IntrusiveLinkedList<FunctionInfo>		myMemberFunctions;
 		TypeInfoList							myParentClasses;
 		TypeInfoList							myChildrenClasses;
+		size_t									myTypeSize = 0;
+		size_t									myTypeAlignment = 0;
+		PlacementInstantiateFunction			myPlacementInstantiator = nullptr;
+		std::atomic<size_t>						myHierarchyIndex{ 0 }; // this type and its children are numbered from myHierarchyIndex to myHierarchyLastIndex
+		std::atomic<size_t>						myHierarchyLastIndex{ 0 };
+		std::atomic<uint32_t>					myHierarchyVersion{ 0 }; // only used on roots
+		mutable std::atomic<TypeInfoCache*>		myCache{ nullptr };
+		std::vector<TypeInfoCache*, DIRE_ALLOCATOR<TypeInfoCache*>>	myRetiredCaches; // under the registration lock
+#ifdef DIRE_STATS_ENABLED
+		mutable TypeStats						myStats;
+#endif
 	};
 
+#ifdef DIRE_STATS_ENABLED
+	inline void	AddTypeStat(const TypeInfo* pTypeInfo, TypeCounter pCounter, uint64_t pValue)
+	{
+		if (pTypeInfo != nullptr)
+		{
+			pTypeInfo->GetStats().Add(pCounter, pValue);
+		}
+	}
+#endif
+
 	/**
 	 * \brief The metadata type declared by DIRE_TYPE_INFO and DIRE_REFLECTABLE_INFO. Never use directly, always use one these two macros.
 	 * The boolean parameter lets you decide if this class should use its default constructor as an instantiator function. DIRE's default is true.
@@ -312,6 +657,13 @@ namespace DIRE_NS
 
 }
 
+// Counts an event for a type (a TypeCounter name) when DIRE_STATS_ENABLED is on, and compiles to nothing otherwise.
+#ifdef DIRE_STATS_ENABLED
+	#define DIRE_STATS_ADD(pTypeInfo, pCounter, pValue) ::DIRE_NS::AddTypeStat((pTypeInfo), ::DIRE_NS::TypeCounter::pCounter, (pValue))
+#else
+	#define DIRE_STATS_ADD(pTypeInfo, pCounter, pValue) ((void)0)
+#endif
+
 #include "DireTypeInfo.inl"
 
 #define DIRE_LPAREN (
@@ -326,7 +678,7 @@ namespace DIRE_NS
 #define DIRE_UNPAREN(...) DIRE_EVALUATING_PASTE(DIRE_NOTHING_, DIRE_EXTRACT __VA_ARGS__)
 
 #define DIRE_FUNCTION_TYPEINFO(Name) \
-	inline static DIRE_NS::TypedFunctionInfo<decltype(&Self::Name)> Name##_TYPEINFO{ &Self::Name, DIRE_STRINGIZE(Name)};
+	inline static ::DIRE_NS::TypedFunctionInfo<decltype(&Self::Name)> Name##_TYPEINFO{ &Self::Name, DIRE_STRINGIZE(Name)};
 
 #define DIRE_FUNCTION(RetType, Name, ...) \
 	RetType Name DIRE_LPAREN DIRE_UNPAREN(__VA_ARGS__) DIRE_RPAREN ; \
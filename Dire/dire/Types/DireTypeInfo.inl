@@ -11,6 +11,11 @@ namespace DIRE_NS
 	{
 		const TypeInfo& theClassReflector = T::EditTypeInfo();
 		const FunctionInfo* funcInfo = theClassReflector.FindFunction(pFuncName);
+		if (funcInfo != nullptr)
+		{
+			DIRE_STATS_ADD(&theClassReflector, FunctionInvocations, 1);
+		}
+
 		if constexpr (std::is_void_v<Ret>)
 		{
 			if (funcInfo != nullptr)
@@ -61,6 +66,7 @@ namespace DIRE_NS
 	{
 		if constexpr (std::is_trivially_copyable_v<TProp>)
 		{
+			myIsTriviallyCopyable = true;
 			myCopyCtor = [](void* pDestAddr, void const* pSrc, size_t pOffset)
 			{
 				memcpy((std::byte*)pDestAddr + pOffset, (std::byte const*)pSrc + pOffset, sizeof(TProp));
@@ -111,16 +117,94 @@ namespace DIRE_NS
 		}
 	}
 
+	template <typename... Args>
+	bool FunctionInfo::PackArguments(void* pArgumentBuffer, Args&&... pFuncArgs) const
+	{
+		if (sizeof...(Args) != Parameters.size())
+		{
+			return false;
+		}
+
+		std::byte* buffer = static_cast<std::byte*>(pArgumentBuffer);
+		size_t iParam = 0;
+		auto writeNextArgument = [&](auto&& pArg)
+		{
+			const size_t iCurrentParam = iParam++;
+			return WriteArgument(buffer + ParameterOffsets[iCurrentParam], Parameters[iCurrentParam].Value, ParameterValueTypes[iCurrentParam].Value,
+				std::forward<decltype(pArg)>(pArg));
+		};
+		const bool packed = (true && ... && writeNextArgument(std::forward<Args>(pFuncArgs)));
+		return packed;
+	}
+
+	template <typename Arg>
+	bool FunctionInfo::WriteArgument(std::byte* pSlot, MetaType::Values pParamType, MetaType::Values pParamValueType, Arg&& pArg)
+	{
+		if (!IsBufferedByValue(pParamType))
+		{
+			// The function reads the argument through the pointer as it is: it has to be of the kind the parameter expects.
+			if (FromActualTypeToEnumType<std::decay_t<Arg>>::EnumType != pParamValueType)
+				return false;
+
+			const void* argAddress = std::addressof(pArg);
+			memcpy(pSlot, &argAddress, sizeof(argAddress));
+			return true;
+		}
+
+		using ArgType = std::decay_t<Arg>;
+		if constexpr (std::is_arithmetic_v<ArgType> || std::is_enum_v<ArgType>)
+		{
+			switch (pParamType)
+			{
+			case MetaType::Bool:	WriteConvertedArgument<bool>(pSlot, pArg); break;
+			case MetaType::Char:	WriteConvertedArgument<char>(pSlot, pArg); break;
+			case MetaType::UChar:	WriteConvertedArgument<unsigned char>(pSlot, pArg); break;
+			case MetaType::Short:	WriteConvertedArgument<short>(pSlot, pArg); break;
+			case MetaType::UShort:	WriteConvertedArgument<unsigned short>(pSlot, pArg); break;
+			case MetaType::Int:		WriteConvertedArgument<int>(pSlot, pArg); break;
+			case MetaType::Uint:	WriteConvertedArgument<unsigned>(pSlot, pArg); break;
+			case MetaType::Float:	WriteConvertedArgument<float>(pSlot, pArg); break;
+			case MetaType::Int64:	WriteConvertedArgument<int64_t>(pSlot, pArg); break;
+			case MetaType::Uint64:	WriteConvertedArgument<uint64_t>(pSlot, pArg); break;
+			case MetaType::Double:	WriteConvertedArgument<double>(pSlot, pArg); break;
+			default:
+				return false;
+			}
+			return true;
+		}
+		else
+		{
+			return false; // a bool, integer or floating point parameter cannot be built from this argument
+		}
+	}
+
+	template <typename Target, typename Arg>
+	void FunctionInfo::WriteConvertedArgument(std::byte* pSlot, const Arg& pArg)
+	{
+		Target converted;
+		if constexpr (std::is_enum_v<Arg>)
+		{
+			converted = static_cast<Target>(static_cast<std::underlying_type_t<Arg>>(pArg));
+		}
+		else
+		{
+			converted = static_cast<Target>(pArg);
+		}
+		memcpy(pSlot, &converted, sizeof(Target));
+	}
+
 	template <typename Class, typename Ret, typename ... Args>
 	TypedFunctionInfo<Ret(Class::*)(Args...)>::TypedFunctionInfo(MemberFunctionSignature memberFunc, const char* methodName) :
-		FunctionInfo(methodName, FromActualTypeToEnumType<Ret>::EnumType),
+		FunctionInfo(methodName, FromActualTypeToEnumType<Ret>::EnumType, GetStoredReturnSize(), GetStoredReturnAlignment()),
 		myMemberFunctionPtr(memberFunc)
 	{
 		if constexpr (sizeof...(Args) > 0)
 		{
-			(PushBackParameterType(FromActualTypeToEnumType<Args>::EnumType), ...);
+			(PushBackParameterType(FromActualTypeToEnumType<Args>::EnumType, FromActualTypeToEnumType<std::decay_t<Args>>::EnumType), ...);
 		}
 
+		SetThunk(GetFunctionSignatureHash<Ret(Args...)>(), reinterpret_cast<ErasedThunk>(&CallMemberFunction));
+
 		TypeInfo& theClassReflector = Class::EditTypeInfo();
 		theClassReflector.PushFunctionInfo(*this);
 	}
@@ -152,6 +236,110 @@ namespace DIRE_NS
 		}
 	}
 
+	template <typename Class, typename Ret, typename ... Args>
+	Ret TypedFunctionInfo<Ret(Class::*)(Args...)>::CallMemberFunction(const FunctionInfo& pFunction, void* pObject, Args... pArgs)
+	{
+		const auto& typedFunction = static_cast<const TypedFunctionInfo&>(pFunction);
+		return (static_cast<Class*>(pObject)->*typedFunction.myMemberFunctionPtr)(std::forward<Args>(pArgs)...);
+	}
+
+	template <typename Class, typename Ret, typename ... Args>
+	void TypedFunctionInfo<Ret(Class::*)(Args...)>::InvokeWithBuffer(void* pObject, const void* pArgumentBuffer, void* pReturnStorage) const
+	{
+		InvokeWithBufferImpl(static_cast<Class*>(pObject), static_cast<const std::byte*>(pArgumentBuffer), pReturnStorage, std::index_sequence_for<Args...>{});
+	}
+
+	template <typename Class, typename Ret, typename ... Args>
+	template <size_t... Indices>
+	void TypedFunctionInfo<Ret(Class::*)(Args...)>::InvokeWithBufferImpl(Class* pObject, [[maybe_unused]] const std::byte* pArgumentBuffer,
+		[[maybe_unused]] void* pReturnStorage, std::index_sequence<Indices...>) const
+	{
+		[[maybe_unused]] const ParameterOffsetList& offsets = GetParameterOffsets();
+
+		if constexpr (std::is_void_v<Ret>)
+		{
+			(pObject->*myMemberFunctionPtr)(ReadArgument<Args>(pArgumentBuffer + offsets[Indices])...);
+		}
+		else if constexpr (std::is_reference_v<Ret>)
+		{
+			Ret result = (pObject->*myMemberFunctionPtr)(ReadArgument<Args>(pArgumentBuffer + offsets[Indices])...);
+			if (pReturnStorage != nullptr)
+			{
+				const void* resultAddress = std::addressof(result);
+				memcpy(pReturnStorage, &resultAddress, sizeof(resultAddress));
+			}
+		}
+		else if (pReturnStorage != nullptr)
+		{
+			new (pReturnStorage) Ret((pObject->*myMemberFunctionPtr)(ReadArgument<Args>(pArgumentBuffer + offsets[Indices])...));
+		}
+		else
+		{
+			(pObject->*myMemberFunctionPtr)(ReadArgument<Args>(pArgumentBuffer + offsets[Indices])...);
+		}
+	}
+
+	template <typename Class, typename Ret, typename ... Args>
+	template <typename Arg>
+	decltype(auto) TypedFunctionInfo<Ret(Class::*)(Args...)>::ReadArgument(const std::byte* pSlot)
+	{
+		using ArgType = std::remove_cv_t<std::remove_reference_t<Arg>>;
+		if constexpr (IsBufferedByValue(FromActualTypeToEnumType<Arg>::EnumType))
+		{
+			static_assert(sizeof(ArgType) == GetBufferedParameterSize(FromActualTypeToEnumType<Arg>::EnumType));
+			ArgType value;
+			memcpy(&value, pSlot, sizeof(ArgType));
+			return value;
+		}
+		else
+		{
+			std::remove_reference_t<Arg>* argAddress;
+			memcpy(&argAddress, pSlot, sizeof(argAddress));
+			if constexpr (std::is_rvalue_reference_v<Arg>)
+			{
+				return std::move(*argAddress);
+			}
+			else
+			{
+				return static_cast<std::remove_reference_t<Arg>&>(*argAddress);
+			}
+		}
+	}
+
+	template <typename Class, typename Ret, typename ... Args>
+	constexpr size_t TypedFunctionInfo<Ret(Class::*)(Args...)>::GetStoredReturnSize()
+	{
+		if constexpr (std::is_void_v<Ret>)
+		{
+			return 0;
+		}
+		else if constexpr (std::is_reference_v<Ret>)
+		{
+			return sizeof(void*);
+		}
+		else
+		{
+			return sizeof(Ret);
+		}
+	}
+
+	template <typename Class, typename Ret, typename ... Args>
+	constexpr size_t TypedFunctionInfo<Ret(Class::*)(Args...)>::GetStoredReturnAlignment()
+	{
+		if constexpr (std::is_void_v<Ret>)
+		{
+			return 0;
+		}
+		else if constexpr (std::is_reference_v<Ret>)
+		{
+			return alignof(void*);
+		}
+		else
+		{
+			return alignof(Ret);
+		}
+	}
+
 	template <typename F>
 	void TypeInfo::ForEachPropertyInHierarchy(F&& pVisitorFunction) const
 	{
@@ -172,23 +360,40 @@ namespace DIRE_NS
 
 	template <typename T, bool UseDefaultCtorForInstantiate>
 	TypedTypeInfo<T, UseDefaultCtorForInstantiate>::TypedTypeInfo(char const* pTypename) :
-		TypeInfo(pTypename)
+		TypeInfo(pTypename, DeferredRegistration{})
 	{
+		myTypeSize = sizeof(T);
+		myTypeAlignment = alignof(T);
+
 		if constexpr (std::is_base_of_v<Reflectable, T>)
 		{
 			RecursiveRegisterParentClasses <typename T::Super>();
+
+			if constexpr (std::is_default_constructible_v<T>)
+			{
+				myPlacementInstantiator = [](void* pMemory) -> Reflectable*
+				{
+					return new (pMemory) T();
+				};
+			}
 		}
 
+		// Only publish the type once complete, as other threads may look it up as soon as it is registered.
+		Register(TypeInfoDatabase::EditSingleton());
+
 		if constexpr (UseDefaultCtorForInstantiate && std::is_default_constructible_v<T>)
 		{
 			static_assert(std::is_base_of_v<Reflectable, T>, "This class is only supposed to be used as a member variable of a Reflectable-derived class.");
 			TypeInfoDatabase::EditSingleton().RegisterInstantiateFunction(T::GetTypeInfo().GetID(),
-				[](std::any const& pParams) -> Reflectable*
+				[](std::any const& pParams, void* pMemory) -> Reflectable*
 				{
 					if (pParams.has_value()) // we've been sent parameters but this is default construction! Error
 						return nullptr;
 
-					return new T();
+					if (pMemory != nullptr)
+						return new (pMemory) T();
+
+					return AllocateReflectable<T>();
 				}
 			);
 		}
@@ -200,9 +405,7 @@ namespace DIRE_NS
 	{
 		if constexpr (!std::is_same_v<TParent, Reflectable>)
 		{
-			TypeInfo& parentTypeInfo = TParent::EditTypeInfo();
-			parentTypeInfo.AddChildClass(this);
-			this->AddParentClass(&parentTypeInfo);
+			this->AddParentClass(&TParent::EditTypeInfo()); // Register links it back to its parents
 			RecursiveRegisterParentClasses<typename TParent::Super>();
 		}
 	}
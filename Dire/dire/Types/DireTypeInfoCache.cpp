@@ -0,0 +1,213 @@
+#include "DireTypeInfoCache.h"
+#include "DireTypeInfo.h"
+
+#include <algorithm> // find, sort, stable_sort, lower_bound
+#include <cstring> // memcpy
+
+namespace DIRE_NS
+{
+	void PropertyLayout::PushProperty(const PropertyTypeInfo& pProperty)
+	{
+		myOffsets.push_back(pProperty.GetOffset());
+		myMetatypes.push_back(pProperty.GetMetatype());
+		mySizes.push_back(pProperty.GetSize());
+		myHandlers.push_back(pProperty.GetDataStructureHandler());
+		myCopyFunctions.push_back(pProperty.GetCopyConstructorFunction());
+		myProperties.push_back(&pProperty);
+	}
+
+	void PropertyLayout::BuildTrivialRuns()
+	{
+		// Going backwards, a trivially copyable property ends the same run as the next one if it lies just before it in memory.
+		myTrivialRunEnds.resize(GetCount());
+		for (size_t iProp = GetCount(); iProp-- != 0;)
+		{
+			if (!myProperties[iProp]->IsTriviallyCopyable())
+			{
+				myTrivialRunEnds[iProp] = iProp;
+			}
+			else if (iProp + 1 < GetCount() && myTrivialRunEnds[iProp + 1] != iProp + 1 && myOffsets[iProp] + mySizes[iProp] == myOffsets[iProp + 1])
+			{
+				myTrivialRunEnds[iProp] = myTrivialRunEnds[iProp + 1];
+			}
+			else
+			{
+				myTrivialRunEnds[iProp] = iProp + 1;
+			}
+		}
+	}
+
+	size_t PropertyLayout::FindIndex(const PropertyTypeInfo& pProperty) const
+	{
+		return static_cast<size_t>(std::find(myProperties.begin(), myProperties.end(), &pProperty) - myProperties.begin());
+	}
+
+	size_t PropertyLayout::FindIndexAtOffset(size_t pOffset) const
+	{
+		for (size_t iProp = 0; iProp < GetCount(); ++iProp)
+		{
+			if (pOffset >= myOffsets[iProp] && pOffset - myOffsets[iProp] < mySizes[iProp])
+				return iProp;
+		}
+
+		return GetCount();
+	}
+
+	size_t PropertyLayout::FindIndexByName(DIRE_STRING_VIEW pName) const
+	{
+		const String::HashType nameHash = String::Hash(pName);
+		auto it = std::lower_bound(myNameIndex.begin(), myNameIndex.end(), nameHash,
+			[](const NameIndexEntry& pEntry, String::HashType pHash) { return pEntry.NameHash < pHash; });
+
+		for (; it != myNameIndex.end() && it->NameHash == nameHash; ++it)
+		{
+			if (myProperties[it->Index]->GetName() == pName) // Still compare the names to be safe against hash collisions.
+				return it->Index;
+		}
+
+		return GetCount();
+	}
+
+	void PropertyLayout::BuildNameIndex()
+	{
+		myNameIndex.resize(GetCount());
+		for (size_t iProp = 0; iProp < GetCount(); ++iProp)
+		{
+			myNameIndex[iProp] = { String::Hash(myProperties[iProp]->GetName()), iProp };
+		}
+
+		// Parents come first in the layout: among equal hashes, put the highest indices first so that derived properties take precedence.
+		std::sort(myNameIndex.begin(), myNameIndex.end(), [](const NameIndexEntry& pLhs, const NameIndexEntry& pRhs)
+		{
+			return (pLhs.NameHash != pRhs.NameHash ? pLhs.NameHash < pRhs.NameHash : pLhs.Index > pRhs.Index);
+		});
+	}
+
+	void CopyPlan::Build(const PropertyLayout& pLayout)
+	{
+		// Sort by offset so that properties that are next to each other in memory can be merged.
+		std::vector<size_t, DIRE_ALLOCATOR<size_t>> sortedProps(pLayout.GetCount());
+		for (size_t iProp = 0; iProp < sortedProps.size(); ++iProp)
+		{
+			sortedProps[iProp] = iProp;
+		}
+
+		std::stable_sort(sortedProps.begin(), sortedProps.end(), [&pLayout](size_t pLhs, size_t pRhs)
+		{
+			return pLayout.GetOffset(pLhs) < pLayout.GetOffset(pRhs);
+		});
+
+		for (const size_t iProp : sortedProps)
+		{
+			PropertyLayout::CopyFunction copyFunc = pLayout.GetCopyFunction(iProp);
+			if (copyFunc == nullptr)
+				continue; // not copyable
+
+			const size_t offset = pLayout.GetOffset(iProp);
+			const size_t size = pLayout.GetSize(iProp);
+			if (pLayout.GetProperty(iProp).IsTriviallyCopyable())
+			{
+				// Only merge properties that are exactly contiguous: padding could hide members that are not reflected.
+				if (!mySteps.empty() && mySteps.back().CopyFunc == nullptr && mySteps.back().Offset + mySteps.back().Size == offset)
+				{
+					mySteps.back().Size += size;
+				}
+				else
+				{
+					mySteps.push_back({ offset, size, nullptr });
+				}
+			}
+			else
+			{
+				mySteps.push_back({ offset, size, copyFunc });
+			}
+		}
+	}
+
+	void CopyPlan::Copy(void* pDest, const void* pSrc) const
+	{
+		for (const Step& step : mySteps)
+		{
+			if (step.CopyFunc == nullptr)
+			{
+				memcpy(static_cast<std::byte*>(pDest) + step.Offset, static_cast<const std::byte*>(pSrc) + step.Offset, step.Size);
+			}
+			else
+			{
+				step.CopyFunc(pDest, pSrc, step.Offset);
+			}
+		}
+	}
+
+	TypeInfoCache::TypeInfoCache(const TypeInfo& pTypeInfo)
+	{
+		// Visit the hierarchy from the type itself to its farthest parent, so that entries get pushed by order of precedence.
+		uint32_t ownerRank = 0;
+		auto addClassMembers = [this, &ownerRank](const TypeInfo& pOwner)
+		{
+			for (const PropertyTypeInfo& prop : pOwner.GetPropertyList())
+			{
+				myPropertyTable.push_back({ String::Hash(prop.GetName()), ownerRank, &pOwner, &prop });
+			}
+
+			for (const FunctionInfo& func : pOwner.GetFunctionList())
+			{
+				myFunctionTable.push_back({ String::Hash(func.GetName()), ownerRank, &pOwner, &func });
+			}
+
+			ownerRank++;
+		};
+
+		addClassMembers(pTypeInfo);
+		for (const TypeInfo* parent : pTypeInfo.GetParentClasses())
+		{
+			addClassMembers(*parent);
+		}
+
+		// A stable sort keeps the order of precedence between entries of the same hash.
+		auto byHash = [](const auto& pLhs, const auto& pRhs) { return pLhs.NameHash < pRhs.NameHash; };
+		std::stable_sort(myPropertyTable.begin(), myPropertyTable.end(), byHash);
+		std::stable_sort(myFunctionTable.begin(), myFunctionTable.end(), byHash);
+
+		pTypeInfo.ForEachPropertyInHierarchy([this](const PropertyTypeInfo& pProperty)
+		{
+			myPropertyLayout.PushProperty(pProperty);
+		});
+		myPropertyLayout.BuildTrivialRuns();
+		myPropertyLayout.BuildNameIndex();
+
+		myCopyPlan.Build(myPropertyLayout);
+	}
+
+	TypeInfoCache::PropertyLookupResult TypeInfoCache::FindProperty(DIRE_STRING_VIEW pName, LookupScope pScope) const
+	{
+		return Lookup(myPropertyTable, pName, pScope);
+	}
+
+	TypeInfoCache::FunctionLookupResult TypeInfoCache::FindFunction(DIRE_STRING_VIEW pName, LookupScope pScope) const
+	{
+		return Lookup(myFunctionTable, pName, pScope);
+	}
+
+	template <typename TInfo>
+	std::pair<const TypeInfo*, const TInfo*> TypeInfoCache::Lookup(const LookupTable<TInfo>& pTable, DIRE_STRING_VIEW pName, LookupScope pScope)
+	{
+		const String::HashType nameHash = String::Hash(pName);
+		auto it = std::lower_bound(pTable.begin(), pTable.end(), nameHash,
+			[](const LookupEntry<TInfo>& pEntry, String::HashType pHash) { return pEntry.NameHash < pHash; });
+
+		for (; it != pTable.end() && it->NameHash == nameHash; ++it)
+		{
+			const bool inScope = (pScope == LookupScope::Hierarchy)
+				|| (pScope == LookupScope::Self && it->OwnerRank == 0)
+				|| (pScope == LookupScope::Parents && it->OwnerRank != 0);
+
+			if (inScope && it->Info->GetName() == pName) // Still compare the names to be safe against hash collisions.
+			{
+				return { it->Owner, it->Info };
+			}
+		}
+
+		return { nullptr, nullptr };
+	}
+}
@@ -0,0 +1,189 @@
+#pragma once
+
+#include "DireDefines.h"
+#include "dire/Utils/DireString.h"
+#include "dire/Types/DireTypes.h"
+#include "dire/Handlers/DireTypeHandlers.h"
+
+#include <cstdint>
+#include <utility> // pair
+#include <vector>
+
+namespace DIRE_NS
+{
+	class TypeInfo;
+	class PropertyTypeInfo;
+	class FunctionInfo;
+
+	/**
+	 * \brief The flattened property layout of a class hierarchy, stored as a structure of arrays.
+	 * Properties are stored in the same order ForEachPropertyInHierarchy visits them (farthest parent first, the type itself last),
+	 * so that the hot data used by serializers and cloning is read from contiguous memory rather than by chasing the
+	 * linked list nodes of properties scattered all over the program's static data.
+	 */
+	class Dire_EXPORT PropertyLayout
+	{
+	public:
+		using CopyFunction = void (*)(void* pDestAddr, const void* pSrc, size_t pOffset);
+
+		[[nodiscard]] size_t	GetCount() const { return myProperties.size(); }
+
+		[[nodiscard]] size_t						GetOffset(const size_t pIndex) const { return myOffsets[pIndex]; }
+		[[nodiscard]] MetaType						GetMetatype(const size_t pIndex) const { return myMetatypes[pIndex]; }
+		[[nodiscard]] size_t						GetSize(const size_t pIndex) const { return mySizes[pIndex]; }
+		[[nodiscard]] const DataStructureHandler&	GetDataStructureHandler(const size_t pIndex) const { return myHandlers[pIndex]; }
+		[[nodiscard]] CopyFunction					GetCopyFunction(const size_t pIndex) const { return myCopyFunctions[pIndex]; }
+
+		/**
+		 * \brief Gives access to the rest of the property data (name, attributes...), which is not stored in the layout.
+		 */
+		[[nodiscard]] const PropertyTypeInfo&		GetProperty(const size_t pIndex) const { return *myProperties[pIndex]; }
+
+		/**
+		 * \brief Returns the index following the run of trivially copyable properties starting at pIndex that lie next to each other in memory,
+		 * so that the whole run can be compared or copied as a single block of bytes. It's pIndex itself if the property is not trivially copyable.
+		 */
+		[[nodiscard]] size_t						GetTrivialRunEnd(const size_t pIndex) const { return myTrivialRunEnds[pIndex]; }
+
+		/**
+		 * \brief Returns the index of a property in the layout (its ordinal), or GetCount() if it's not part of it.
+		 */
+		[[nodiscard]] Dire_EXPORT size_t			FindIndex(const PropertyTypeInfo& pProperty) const;
+
+		/**
+		 * \brief Returns the index of the property whose memory contains the given offset in the object, or GetCount() if there is none.
+		 */
+		[[nodiscard]] Dire_EXPORT size_t			FindIndexAtOffset(size_t pOffset) const;
+
+		/**
+		 * \brief Returns the index of the property of the given name, or GetCount() if there is none.
+		 * Names are looked up by hash: when a property hides a parent property of the same name, the most derived one is found.
+		 */
+		[[nodiscard]] Dire_EXPORT size_t			FindIndexByName(DIRE_STRING_VIEW pName) const;
+
+	private:
+		friend class TypeInfoCache;
+
+		void	PushProperty(const PropertyTypeInfo& pProperty);
+
+		void	BuildTrivialRuns();
+
+		void	BuildNameIndex();
+
+		template <typename T>
+		using Array = std::vector<T, DIRE_ALLOCATOR<T>>;
+
+		Array<size_t>					myOffsets;
+		Array<MetaType>					myMetatypes;
+		Array<size_t>					mySizes;
+		Array<DataStructureHandler>		myHandlers;
+		Array<CopyFunction>				myCopyFunctions;
+		Array<const PropertyTypeInfo*>	myProperties;
+		Array<size_t>					myTrivialRunEnds;
+
+		struct NameIndexEntry
+		{
+			String::HashType	NameHash = 0;
+			size_t				Index = 0;
+		};
+
+		Array<NameIndexEntry>			myNameIndex; // sorted by name hash, the most derived properties first among equal names
+	};
+
+	/**
+	 * \brief The sequence of copies needed to clone every property of a class hierarchy, computed once from its property layout.
+	 * Properties are copied straight from their offset, and runs of adjacent trivially copyable properties are coalesced
+	 * into a single memcpy.
+	 */
+	class Dire_EXPORT CopyPlan
+	{
+	public:
+		/**
+		 * \brief Copies every copyable property of pSrc into pDest. Both must be instances of the type this plan was built for.
+		 */
+		void	Copy(void* pDest, const void* pSrc) const;
+
+		/**
+		 * \brief The number of copy operations performed by Copy (a coalesced memcpy counts as one).
+		 */
+		[[nodiscard]] size_t	GetStepCount() const { return mySteps.size(); }
+
+	private:
+		friend class TypeInfoCache;
+
+		void	Build(const PropertyLayout& pLayout);
+
+		struct Step
+		{
+			size_t						Offset = 0;
+			size_t						Size = 0;
+			PropertyLayout::CopyFunction	CopyFunc = nullptr; // nullptr means a memcpy of Size bytes
+		};
+
+		std::vector<Step, DIRE_ALLOCATOR<Step>>	mySteps;
+	};
+
+	/**
+	 * \brief Immutable data computed from a type info and its whole class hierarchy, used to speed up the reflection queries.
+	 * It is built lazily the first time it is needed by TypeInfo::GetCache, and thrown away whenever the type info
+	 * (or one of its parents) is modified, e.g. when a property or a function gets registered.
+	 * It holds name lookup tables (flat arrays of every property and function of the hierarchy, sorted by name hash)
+	 * and the flattened property layout of the hierarchy with the copy plan derived from it.
+	 */
+	class Dire_EXPORT TypeInfoCache
+	{
+	public:
+		/**
+		 * \brief Which part of the hierarchy a lookup should consider.
+		 */
+		enum class LookupScope : uint8_t
+		{
+			Self,		// Only the members declared by the type itself
+			Parents,	// Only the members declared by the parent classes
+			Hierarchy	// Both (members of the type itself take precedence, then the nearest parent ones)
+		};
+
+		using PropertyLookupResult = std::pair<const TypeInfo*, const PropertyTypeInfo*>;
+		using FunctionLookupResult = std::pair<const TypeInfo*, const FunctionInfo*>;
+
+		explicit TypeInfoCache(const TypeInfo& pTypeInfo);
+
+		/**
+		 * \brief Finds a property by name. When several classes of the hierarchy declare a property with the same name,
+		 * the one declared by the most derived class wins.
+		 * \return The class declaring the found property and the property, or a pair of nullptr if not found.
+		 */
+		[[nodiscard]] PropertyLookupResult	FindProperty(DIRE_STRING_VIEW pName, LookupScope pScope) const;
+
+		/**
+		 * \brief Finds a member function by name, following the same rules as FindProperty.
+		 */
+		[[nodiscard]] FunctionLookupResult	FindFunction(DIRE_STRING_VIEW pName, LookupScope pScope) const;
+
+		[[nodiscard]] const PropertyLayout&	GetPropertyLayout() const { return myPropertyLayout; }
+
+		[[nodiscard]] const CopyPlan&		GetCopyPlan() const { return myCopyPlan; }
+
+	private:
+
+		template <typename TInfo>
+		struct LookupEntry
+		{
+			String::HashType	NameHash = 0;
+			uint32_t			OwnerRank = 0; // 0 for the type itself, 1 for the nearest parent, etc.
+			const TypeInfo*		Owner = nullptr;
+			const TInfo*		Info = nullptr;
+		};
+
+		template <typename TInfo>
+		using LookupTable = std::vector<LookupEntry<TInfo>, DIRE_ALLOCATOR<LookupEntry<TInfo>>>;
+
+		template <typename TInfo>
+		static std::pair<const TypeInfo*, const TInfo*>	Lookup(const LookupTable<TInfo>& pTable, DIRE_STRING_VIEW pName, LookupScope pScope);
+
+		LookupTable<PropertyTypeInfo>	myPropertyTable;
+		LookupTable<FunctionInfo>		myFunctionTable;
+		PropertyLayout					myPropertyLayout;
+		CopyPlan						myCopyPlan;
+	};
+}
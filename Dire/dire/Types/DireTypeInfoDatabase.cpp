@@ -1,8 +1,10 @@
 #include "DireTypeInfoDatabase.h"
 #include "DireTypeInfo.h"
+#include "dire/DireAllocationContext.h"
 
 #include <fstream>
-#include <algorithm> // find_if
+#include <algorithm> // max
+#include <unordered_map>
 
 namespace DIRE_NS
 {
@@ -28,28 +30,24 @@ DIRE_NS::TypeInfoDatabase& DIRE_NS::TypeInfoDatabase::EditSingleton()
 
 size_t DIRE_NS::TypeInfoDatabase::GetTypeInfoCount() const
 {
-	return myReflectableTypeInfos.size();
+	return myReflectableTypeInfos.Size();
 }
 
-void dire::ReflectableFactory::RegisterInstantiator(ReflectableID pID, InstantiateFunction pFunc)
+void dire::ReflectableFactory::RegisterInstantiator(size_t pTypeIndex, InstantiateFunction pFunc)
 {
 	// Replace the existing one, if any.
-	auto [it, inserted] = myInstantiators.try_emplace(pID, pFunc);
-	if (!inserted)
-	{
-		it->second = pFunc;
-	}
+	myInstantiators.Set(pTypeIndex, pFunc);
 }
 
-dire::ReflectableFactory::InstantiateFunction dire::ReflectableFactory::GetInstantiator(ReflectableID pID) const
+dire::ReflectableFactory::InstantiateFunction dire::ReflectableFactory::GetInstantiator(size_t pTypeIndex) const
 {
-	auto it = myInstantiators.find(pID);
-	if (it == myInstantiators.end())
+	const SnapshotArray<InstantiateFunction>::View instantiators = myInstantiators.GetView();
+	if (pTypeIndex >= instantiators.Size())
 	{
 		return nullptr;
 	}
 
-	return it->second;
+	return instantiators[pTypeIndex];
 }
 
 const DIRE_NS::TypeInfoDatabase& DIRE_NS::TypeInfoDatabase::GetSingleton()
@@ -59,21 +57,52 @@ const DIRE_NS::TypeInfoDatabase& DIRE_NS::TypeInfoDatabase::GetSingleton()
 
 const DIRE_NS::TypeInfo * DIRE_NS::TypeInfoDatabase::GetTypeInfo(ReflectableID classID) const
 {
-	// TypeInfos IDs are supposed to match their position in the vector, but not always because of possible binary import/exports.
-	// if possible, use Reflectable::GetTypeInfo instead.
-	if (classID < myReflectableTypeInfos.size() && myReflectableTypeInfos[classID]->GetID() == classID)
+	const size_t typeIndex = FindTypeIndex(classID);
+	if (typeIndex == INVALID_TYPE_INDEX)
+	{
+		return nullptr;
+	}
+
+	// The index of a type is published before the type, for GetTypeInfoCount: it may not be visible yet.
+	const SnapshotArray<TypeInfo*>::View typeInfos = myReflectableTypeInfos.GetView();
+	if (typeIndex >= typeInfos.Size())
+	{
+		return nullptr;
+	}
+
+	return typeInfos[typeIndex];
+}
+
+size_t DIRE_NS::TypeInfoDatabase::FindTypeIndex(ReflectableID pClassID) const
+{
+	const SnapshotArray<size_t>::View typeIndices = myTypeIndices.GetView();
+	if (pClassID >= typeIndices.Size())
 	{
-		// lucky!
-		return myReflectableTypeInfos[classID];
+		return INVALID_TYPE_INDEX;
 	}
-	// not so lucky :( Linear search but for any reasonable workload it should still be OK.
-	auto it = std::find_if(myReflectableTypeInfos.begin(), myReflectableTypeInfos.end(), [classID](const TypeInfo* pTI) { return pTI->GetID() == classID; });
-	if (it != myReflectableTypeInfos.end())
+
+	const size_t typeIndexPlusOne = typeIndices[pClassID];
+	return (typeIndexPlusOne != 0 ? typeIndexPlusOne - 1 : INVALID_TYPE_INDEX);
+}
+
+void DIRE_NS::TypeInfoDatabase::RebuildTypeIndices()
+{
+	const SnapshotArray<TypeInfo*>::View typeInfos = myReflectableTypeInfos.GetView();
+	for (size_t iType = 0; iType < typeInfos.Size(); ++iType)
 	{
-		return *it;
+		myTypeIndices.Set(typeInfos[iType]->GetID(), iType + 1);
 	}
 
-	return nullptr;
+	// Then forget the IDs no type has anymore.
+	const SnapshotArray<size_t>::View typeIndices = myTypeIndices.GetView();
+	for (ReflectableID iID = 0; iID < typeIndices.Size(); ++iID)
+	{
+		const size_t typeIndexPlusOne = typeIndices[iID];
+		if (typeIndexPlusOne != 0 && typeInfos[typeIndexPlusOne - 1]->GetID() != iID)
+		{
+			myTypeIndices.Set(iID, 0);
+		}
+	}
 }
 
 DIRE_NS::TypeInfo* DIRE_NS::TypeInfoDatabase::EditTypeInfo(ReflectableID classID)
@@ -84,18 +113,71 @@ DIRE_NS::TypeInfo* DIRE_NS::TypeInfoDatabase::EditTypeInfo(ReflectableID classID
 
 void DIRE_NS::TypeInfoDatabase::RegisterInstantiateFunction(ReflectableID pClassID, ReflectableFactory::InstantiateFunction pInstantiateFunction)
 {
-	myInstantiateFactory.RegisterInstantiator(pClassID, pInstantiateFunction);
+	std::lock_guard<std::mutex> lock(myWriteMutex);
+	const size_t typeIndex = FindTypeIndex(pClassID);
+	DIRE_ASSERT(typeIndex != INVALID_TYPE_INDEX); // the type info has to be registered first
+	if (typeIndex != INVALID_TYPE_INDEX)
+	{
+		myInstantiateFactory.RegisterInstantiator(typeIndex, pInstantiateFunction);
+	}
+}
+
+DIRE_NS::ReflectableID DIRE_NS::TypeInfoDatabase::RegisterTypeInfo(TypeInfo* pTypeInfo)
+{
+	std::lock_guard<std::mutex> lock(myWriteMutex);
+	// New IDs come after all the IDs ever used: it is the number of types, unless an import assigned bigger ones.
+	const size_t typeIndex = myReflectableTypeInfos.Size();
+	const auto newID = ReflectableID(std::max(typeIndex, myTypeIndices.Size()));
+
+	// Set the ID before publishing the type info, so that lookups never see it without.
+	pTypeInfo->SetID(newID);
+	myTypeIndices.Set(newID, typeIndex + 1);
+	myReflectableTypeInfos.PushBack(pTypeInfo);
+	return newID;
 }
 
 DIRE_NS::Reflectable* DIRE_NS::TypeInfoDatabase::TryInstantiate(ReflectableID pClassID, std::any const& pAnyParameterPack) const
 {
-	ReflectableFactory::InstantiateFunction anInstantiateFunc = myInstantiateFactory.GetInstantiator(pClassID);
+	const size_t typeIndex = FindTypeIndex(pClassID);
+	if (typeIndex == INVALID_TYPE_INDEX)
+	{
+		return nullptr;
+	}
+
+	ReflectableFactory::InstantiateFunction anInstantiateFunc = myInstantiateFactory.GetInstantiator(typeIndex);
 	if (anInstantiateFunc == nullptr)
 	{
 		return nullptr;
 	}
 
-	Reflectable* newInstance = anInstantiateFunc(pAnyParameterPack);
+	Reflectable* newInstance = anInstantiateFunc(pAnyParameterPack, nullptr);
+	if (newInstance != nullptr)
+	{
+		DIRE_STATS_ADD(myReflectableTypeInfos.GetView()[typeIndex], Instantiations, 1);
+	}
+	return newInstance;
+}
+
+DIRE_NS::Reflectable* DIRE_NS::TypeInfoDatabase::TryInstantiate(ReflectableID pClassID, std::any const& pAnyParameterPack, AllocationContext& pContext) const
+{
+	const size_t typeIndex = FindTypeIndex(pClassID);
+	if (typeIndex == INVALID_TYPE_INDEX)
+	{
+		return nullptr;
+	}
+
+	ReflectableFactory::InstantiateFunction anInstantiateFunc = myInstantiateFactory.GetInstantiator(typeIndex);
+	const TypeInfo* typeInfo = GetTypeInfo(pClassID);
+	if (anInstantiateFunc == nullptr || typeInfo == nullptr)
+	{
+		return nullptr;
+	}
+
+	Reflectable* newInstance = pContext.Instantiate(*typeInfo, anInstantiateFunc, pAnyParameterPack);
+	if (newInstance != nullptr)
+	{
+		DIRE_STATS_ADD(typeInfo, Instantiations, 1);
+	}
 	return newInstance;
 }
 
@@ -112,8 +194,10 @@ DIRE_STRING	DIRE_NS::TypeInfoDatabase::BinaryExport() const
 	// - total number of encoded types
 	// - the reflectable type ID
 	// - the typename string
+	std::lock_guard<std::mutex> lock(myWriteMutex);
+	const SnapshotArray<TypeInfo*>::View typeInfos = myReflectableTypeInfos.GetView();
 	DIRE_STRING writeBuffer;
-	auto nbTypeInfos = unsigned(myReflectableTypeInfos.size());
+	auto nbTypeInfos = unsigned(typeInfos.Size());
 
 	const size_t estimatedNamesStorage = (sizeof(ReflectableID) + 64) * nbTypeInfos; // expect 64 chars or less for a typename (i.e. 63 + 1 \0)
 	writeBuffer.resize(sizeof(DATABASE_VERSION) + sizeof(nbTypeInfos) + estimatedNamesStorage);
@@ -122,8 +206,9 @@ DIRE_STRING	DIRE_NS::TypeInfoDatabase::BinaryExport() const
 	offset = BinaryWriteAtOffset(writeBuffer.data(), &DATABASE_VERSION, sizeof(DATABASE_VERSION), offset);
 	offset = BinaryWriteAtOffset(writeBuffer.data(), &nbTypeInfos, sizeof(nbTypeInfos), offset);
 
-	for (const TypeInfo * typeInfo : myReflectableTypeInfos)
+	for (size_t iTypeInfo = 0; iTypeInfo < typeInfos.Size(); ++iTypeInfo)
 	{
+		const TypeInfo* typeInfo = typeInfos[iTypeInfo];
 		const ReflectableID typeID = typeInfo->GetID();
 
 		const DIRE_STRING_VIEW& typeName = typeInfo->GetName();
@@ -225,23 +310,31 @@ bool	DIRE_NS::TypeInfoDatabase::ImportFromBinaryFile(DIRE_STRING_VIEW pReadSetti
 	// To assign new IDs to new types not in the database
 	ReflectableID nextAvailableID = maxTypeInfoID + 1;
 
-	for (size_t iReg = 0; iReg < myReflectableTypeInfos.size(); ++iReg)
+	// Join the read types with the registered ones by name, in a hash table rather than a search per type.
+	std::unordered_map<DIRE_STRING_VIEW, ReflectableID, std::hash<DIRE_STRING_VIEW>, std::equal_to<DIRE_STRING_VIEW>,
+		DIRE_ALLOCATOR<std::pair<const DIRE_STRING_VIEW, ReflectableID>>> readIDs;
+	readIDs.reserve(theReadData.size());
+	for (const ExportedTypeInfoData& readData : theReadData)
 	{
-		TypeInfo* registeredTypeInfo = myReflectableTypeInfos[iReg];
+		readIDs.try_emplace(readData.TypeName, readData.ID); // in case of twin types, the first one wins
+	}
 
-		// Is this type in the read info ?
-		auto it = std::find_if(theReadData.begin(), theReadData.end(),
-			[registeredTypeInfo](const ExportedTypeInfoData& pReadTypeInfo)
-			{
-				return pReadTypeInfo.TypeName == registeredTypeInfo->GetName();
-			});
+	// Lookups keep running while IDs change: until the type indices are rebuilt, they keep finding types by their previous ID.
+	std::lock_guard<std::mutex> lock(myWriteMutex);
 
-		if (it != theReadData.end())
+	const SnapshotArray<TypeInfo*>::View typeInfos = myReflectableTypeInfos.GetView();
+	for (size_t iReg = 0; iReg < typeInfos.Size(); ++iReg)
+	{
+		TypeInfo* registeredTypeInfo = typeInfos[iReg];
+
+		// Is this type in the read info ?
+		auto it = readIDs.find(registeredTypeInfo->GetName());
+		if (it != readIDs.end())
 		{
 			// we found it in the read data. Fix its ID if necessary
-			if (it->ID != registeredTypeInfo->GetID())
+			if (it->second != registeredTypeInfo->GetID())
 			{
-				registeredTypeInfo->SetID(it->ID);
+				registeredTypeInfo->SetID(it->second);
 			}
 		}
 		else
@@ -253,5 +346,49 @@ bool	DIRE_NS::TypeInfoDatabase::ImportFromBinaryFile(DIRE_STRING_VIEW pReadSetti
 		}
 	}
 
+	RebuildTypeIndices();
+
 	return true;
 }
+
+#ifdef DIRE_STATS_ENABLED
+DIRE_NS::ReflectionStats	DIRE_NS::TypeInfoDatabase::GetStatsSnapshot(size_t pMaxPropertyPaths) const
+{
+	ReflectionStats stats;
+
+	const SnapshotArray<TypeInfo*>::View typeInfos = myReflectableTypeInfos.GetView();
+	for (size_t iType = 0; iType < typeInfos.Size(); ++iType)
+	{
+		const TypeInfo* typeInfo = typeInfos[iType];
+
+		TypeStatsSnapshot snapshot;
+		bool hasCounted = false;
+		for (size_t iCounter = 0; iCounter < (size_t)TypeCounter::Count; ++iCounter)
+		{
+			snapshot.Counters[iCounter] = typeInfo->GetStats().Get((TypeCounter)iCounter);
+			hasCounted |= (snapshot.Counters[iCounter] != 0);
+		}
+
+		if (hasCounted)
+		{
+			snapshot.ID = typeInfo->GetID();
+			snapshot.TypeName = typeInfo->GetName();
+			stats.Types.push_back(snapshot);
+		}
+	}
+
+	stats.TopPropertyPaths = myPathSampler.GetTopPaths(pMaxPropertyPaths);
+	return stats;
+}
+
+void DIRE_NS::TypeInfoDatabase::ResetStats()
+{
+	const SnapshotArray<TypeInfo*>::View typeInfos = myReflectableTypeInfos.GetView();
+	for (size_t iType = 0; iType < typeInfos.Size(); ++iType)
+	{
+		typeInfos[iType]->GetStats().Reset();
+	}
+
+	myPathSampler.Reset();
+}
+#endif
@@ -2,10 +2,13 @@
 
 #include "DireDefines.h"
 
+#include <cstdint> // SIZE_MAX
+#include <mutex>
 #include <vector>
-#include <unordered_map>
 
 #include "dire/Utils/DireString.h"
+#include "dire/Utils/DireSnapshotArray.h"
+#include "dire/Types/DireTypeStats.h"
 #include "dire/DireReflectableID.h"
 
 namespace std
@@ -17,29 +20,33 @@ namespace DIRE_NS
 {
 	class TypeInfo;
 	class Reflectable;
+	class AllocationContext;
 
 	/**
 	 * \brief Internal component of the type info database that holds pointers to instantiator functions.
 	 * Each reflectable class can register exactly one instantiator function with the DECLARE_INSTANTIATOR macro.
 	 * These function pointers are stored in this factory and can be used later on to instantiate a Reflectable with only its reflectable ID.
+	 * They are indexed by the registration index of their type, which unlike its ID, never changes (the type info database maps IDs to it).
+	 * Getting one is lock-free and can run concurrently with a registration, but registrations have to be serialized (the type info database does it).
 	 */
 	class ReflectableFactory
 	{
 	public:
-		using InstantiateFunction = Reflectable * (*)(const std::any &);
+		/**
+		 * \brief Constructs an object from a type-erased tuple of constructor parameters.
+		 * If pMemory is nullptr, the object is allocated with DIRE_ALLOCATOR, otherwise it is constructed in place in pMemory.
+		 * Returns nullptr if the parameters don't match what the instantiator expects.
+		 */
+		using InstantiateFunction = Reflectable * (*)(const std::any & pParameters, void* pMemory);
 
 		ReflectableFactory() = default;
 
-		Dire_EXPORT void	RegisterInstantiator(ReflectableID pID, InstantiateFunction pFunc);
+		Dire_EXPORT void	RegisterInstantiator(size_t pTypeIndex, InstantiateFunction pFunc);
 
-		Dire_EXPORT InstantiateFunction	GetInstantiator(ReflectableID pID) const;
+		Dire_EXPORT InstantiateFunction	GetInstantiator(size_t pTypeIndex) const;
 
 	private:
-		using InstantiatorsHashTable =
-			std::unordered_map<ReflectableID, InstantiateFunction, std::hash<ReflectableID>, std::equal_to<ReflectableID>,
-			DIRE_ALLOCATOR<std::pair<const ReflectableID, InstantiateFunction>>>;
-
-		InstantiatorsHashTable	myInstantiators;
+		SnapshotArray<InstantiateFunction>	myInstantiators; // indexed by type index
 	};
 
 	/**
@@ -47,6 +54,10 @@ namespace DIRE_NS
 	 * It is supposed to be used as a singleton (except for testing purposes), thus you should only have one in your whole program.
 	 * It allows you to fetch any type info or instantiate any Reflectable type, given you provide the matching Reflectable ID.
 	 * It also supports importing and exporting the type info database, which is useful for persistent identification of types across multiple runs of a program.
+	 * Lookups (GetTypeInfo, TryInstantiate...) never lock: they can run on any number of threads while types get registered or imported
+	 * (e.g. by a plugin loading on a background thread). Registrations and imports are serialized by a mutex.
+	 * Type infos are stored in registration order, and found by ID in constant time through a dense table mapping IDs to registration indices:
+	 * an import only has to rewrite this table, whatever IDs it assigns.
 	 */
 	class TypeInfoDatabase
 	{
@@ -69,6 +80,12 @@ namespace DIRE_NS
 
 		[[nodiscard]] Dire_EXPORT Reflectable* TryInstantiate(ReflectableID pClassID, std::any const& pAnyParameterPack) const;
 
+		/**
+		 * \brief Instantiates a reflectable in the memory provided by an allocation context (an object pool, an arena...).
+		 * The instance then has to be destroyed through the context.
+		 */
+		[[nodiscard]] Dire_EXPORT Reflectable* TryInstantiate(ReflectableID pClassID, std::any const& pAnyParameterPack, AllocationContext& pContext) const;
+
 		template <typename T, typename... Args>
 		[[nodiscard]] T* InstantiateClass(Args &&... pArgs) const
 		{
@@ -79,12 +96,50 @@ namespace DIRE_NS
 				return static_cast<T*>(TryInstantiate(T::GetTypeInfo().GetID(), { std::tuple<Args...>(std::forward<Args>(pArgs)...) }));
 		}
 
+		template <typename T, typename... Args>
+		[[nodiscard]] T* InstantiateClassIn(AllocationContext& pContext, Args &&... pArgs) const
+		{
+			static_assert(std::is_base_of_v<Reflectable, T>, "ClassInstantiator is only meant to be used as a member of Reflectable-derived classes.");
+			if constexpr (sizeof...(Args) == 0)
+				return static_cast<T*>(TryInstantiate(T::GetTypeInfo().GetID(), {}, pContext));
+			else
+				return static_cast<T*>(TryInstantiate(T::GetTypeInfo().GetID(), { std::tuple<Args...>(std::forward<Args>(pArgs)...) }, pContext));
+		}
+
 		Dire_EXPORT DIRE_STRING	BinaryExport() const;
 		Dire_EXPORT bool	ExportToBinaryFile(DIRE_STRING_VIEW pWrittenSettingsFile) const;
 
 		Dire_EXPORT static DIRE_STRING	BinaryImport(DIRE_STRING_VIEW pReadSettingsFile);
 		Dire_EXPORT bool	ImportFromBinaryFile(DIRE_STRING_VIEW pReadSettingsFile);
 
+#ifdef DIRE_STATS_ENABLED
+		/**
+		 * \brief Reads the counters of every type, and the most requested property paths, e.g. to export them to a metrics system.
+		 * Counters keep running during the snapshot: they are each read once, but not all at the same instant.
+		 * \param pMaxPropertyPaths The maximum number of property paths to return
+		 * \return The stats of the types that counted something since the last reset
+		 */
+		[[nodiscard]] Dire_EXPORT ReflectionStats	GetStatsSnapshot(size_t pMaxPropertyPaths = 32) const;
+
+		/**
+		 * \brief Sets the counters of every type back to zero, and forgets the sampled property paths.
+		 */
+		Dire_EXPORT void	ResetStats();
+
+		/**
+		 * \brief Samples one property lookup out of pPeriod on each thread to find the most requested paths (0 disables sampling).
+		 */
+		void	SetPropertyPathSamplingPeriod(uint32_t pPeriod)
+		{
+			myPathSampler.SetSamplingPeriod(pPeriod);
+		}
+
+		void	RecordPropertyPath(DIRE_STRING_VIEW pPath) const
+		{
+			myPathSampler.Record(pPath);
+		}
+#endif
+
 	// Allow unit tests to build a database that is not the program's singleton.
 #if !DIRE_TESTS_ENABLED
 	protected:
@@ -94,14 +149,32 @@ namespace DIRE_NS
 #endif
 		friend TypeInfo;
 
-		[[nodiscard]] ReflectableID	RegisterTypeInfo(TypeInfo* pTypeInfo)
-		{
-			myReflectableTypeInfos.push_back(pTypeInfo);
-			return ReflectableID(GetTypeInfoCount()) - 1;
-		}
-
-		std::vector<TypeInfo*, DIRE_ALLOCATOR<TypeInfo*>>	myReflectableTypeInfos;
-		ReflectableFactory		myInstantiateFactory;
+		/**
+		 * \brief Gives its ID to a type info, then makes it visible to lookups.
+		 * \return The ID of the type info
+		 */
+		Dire_EXPORT ReflectableID	RegisterTypeInfo(TypeInfo* pTypeInfo);
+
+		static const size_t	INVALID_TYPE_INDEX = SIZE_MAX;
+
+		/**
+		 * \brief Finds the registration index of the type that has this ID.
+		 * \return INVALID_TYPE_INDEX if no type has this ID
+		 */
+		[[nodiscard]] size_t	FindTypeIndex(ReflectableID pClassID) const;
+
+		/**
+		 * \brief Maps the current ID of every type to its index, after IDs changed. Must be called under myWriteMutex.
+		 */
+		void	RebuildTypeIndices();
+
+		SnapshotArray<TypeInfo*>	myReflectableTypeInfos; // in registration order
+		SnapshotArray<size_t>		myTypeIndices; // by ID: the registration index of the type + 1, or 0 if no type has this ID
+		ReflectableFactory			myInstantiateFactory;
+		mutable std::mutex			myWriteMutex;
+#ifdef DIRE_STATS_ENABLED
+		mutable PropertyPathSampler	myPathSampler;
+#endif
 	};
 
 }
@@ -0,0 +1,99 @@
+#include "DireTypeStats.h"
+
+#ifdef DIRE_STATS_ENABLED
+
+#include <algorithm> // min, min_element, sort
+
+namespace DIRE_NS
+{
+	const char*	GetTypeCounterName(TypeCounter pCounter)
+	{
+		switch (pCounter)
+		{
+		case TypeCounter::PropertyLookups:			return "PropertyLookups";
+		case TypeCounter::FailedPropertyLookups:	return "FailedPropertyLookups";
+		case TypeCounter::FunctionInvocations:		return "FunctionInvocations";
+		case TypeCounter::Instantiations:			return "Instantiations";
+		case TypeCounter::Clones:					return "Clones";
+		case TypeCounter::BinaryBytesSerialized:	return "BinaryBytesSerialized";
+		case TypeCounter::BinaryBytesDeserialized:	return "BinaryBytesDeserialized";
+		case TypeCounter::JsonBytesSerialized:		return "JsonBytesSerialized";
+		case TypeCounter::JsonBytesDeserialized:	return "JsonBytesDeserialized";
+		case TypeCounter::Count:
+			break;
+		}
+		return "Invalid";
+	}
+
+	void PropertyPathSampler::Record(DIRE_STRING_VIEW pPath)
+	{
+		// Each thread counts down to its next sample: the lookups that are not sampled cost no synchronization at all.
+		thread_local uint32_t theLookupsBeforeSample = 1;
+
+		const uint32_t period = myPeriod.load(std::memory_order_relaxed);
+		if (period == 0)
+			return;
+
+		theLookupsBeforeSample = std::min(theLookupsBeforeSample, period); // in case the period got shorter
+		if (--theLookupsBeforeSample != 0)
+			return;
+
+		theLookupsBeforeSample = period;
+
+		std::lock_guard lock(myMutex);
+
+		DIRE_STRING path(pPath);
+		auto pathIt = myCounts.find(path);
+		if (pathIt != myCounts.end())
+		{
+			pathIt->second++;
+			return;
+		}
+
+		uint64_t count = 1;
+		if (myCounts.size() >= MAX_TRACKED_PATHS)
+		{
+			auto leastSampledIt = std::min_element(myCounts.begin(), myCounts.end(), [](const auto& pLeft, const auto& pRight)
+			{
+				return pLeft.second < pRight.second;
+			});
+			count += leastSampledIt->second;
+			myCounts.erase(leastSampledIt);
+		}
+
+		myCounts.emplace(std::move(path), count);
+	}
+
+	std::vector<PropertyPathSample, DIRE_ALLOCATOR<PropertyPathSample>> PropertyPathSampler::GetTopPaths(size_t pMaxCount) const
+	{
+		std::vector<PropertyPathSample, DIRE_ALLOCATOR<PropertyPathSample>> topPaths;
+		{
+			std::lock_guard lock(myMutex);
+			topPaths.reserve(myCounts.size());
+			for (const auto& [path, count] : myCounts)
+			{
+				topPaths.push_back({ path, count });
+			}
+		}
+
+		std::sort(topPaths.begin(), topPaths.end(), [](const PropertyPathSample& pLeft, const PropertyPathSample& pRight)
+		{
+			return pLeft.Count > pRight.Count || (pLeft.Count == pRight.Count && pLeft.Path < pRight.Path);
+		});
+
+		if (topPaths.size() > pMaxCount)
+		{
+			topPaths.resize(pMaxCount);
+		}
+
+		return topPaths;
+	}
+
+	void PropertyPathSampler::Reset()
+	{
+		std::lock_guard lock(myMutex);
+		myCounts.clear();
+	}
+}
+
+#endif
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "DireDefines.h"
+
+#ifdef DIRE_STATS_ENABLED
+
+#include "dire/Utils/DireString.h"
+#include "dire/DireReflectableID.h"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace DIRE_NS
+{
+	class TypeInfo;
+
+	/**
+	 * \brief The events counted for each type when DIRE_STATS_ENABLED is on.
+	 */
+	enum class TypeCounter : uint8_t
+	{
+		PropertyLookups,		// GetProperty calls on an instance of the type (by string)
+		FailedPropertyLookups,	// the ones that did not find the property
+		FunctionInvocations,	// InvokeFunction calls on an instance of the type
+		Instantiations,			// instances created by the type info database
+		Clones,					// Clone and CloneBatch
+		BinaryBytesSerialized,	// bytes written by the binary serializer for a root object of the type
+		BinaryBytesDeserialized,
+		JsonBytesSerialized,	// bytes written by the JSON serializer for a root object of the type
+		JsonBytesDeserialized,
+		Count
+	};
+
+	[[nodiscard]] Dire_EXPORT const char*	GetTypeCounterName(TypeCounter pCounter);
+
+	/**
+	 * \brief The counters of a type. They are relaxed atomics: any thread can count, and only the totals are meaningful.
+	 */
+	class TypeStats
+	{
+	public:
+		TypeStats() = default;
+
+		TypeStats(const TypeStats&) = delete;
+		TypeStats& operator=(const TypeStats&) = delete;
+
+		void	Add(TypeCounter pCounter, uint64_t pValue)
+		{
+			myCounters[(size_t)pCounter].fetch_add(pValue, std::memory_order_relaxed);
+		}
+
+		[[nodiscard]] uint64_t	Get(TypeCounter pCounter) const
+		{
+			return myCounters[(size_t)pCounter].load(std::memory_order_relaxed);
+		}
+
+		void	Reset()
+		{
+			for (std::atomic<uint64_t>& counter : myCounters)
+			{
+				counter.store(0, std::memory_order_relaxed);
+			}
+		}
+
+	private:
+		std::atomic<uint64_t>	myCounters[(size_t)TypeCounter::Count]{};
+	};
+
+	/**
+	 * \brief The counters of a type at the time of a snapshot.
+	 */
+	struct TypeStatsSnapshot
+	{
+		[[nodiscard]] uint64_t	Get(TypeCounter pCounter) const
+		{
+			return Counters[(size_t)pCounter];
+		}
+
+		ReflectableID		ID = INVALID_REFLECTABLE_ID;
+		DIRE_STRING_VIEW	TypeName;
+		uint64_t			Counters[(size_t)TypeCounter::Count]{};
+	};
+
+	struct PropertyPathSample
+	{
+		DIRE_STRING	Path;
+		uint64_t	Count = 0; // an estimate of the number of lookups of this path, in sampled lookups
+	};
+
+	/**
+	 * \brief The statistics of a type info database, as returned by TypeInfoDatabase::GetStatsSnapshot.
+	 */
+	struct ReflectionStats
+	{
+		std::vector<TypeStatsSnapshot, DIRE_ALLOCATOR<TypeStatsSnapshot>>	Types; // only the types that counted something, in registration order
+		std::vector<PropertyPathSample, DIRE_ALLOCATOR<PropertyPathSample>>	TopPropertyPaths; // most sampled first
+	};
+
+	/**
+	 * \brief Finds the most requested property paths, by sampling one lookup every N per thread.
+	 * It only tracks a bounded number of paths: when a new path is sampled and all slots are taken, it replaces the least sampled one
+	 * and inherits its count (the "space saving" algorithm), so frequent paths can only be overestimated, never missed.
+	 */
+	class PropertyPathSampler
+	{
+	public:
+		static const size_t		MAX_TRACKED_PATHS = 256;
+		static const uint32_t	DEFAULT_SAMPLING_PERIOD = 64;
+
+		/**
+		 * \param pPeriod Samples one lookup out of pPeriod on each thread (1 samples them all, 0 disables sampling)
+		 */
+		void	SetSamplingPeriod(uint32_t pPeriod)
+		{
+			myPeriod.store(pPeriod, std::memory_order_relaxed);
+		}
+
+		Dire_EXPORT void	Record(DIRE_STRING_VIEW pPath);
+
+		[[nodiscard]] Dire_EXPORT std::vector<PropertyPathSample, DIRE_ALLOCATOR<PropertyPathSample>>	GetTopPaths(size_t pMaxCount) const;
+
+		Dire_EXPORT void	Reset();
+
+	private:
+		struct PathHash
+		{
+			size_t	operator()(const DIRE_STRING& pPath) const
+			{
+				return std::hash<DIRE_STRING_VIEW>()(pPath);
+			}
+		};
+
+		using PathCountMap = std::unordered_map<DIRE_STRING, uint64_t, PathHash, std::equal_to<DIRE_STRING>, DIRE_ALLOCATOR<std::pair<const DIRE_STRING, uint64_t>>>;
+
+		std::atomic<uint32_t>	myPeriod{ DEFAULT_SAMPLING_PERIOD };
+		mutable std::mutex		myMutex;
+		PathCountMap			myCounts;
+	};
+}
+
+#endif
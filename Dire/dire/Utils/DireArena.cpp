@@ -0,0 +1,78 @@
+#include "DireArena.h"
+
+#include <cstdint> // uintptr_t
+
+namespace DIRE_NS
+{
+	Arena::Arena(size_t pChunkSize) :
+		myChunkSize(pChunkSize)
+	{
+		DIRE_ASSERT(myChunkSize != 0);
+	}
+
+	Arena::~Arena()
+	{
+		for (const Chunk& chunk : myChunks)
+		{
+			FreeChunk(chunk);
+		}
+	}
+
+	void* Arena::Allocate(size_t pSize, size_t pAlignment)
+	{
+		DIRE_ASSERT(pAlignment != 0 && (pAlignment & (pAlignment - 1)) == 0);
+
+		if (!myChunks.empty())
+		{
+			const Chunk& chunk = myChunks.back();
+			const auto chunkAddress = reinterpret_cast<uintptr_t>(chunk.Memory);
+			const uintptr_t alignedAddress = (chunkAddress + myCurrentOffset + pAlignment - 1) & ~uintptr_t(pAlignment - 1);
+			const size_t alignedOffset = size_t(alignedAddress - chunkAddress);
+			if (alignedOffset + pSize <= chunk.Size)
+			{
+				myUsedBytes += alignedOffset + pSize - myCurrentOffset;
+				myCurrentOffset = alignedOffset + pSize;
+				return chunk.Memory + alignedOffset;
+			}
+		}
+
+		// Doesn't fit: start a new chunk, big enough to hold this allocation whatever the alignment of the chunk memory.
+		PushChunk(pSize + pAlignment - 1);
+		return Allocate(pSize, pAlignment);
+	}
+
+	void Arena::Reset()
+	{
+		for (size_t iChunk = 1; iChunk < myChunks.size(); ++iChunk)
+		{
+			FreeChunk(myChunks[iChunk]);
+		}
+
+		if (!myChunks.empty())
+		{
+			myChunks.resize(1);
+		}
+
+		myCurrentOffset = 0;
+		myUsedBytes = 0;
+	}
+
+	void Arena::PushChunk(size_t pMinimumSize)
+	{
+		Chunk newChunk;
+		newChunk.Size = (pMinimumSize > myChunkSize ? pMinimumSize : myChunkSize);
+
+		DIRE_ALLOCATOR<std::byte> allocator;
+		newChunk.Memory = allocator.allocate(newChunk.Size);
+		DIRE_ASSERT(newChunk.Memory != nullptr);
+
+		myChunks.push_back(newChunk);
+		myCurrentOffset = 0;
+	}
+
+	void Arena::FreeChunk(const Chunk& pChunk)
+	{
+		DIRE_ALLOCATOR<std::byte> allocator;
+		allocator.deallocate(pChunk.Memory, pChunk.Size);
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include "DireDefines.h"
+
+#include <cstddef> // byte, size_t
+#include <vector>
+
+namespace DIRE_NS
+{
+	/**
+	 * \brief A simple bump allocator: memory is carved linearly out of big chunks, and only given back all at once.
+	 * Allocating from it costs a pointer increment most of the time, and consecutive allocations are contiguous in memory.
+	 * The arena never runs destructors: objects constructed in it have to be destroyed by the user before it is reset.
+	 */
+	class Dire_EXPORT Arena
+	{
+	public:
+		static const size_t	DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+		explicit Arena(size_t pChunkSize = DEFAULT_CHUNK_SIZE);
+		~Arena();
+
+		Arena(const Arena&) = delete;
+		Arena& operator=(const Arena&) = delete;
+
+		/**
+		 * \brief Allocates uninitialized memory. Allocations bigger than the chunk size get a chunk of their own.
+		 * \param pSize The number of bytes to allocate
+		 * \param pAlignment The required alignment (must be a power of two)
+		 * \return The allocated memory (never nullptr)
+		 */
+		[[nodiscard]] void*	Allocate(size_t pSize, size_t pAlignment);
+
+		/**
+		 * \brief Makes all the memory of the arena available again. The first chunk is kept to be reused, others are freed.
+		 */
+		void	Reset();
+
+		/**
+		 * \brief The total number of bytes handed out by Allocate since the last Reset (including alignment padding).
+		 */
+		[[nodiscard]] size_t	GetUsedBytes() const { return myUsedBytes; }
+
+	private:
+
+		struct Chunk
+		{
+			std::byte*	Memory = nullptr;
+			size_t		Size = 0;
+		};
+
+		void	PushChunk(size_t pMinimumSize);
+
+		void	FreeChunk(const Chunk& pChunk);
+
+		std::vector<Chunk, DIRE_ALLOCATOR<Chunk>>	myChunks;
+		size_t	myChunkSize = DEFAULT_CHUNK_SIZE;
+		size_t	myCurrentOffset = 0; // in the last chunk
+		size_t	myUsedBytes = 0;
+	};
+}
@@ -1,6 +1,8 @@
 #pragma once
 #include "DireDefines.h"
 
+#include <atomic>
+
 namespace DIRE_NS
 {
 	/**
@@ -17,18 +19,23 @@ namespace DIRE_NS
 
 		IntrusiveListNode(IntrusiveListNode& pNext);
 
-		IntrusiveListNode* Next = nullptr;
+		IntrusiveListNode(const IntrusiveListNode&) = delete;
+		IntrusiveListNode& operator=(const IntrusiveListNode&) = delete;
+
+		std::atomic<IntrusiveListNode*> Next{ nullptr }; // atomic so that a node can be appended while the list is traversed
 	};
 
 	template <typename T>
 	IntrusiveListNode<T>::IntrusiveListNode(IntrusiveListNode& pNext)
 	{
-		Next = &pNext;
+		Next.store(&pNext, std::memory_order_relaxed);
 	}
 
 	/**
 	 * \brief Basic implementation of an intrusive list keeping a pointer to the head and the tail of the list
 	 * Only allows pushing at the back and traversal front to back.
+	 * A node can be pushed while other threads traverse the list: they see it or not, but never a half-linked node.
+	 * Pushes are not synchronized with each other and have to be serialized by the user.
 	 * \tparam T The type of node we store.
 	 */
 	template <typename T>
@@ -92,8 +99,8 @@ namespace DIRE_NS
 
 	private:
 
-		IntrusiveListNode<T>* Head = nullptr;
-		IntrusiveListNode<T>* Tail = nullptr;
+		std::atomic<IntrusiveListNode<T>*>	Head{ nullptr };
+		IntrusiveListNode<T>*				Tail = nullptr; // only used by pushes
 	};
 }
 
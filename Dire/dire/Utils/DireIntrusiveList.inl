@@ -5,7 +5,7 @@ namespace DIRE_NS
 	template <typename T>
 	typename IntrusiveLinkedList<T>::iterator& IntrusiveLinkedList<T>::iterator::operator++()
 	{
-		myNode = myNode->Next;
+		myNode = myNode->Next.load(std::memory_order_acquire);
 		return *this;
 	}
 
@@ -38,7 +38,7 @@ namespace DIRE_NS
 	template <typename T>
 	typename IntrusiveLinkedList<T>::const_iterator& IntrusiveLinkedList<T>::const_iterator::operator++()
 	{
-		myNode = myNode->Next;
+		myNode = myNode->Next.load(std::memory_order_acquire);
 		return *this;
 	}
 
@@ -71,7 +71,7 @@ namespace DIRE_NS
 	template <typename T>
 	typename IntrusiveLinkedList<T>::iterator IntrusiveLinkedList<T>::begin()
 	{
-		return iterator(Head);
+		return iterator(Head.load(std::memory_order_acquire));
 	}
 
 	template <typename T>
@@ -83,7 +83,7 @@ namespace DIRE_NS
 	template <typename T>
 	typename IntrusiveLinkedList<T>::const_iterator IntrusiveLinkedList<T>::begin() const
 	{
-		return const_iterator(Head);
+		return const_iterator(Head.load(std::memory_order_acquire));
 	}
 
 	template <typename T>
@@ -95,11 +95,11 @@ namespace DIRE_NS
 	template <typename T>
 	void IntrusiveLinkedList<T>::PushBackNewNode(IntrusiveListNode<T>& pNewNode)
 	{
-		if (Head == nullptr)
-			Head = &pNewNode;
-
-		if (Tail != nullptr)
-			Tail->Next = &pNewNode;
+		// The node is fully built before being linked: traversals that reach it see it whole.
+		if (Tail == nullptr)
+			Head.store(&pNewNode, std::memory_order_release);
+		else
+			Tail->Next.store(&pNewNode, std::memory_order_release);
 
 		Tail = &pNewNode;
 	}
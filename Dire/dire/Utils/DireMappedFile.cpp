@@ -0,0 +1,178 @@
+#include "DireMappedFile.h"
+
+#include <utility> // exchange
+
+#ifdef _WIN32
+# ifndef WIN32_LEAN_AND_MEAN
+#  define WIN32_LEAN_AND_MEAN
+# endif
+# ifndef NOMINMAX
+#  define NOMINMAX
+# endif
+# include <windows.h>
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+namespace DIRE_NS
+{
+	MappedFile::MappedFile(DIRE_STRING_VIEW pFilePath)
+	{
+		Open(pFilePath);
+	}
+
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+	MappedFile::MappedFile(MappedFile&& pOther) noexcept
+	{
+		*this = std::move(pOther);
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& pOther) noexcept
+	{
+		if (this != &pOther)
+		{
+			Close();
+			myData = std::exchange(pOther.myData, nullptr);
+			mySize = std::exchange(pOther.mySize, 0);
+			myDiscardedSize = std::exchange(pOther.myDiscardedSize, 0);
+			myIsOpen = std::exchange(pOther.myIsOpen, false);
+#ifdef _WIN32
+			myFileHandle = std::exchange(pOther.myFileHandle, nullptr);
+			myMappingHandle = std::exchange(pOther.myMappingHandle, nullptr);
+#endif
+		}
+		return *this;
+	}
+
+#ifdef _WIN32
+	bool MappedFile::Open(DIRE_STRING_VIEW pFilePath)
+	{
+		Close();
+
+		const DIRE_STRING path(pFilePath); // the path has to be null-terminated
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(file, &fileSize))
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		myFileHandle = file;
+		myIsOpen = true;
+		mySize = size_t(fileSize.QuadPart);
+		if (mySize == 0)
+			return true; // a file mapping of an empty file cannot be created
+
+		myMappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (myMappingHandle != nullptr)
+		{
+			myData = static_cast<const char*>(MapViewOfFile(myMappingHandle, FILE_MAP_READ, 0, 0, 0));
+		}
+
+		if (myData == nullptr)
+		{
+			Close();
+			return false;
+		}
+
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (myData != nullptr)
+			UnmapViewOfFile(myData);
+		if (myMappingHandle != nullptr)
+			CloseHandle(myMappingHandle);
+		if (myFileHandle != nullptr)
+			CloseHandle(myFileHandle);
+
+		myData = nullptr;
+		mySize = 0;
+		myDiscardedSize = 0;
+		myIsOpen = false;
+		myFileHandle = nullptr;
+		myMappingHandle = nullptr;
+	}
+
+	void MappedFile::DiscardUntil(size_t /*pSize*/) const
+	{
+		// Not implemented: pages of a file mapping are trimmed from the working set by the system when needed anyway.
+	}
+#else
+	bool MappedFile::Open(DIRE_STRING_VIEW pFilePath)
+	{
+		Close();
+
+		const DIRE_STRING path(pFilePath); // the path has to be null-terminated
+		const int fd = open(path.c_str(), O_RDONLY);
+		if (fd == -1)
+			return false;
+
+		struct stat fileStats{};
+		if (fstat(fd, &fileStats) == -1)
+		{
+			close(fd);
+			return false;
+		}
+
+		const auto fileSize = size_t(fileStats.st_size);
+		if (fileSize != 0)
+		{
+			void* mapping = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (mapping == MAP_FAILED)
+			{
+				close(fd);
+				return false;
+			}
+
+			// Deserialization reads from front to back: let the kernel read ahead aggressively.
+			madvise(mapping, fileSize, MADV_SEQUENTIAL);
+			myData = static_cast<const char*>(mapping);
+		}
+
+		// The mapping stays valid after the file descriptor is closed.
+		close(fd);
+		mySize = fileSize;
+		myIsOpen = true;
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (myData != nullptr)
+		{
+			munmap(const_cast<char*>(myData), mySize);
+		}
+
+		myData = nullptr;
+		mySize = 0;
+		myDiscardedSize = 0;
+		myIsOpen = false;
+	}
+
+	void MappedFile::DiscardUntil(size_t pSize) const
+	{
+		static const auto pageSize = size_t(sysconf(_SC_PAGESIZE));
+
+		// Only whole pages can be discarded
+		const size_t discardedSize = (pSize < mySize ? pSize : mySize) / pageSize * pageSize;
+		if (myData == nullptr || discardedSize <= myDiscardedSize)
+			return;
+
+		madvise(const_cast<char*>(myData) + myDiscardedSize, discardedSize - myDiscardedSize, MADV_DONTNEED);
+		myDiscardedSize = discardedSize;
+	}
+#endif
+}
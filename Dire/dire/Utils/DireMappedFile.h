@@ -0,0 +1,58 @@
+#pragma once
+#include "DireDefines.h"
+#include "dire/Utils/DireString.h"
+
+#include <cstddef> // size_t
+
+namespace DIRE_NS
+{
+	/**
+	 * \brief A read-only view of a whole file mapped in memory (mmap on POSIX systems, a file mapping on Windows).
+	 * Pages are only loaded when they are read, and are backed by the file itself instead of a heap copy of it,
+	 * which keeps the memory footprint of loading very big files low.
+	 * Mapping an empty file succeeds but gives a null data pointer.
+	 */
+	class Dire_EXPORT MappedFile
+	{
+	public:
+		MappedFile() = default;
+		explicit MappedFile(DIRE_STRING_VIEW pFilePath);
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		MappedFile(MappedFile&& pOther) noexcept;
+		MappedFile& operator=(MappedFile&& pOther) noexcept;
+
+		/**
+		 * \brief Maps a file, unmapping the previously mapped one if any.
+		 * \param pFilePath The path of the file to map
+		 * \return true if the file could be opened and mapped
+		 */
+		bool	Open(DIRE_STRING_VIEW pFilePath);
+
+		void	Close();
+
+		/**
+		 * \brief Tells the system the first pSize bytes of the file won't be read anymore, so that their pages can be dropped
+		 * from the process memory (they stay in the system file cache). Reading them again is still valid, it just reloads them.
+		 * Calling it regularly while reading a big file sequentially keeps the peak memory usage low.
+		 */
+		void	DiscardUntil(size_t pSize) const;
+
+		[[nodiscard]] bool			IsOpen() const { return myIsOpen; }
+		[[nodiscard]] const char*	GetData() const { return myData; }
+		[[nodiscard]] size_t		GetSize() const { return mySize; }
+
+	private:
+		const char*		myData = nullptr;
+		size_t			mySize = 0;
+		mutable size_t	myDiscardedSize = 0;
+		bool			myIsOpen = false;
+#ifdef _WIN32
+		void*			myFileHandle = nullptr;
+		void*			myMappingHandle = nullptr;
+#endif
+	};
+}
@@ -0,0 +1,137 @@
+#pragma once
+#include "DireDefines.h"
+
+#include <algorithm> // max
+#include <atomic>
+#include <cstddef> // size_t
+#include <memory> // unique_ptr
+#include <vector>
+
+namespace DIRE_NS
+{
+	/**
+	 * \brief An array that any number of threads can read without locking while elements are added or replaced.
+	 * Writers are not synchronized with each other: their calls have to be serialized by the user (e.g. with a mutex).
+	 * Elements are stored in atomics, so that existing elements are replaced in place. Growing the array copies it into a new buffer
+	 * published atomically: readers still going through the previous buffer keep reading consistent values.
+	 * Previous buffers are only freed with the array: capacities double, so they never take more memory than the current one.
+	 * \tparam T The type of elements, small and trivially copyable (like pointers)
+	 */
+	template <typename T>
+	class SnapshotArray
+	{
+	public:
+		/**
+		 * \brief What a reader sees of the array: the elements added after it was taken are not part of it.
+		 */
+		class View
+		{
+		public:
+			[[nodiscard]] size_t	Size() const { return mySize; }
+
+			T	operator[](size_t pIndex) const
+			{
+				DIRE_ASSERT(pIndex < mySize);
+				return myElements[pIndex].load(std::memory_order_acquire);
+			}
+
+		private:
+			friend SnapshotArray;
+
+			View(const std::atomic<T>* pElements, size_t pSize) :
+				myElements(pElements), mySize(pSize)
+			{}
+
+			const std::atomic<T>*	myElements = nullptr;
+			size_t					mySize = 0;
+		};
+
+		SnapshotArray() = default;
+
+		SnapshotArray(const SnapshotArray&) = delete;
+		SnapshotArray& operator=(const SnapshotArray&) = delete;
+
+		[[nodiscard]] View	GetView() const
+		{
+			// The size first: a buffer published after it is at least as big.
+			const size_t size = mySize.load(std::memory_order_acquire);
+			return { myElements.load(std::memory_order_acquire), size };
+		}
+
+		[[nodiscard]] size_t	Size() const
+		{
+			return mySize.load(std::memory_order_acquire);
+		}
+
+		void	PushBack(T pValue)
+		{
+			const size_t size = mySize.load(std::memory_order_relaxed);
+			Reserve(size + 1);
+			myBuffers.back()[size].store(pValue, std::memory_order_relaxed);
+			mySize.store(size + 1, std::memory_order_release);
+		}
+
+		/**
+		 * \brief Replaces an element. Setting an element past the end grows the array, filling the gap with value-initialized elements.
+		 */
+		void	Set(size_t pIndex, T pValue)
+		{
+			const size_t size = mySize.load(std::memory_order_relaxed);
+			if (pIndex < size)
+			{
+				myBuffers.back()[pIndex].store(pValue, std::memory_order_release);
+				return;
+			}
+
+			Reserve(pIndex + 1);
+			for (size_t iElem = size; iElem < pIndex; ++iElem)
+			{
+				myBuffers.back()[iElem].store(T{}, std::memory_order_relaxed);
+			}
+			myBuffers.back()[pIndex].store(pValue, std::memory_order_relaxed);
+			mySize.store(pIndex + 1, std::memory_order_release);
+		}
+
+	private:
+		static constexpr size_t	MIN_CAPACITY = 16;
+
+		static std::unique_ptr<std::atomic<T>[]>	AllocateBuffer(size_t pCapacity)
+		{
+			std::unique_ptr<std::atomic<T>[]> buffer = std::make_unique<std::atomic<T>[]>(pCapacity);
+			for (size_t iElem = 0; iElem < pCapacity; ++iElem)
+			{
+				buffer[iElem].store(T{}, std::memory_order_relaxed);
+			}
+			return buffer;
+		}
+
+		void	Reserve(size_t pCapacity)
+		{
+			if (pCapacity <= myCapacity)
+				return;
+
+			const size_t capacity = std::max({ pCapacity, myCapacity * 2, MIN_CAPACITY });
+			std::unique_ptr<std::atomic<T>[]> buffer = AllocateBuffer(capacity);
+			const size_t size = mySize.load(std::memory_order_relaxed);
+			for (size_t iElem = 0; iElem < size; ++iElem)
+			{
+				buffer[iElem].store(myBuffers.back()[iElem].load(std::memory_order_relaxed), std::memory_order_relaxed);
+			}
+			PublishBuffer(std::move(buffer), capacity);
+		}
+
+		void	PublishBuffer(std::unique_ptr<std::atomic<T>[]> pBuffer, size_t pCapacity)
+		{
+			myElements.store(pBuffer.get(), std::memory_order_release);
+			myBuffers.push_back(std::move(pBuffer));
+			myCapacity = pCapacity;
+		}
+
+		using BufferPtr = std::unique_ptr<std::atomic<T>[]>;
+
+		std::atomic<std::atomic<T>*>						myElements{ nullptr }; // the last buffer
+		std::atomic<size_t>									mySize{ 0 };
+		std::vector<BufferPtr, DIRE_ALLOCATOR<BufferPtr>>	myBuffers; // the last one is the current one
+		size_t												myCapacity = 0;
+	};
+}
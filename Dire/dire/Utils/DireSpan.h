@@ -0,0 +1,35 @@
+#pragma once
+#include "DireDefines.h"
+
+#include <cstddef> // size_t
+
+namespace DIRE_NS
+{
+	/**
+	 * \brief A minimal non-owning view over a contiguous sequence of objects (DIRE targets C++17, which has no std::span).
+	 * \tparam T The type of viewed objects
+	 */
+	template <typename T>
+	class Span
+	{
+	public:
+		Span() = default;
+
+		Span(T* pData, const size_t pSize) :
+			myData(pData), mySize(pSize)
+		{}
+
+		[[nodiscard]] T*		Data() const { return myData; }
+		[[nodiscard]] size_t	Size() const { return mySize; }
+		[[nodiscard]] bool		Empty() const { return mySize == 0; }
+
+		T&	operator[](const size_t pIndex) const { return myData[pIndex]; }
+
+		T*	begin() const { return myData; }
+		T*	end() const { return myData + mySize; }
+
+	private:
+		T*		myData = nullptr;
+		size_t	mySize = 0;
+	};
+}
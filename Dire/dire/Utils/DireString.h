@@ -4,6 +4,7 @@
 #include <charconv> // from_chars
 #include <system_error>
 #include <variant>
+#include <cstdint> // uint64_t
 #include "DireDefines.h"
 
 namespace DIRE_NS
@@ -25,6 +26,24 @@ namespace DIRE_NS
 		{
 			return ADL::AsString(std::forward<T>(t));
 		}
+
+		using HashType = uint64_t;
+
+		/**
+		 * \brief Computes the 64-bit FNV-1a hash of a string. Usable at compile-time to precompute hashes of names.
+		 * \param pStr The string to hash
+		 * \return The string's hash
+		 */
+		constexpr HashType	Hash(DIRE_STRING_VIEW pStr)
+		{
+			HashType hash = 0xcbf29ce484222325ull; // FNV offset basis
+			for (const char c : pStr)
+			{
+				hash ^= HashType(static_cast<unsigned char>(c));
+				hash *= 0x100000001b3ull; // FNV prime
+			}
+			return hash;
+		}
 	}
 
 	using ConvertError = DIRE_STRING;
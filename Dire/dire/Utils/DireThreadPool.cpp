@@ -0,0 +1,156 @@
+#include "DireThreadPool.h"
+
+#include <algorithm> // min
+
+namespace DIRE_NS
+{
+	ThreadPool::ThreadPool(size_t pThreadCount)
+	{
+		if (pThreadCount == 0)
+		{
+			pThreadCount = std::max<size_t>(std::thread::hardware_concurrency(), 1); // can be 0 if it is unknown
+		}
+
+		myThreadCount = pThreadCount;
+		myQueues = std::make_unique<WorkQueue[]>(myThreadCount);
+
+		myThreads.reserve(myThreadCount - 1);
+		for (size_t iWorker = 1; iWorker < myThreadCount; ++iWorker)
+		{
+			myThreads.emplace_back(&ThreadPool::WorkerLoop, this, iWorker);
+		}
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(myLoopMutex);
+			myIsStopping = true;
+		}
+		myLoopStarted.notify_all();
+
+		for (std::thread& thread : myThreads)
+		{
+			thread.join();
+		}
+	}
+
+	void ThreadPool::Run(size_t pCount, size_t pChunkSize, void* pContext, ChunkFunction pFunction)
+	{
+		if (pCount == 0)
+			return;
+
+		pChunkSize = std::max<size_t>(pChunkSize, 1);
+		const size_t nbChunks = (pCount + pChunkSize - 1) / pChunkSize;
+		if (myThreadCount == 1 || nbChunks == 1)
+		{
+			for (size_t begin = 0; begin < pCount; begin += pChunkSize)
+			{
+				pFunction(pContext, 0, begin, std::min(begin + pChunkSize, pCount));
+			}
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(myLoopMutex);
+			myContext = pContext;
+			myFunction = pFunction;
+			myCount = pCount;
+			myChunkSize = pChunkSize;
+
+			// The workers are all waiting for the loop: their queues can be filled without locking them.
+			for (size_t iWorker = 0; iWorker < myThreadCount; ++iWorker)
+			{
+				myQueues[iWorker].Begin = nbChunks * iWorker / myThreadCount;
+				myQueues[iWorker].End = nbChunks * (iWorker + 1) / myThreadCount;
+			}
+
+			myBusyWorkers = myThreadCount - 1;
+			myLoopGeneration++;
+		}
+		myLoopStarted.notify_all();
+
+		RunChunks(0);
+
+		std::unique_lock<std::mutex> lock(myLoopMutex);
+		myLoopFinished.wait(lock, [this]() { return myBusyWorkers == 0; });
+	}
+
+	void ThreadPool::WorkerLoop(size_t pWorker)
+	{
+		uint64_t lastGeneration = 0;
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(myLoopMutex);
+				myLoopStarted.wait(lock, [&]() { return myIsStopping || myLoopGeneration != lastGeneration; });
+				if (myIsStopping)
+					return;
+
+				// Run waits for every worker before returning: no loop can be missed.
+				lastGeneration = myLoopGeneration;
+			}
+
+			RunChunks(pWorker);
+
+			bool isLastWorker;
+			{
+				std::lock_guard<std::mutex> lock(myLoopMutex);
+				isLastWorker = (--myBusyWorkers == 0);
+			}
+			if (isLastWorker)
+			{
+				myLoopFinished.notify_one();
+			}
+		}
+	}
+
+	void ThreadPool::RunChunks(size_t pWorker)
+	{
+		size_t iChunk = 0;
+		while (PopChunk(pWorker, iChunk) || (StealChunks(pWorker) && PopChunk(pWorker, iChunk)))
+		{
+			const size_t begin = iChunk * myChunkSize;
+			myFunction(myContext, pWorker, begin, std::min(begin + myChunkSize, myCount));
+		}
+	}
+
+	bool ThreadPool::PopChunk(size_t pWorker, size_t& pChunk)
+	{
+		WorkQueue& queue = myQueues[pWorker];
+		std::lock_guard<std::mutex> lock(queue.Mutex);
+		if (queue.Begin == queue.End)
+			return false;
+
+		pChunk = queue.Begin++;
+		return true;
+	}
+
+	bool ThreadPool::StealChunks(size_t pThief)
+	{
+		// Loops do not create chunks: once all the queues are seen empty, the thief is done.
+		for (size_t iOffset = 1; iOffset < myThreadCount; ++iOffset)
+		{
+			WorkQueue& victim = myQueues[(pThief + iOffset) % myThreadCount];
+			size_t stolenBegin, stolenEnd;
+			{
+				std::lock_guard<std::mutex> lock(victim.Mutex);
+				const size_t nbChunks = victim.End - victim.Begin;
+				if (nbChunks == 0)
+					continue;
+
+				stolenEnd = victim.End;
+				stolenBegin = victim.End - (nbChunks + 1) / 2;
+				victim.End = stolenBegin;
+			}
+
+			WorkQueue& queue = myQueues[pThief];
+			std::lock_guard<std::mutex> lock(queue.Mutex);
+			queue.Begin = stolenBegin;
+			queue.End = stolenEnd;
+			return true;
+		}
+
+		return false;
+	}
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include "DireDefines.h"
+
+#include <condition_variable>
+#include <cstddef> // size_t
+#include <cstdint>
+#include <memory> // unique_ptr
+#include <mutex>
+#include <thread>
+#include <type_traits> // remove_reference
+#include <vector>
+
+namespace DIRE_NS
+{
+	/**
+	 * \brief A fixed set of worker threads running parallel loops with work stealing.
+	 * The iterations of a loop are cut in chunks, spread evenly over the queues of the threads: each thread pops chunks from the front
+	 * of its own queue, and once it is empty, steals the back half of the queue of another thread. Threads working on cheaper chunks
+	 * thus help the others instead of waiting for them, whatever the cost of each iteration.
+	 * The thread calling ParallelFor takes part in the loop as worker 0, and only one loop runs at a time.
+	 */
+	class Dire_EXPORT ThreadPool
+	{
+	public:
+		/**
+		 * \param pThreadCount The number of threads running the loops, the calling thread included.
+		 * 0 uses the number of hardware threads. A pool of 1 thread runs the loops on the calling thread only.
+		 */
+		explicit ThreadPool(size_t pThreadCount = 0);
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		/**
+		 * \brief The number of threads running the loops, the calling thread included.
+		 */
+		[[nodiscard]] size_t	GetThreadCount() const
+		{
+			return myThreadCount;
+		}
+
+		/**
+		 * \brief Runs a loop of pCount iterations in parallel, and returns once they are all done.
+		 * \param pCount The number of iterations
+		 * \param pChunkSize The number of consecutive iterations given to a thread at once (at least 1)
+		 * \param pFunc The function running a chunk, called once per chunk as pFunc(size_t pWorker, size_t pBegin, size_t pEnd):
+		 * pWorker is the index of the thread running the chunk, below GetThreadCount(), to use per-thread data without synchronization.
+		 */
+		template <typename Func>
+		void	ParallelFor(size_t pCount, size_t pChunkSize, Func&& pFunc)
+		{
+			using FuncType = std::remove_reference_t<Func>;
+			Run(pCount, pChunkSize, &pFunc, [](void* pContext, size_t pWorker, size_t pBegin, size_t pEnd)
+			{
+				(*static_cast<FuncType*>(pContext))(pWorker, pBegin, pEnd);
+			});
+		}
+
+	private:
+		using ChunkFunction = void (*)(void* pContext, size_t pWorker, size_t pBegin, size_t pEnd);
+
+		/**
+		 * \brief The chunks left to a thread: the owner pops them from the front, thieves from the back.
+		 */
+		struct alignas(64) WorkQueue // one cache line each, not to slow down the other threads popping their own chunks
+		{
+			std::mutex	Mutex;
+			size_t		Begin = 0; // chunk indices
+			size_t		End = 0;
+		};
+
+		void	Run(size_t pCount, size_t pChunkSize, void* pContext, ChunkFunction pFunction);
+
+		void	WorkerLoop(size_t pWorker);
+
+		/**
+		 * \brief Runs chunks of the current loop until there are none left to pop or steal.
+		 */
+		void	RunChunks(size_t pWorker);
+
+		bool	PopChunk(size_t pWorker, size_t& pChunk);
+
+		/**
+		 * \brief Moves the back half of the chunks of another thread to the queue of pThief.
+		 * \return false if all the other queues are empty
+		 */
+		bool	StealChunks(size_t pThief);
+
+		std::vector<std::thread>		myThreads; // workers 1 to myThreadCount-1
+		std::unique_ptr<WorkQueue[]>	myQueues;
+		size_t							myThreadCount = 1;
+
+		// The current loop
+		void*			myContext = nullptr;
+		ChunkFunction	myFunction = nullptr;
+		size_t			myCount = 0;
+		size_t			myChunkSize = 1;
+
+		std::mutex				myLoopMutex;
+		std::condition_variable	myLoopStarted;
+		std::condition_variable	myLoopFinished;
+		uint64_t				myLoopGeneration = 0; // incremented for each loop, to wake up the workers
+		size_t					myBusyWorkers = 0;
+		bool					myIsStopping = false;
+	};
+}
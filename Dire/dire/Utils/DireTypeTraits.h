@@ -77,6 +77,7 @@ namespace DIRE_NS
 	MEMBER_FUNCTION_ALIAS_DETECTOR_PARAM1(MapErase, erase, typename T::key_type())
 	MEMBER_FUNCTION_DETECTOR(clear)
 	MEMBER_FUNCTION_DETECTOR(size)
+	MEMBER_FUNCTION_DETECTOR(data)
 
 	DECLARE_HAS_TYPE_DETECTOR(HasValueType, value_type)
 	DECLARE_HAS_TYPE_DETECTOR(HasKeyType, key_type)
@@ -0,0 +1,128 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "dire/Dire.h"
+
+#include "BenchmarkClasses.h"
+#include "BenchmarkSizes.h"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#ifdef DIRE_COMPILE_BINARY_SERIALIZATION
+
+namespace
+{
+	const size_t	NB_ENTITIES = 20000;
+
+	// A level-like mix: mostly small components, some entities and characters, a few players.
+	std::vector<std::unique_ptr<dire::Reflectable>>	MakeEntities()
+	{
+		std::vector<std::unique_ptr<dire::Reflectable>> entities;
+		entities.reserve(NB_ENTITIES);
+		for (size_t iEntity = 0; iEntity < NB_ENTITIES; ++iEntity)
+		{
+			const int id = int(iEntity);
+			switch (iEntity % 10)
+			{
+			case 0:
+			{
+				auto player = std::make_unique<bench::Player>();
+				player->id = id;
+				player->score = id * 10;
+				player->inventory.resize(iEntity % 64, id);
+				for (int iSocket = 0; iSocket < 4; ++iSocket)
+				{
+					player->sockets[iSocket].position.x = float(iSocket);
+				}
+				entities.push_back(std::move(player));
+				break;
+			}
+			case 1:
+			case 2:
+			{
+				auto character = std::make_unique<bench::Character>();
+				character->id = id;
+				character->level = id % 100;
+				entities.push_back(std::move(character));
+				break;
+			}
+			case 3:
+			case 4:
+			case 5:
+			{
+				auto entity = std::make_unique<bench::Entity>();
+				entity->id = id;
+				entity->health = double(iEntity % 100);
+				entities.push_back(std::move(entity));
+				break;
+			}
+			default:
+			{
+				auto component = std::make_unique<bench::Component>();
+				component->id = id;
+				component->transform.position.y = float(iEntity);
+				entities.push_back(std::move(component));
+				break;
+			}
+			}
+		}
+		return entities;
+	}
+
+	std::vector<size_t>	GetThreadCounts()
+	{
+		const size_t nbHardwareThreads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+		std::vector<size_t> threadCounts;
+		for (size_t nbThreads = 1; nbThreads < nbHardwareThreads; nbThreads *= 2)
+		{
+			threadCounts.push_back(nbThreads);
+		}
+		threadCounts.push_back(nbHardwareThreads);
+		return threadCounts;
+	}
+}
+
+TEST_CASE("Batch serialization: scaling from 1 to N threads", "[Benchmark][Binary][Batch]")
+{
+	const std::vector<std::unique_ptr<dire::Reflectable>> entities = MakeEntities();
+	std::vector<const dire::Reflectable*> entityPtrs;
+	for (const auto& entity : entities)
+	{
+		entityPtrs.push_back(entity.get());
+	}
+	const dire::Span<const dire::Reflectable* const> entitySpan(entityPtrs.data(), entityPtrs.size());
+
+	for (const size_t nbThreads : GetThreadCounts())
+	{
+		dire::ThreadPool pool(nbThreads);
+		dire::BatchSerializer batchSerializer(pool, []() -> std::unique_ptr<dire::ISerializer> { return std::make_unique<dire::BinaryReflectorSerializer>(); });
+		dire::BatchDeserializer batchDeserializer(pool, []() -> std::unique_ptr<dire::IDeserializer> { return std::make_unique<dire::BinaryReflectorDeserializer>(); });
+
+		dire::SerializedBatch batch;
+		(void)batchSerializer.Serialize(entitySpan, batch);
+		if (nbThreads == 1)
+		{
+			bench::ReportSize(std::to_string(NB_ENTITIES) + " entities", batch.Bytes.size(), NB_ENTITIES);
+		}
+
+		BENCHMARK(std::string("Serialize ") + std::to_string(NB_ENTITIES) + " entities, " + std::to_string(nbThreads) + " thread(s)")
+		{
+			return batchSerializer.Serialize(entitySpan, batch).HasError();
+		};
+
+		std::vector<dire::Reflectable*> deserialized(batch.GetCount());
+		BENCHMARK(std::string("Deserialize ") + std::to_string(NB_ENTITIES) + " entities, " + std::to_string(nbThreads) + " thread(s)")
+		{
+			const bool hasError = batchDeserializer.Deserialize(batch, { deserialized.data(), deserialized.size() }).HasError();
+			for (dire::Reflectable* entity : deserialized)
+			{
+				delete entity;
+			}
+			return hasError;
+		};
+	}
+}
+
+#endif
@@ -0,0 +1,123 @@
+#pragma once
+#include "dire/DireEnums.h"
+#include "dire/DireProperty.h"
+#include "dire/DireReflectable.h"
+
+#include <map>
+#include <vector>
+
+// Fixture types shared by the benchmarks: a few levels of compounds, arrays and maps, and a deep inheritance chain.
+
+namespace bench
+{
+	// Enums the way gameplay data uses them, for string conversions.
+	// They come before the reflectables, whose macros declare a nested namespace named like the library one.
+	DIRE_SEQUENTIAL_ENUM(ItemKind, int, Sword, Shield, Bow, Arrow, Potion, Scroll, Ring, Amulet, Helmet, Armor, Boots, Gloves, Key, Gem, Coin, Torch);
+	DIRE_BITMASK_ENUM(EntityFlags, uint32_t, Visible, Solid, Static, Interactive, Hostile, Friendly, Flying, Swimming);
+
+	dire_reflectable(struct Vec3)
+	{
+		DIRE_REFLECTABLE_INFO()
+
+		DIRE_PROPERTY(float, x, 0.f)
+		DIRE_PROPERTY(float, y, 0.f)
+		DIRE_PROPERTY(float, z, 0.f)
+	};
+
+	dire_reflectable(struct Transform)
+	{
+		DIRE_REFLECTABLE_INFO()
+
+		DIRE_PROPERTY(Vec3, position)
+		DIRE_PROPERTY(Vec3, scale)
+		DIRE_ARRAY_PROPERTY(float, matrix, [16])
+	};
+
+	dire_reflectable(struct Component)
+	{
+		DIRE_REFLECTABLE_INFO()
+
+		DIRE_PROPERTY(int, id, 0)
+		DIRE_PROPERTY(bool, enabled, true)
+		DIRE_PROPERTY(Transform, transform)
+	};
+
+	dire_reflectable(struct Entity, Component)
+	{
+		DIRE_REFLECTABLE_INFO()
+
+		DIRE_PROPERTY(double, health, 100.0)
+		DIRE_PROPERTY(unsigned, flags, 0)
+		DIRE_ARRAY_PROPERTY(Transform, bones, [4])
+	};
+
+	dire_reflectable(struct Character, Entity)
+	{
+		DIRE_REFLECTABLE_INFO()
+
+		DIRE_PROPERTY(int, level, 1)
+		DIRE_PROPERTY((std::vector<int>), inventory, std::initializer_list<int>{1, 2, 3, 4})
+		DIRE_PROPERTY((std::map<int, Transform>), sockets)
+	};
+
+	dire_reflectable(struct Player, Character)
+	{
+		DIRE_REFLECTABLE_INFO()
+
+		DIRE_PROPERTY(int64_t, score, 0)
+		DIRE_PROPERTY(float, speed, 1.f)
+		DIRE_PROPERTY(Transform, camera)
+
+		DIRE_FUNCTION(float, Move, const Vec3& pDirection, float pDeltaTime, int64_t pTicks) // defined in FunctionBenchmarks.cpp
+	};
+
+	// Big arrays of fundamental types, like baked animation curves or navigation meshes.
+	dire_reflectable(struct AnimationCurves)
+	{
+		DIRE_REFLECTABLE_INFO()
+
+		DIRE_PROPERTY((std::vector<float>), times)
+		DIRE_PROPERTY((std::vector<float>), values)
+		DIRE_PROPERTY((std::vector<int>), keyIndices)
+	};
+
+	// A deep inheritance chain of small classes, the worst case for walking the hierarchy property by property.
+#define BENCH_DEEP_LAYER(Name, Parent) \
+	dire_reflectable(struct Name, Parent) \
+	{ \
+		DIRE_REFLECTABLE_INFO() \
+		DIRE_PROPERTY(int, Name##_i, 0) \
+		DIRE_PROPERTY(float, Name##_f, 0.f) \
+		DIRE_PROPERTY(double, Name##_d, 0.0) \
+		DIRE_PROPERTY(bool, Name##_b, false) \
+	};
+	dire_reflectable(struct Deep0)
+	{
+		DIRE_REFLECTABLE_INFO()
+
+		DIRE_PROPERTY(int, Deep0_i, 0)
+		DIRE_PROPERTY(float, Deep0_f, 0.f)
+		DIRE_PROPERTY(double, Deep0_d, 0.0)
+		DIRE_PROPERTY(bool, Deep0_b, false)
+	};
+
+	BENCH_DEEP_LAYER(Deep1, Deep0)
+	BENCH_DEEP_LAYER(Deep2, Deep1)
+	BENCH_DEEP_LAYER(Deep3, Deep2)
+	BENCH_DEEP_LAYER(Deep4, Deep3)
+	BENCH_DEEP_LAYER(Deep5, Deep4)
+	BENCH_DEEP_LAYER(Deep6, Deep5)
+	BENCH_DEEP_LAYER(Deep7, Deep6)
+
+#undef BENCH_DEEP_LAYER
+
+	// A level of any size: a big map of compounds, plus enums.
+	dire_reflectable(struct Level)
+	{
+		DIRE_REFLECTABLE_INFO()
+
+		DIRE_PROPERTY((std::map<int, Character>), characters)
+		DIRE_PROPERTY((std::vector<ItemKind>), loot)
+		DIRE_PROPERTY(EntityFlags, defaultFlags)
+	};
+}
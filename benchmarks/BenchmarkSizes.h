@@ -0,0 +1,15 @@
+#pragma once
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <string>
+
+namespace bench
+{
+	// Reports the size of some encoded data through the Catch2 reporter, so that it ends up in the benchmark report.
+	// Warnings are written by every reporter, even when nothing fails. benchmark_report.py parses this exact message.
+	inline void	ReportSize(const std::string& pName, size_t pNbBytes, size_t pNbObjects = 1)
+	{
+		WARN("Size of " << pName << ": " << pNbBytes << " bytes, " << pNbObjects << " object(s)");
+	}
+}
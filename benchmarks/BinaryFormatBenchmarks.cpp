@@ -0,0 +1,149 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "dire/Dire.h"
+
+#include "BenchmarkClasses.h"
+#include "BenchmarkSizes.h"
+
+#ifdef DIRE_COMPILE_BINARY_SERIALIZATION
+
+namespace
+{
+	void	FillPlayer(bench::Player& pPlayer)
+	{
+		pPlayer.id = 42;
+		pPlayer.level = 17;
+		pPlayer.score = 123456;
+		pPlayer.flags = 0x5;
+		pPlayer.inventory = { 1, 2, 3, 4, 5, 6, 7, 8, 100, 200, 300, 400 };
+		for (int iSocket = 0; iSocket < 4; ++iSocket)
+		{
+			pPlayer.sockets[iSocket].position.x = float(iSocket);
+		}
+	}
+
+	template <typename T>
+	void	BenchmarkFormat(const char* pName, const T& pObject, dire::BinaryFormat pFormat)
+	{
+		dire::BinaryReflectorSerializer serializer;
+		serializer.SetFormat(pFormat);
+		dire::BinaryReflectorDeserializer deserializer;
+		deserializer.SetFormat(pFormat);
+
+		const dire::ISerializer::Result serialized = serializer.Serialize(pObject);
+		const auto& bytes = serialized.GetBytes();
+		const char* formatName = (pFormat == dire::BinaryFormat::Native ? "native" : pFormat == dire::BinaryFormat::Compact ? "compact" : "schema");
+		bench::ReportSize(std::string(pName) + " (" + formatName + ")", bytes.size());
+
+		BENCHMARK(std::string("Encode ") + pName + " (" + formatName + ")")
+		{
+			return serializer.Serialize(pObject).GetBytes().size();
+		};
+
+		BENCHMARK(std::string("Decode ") + pName + " (" + formatName + ")")
+		{
+			T deserialized;
+			return deserializer.DeserializeInto(reinterpret_cast<const char*>(bytes.data()), bytes.size(), deserialized).HasError();
+		};
+	}
+}
+
+TEST_CASE("Binary formats: native vs. compact vs. schema", "[Benchmark][Binary][Format]")
+{
+	bench::Player player;
+	FillPlayer(player);
+	BenchmarkFormat("Player", player, dire::BinaryFormat::Native);
+	BenchmarkFormat("Player", player, dire::BinaryFormat::Compact);
+	BenchmarkFormat("Player", player, dire::BinaryFormat::Schema);
+
+	bench::Deep7 deep;
+	BenchmarkFormat("Deep7", deep, dire::BinaryFormat::Native);
+	BenchmarkFormat("Deep7", deep, dire::BinaryFormat::Compact);
+	BenchmarkFormat("Deep7", deep, dire::BinaryFormat::Schema);
+
+	// Arrays of small integers: a bulk copy in the native format, a varint per element in the compact one.
+	bench::AnimationCurves curves;
+	curves.keyIndices.resize(64 * 1024);
+	for (size_t iKey = 0; iKey < curves.keyIndices.size(); ++iKey)
+	{
+		curves.keyIndices[iKey] = int(iKey % 100);
+	}
+	BenchmarkFormat("64K small ints", curves, dire::BinaryFormat::Native);
+	BenchmarkFormat("64K small ints", curves, dire::BinaryFormat::Compact);
+	BenchmarkFormat("64K small ints", curves, dire::BinaryFormat::Schema);
+}
+
+TEST_CASE("Binary schema format: reading data of another layout", "[Benchmark][Binary][Format]")
+{
+	bench::Player player;
+	FillPlayer(player);
+
+	dire::BinaryReflectorSerializer serializer;
+	serializer.SetFormat(dire::BinaryFormat::Schema);
+	dire::BinaryReflectorDeserializer deserializer;
+	deserializer.SetFormat(dire::BinaryFormat::Schema);
+
+	const dire::ISerializer::Result serialized = serializer.Serialize(player);
+	const auto& bytes = serialized.GetBytes();
+
+	// A Character has the properties of a Player minus the ones Player declares: their records are skipped.
+	BENCHMARK("Decode Player into the same layout")
+	{
+		bench::Player deserialized;
+		return deserializer.DeserializeInto(reinterpret_cast<const char*>(bytes.data()), bytes.size(), deserialized).HasError();
+	};
+
+	BENCHMARK("Decode Player into an older layout (Character)")
+	{
+		bench::Character deserialized;
+		return deserializer.DeserializeInto(reinterpret_cast<const char*>(bytes.data()), bytes.size(), deserialized).HasError();
+	};
+}
+
+TEST_CASE("Binary delta serialization: full vs. delta against a baseline", "[Benchmark][Binary][Format][Delta]")
+{
+	bench::Player baseline;
+	FillPlayer(baseline);
+	bench::Player player = baseline;
+	player.score += 100;
+	player.inventory[3] = 42;
+
+	// A replication-like update: a few values of a big array changed since the last sent state.
+	bench::AnimationCurves baselineCurves;
+	baselineCurves.keyIndices.resize(64 * 1024, 7);
+	bench::AnimationCurves curves = baselineCurves;
+	for (size_t iKey = 0; iKey < curves.keyIndices.size(); iKey += 4096)
+	{
+		curves.keyIndices[iKey] = 8;
+	}
+
+	dire::BinaryReflectorSerializer serializer;
+	serializer.SetFormat(dire::BinaryFormat::Compact);
+	bench::ReportSize("Player (full)", serializer.Serialize(player).GetBytes().size());
+	bench::ReportSize("Player (delta)", serializer.SerializeDelta(player, baseline).GetBytes().size());
+	bench::ReportSize("64K small ints (full)", serializer.Serialize(curves).GetBytes().size());
+	bench::ReportSize("64K small ints (delta)", serializer.SerializeDelta(curves, baselineCurves).GetBytes().size());
+
+	BENCHMARK("Encode Player (full)")
+	{
+		return serializer.Serialize(player).GetBytes().size();
+	};
+
+	BENCHMARK("Encode Player (delta)")
+	{
+		return serializer.SerializeDelta(player, baseline).GetBytes().size();
+	};
+
+	BENCHMARK("Encode 64K small ints (full)")
+	{
+		return serializer.Serialize(curves).GetBytes().size();
+	};
+
+	BENCHMARK("Encode 64K small ints (delta)")
+	{
+		return serializer.SerializeDelta(curves, baselineCurves).GetBytes().size();
+	};
+}
+
+#endif
@@ -0,0 +1,205 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "dire/Dire.h"
+
+#include "BenchmarkClasses.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+#ifdef __GLIBC__
+# include <malloc.h> // malloc_trim
+#endif
+
+#ifdef DIRE_COMPILE_BINARY_SERIALIZATION
+
+namespace
+{
+	const size_t	NB_CURVE_KEYS = 2 * 1024 * 1024;
+	const char*		CURVES_FILE = "bench_curves.bin";
+
+	void	FillCurves(bench::AnimationCurves& pCurves)
+	{
+		pCurves.times.resize(NB_CURVE_KEYS);
+		pCurves.values.resize(NB_CURVE_KEYS);
+		pCurves.keyIndices.resize(NB_CURVE_KEYS);
+		for (size_t iKey = 0; iKey < NB_CURVE_KEYS; ++iKey)
+		{
+			pCurves.times[iKey] = float(iKey) * 0.016f;
+			pCurves.values[iKey] = float(iKey % 360);
+			pCurves.keyIndices[iKey] = int(iKey);
+		}
+	}
+
+	// What saving a file looked like before sinks: serialize it all in memory, then write it.
+	bool	SaveInMemory(const bench::AnimationCurves& pCurves)
+	{
+		dire::BinaryReflectorSerializer serializer;
+		const dire::ISerializer::Result result = serializer.Serialize(pCurves);
+		const auto& bytes = result.GetBytes();
+		std::ofstream file(CURVES_FILE, std::ios::binary);
+		file.write(reinterpret_cast<const char*>(bytes.data()), std::streamsize(bytes.size()));
+		return !result.HasError() && file.good();
+	}
+
+	bool	SaveToSink(const bench::AnimationCurves& pCurves)
+	{
+		FILE* file = std::fopen(CURVES_FILE, "wb");
+		if (file == nullptr)
+			return false;
+
+#ifdef _WIN32
+		dire::FileDescriptorSink sink(_fileno(file));
+#else
+		dire::FileDescriptorSink sink(fileno(file));
+#endif
+		dire::BinaryReflectorSerializer serializer;
+		const bool saved = !serializer.SerializeTo(pCurves, sink).HasError();
+		std::fclose(file);
+		return saved;
+	}
+
+	void	WriteCurvesFile()
+	{
+		bench::AnimationCurves curves;
+		FillCurves(curves);
+		SaveToSink(curves);
+	}
+
+	// What loading a file looked like before memory mapping: read it all in a string, then deserialize.
+	bool	LoadWithIfstream(bench::AnimationCurves& pCurves)
+	{
+		const DIRE_STRING fileBuffer = dire::TypeInfoDatabase::BinaryImport(CURVES_FILE);
+		dire::BinaryReflectorDeserializer deserializer;
+		return !deserializer.DeserializeInto(fileBuffer.data(), fileBuffer.size(), pCurves).HasError();
+	}
+
+	bool	LoadWithMapping(bench::AnimationCurves& pCurves)
+	{
+		dire::BinaryReflectorDeserializer deserializer;
+		return !deserializer.DeserializeFileInto(CURVES_FILE, pCurves).HasError();
+	}
+
+#ifdef __linux__
+	// Reads a "VmXXX:  1234 kB" line of /proc/self/status, in KiB.
+	size_t	ReadProcStatus(const char* pField)
+	{
+		std::ifstream status("/proc/self/status");
+		std::string line;
+		const size_t fieldLength = strlen(pField);
+		while (std::getline(status, line))
+		{
+			if (line.compare(0, fieldLength, pField) == 0)
+			{
+				return size_t(std::stoul(line.substr(fieldLength + 1)));
+			}
+		}
+		return 0;
+	}
+
+	// Resets the peak resident set size (VmHWM) to the current one.
+	void	ResetPeakRSS()
+	{
+		std::ofstream clearRefs("/proc/self/clear_refs");
+		clearRefs << "5";
+	}
+
+	template <typename Func>
+	size_t	MeasurePeakRSSIncrease(Func pFunc)
+	{
+#ifdef __GLIBC__
+		// Give the memory freed by previous runs back to the system, or reusing it would not show in the RSS.
+		malloc_trim(0);
+#endif
+		ResetPeakRSS();
+		const size_t baseRSS = ReadProcStatus("VmRSS:");
+		REQUIRE(pFunc());
+		return ReadProcStatus("VmHWM:") - baseRSS;
+	}
+#endif
+}
+
+TEST_CASE("Binary serialization of big fundamental arrays", "[Benchmark][Binary]")
+{
+	bench::AnimationCurves curves;
+	FillCurves(curves);
+
+	BENCHMARK("Serialize 3 x 2M keys")
+	{
+		dire::BinaryReflectorSerializer serializer;
+		return serializer.Serialize(curves).GetBytes().size();
+	};
+
+	dire::BinaryReflectorSerializer serializer;
+	const dire::ISerializer::Result serialized = serializer.Serialize(curves);
+	const auto& bytes = serialized.GetBytes();
+
+	BENCHMARK("Deserialize 3 x 2M keys")
+	{
+		bench::AnimationCurves deserialized;
+		dire::BinaryReflectorDeserializer deserializer;
+		deserializer.DeserializeInto(reinterpret_cast<const char*>(bytes.data()), bytes.size(), deserialized);
+		return deserialized.keyIndices.size();
+	};
+}
+
+TEST_CASE("Loading a big binary file: ifstream vs. memory mapping", "[Benchmark][Binary]")
+{
+	WriteCurvesFile();
+
+	BENCHMARK("ifstream + DeserializeInto")
+	{
+		bench::AnimationCurves curves;
+		return LoadWithIfstream(curves);
+	};
+
+	BENCHMARK("DeserializeFileInto (mmap)")
+	{
+		bench::AnimationCurves curves;
+		return LoadWithMapping(curves);
+	};
+
+#ifdef __linux__
+	// The deserialized object itself accounts for 3 * NB_CURVE_KEYS * 4 bytes (24 MiB) in both cases.
+	auto loadWith = [](auto pLoad)
+	{
+		return [pLoad]
+		{
+			bench::AnimationCurves curves;
+			return pLoad(curves);
+		};
+	};
+	std::cout << "Peak RSS increase, ifstream: " << MeasurePeakRSSIncrease(loadWith(LoadWithIfstream)) / 1024 << " MiB\n";
+	std::cout << "Peak RSS increase, mmap: " << MeasurePeakRSSIncrease(loadWith(LoadWithMapping)) / 1024 << " MiB\n";
+#endif
+
+	std::remove(CURVES_FILE);
+}
+
+TEST_CASE("Saving a big binary file: in memory vs. file descriptor sink", "[Benchmark][Binary]")
+{
+	bench::AnimationCurves curves;
+	FillCurves(curves);
+
+	BENCHMARK("Serialize + ofstream")
+	{
+		return SaveInMemory(curves);
+	};
+
+	BENCHMARK("SerializeTo (FileDescriptorSink)")
+	{
+		return SaveToSink(curves);
+	};
+
+#ifdef __linux__
+	// The curves are already in memory: any increase is the serialization buffer.
+	std::cout << "Peak RSS increase, in memory: " << MeasurePeakRSSIncrease([&curves] { return SaveInMemory(curves); }) / 1024 << " MiB\n";
+	std::cout << "Peak RSS increase, sink: " << MeasurePeakRSSIncrease([&curves] { return SaveToSink(curves); }) / 1024 << " MiB\n";
+#endif
+
+	std::remove(CURVES_FILE);
+}
+
+#endif
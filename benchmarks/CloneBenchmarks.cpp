@@ -0,0 +1,48 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "dire/Dire.h"
+
+#include "BenchmarkClasses.h"
+
+namespace
+{
+	const size_t	NB_SPAWNED_ENTITIES = 10000;
+}
+
+TEST_CASE("Spawning 10k entities: Clone vs. CloneBatch", "[Benchmark][Clone]")
+{
+	bench::Player prefab;
+	prefab.level = 42;
+	prefab.inventory = { 1, 2, 3, 4, 5, 6, 7, 8 };
+	prefab.sockets[0].position.x = 1.f;
+
+	BENCHMARK("10k Reflectable::Clone")
+	{
+		std::vector<bench::Player*> spawned(NB_SPAWNED_ENTITIES);
+		for (bench::Player*& player : spawned)
+		{
+			player = prefab.Clone<bench::Player>();
+		}
+
+		const int level = spawned.back()->level;
+		for (bench::Player* player : spawned)
+		{
+			delete player;
+		}
+		return level;
+	};
+
+	// Sized so that the whole batch fits in one chunk, like a level load arena would be.
+	dire::Arena arena(NB_SPAWNED_ENTITIES * (sizeof(bench::Player) + sizeof(void*)) + 1024);
+
+	BENCHMARK("CloneBatch of 10k")
+	{
+		dire::Span<dire::Reflectable*> spawned = dire::CloneBatch(prefab, NB_SPAWNED_ENTITIES, arena);
+
+		const int level = static_cast<bench::Player*>(spawned[spawned.Size() - 1])->level;
+		dire::DestroyBatch(spawned);
+		arena.Reset();
+		return level;
+	};
+}
@@ -0,0 +1,55 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "dire/Dire.h"
+
+#include "BenchmarkClasses.h"
+
+#include <cstring> // strlen
+
+namespace
+{
+	const char* const	ITEM_NAMES[] = { "Sword", "Shield", "Bow", "Arrow", "Potion", "Scroll", "Ring", "Amulet",
+		"Helmet", "Armor", "Boots", "Gloves", "Key", "Gem", "Coin", "Torch" };
+}
+
+TEST_CASE("Enum string conversions", "[Benchmark][Enum]")
+{
+	BENCHMARK("Sequential enum: value to string (x16)")
+	{
+		size_t totalLength = 0;
+		bench::ItemKind::Enumerate([&](bench::ItemKind::Values pKind)
+		{
+			totalLength += strlen(bench::ItemKind::GetStringFromSafeEnum(pKind));
+		});
+		return totalLength;
+	};
+
+	BENCHMARK("Sequential enum: string to value (x16)")
+	{
+		int total = 0;
+		for (const char* name : ITEM_NAMES)
+		{
+			total += int(bench::ItemKind::GetValueFromSafeString(name));
+		}
+		return total;
+	};
+
+	const bench::EntityFlags flags = bench::EntityFlags::Visible | bench::EntityFlags::Solid | bench::EntityFlags::Hostile | bench::EntityFlags::Flying;
+
+	BENCHMARK("Bitmask enum: value to string (allocating)")
+	{
+		return flags.GetString().size();
+	};
+
+	BENCHMARK("Bitmask enum: value to string (ToChars)")
+	{
+		char buffer[128];
+		return bench::EntityFlags::ToChars(flags, buffer, sizeof(buffer)).size();
+	};
+
+	BENCHMARK("Bitmask enum: string to value")
+	{
+		return uint32_t(bench::EntityFlags::GetValueFromString("Visible | Solid | Hostile | Flying"));
+	};
+}
@@ -0,0 +1,68 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "dire/Dire.h"
+
+#include "BenchmarkClasses.h"
+
+float bench::Player::Move(const Vec3& pDirection, float pDeltaTime, int64_t pTicks)
+{
+	camera.position.x += pDirection.x * pDeltaTime;
+	camera.position.y += pDirection.y * pDeltaTime;
+	camera.position.z += pDirection.z * pDeltaTime;
+	score += pTicks;
+	return camera.position.x;
+}
+
+TEST_CASE("Function invocation: std::any vs. argument buffer vs. handle", "[Benchmark][Function]")
+{
+	bench::Player player;
+	const bench::Vec3 direction;
+	const dire::FunctionInfo* move = player.GetFunction("Move");
+	REQUIRE(move != nullptr);
+
+	BENCHMARK("Direct call")
+	{
+		return player.Move(direction, 0.016f, 1);
+	};
+
+	BENCHMARK("InvokeWithArgs (std::any)")
+	{
+		// explicit argument types on purpose: the std::any path only matches the exact tuple of parameter types
+		std::any result = move->InvokeWithArgs<const bench::Vec3&, float, int64_t>(&player, direction, 0.016f, int64_t(1));
+		return std::any_cast<float>(result);
+	};
+
+	alignas(dire::FunctionInfo::ARGUMENT_BUFFER_ALIGNMENT) std::byte argBuffer[32];
+
+	BENCHMARK("PackArguments + InvokeWithBuffer")
+	{
+		float result = 0.f;
+		move->PackArguments(argBuffer, direction, 0.016f, int64_t(1));
+		move->InvokeWithBuffer(&player, argBuffer, &result);
+		return result;
+	};
+
+	// The arguments are often the same from call to call (e.g. a script binding): pack them once.
+	move->PackArguments(argBuffer, direction, 0.016f, int64_t(1));
+
+	BENCHMARK("InvokeWithBuffer (prepacked)")
+	{
+		float result = 0.f;
+		move->InvokeWithBuffer(&player, argBuffer, &result);
+		return result;
+	};
+
+	const auto moveHandle = dire::FunctionHandle<float(const bench::Vec3&, float, int64_t)>::Bind(bench::Player::GetTypeInfo(), "Move");
+	REQUIRE(moveHandle.IsValid());
+
+	BENCHMARK("FunctionHandle")
+	{
+		return moveHandle(&player, direction, 0.016f, 1);
+	};
+
+	BENCHMARK("TypedInvokeFunction (name lookup + std::any)")
+	{
+		return player.TypedInvokeFunction<float, const bench::Vec3&, float, int64_t>("Move", direction, 0.016f, int64_t(1));
+	};
+}
@@ -0,0 +1,98 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "dire/Dire.h"
+
+#include "BenchmarkClasses.h"
+
+namespace
+{
+	// Reads what a serializer or a clone needs from every property: offset, type, handler and copy function.
+	template <typename T>
+	size_t	TraverseLinkedLists()
+	{
+		size_t checksum = 0;
+		T::GetTypeInfo().ForEachPropertyInHierarchy([&checksum](const dire::PropertyTypeInfo& pProperty)
+		{
+			checksum += pProperty.GetOffset() + pProperty.GetSize() + size_t(pProperty.GetMetatype().Value);
+			checksum += (pProperty.GetDataStructureHandler().GetArrayHandler() != nullptr);
+			checksum += (pProperty.GetCopyConstructorFunction() != nullptr);
+		});
+		return checksum;
+	}
+
+	template <typename T>
+	size_t	TraverseLayout()
+	{
+		size_t checksum = 0;
+		const dire::PropertyLayout& layout = T::GetTypeInfo().GetPropertyLayout();
+		for (size_t iProp = 0; iProp < layout.GetCount(); ++iProp)
+		{
+			checksum += layout.GetOffset(iProp) + layout.GetSize(iProp) + size_t(layout.GetMetatype(iProp).Value);
+			checksum += (layout.GetDataStructureHandler(iProp).GetArrayHandler() != nullptr);
+			checksum += (layout.GetCopyFunction(iProp) != nullptr);
+		}
+		return checksum;
+	}
+}
+
+TEST_CASE("Hierarchy traversal: linked lists vs. flattened layout", "[Benchmark][PropertyLayout]")
+{
+	REQUIRE(TraverseLinkedLists<bench::Deep7>() == TraverseLayout<bench::Deep7>());
+	REQUIRE(TraverseLinkedLists<bench::Player>() == TraverseLayout<bench::Player>());
+
+	BENCHMARK("ForEachPropertyInHierarchy (Deep7, 8 levels)")
+	{
+		return TraverseLinkedLists<bench::Deep7>();
+	};
+
+	BENCHMARK("PropertyLayout (Deep7, 8 levels)")
+	{
+		return TraverseLayout<bench::Deep7>();
+	};
+
+	BENCHMARK("ForEachPropertyInHierarchy (Player, 4 levels)")
+	{
+		return TraverseLinkedLists<bench::Player>();
+	};
+
+	BENCHMARK("PropertyLayout (Player, 4 levels)")
+	{
+		return TraverseLayout<bench::Player>();
+	};
+}
+
+TEST_CASE("Clone of a deep hierarchy", "[Benchmark][PropertyLayout][Clone]")
+{
+	bench::Deep7 deep;
+	deep.Deep0_i = 42;
+	deep.Deep7_d = 1337.0;
+
+	const dire::TypeInfo& deepTypeInfo = bench::Deep7::GetTypeInfo();
+	const dire::PropertyLayout& layout = deepTypeInfo.GetPropertyLayout();
+	bench::Deep7 clone; // constructed once so that only the copies are measured
+
+	BENCHMARK("One copy per property (Deep7)")
+	{
+		for (size_t iProp = 0; iProp < layout.GetCount(); ++iProp)
+		{
+			layout.GetCopyFunction(iProp)(&clone, &deep, layout.GetOffset(iProp));
+		}
+		return clone.Deep0_i;
+	};
+
+	BENCHMARK("CloneHierarchyPropertiesOf (Deep7, coalesced)")
+	{
+		deepTypeInfo.CloneHierarchyPropertiesOf(clone, deep);
+		return clone.Deep0_i;
+	};
+
+	bench::Player player;
+	BENCHMARK("Reflectable::Clone (Player)")
+	{
+		bench::Player* clone = player.Clone<bench::Player>();
+		const int level = clone->level;
+		delete clone;
+		return level;
+	};
+}
@@ -0,0 +1,73 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "dire/Dire.h"
+#include "dire/DirePropertyPath.h"
+
+#include "BenchmarkClasses.h"
+
+namespace
+{
+	// The paths a gameplay script would typically hammer every frame.
+	const char* const	BENCHMARKED_PATHS[] = {
+		"speed",
+		"health",
+		"transform.position.y",
+		"camera.scale.z",
+		"transform.matrix[15]",
+		"bones[2]",
+		"sockets[3].position.x",
+		"inventory[2]"
+	};
+
+	const size_t	NB_BENCHMARKED_PATHS = std::size(BENCHMARKED_PATHS);
+}
+
+TEST_CASE("PropertyPath vs. string path", "[Benchmark][PropertyPath]")
+{
+	bench::Player player;
+
+	std::vector<dire::PropertyPath> compiledPaths;
+	for (const char* path : BENCHMARKED_PATHS)
+	{
+		compiledPaths.push_back(dire::PropertyPath::Compile<bench::Player>(path));
+		REQUIRE(compiledPaths.back().IsValid());
+		REQUIRE(compiledPaths.back().Get(player) == player.GetProperty(path).GetPointer());
+	}
+
+	BENCHMARK("GetProperty (string path)")
+	{
+		const void* last = nullptr;
+		for (const char* path : BENCHMARKED_PATHS)
+		{
+			last = player.GetProperty(path).GetPointer();
+		}
+		return last;
+	};
+
+	BENCHMARK("PropertyPath::Get (compiled path)")
+	{
+		const void* last = nullptr;
+		for (const dire::PropertyPath& path : compiledPaths)
+		{
+			last = path.Get(player);
+		}
+		return last;
+	};
+
+	BENCHMARK("SetProperty (string path)")
+	{
+		return player.SetProperty<float>("camera.scale.z", 2.f);
+	};
+
+	const dire::PropertyPath cameraScaleZ = dire::PropertyPath::Compile<bench::Player>("camera.scale.z");
+	BENCHMARK("PropertyPath::Set (compiled path)")
+	{
+		return cameraScaleZ.Set(player, 2.f);
+	};
+
+	BENCHMARK("PropertyPath::Compile")
+	{
+		return dire::PropertyPath::Compile<bench::Player>(BENCHMARKED_PATHS[NB_BENCHMARKED_PATHS - 1]);
+	};
+}
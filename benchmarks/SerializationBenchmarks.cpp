@@ -0,0 +1,81 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "dire/Dire.h"
+
+#include "BenchmarkClasses.h"
+#include "BenchmarkSizes.h"
+
+#if defined(DIRE_COMPILE_BINARY_SERIALIZATION) || defined(DIRE_COMPILE_JSON_SERIALIZATION)
+
+namespace
+{
+	const int	LEVEL_SIZES[] = { 10, 1000, 10000 };
+
+	void	FillLevel(bench::Level& pLevel, int pNbCharacters)
+	{
+		for (int iChar = 0; iChar < pNbCharacters; ++iChar)
+		{
+			bench::Character& character = pLevel.characters[iChar];
+			character.id = iChar;
+			character.level = iChar % 100;
+			character.health = double(iChar % 250);
+			character.sockets[0].position.x = float(iChar);
+		}
+		for (int iLoot = 0; iLoot < pNbCharacters; ++iLoot)
+		{
+			pLevel.loot.push_back(bench::ItemKind::Values(iLoot % 16));
+		}
+		pLevel.defaultFlags = bench::EntityFlags::Visible | bench::EntityFlags::Solid;
+	}
+
+	void	BenchmarkSerializer(const char* pFormatName, dire::ISerializer& pSerializer, dire::IDeserializer& pDeserializer)
+	{
+		for (const int nbCharacters : LEVEL_SIZES)
+		{
+			bench::Level level;
+			FillLevel(level, nbCharacters);
+
+			const dire::ISerializer::Result serialized = pSerializer.Serialize(level);
+			const DIRE_STRING data = serialized.AsString();
+			bench::ReportSize("Level of " + std::to_string(nbCharacters) + " characters (" + pFormatName + ")", data.size());
+
+			const std::string suffix = std::string(" level of ") + std::to_string(nbCharacters) + " characters (" + pFormatName + ")";
+
+			BENCHMARK("Serialize" + suffix)
+			{
+				return pSerializer.Serialize(level).HasError();
+			};
+
+			BENCHMARK("Deserialize" + suffix)
+			{
+				bench::Level deserialized;
+				return pDeserializer.DeserializeInto(data.data(), data.size(), deserialized).HasError();
+			};
+		}
+	}
+}
+
+#endif
+
+#ifdef DIRE_COMPILE_BINARY_SERIALIZATION
+
+TEST_CASE("Binary serialization of growing levels", "[Benchmark][Serialization][Binary]")
+{
+	dire::BinaryReflectorSerializer serializer;
+	dire::BinaryReflectorDeserializer deserializer;
+	BenchmarkSerializer("binary", serializer, deserializer);
+}
+
+#endif
+
+#ifdef DIRE_COMPILE_JSON_SERIALIZATION
+
+TEST_CASE("JSON serialization of growing levels", "[Benchmark][Serialization][JSON]")
+{
+	dire::JsonReflectorSerializer serializer;
+	dire::JsonReflectorDeserializer deserializer;
+	BenchmarkSerializer("JSON", serializer, deserializer);
+}
+
+#endif
@@ -0,0 +1,124 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "dire/Dire.h"
+#include "dire/DireSubclass.h"
+
+#include "BenchmarkClasses.h"
+
+#include <memory>
+#include <vector>
+
+namespace
+{
+	const size_t	NB_ACTORS = 1000;
+
+	// A mixed actor list, like the ones gameplay code filters by type.
+	std::vector<std::unique_ptr<dire::Reflectable>>	MakeActors()
+	{
+		std::vector<std::unique_ptr<dire::Reflectable>> actors;
+		actors.reserve(NB_ACTORS);
+		for (size_t iActor = 0; iActor < NB_ACTORS; ++iActor)
+		{
+			switch (iActor % 4)
+			{
+			case 0:
+				actors.push_back(std::make_unique<bench::Player>());
+				break;
+			case 1:
+				actors.push_back(std::make_unique<bench::Deep7>());
+				break;
+			case 2:
+				actors.push_back(std::make_unique<bench::Deep2>());
+				break;
+			default:
+				actors.push_back(std::make_unique<bench::Vec3>());
+				break;
+			}
+		}
+		return actors;
+	}
+}
+
+TEST_CASE("Type info lookups and instantiation", "[Benchmark][TypeInfo]")
+{
+	const dire::TypeInfoDatabase& database = dire::TypeInfoDatabase::GetSingleton();
+	const dire::ReflectableID playerID = bench::Player::GetTypeInfo().GetID();
+	const dire::ReflectableID deepID = bench::Deep7::GetTypeInfo().GetID();
+
+	BENCHMARK("GetTypeInfo by ID (x1000)")
+	{
+		size_t totalSize = 0;
+		for (size_t iLookup = 0; iLookup < 1000; ++iLookup)
+		{
+			totalSize += database.GetTypeInfo(iLookup % 2 == 0 ? playerID : deepID)->GetTypeSize();
+		}
+		return totalSize;
+	};
+
+	BENCHMARK("TryInstantiate (Player)")
+	{
+		dire::Reflectable* player = database.TryInstantiate(playerID, {});
+		const bool instantiated = (player != nullptr);
+		delete player;
+		return instantiated;
+	};
+
+	BENCHMARK("TryInstantiate (Deep7, 8 levels)")
+	{
+		dire::Reflectable* deep = database.TryInstantiate(deepID, {});
+		const bool instantiated = (deep != nullptr);
+		delete deep;
+		return instantiated;
+	};
+}
+
+TEST_CASE("Type checks on a mixed actor list", "[Benchmark][TypeInfo]")
+{
+	const std::vector<std::unique_ptr<dire::Reflectable>> actors = MakeActors();
+
+	BENCHMARK("IsA<Deep3> on 1000 actors")
+	{
+		size_t nbDeep = 0;
+		for (const auto& actor : actors)
+		{
+			nbDeep += actor->IsA<bench::Deep3>();
+		}
+		return nbDeep;
+	};
+
+	BENCHMARK("IsA<Component> on 1000 actors")
+	{
+		size_t nbComponents = 0;
+		for (const auto& actor : actors)
+		{
+			nbComponents += actor->IsA<bench::Component>();
+		}
+		return nbComponents;
+	};
+
+	BENCHMARK("Cast<Character> on 1000 actors")
+	{
+		int totalLevel = 0;
+		for (const auto& actor : actors)
+		{
+			if (const bench::Character* character = dire::Cast<bench::Character>(actor.get()))
+			{
+				totalLevel += character->level;
+			}
+		}
+		return totalLevel;
+	};
+
+	BENCHMARK("Subclass<Deep0>::IsValid on 1000 actors")
+	{
+		size_t nbValid = 0;
+		dire::Subclass<bench::Deep0> subclass;
+		for (const auto& actor : actors)
+		{
+			subclass.SetClass(actor->GetReflectableClassID());
+			nbValid += subclass.IsValid();
+		}
+		return nbValid;
+	};
+}
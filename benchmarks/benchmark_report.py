@@ -0,0 +1,130 @@
+#!/usr/bin/env python3
+"""Turns the XML report of Dire_Benchmarks into JSON, and compares it with a baseline.
+
+Usage:
+    Dire_Benchmarks --reporter xml --out benchmarks.xml
+    benchmark_report.py benchmarks.xml --json benchmarks.json [--baseline baseline.json] [--threshold 0.10]
+
+The JSON holds one entry per benchmark, in nanoseconds, and one entry per encoded size the benchmarks report
+(the "Size of <name>: <bytes> bytes, <objects> object(s)" warnings of bench::ReportSize):
+    {"benchmarks": [{"name": ..., "test_case": ..., "mean": ..., "low": ..., "high": ..., "std_dev": ...}],
+     "sizes": [{"name": ..., "test_case": ..., "bytes": ..., "objects": ..., "bytes_per_object": ...}]}
+
+With a baseline, a benchmark regresses when its mean is more than threshold slower than the baseline mean,
+and its confidence interval does not overlap the one of the baseline. Sizes are exact: a size regresses when
+its bytes per object grew by more than threshold. The script then exits with 1.
+"""
+
+import argparse
+import json
+import re
+import sys
+import xml.etree.ElementTree as ElementTree
+
+SIZE_MESSAGE = re.compile(r"^Size of (.+): (\d+) bytes, (\d+) object\(s\)$")
+
+
+def parse_catch2_xml(path):
+    benchmarks = []
+    root = ElementTree.parse(path).getroot()
+    for test_case in root.iter("TestCase"):
+        for result in test_case.iter("BenchmarkResults"):
+            mean = result.find("mean")
+            std_dev = result.find("standardDeviation")
+            if mean is None:
+                continue
+            benchmarks.append({
+                "name": result.get("name"),
+                "test_case": test_case.get("name"),
+                "mean": float(mean.get("value")),
+                "low": float(mean.get("lowerBound")),
+                "high": float(mean.get("upperBound")),
+                "std_dev": float(std_dev.get("value")) if std_dev is not None else 0.0,
+            })
+    return benchmarks
+
+
+def parse_catch2_sizes(path):
+    sizes = []
+    root = ElementTree.parse(path).getroot()
+    for test_case in root.iter("TestCase"):
+        for warning in test_case.iter("Warning"):
+            match = SIZE_MESSAGE.match((warning.text or "").strip())
+            if match is None:
+                continue
+            nb_bytes = int(match.group(2))
+            nb_objects = int(match.group(3))
+            sizes.append({
+                "name": match.group(1),
+                "test_case": test_case.get("name"),
+                "bytes": nb_bytes,
+                "objects": nb_objects,
+                "bytes_per_object": nb_bytes / nb_objects if nb_objects > 0 else 0.0,
+            })
+    return sizes
+
+
+def compare(benchmarks, baseline, threshold):
+    baseline_by_name = {bench["name"]: bench for bench in baseline}
+    regressions = []
+    for bench in benchmarks:
+        base = baseline_by_name.get(bench["name"])
+        if base is None or base["mean"] <= 0.0:
+            print(f"  new        {bench['name']}: {bench['mean']:.1f} ns")
+            continue
+        ratio = bench["mean"] / base["mean"]
+        regressed = ratio > 1.0 + threshold and bench["low"] > base["high"]
+        improved = ratio < 1.0 - threshold and bench["high"] < base["low"]
+        status = "REGRESSED" if regressed else "improved" if improved else "same"
+        print(f"  {status:<10} {bench['name']}: {base['mean']:.1f} -> {bench['mean']:.1f} ns ({(ratio - 1.0) * 100.0:+.1f}%)")
+        if regressed:
+            regressions.append(bench["name"])
+    return regressions
+
+
+def compare_sizes(sizes, baseline, threshold):
+    baseline_by_name = {size["name"]: size for size in baseline}
+    regressions = []
+    for size in sizes:
+        base = baseline_by_name.get(size["name"])
+        if base is None or base["bytes_per_object"] <= 0.0:
+            print(f"  new        {size['name']}: {size['bytes_per_object']:.1f} bytes per object")
+            continue
+        ratio = size["bytes_per_object"] / base["bytes_per_object"]
+        status = "REGRESSED" if ratio > 1.0 + threshold else "improved" if ratio < 1.0 else "grew" if ratio > 1.0 else "same"
+        print(f"  {status:<10} {size['name']}: {base['bytes_per_object']:.1f} -> {size['bytes_per_object']:.1f} bytes per object ({(ratio - 1.0) * 100.0:+.1f}%)")
+        if status == "REGRESSED":
+            regressions.append(size["name"])
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("xml", help="XML report written by Dire_Benchmarks --reporter xml")
+    parser.add_argument("--json", help="where to write the JSON report")
+    parser.add_argument("--baseline", help="a JSON report to compare the results with")
+    parser.add_argument("--threshold", type=float, default=0.10, help="relative slowdown considered a regression (default: 0.10)")
+    args = parser.parse_args()
+
+    benchmarks = parse_catch2_xml(args.xml)
+    sizes = parse_catch2_sizes(args.xml)
+    if args.json:
+        with open(args.json, "w") as json_file:
+            json.dump({"benchmarks": benchmarks, "sizes": sizes}, json_file, indent=2)
+        print(f"{len(benchmarks)} benchmarks and {len(sizes)} sizes written to {args.json}")
+
+    if args.baseline:
+        with open(args.baseline) as baseline_file:
+            baseline = json.load(baseline_file)
+        print(f"Comparing with {args.baseline} (threshold: {args.threshold * 100.0:.0f}%):")
+        regressions = compare(benchmarks, baseline["benchmarks"], args.threshold)
+        # Reports written before the sizes were collected have none.
+        regressions += compare_sizes(sizes, baseline.get("sizes", []), args.threshold)
+        if regressions:
+            print(f"{len(regressions)} regression(s): " + ", ".join(regressions))
+            return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
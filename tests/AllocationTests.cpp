@@ -0,0 +1,182 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "dire/Dire.h"
+
+#include <cstdint>
+
+TEST_CASE("Arena Allocate", "[Arena]")
+{
+	dire::Arena arena(256);
+
+	// consecutive allocations are contiguous
+	auto* first = static_cast<std::byte*>(arena.Allocate(16, 8));
+	auto* second = static_cast<std::byte*>(arena.Allocate(16, 8));
+	REQUIRE(second == first + 16);
+	REQUIRE(arena.GetUsedBytes() == 32);
+
+	// alignment is respected
+	REQUIRE(arena.Allocate(1, 1) != nullptr);
+	void* aligned = arena.Allocate(8, 64);
+	REQUIRE(reinterpret_cast<uintptr_t>(aligned) % 64 == 0);
+
+	// allocations bigger than a chunk get their own
+	auto* big = static_cast<std::byte*>(arena.Allocate(1024, 16));
+	REQUIRE(big != nullptr);
+	big[1023] = std::byte{ 42 };
+
+	// a reset reuses the first chunk
+	arena.Reset();
+	REQUIRE(arena.GetUsedBytes() == 0);
+	REQUIRE(arena.Allocate(16, 8) == first);
+}
+
+TEST_CASE("Arena reuse after Reset", "[Arena]")
+{
+	dire::Arena arena(256);
+
+	// filling several chunks, then resetting, starts over from the first one
+	auto* first = static_cast<std::byte*>(arena.Allocate(64, 8));
+	for (int iAlloc = 0; iAlloc < 20; ++iAlloc)
+	{
+		REQUIRE(arena.Allocate(64, 8) != nullptr);
+	}
+	REQUIRE(arena.GetUsedBytes() >= 21 * 64);
+
+	for (int iCycle = 0; iCycle < 3; ++iCycle)
+	{
+		arena.Reset();
+		REQUIRE(arena.Allocate(64, 8) == first);
+		REQUIRE(arena.GetUsedBytes() == 64);
+
+		// a whole chunk does not fit after that, so it gets a new one
+		auto* wholeChunk = static_cast<std::byte*>(arena.Allocate(256, 8));
+		REQUIRE(wholeChunk != first + 64);
+		wholeChunk[255] = std::byte{ 42 };
+	}
+
+	// big allocations respect the alignment too, and the small ones keep going after them
+	arena.Reset();
+	void* bigAligned = arena.Allocate(4096, 256);
+	REQUIRE(reinterpret_cast<uintptr_t>(bigAligned) % 256 == 0);
+	REQUIRE(arena.Allocate(8, 8) != nullptr);
+
+	// an arena whose first allocation was big keeps that big chunk
+	dire::Arena bigFirstArena(256);
+	void* bigFirst = bigFirstArena.Allocate(1024, 16);
+	bigFirstArena.Reset();
+	REQUIRE(bigFirstArena.Allocate(1024, 16) == bigFirst);
+}
+
+// These reflectables are declared in the last test files of the list,
+// so that they don't shift the reflectable IDs hardcoded in the expected serialization results.
+
+namespace
+{
+	int	theLiveCounted = 0;
+}
+
+dire_reflectable(struct Counted)
+{
+	DIRE_REFLECTABLE_INFO()
+
+	DECLARE_INSTANTIATOR(int)
+
+	Counted() { theLiveCounted++; }
+	explicit Counted(int pValue) : value(pValue) { theLiveCounted++; }
+	~Counted() override { theLiveCounted--; }
+
+	DIRE_PROPERTY(int, value, 0)
+	DIRE_PROPERTY((std::vector<int>), someData, std::initializer_list<int>{ 1, 2, 3 })
+};
+
+// The alignment comes from a member: dire_reflectable repeats the class name where attributes are ignored.
+dire_reflectable(struct OverAligned)
+{
+	DIRE_REFLECTABLE_INFO()
+
+	DIRE_PROPERTY(int, value, 0)
+
+	alignas(64) char payload[64]{};
+};
+
+TEST_CASE("TypeInfo type layout", "[Allocation]")
+{
+	REQUIRE(Counted::GetTypeInfo().GetTypeSize() == sizeof(Counted));
+	REQUIRE(alignof(OverAligned) == 64);
+	REQUIRE(OverAligned::GetTypeInfo().GetTypeAlignment() == 64);
+}
+
+TEST_CASE("ReflectablePool", "[Allocation]")
+{
+	const dire::TypeInfoDatabase& database = dire::TypeInfoDatabase::GetSingleton();
+	{
+		dire::ReflectablePool pool(4);
+		pool.Reserve(Counted::GetTypeInfo().GetID(), 8);
+		REQUIRE(pool.GetCapacity(Counted::GetTypeInfo().GetID()) == 8);
+
+		// with a custom instantiator
+		Counted* first = database.InstantiateClassIn<Counted>(pool, 42);
+		REQUIRE((first != nullptr && first->value == 42 && first->someData.size() == 3));
+
+		// bad parameters
+		REQUIRE(database.InstantiateClassIn<Counted>(pool, 42.f) == nullptr);
+
+		// individual destruction recycles the slot
+		pool.Destroy(first);
+		REQUIRE(theLiveCounted == 0);
+		Counted* second = database.InstantiateClassIn<Counted>(pool, 1337);
+		REQUIRE(second == first);
+
+		for (int i = 0; i < 20; ++i)
+		{
+			REQUIRE(database.InstantiateClassIn<Counted>(pool, int(i)) != nullptr);
+		}
+		REQUIRE(theLiveCounted == 21);
+		REQUIRE(pool.GetLiveObjectCount() == 21);
+		REQUIRE(pool.GetCapacity(Counted::GetTypeInfo().GetID()) == 24);
+
+		// alignment is respected
+		auto* aligned = database.InstantiateClassIn<OverAligned>(pool);
+		REQUIRE((aligned != nullptr && reinterpret_cast<uintptr_t>(aligned) % 64 == 0));
+
+		// bulk destroy
+		pool.DestroyAll();
+		REQUIRE(theLiveCounted == 0);
+		REQUIRE(pool.GetLiveObjectCount() == 0);
+		REQUIRE(pool.GetCapacity(Counted::GetTypeInfo().GetID()) == 24);
+
+		REQUIRE(database.InstantiateClassIn<Counted>(pool, 0) != nullptr);
+
+		// pools are kept by type, not by ID: objects outlive an import changing the ID of their type
+		Counted* beforeImport = database.InstantiateClassIn<Counted>(pool, 7);
+		dire::TypeInfo& countedTypeInfo = Counted::EditTypeInfo();
+		const dire::ReflectableID countedID = countedTypeInfo.GetID();
+		countedTypeInfo.SetID(dire::ReflectableID(countedID + 1000));
+		pool.Destroy(beforeImport);
+		countedTypeInfo.SetID(countedID);
+		REQUIRE(database.InstantiateClassIn<Counted>(pool, 8) == beforeImport);
+	}
+
+	// the pool destroys what's left on destruction
+	REQUIRE(theLiveCounted == 0);
+}
+
+TEST_CASE("ArenaContext", "[Allocation]")
+{
+	const dire::TypeInfoDatabase& database = dire::TypeInfoDatabase::GetSingleton();
+	dire::ArenaContext frameContext;
+
+	for (int iFrame = 0; iFrame < 3; ++iFrame)
+	{
+		for (int i = 0; i < 100; ++i)
+		{
+			Counted* counted = static_cast<Counted*>(database.TryInstantiate(Counted::GetTypeInfo().GetID(), std::tuple<int>(i), frameContext));
+			REQUIRE((counted != nullptr && counted->value == i));
+		}
+
+		REQUIRE(theLiveCounted == 100);
+		frameContext.DestroyAll();
+		REQUIRE(theLiveCounted == 0);
+		REQUIRE(frameContext.GetArena().GetUsedBytes() == 0);
+	}
+}
@@ -0,0 +1,196 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "dire/Dire.h"
+#include "dire/DirePropertyPath.h"
+
+#include "TestClasses.h"
+
+// Declared in the last test file of the list, so that it doesn't shift the reflectable IDs hardcoded in the expected serialization results.
+dire_reflectable(struct TrackedD, d)
+{
+	DIRE_REFLECTABLE_INFO()
+	DIRE_DIRTY_TRACKING()
+
+	DIRE_PROPERTY(int, hitPoints, 100)
+};
+
+namespace
+{
+	size_t	GetOrdinal(const dire::Reflectable& pReflectable, DIRE_STRING_VIEW pPropName)
+	{
+		const dire::TypeInfo* typeInfo = pReflectable.GetReflectableTypeInfo();
+		return typeInfo->GetPropertyLayout().FindIndex(*typeInfo->FindPropertyInHierarchy(pPropName));
+	}
+}
+
+TEST_CASE("DirtyPropertySet", "[DirtyTracking]")
+{
+	dire::DirtyPropertySet dirty;
+	REQUIRE(dirty.IsEmpty());
+
+	// Beyond the first 64 properties too
+	dirty.Mark(130);
+	dirty.Mark(3);
+	dirty.Mark(63);
+	dirty.Mark(64);
+	dirty.Mark(3);
+	REQUIRE(dirty.Count() == 4);
+	REQUIRE((dirty.IsMarked(3) && dirty.IsMarked(63) && dirty.IsMarked(64) && dirty.IsMarked(130)));
+	REQUIRE_FALSE((dirty.IsMarked(4) || dirty.IsMarked(129) || dirty.IsMarked(1000)));
+
+	std::vector<size_t> marked;
+	dirty.ForEachMarked([&marked](size_t pOrdinal) { marked.push_back(pOrdinal); });
+	REQUIRE(marked == std::vector<size_t>{ 3, 63, 64, 130 });
+
+	dirty.Clear();
+	REQUIRE(dirty.IsEmpty());
+	REQUIRE(dirty.Count() == 0);
+}
+
+TEST_CASE("Dirty property tracking", "[DirtyTracking]")
+{
+	TrackedD tracked;
+	REQUIRE(tracked.GetDirtyProperties() != nullptr);
+	REQUIRE(tracked.GetDirtyProperties()->IsEmpty());
+
+	// Reflection writes mark the property the path starts with
+	REQUIRE(tracked.SetProperty<int>("xp", 5));
+	REQUIRE(tracked.SetProperty<int>("ultra.mega.toto[0].titi[2]", 42));
+	tracked.aVector = { 1, 2, 3 };
+	REQUIRE(tracked.EraseProperty("aVector[0]"));
+	REQUIRE_FALSE(tracked.SetProperty<int>("doesNotExist", 0));
+
+	const dire::DirtyPropertySet& dirty = *tracked.GetDirtyProperties();
+	REQUIRE(dirty.Count() == 3);
+	REQUIRE((dirty.IsMarked(GetOrdinal(tracked, "xp")) && dirty.IsMarked(GetOrdinal(tracked, "ultra")) && dirty.IsMarked(GetOrdinal(tracked, "aVector"))));
+
+	// Direct writes are marked by member, nested ones mark the property they are in
+	tracked.MarkDirty(tracked.compvar.compleet.leet);
+	tracked.hitPoints = 50;
+	tracked.MarkDirty(tracked.hitPoints);
+	REQUIRE((dirty.IsMarked(GetOrdinal(tracked, "compvar")) && dirty.IsMarked(GetOrdinal(tracked, "hitPoints"))));
+
+	// Compiled paths mark too, even when compiled against a parent type
+	tracked.EditDirtyProperties()->Clear();
+	const dire::PropertyPath bdoublePath = dire::PropertyPath::Compile<d>("bdouble");
+	REQUIRE(bdoublePath.Set(tracked, 4.0));
+	REQUIRE(dirty.Count() == 1);
+	REQUIRE(dirty.IsMarked(GetOrdinal(tracked, "bdouble")));
+
+	// Types that don't opt in don't track anything
+	d untracked;
+	REQUIRE(untracked.GetDirtyProperties() == nullptr);
+	untracked.MarkDirty(untracked.xp);
+	REQUIRE(untracked.SetProperty<int>("xp", 5));
+}
+
+#ifdef DIRE_SERIALIZATION_BINARY_ENABLED
+#	include "dire/Serialization/DireBinaryDeserializer.h"
+#	include "dire/Serialization/DireBinarySerializer.h"
+#	include "dire/Serialization/DireDelta.h"
+
+TEST_CASE("Binary dirty-only serialization", "[DirtyTracking][Serialization]")
+{
+	dire::BinaryReflectorSerializer serializer;
+	dire::BinaryReflectorDeserializer deserializer;
+
+	for (dire::BinaryFormat format : { dire::BinaryFormat::Native, dire::BinaryFormat::Compact })
+	{
+		serializer.SetFormat(format);
+		deserializer.SetFormat(format);
+
+		TrackedD tracked;
+		tracked.aBoolMap = { {1, true}, {2, false} };
+		tracked.aVector.assign(100, 7);
+		tracked.EditDirtyProperties()->Clear();
+		TrackedD replica = tracked;
+
+		tracked.hitPoints = 1;
+		tracked.MarkDirty(tracked.hitPoints);
+		const dire::DataStructureHandler& mapHandler = tracked.GetTypeInfo().FindPropertyInHierarchy("aBoolMap")->GetDataStructureHandler();
+		REQUIRE(mapHandler.GetMapHandler()->Erase(&tracked.aBoolMap, "1"));
+		tracked.MarkDirty(tracked.aBoolMap);
+
+		const std::string full = serializer.Serialize(tracked).AsString();
+		const std::string dirty = serializer.SerializeDirty(tracked).AsString();
+		REQUIRE(dirty.size() < full.size());
+		REQUIRE(tracked.GetDirtyProperties()->IsEmpty());
+
+		// Only the dirty properties are overwritten in the replica: maps lose their erased entries
+		REQUIRE_FALSE(deserializer.DeserializeInto(dirty.data(), dirty.size(), replica).HasError());
+		REQUIRE(replica.hitPoints == 1);
+		REQUIRE(replica.aBoolMap == tracked.aBoolMap);
+		REQUIRE(dire::AreReflectablesEqual(replica, tracked));
+
+		// Nothing dirty: nothing changes
+		const std::string clean = serializer.SerializeDirty(tracked).AsString();
+		REQUIRE_FALSE(deserializer.DeserializeInto(clean.data(), clean.size(), replica).HasError());
+		REQUIRE(dire::AreReflectablesEqual(replica, tracked));
+
+		// A sink that refuses the data keeps the properties dirty
+		tracked.MarkDirty(tracked.aVector);
+		char tooSmall[4];
+		dire::FixedBufferSink sink(tooSmall, sizeof(tooSmall));
+		serializer.SetStagingSize(dire::SerializationWriter::MIN_STAGING_SIZE);
+		REQUIRE(serializer.SerializeDirtyTo(tracked, sink).HasError());
+		REQUIRE(tracked.GetDirtyProperties()->Count() == 1);
+	}
+
+	d untracked;
+	REQUIRE(serializer.SerializeDirty(untracked).HasError());
+	serializer.SetFormat(dire::BinaryFormat::Schema);
+	TrackedD tracked;
+	REQUIRE(serializer.SerializeDirty(tracked).HasError());
+}
+#endif
+
+#ifdef DIRE_SERIALIZATION_RAPIDJSON_ENABLED
+#	include "dire/Serialization/DireJSONDeserializer.h"
+#	include "dire/Serialization/DireJSONSerializer.h"
+
+TEST_CASE("JSON dirty-only serialization", "[DirtyTracking][Serialization]")
+{
+	dire::JsonReflectorSerializer serializer;
+	dire::JsonReflectorDeserializer deserializer;
+
+	TrackedD tracked;
+	tracked.aBoolMap = { {1, true}, {2, false} };
+	tracked.aVector.assign(10, 7);
+	tracked.EditDirtyProperties()->Clear();
+	TrackedD replica = tracked;
+
+	tracked.hitPoints = 1;
+	tracked.MarkDirty(tracked.hitPoints);
+	REQUIRE(tracked.EraseProperty("aBoolMap[1]"));
+	tracked.aVector.resize(3);
+	tracked.MarkDirty(tracked.aVector);
+
+	const std::string full = serializer.Serialize(tracked).AsString();
+	const std::string dirty = serializer.SerializeDirty(tracked).AsString();
+	REQUIRE(dirty.size() < full.size());
+	REQUIRE(tracked.GetDirtyProperties()->IsEmpty());
+
+	// Only the dirty properties are overwritten in the replica: maps lose their erased entries, and arrays their trailing elements
+	REQUIRE_FALSE(deserializer.DeserializeInto(dirty.data(), replica).HasError());
+	REQUIRE(replica.hitPoints == 1);
+	REQUIRE(replica.aBoolMap == tracked.aBoolMap);
+	REQUIRE(replica.aVector == tracked.aVector);
+	REQUIRE(dire::AreReflectablesEqual(replica, tracked));
+
+	// Nothing dirty: nothing changes
+	const std::string clean = serializer.SerializeDirty(tracked).AsString();
+	REQUIRE_FALSE(deserializer.DeserializeInto(clean.data(), replica).HasError());
+	REQUIRE(dire::AreReflectablesEqual(replica, tracked));
+
+	// A sink that refuses the data keeps the properties dirty
+	tracked.MarkDirty(tracked.aVector);
+	char tooSmall[4];
+	dire::FixedBufferSink sink(tooSmall, sizeof(tooSmall));
+	serializer.SetStagingSize(dire::SerializationWriter::MIN_STAGING_SIZE);
+	REQUIRE(serializer.SerializeDirtyTo(tracked, sink).HasError());
+	REQUIRE(tracked.GetDirtyProperties()->Count() == 1);
+
+	d untracked;
+	REQUIRE(serializer.SerializeDirty(untracked).HasError());
+}
+#endif
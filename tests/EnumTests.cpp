@@ -3,6 +3,18 @@
 #include "TestClasses.h"
 #include <cstring> // strcmp
 
+// dire_reflectable opens a namespace named like the library one: the enum macros have to still find the library after it.
+namespace EnumsAfterReflectable
+{
+	dire_reflectable(struct Holder)
+	{
+		DIRE_REFLECTABLE_INFO()
+	};
+
+	DIRE_SEQUENTIAL_ENUM(Seasons, int, Spring, Summer, Autumn, Winter);
+	DIRE_BITMASK_ENUM(Senses, uint8_t, Sight, Hearing, Touch, Smell, Taste);
+}
+
 TEST_CASE("FindFirstSetBit", "[Enums]")
 {
 	unsigned value = 0b0;
@@ -72,6 +84,33 @@ TEST_CASE("Bitmask enum values", "[Enums]")
 	REQUIRE(typeName == "BitEnum");
 }
 
+TEST_CASE("Bitmask enum strings without allocation", "[Enums]")
+{
+	const BitEnum combined = BitEnum::one | BitEnum::four | BitEnum::eight;
+	REQUIRE(combined.GetString() == "one | four | eight");
+
+	char buffer[32];
+	REQUIRE(BitEnum::ToChars(combined, buffer, sizeof(buffer)) == "one | four | eight");
+	REQUIRE(BitEnum::ToChars(BitEnum::two, buffer, sizeof(buffer)) == "two");
+	REQUIRE(BitEnum::ToChars((BitEnum::Values)0, buffer, sizeof(buffer)) == "invalid");
+	REQUIRE(BitEnum::ToChars(combined, buffer, 17).data() == nullptr); // one character short
+	REQUIRE(BitEnum::ToChars(combined, buffer, 18) == "one | four | eight");
+
+	REQUIRE(BitEnum::GetValueFromString("one | four | eight") == combined);
+	REQUIRE(BitEnum::GetValueFromString("eight | one") == (BitEnum::one | BitEnum::eight));
+	REQUIRE((BitEnum::GetValueFromString("one | five") == 0 && BitEnum::GetValueFromString("one|two") == 0 && BitEnum::GetValueFromString("") == 0));
+}
+
+TEST_CASE("Enums declared after a reflectable", "[Enums]")
+{
+	using namespace EnumsAfterReflectable;
+	REQUIRE(Seasons::GetValueFromSafeString("Autumn") == Seasons::Autumn);
+	REQUIRE(Senses::GetValueFromString("Sight | Smell") == (Senses::Sight | Senses::Smell));
+
+	char buffer[32];
+	REQUIRE(Senses::ToChars(static_cast<Senses::Values>(Senses::Hearing | Senses::Taste), buffer, sizeof(buffer)) == "Hearing | Taste");
+}
+
 TEST_CASE("Bitmask enum bit manipulation", "[Enums]")
 {
 	BitEnum be = BitEnum::two;
@@ -169,6 +208,8 @@ TEST_CASE("Sequential Enum", "[Enums]")
 
 	TestEnum fromString = *TestEnum::GetValueFromString("one");
 	REQUIRE(fromString == TestEnum::one);
+	REQUIRE(TestEnum::GetValueFromSafeString("four") == TestEnum::four);
+	REQUIRE((TestEnum::GetValueFromString("five") == nullptr && TestEnum::GetValueFromString("") == nullptr && TestEnum::GetValueFromString("thre") == nullptr));
 
 	std::vector<std::string> strings;
 	std::vector<std::string> goodStrings{"one", "two", "three", "four"};
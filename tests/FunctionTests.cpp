@@ -161,3 +161,118 @@ TEST_CASE("Reflectable Function Invoke Interface", "[Functions]")
 
 
 }
+
+TEST_CASE("Function Invoke With Buffer", "[Functions]")
+{
+	Test aTest;
+
+	// Buffer layout follows the parameter list: by-value arithmetic slots aligned on their size, pointers for the rest
+	const dire::FunctionInfo* multipleArgs = aTest.GetFunction("multipleArguments");
+	REQUIRE(multipleArgs != nullptr);
+	REQUIRE(multipleArgs->GetParameterOffsets().size() == 2);
+	REQUIRE(multipleArgs->GetParameterOffsets()[0] == 0);
+	REQUIRE(multipleArgs->GetParameterOffsets()[1] == 4);
+	REQUIRE(multipleArgs->GetArgumentBufferSize() == 8);
+	REQUIRE(multipleArgs->GetReturnSize() == sizeof(short));
+	REQUIRE(multipleArgs->GetReturnAlignment() == alignof(short));
+
+	alignas(dire::FunctionInfo::ARGUMENT_BUFFER_ALIGNMENT) std::byte argBuffer[64];
+
+	// arguments converted to the declared parameter types
+	short sres = 0;
+	REQUIRE(multipleArgs->PackArguments(argBuffer, 4.f, 3));
+	multipleArgs->InvokeWithBuffer(&aTest, argBuffer, &sres);
+	REQUIRE(sres == 7);
+	REQUIRE(multipleArgs->PackArguments(argBuffer, 4.0, (int64_t)2));
+	multipleArgs->InvokeWithBuffer(&aTest, argBuffer, &sres);
+	REQUIRE(sres == 6);
+
+	// wrong argument count or type
+	REQUIRE_FALSE(multipleArgs->PackArguments(argBuffer, 4.f));
+	REQUIRE_FALSE(multipleArgs->PackArguments(argBuffer, 4.f, std::vector<int>{}));
+
+	// discarded return value
+	multipleArgs->PackArguments(argBuffer, 1.f, 1);
+	multipleArgs->InvokeWithBuffer(&aTest, argBuffer, nullptr);
+
+	// no arguments
+	const dire::FunctionInfo* noArgs = aTest.GetFunction("noArguments");
+	REQUIRE(noArgs->GetArgumentBufferSize() == 0);
+	int resulti = 0;
+	noArgs->InvokeWithBuffer(&aTest, nullptr, &resulti);
+	REQUIRE(resulti == 42);
+
+	// reference parameters are stored as pointers and modified in place
+	const dire::FunctionInfo* refParam = aTest.GetFunction("refParam");
+	REQUIRE(refParam->GetArgumentBufferSize() == sizeof(void*));
+	REQUIRE(refParam->GetReturnSize() == 0);
+	resulti = 1337;
+	REQUIRE(refParam->PackArguments(argBuffer, resulti));
+	refParam->InvokeWithBuffer(&aTest, argBuffer, nullptr);
+	REQUIRE(resulti == 42);
+
+	// mixing pointer and by-value slots
+	const dire::FunctionInfo* templateArgs = aTest.GetFunction("templateArguments1");
+	REQUIRE(templateArgs->GetParameterOffsets()[1] == sizeof(void*));
+	std::vector<float> floats;
+	REQUIRE(templateArgs->PackArguments(argBuffer, floats, 2));
+	templateArgs->InvokeWithBuffer(&aTest, argBuffer, nullptr);
+	REQUIRE(floats.size() == 1);
+	REQUIRE_THAT(floats[0], Catch::Matchers::WithinRel(2.f));
+
+	// objects passed by value are copied from the pointed argument
+	std::vector<bool> bools{true, false};
+	REQUIRE(aTest.GetFunction("passArrayByValue")->PackArguments(argBuffer, bools));
+	aTest.GetFunction("passArrayByValue")->InvokeWithBuffer(&aTest, argBuffer, nullptr);
+	REQUIRE(bools.size() == 2);
+
+	// arguments stored by pointer are not converted: they have to be of the kind of their parameter
+	const double aDouble = 1.0;
+	REQUIRE_FALSE(refParam->PackArguments(argBuffer, aDouble));
+	REQUIRE_FALSE(refParam->PackArguments(argBuffer, floats));
+	REQUIRE_FALSE(templateArgs->PackArguments(argBuffer, resulti, 2));
+	REQUIRE_FALSE(aTest.GetFunction("passObjectByValue")->PackArguments(argBuffer, bools));
+}
+
+TEST_CASE("Function Handle", "[Functions]")
+{
+	Test aTest;
+	const dire::TypeInfo& testTypeInfo = Test::GetTypeInfo();
+
+	// default is invalid
+	dire::FunctionHandle<int()> invalid;
+	REQUIRE_FALSE(invalid.IsValid());
+
+	auto noArgs = dire::FunctionHandle<int()>::Bind(testTypeInfo, "noArguments");
+	REQUIRE(noArgs.IsValid());
+	REQUIRE(noArgs.GetFunctionInfo() == aTest.GetFunction("noArguments"));
+	REQUIRE(noArgs(&aTest) == 42);
+
+	auto multipleArgs = dire::FunctionHandle<short(float, int)>::Bind(testTypeInfo, "multipleArguments");
+	REQUIRE(multipleArgs);
+	REQUIRE(multipleArgs(&aTest, 4.f, 3) == 7);
+
+	int resulti = 1337;
+	auto refParam = dire::FunctionHandle<void(int&)>::Bind(testTypeInfo, "refParam");
+	REQUIRE(refParam);
+	refParam(&aTest, resulti);
+	REQUIRE(resulti == 42);
+
+	std::vector<float> floats;
+	auto templateArgs = dire::FunctionHandle<void(std::vector<float>&, int)>::Bind(testTypeInfo, "templateArguments1");
+	REQUIRE(templateArgs);
+	templateArgs(&aTest, floats, 2);
+	REQUIRE(floats.size() == 1);
+
+	// unknown name
+	REQUIRE_FALSE(dire::FunctionHandle<void()>::Bind(testTypeInfo, "zdzdzdz"));
+
+	// mismatching return type, parameter count, parameter metatype
+	REQUIRE_FALSE(dire::FunctionHandle<float()>::Bind(testTypeInfo, "noArguments"));
+	REQUIRE_FALSE(dire::FunctionHandle<short(float)>::Bind(testTypeInfo, "multipleArguments"));
+	REQUIRE_FALSE(dire::FunctionHandle<short(int, int)>::Bind(testTypeInfo, "multipleArguments"));
+
+	// same metatypes (Reference, Int) but another C++ signature
+	REQUIRE_FALSE(dire::FunctionHandle<void(std::vector<int>&, int)>::Bind(testTypeInfo, "templateArguments1"));
+	REQUIRE_FALSE(dire::FunctionHandle<void(const int&)>::Bind(testTypeInfo, "refParam"));
+}
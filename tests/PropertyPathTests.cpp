@@ -0,0 +1,135 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "catch2/matchers/catch_matchers.hpp"
+#include "catch2/matchers/catch_matchers_floating_point.hpp"
+#include "dire/Dire.h"
+#include "dire/DirePropertyPath.h"
+
+#include "TestClasses.h"
+
+TEST_CASE("PropertyPath Simple", "[PropertyPath]")
+{
+	c superC;
+
+	// direct property
+	dire::PropertyPath path = dire::PropertyPath::Compile<c>("ctoto");
+	REQUIRE(path.IsValid());
+	REQUIRE((path.GetLeafProperty() != nullptr && path.GetLeafProperty()->GetName() == "ctoto"));
+	REQUIRE(path.GetLeafMetatype() == dire::MetaType::Uint);
+	REQUIRE(path.Get<unsigned>(superC) == &superC.ctoto);
+
+	// inherited property
+	superC.bdouble = 42.0;
+	path = dire::PropertyPath::Compile<c>("bdouble");
+	REQUIRE_THAT(*path.Get<double>(superC), Catch::Matchers::WithinRel(42.0));
+
+	// in nested compound: the same path works on any instance
+	path = dire::PropertyPath::Compile<c>("ultra.mega.compint");
+	REQUIRE(path.IsValid());
+	c otherC;
+	superC.ultra.mega.compint = 0x2a;
+	otherC.ultra.mega.compint = 0x42;
+	REQUIRE(path.Get<int>(superC) == &superC.ultra.mega.compint);
+	REQUIRE(*path.Get<int>(otherC) == 0x42);
+
+	// also works on instances of child classes
+	d aD;
+	aD.ultra.mega.compint = 0x1337;
+	REQUIRE(*path.Get<int>(aD) == 0x1337);
+
+	// setting
+	REQUIRE(path.Set(otherC, 1234));
+	REQUIRE(otherC.ultra.mega.compint == 1234);
+
+	// non existing
+	path = dire::PropertyPath::Compile<c>("ABCD");
+	REQUIRE((!path.IsValid() && *path.GetError() == "Property ABCD not found."));
+	REQUIRE(path.Get<int>(superC) == nullptr);
+	REQUIRE(!path.Set(superC, 42));
+
+	// not a Reflectable
+	path = dire::PropertyPath::Compile<c>("ctoto.nope");
+	REQUIRE(!path.IsValid());
+
+	// empty names
+	REQUIRE(!dire::PropertyPath::Compile<c>("").IsValid());
+	REQUIRE(!dire::PropertyPath::Compile<c>("mega.").IsValid());
+	REQUIRE(!dire::PropertyPath::Compile<c>(".mega").IsValid());
+	REQUIRE(!dire::PropertyPath().IsValid());
+}
+
+TEST_CASE("PropertyPath Array", "[PropertyPath]")
+{
+	c superC;
+	for (int i = 0; i < 10; i++)
+		superC.anArray[i] = i;
+
+	dire::PropertyPath path = dire::PropertyPath::Compile<c>("anArray[6]");
+	REQUIRE(path.IsValid());
+	REQUIRE(path.GetLeafProperty() == nullptr);
+	REQUIRE(path.GetLeafMetatype() == dire::MetaType::Int);
+	REQUIRE(path.Get<int>(superC) == &superC.anArray[6]);
+
+	// in multiarray
+	superC.aMultiArray[1][2] = 1337;
+	path = dire::PropertyPath::Compile<c>("aMultiArray[1][2]");
+	REQUIRE(*path.Get<int>(superC) == 1337);
+
+	// nested arrays in compounds
+	path = dire::PropertyPath::Compile<c>("mega.toto[2].titi[3]");
+	REQUIRE(path.Set(superC, 9999));
+	REQUIRE(superC.mega.toto[2].titi[3] == 9999);
+	REQUIRE(path.Get<int>(superC) == &superC.mega.toto[2].titi[3]);
+
+	// array-like data structures (std::vector) should resize like SetProperty does
+	path = dire::PropertyPath::Compile<c>("aVector[4]");
+	REQUIRE(path.Set(superC, 0x42));
+	REQUIRE((superC.aVector.size() == 5 && superC.aVector[4] == 0x42));
+
+	// mismatched brackets
+	path = dire::PropertyPath::Compile<c>("aVector[error");
+	REQUIRE(!path.IsValid());
+
+	// empty brackets
+	path = dire::PropertyPath::Compile<c>("aVector[]");
+	REQUIRE(!path.IsValid());
+
+	// not a number
+	path = dire::PropertyPath::Compile<c>("aVector[abc]");
+	REQUIRE(!path.IsValid());
+
+	// not an array
+	path = dire::PropertyPath::Compile<c>("ctoto[0]");
+	REQUIRE(!path.IsValid());
+}
+
+TEST_CASE("PropertyPath Map", "[PropertyPath]")
+{
+	d aD;
+
+	// compound in map
+	aD.aFatMap[0].leet = 4242;
+	dire::PropertyPath path = dire::PropertyPath::Compile<d>("aFatMap[0].leet");
+	REQUIRE(path.IsValid());
+	REQUIRE(path.Get<int>(aD) == &aD.aFatMap[0].leet);
+
+	// nested map in compounds
+	aD.aStruct.aSuperMap[42].titi[1] = 2;
+	path = dire::PropertyPath::Compile<d>("aStruct.aSuperMap[42].titi[1]");
+	REQUIRE(path.Get<int>(aD) == &aD.aStruct.aSuperMap[42].titi[1]);
+
+	// map in map
+	path = dire::PropertyPath::Compile<d>("aMapInMap[0][true]");
+	REQUIRE(path.Set(aD, 9999));
+	REQUIRE(aD.aMapInMap[0][true] == 9999);
+
+	// enum key
+	enumTestType enums;
+	path = dire::PropertyPath::Compile<enumTestType>("allowedQueens[Judith]");
+	REQUIRE(path.Set(enums, true));
+	REQUIRE(enums.allowedQueens[Queens::Judith] == true);
+
+	// bad key
+	path = dire::PropertyPath::Compile<d>("aBoolMap[notAnInt]");
+	REQUIRE(!path.IsValid());
+}
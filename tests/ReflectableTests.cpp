@@ -3,6 +3,8 @@
 #include "TestClasses.h"
 
 #include "dire/DireSubclass.h"
+#include "dire/Utils/DireArena.h"
+#include "dire/Serialization/DireBinarySerializer.h"
 
 // Test for instantiation with and without automatic default constructor registration
 
@@ -34,6 +36,22 @@ dire_reflectable(struct CustomInstantiated)
 #define DIRE_DEFAULT_CONSTRUCTOR_INSTANTIATE 1
 
 
+// Test for name lookups when a child class declares members with the same names as its parent's
+
+dire_reflectable(struct Shadowing, c)
+{
+	DIRE_REFLECTABLE_INFO()
+
+	DIRE_PROPERTY(int, ctoto, 42)
+
+	DIRE_FUNCTION(int, test)
+};
+
+int Shadowing::test()
+{
+	return 1337;
+}
+
 TEST_CASE("Subclass Instantiate", "[Reflectable]")
 {
 	// generic instantiate
@@ -85,6 +103,53 @@ TEST_CASE("Clone", "[Reflectable]")
 	testcompound2* clone = clonedComp.Clone<testcompound2>();
 	REQUIRE((clone && clone->leet == clonedComp.leet && clone->copyable.aUselessProp == clonedComp.copyable.aUselessProp && &clone->leet != &clonedComp.leet));
 	delete clone; // So far, Cloning is handled with new, so deleting the pointer is up to the caller.
+
+	// through the whole hierarchy, with adjacent trivially copyable properties merged in a single copy
+	c aC;
+	aC.atoto = 42.f;
+	aC.bdouble = 1337.0;
+	aC.compvar.compleet.leet = 0x42;
+	aC.ctoto = 0x1337;
+	aC.aVector = { 4, 5, 6, 7 };
+	aC.anArray[9] = 9;
+	aC.aMultiArray[9][9] = 99;
+	aC.mega.toto[1].titi[2] = 12;
+	c* cClone = aC.Clone<c>();
+	REQUIRE(cClone != nullptr);
+	REQUIRE((cClone->atoto == 42.f && cClone->bdouble == 1337.0 && cClone->compvar.compleet.leet == 0x42 && cClone->ctoto == 0x1337));
+	REQUIRE((cClone->aVector == aC.aVector && cClone->anArray[9] == 9 && cClone->aMultiArray[9][9] == 99 && cClone->mega.toto[1].titi[2] == 12));
+	delete cClone;
+
+	const dire::TypeInfo& cTypeInfo = c::GetTypeInfo();
+	REQUIRE(cTypeInfo.GetCache().GetCopyPlan().GetStepCount() < cTypeInfo.GetPropertyLayout().GetCount());
+}
+
+TEST_CASE("CloneBatch", "[Reflectable]")
+{
+	c aC;
+	aC.ctoto = 0x1337;
+	aC.aVector = { 4, 5, 6, 7 };
+	aC.mega.compleet.leet = 42;
+
+	dire::Arena arena;
+	dire::Span<dire::Reflectable*> clones = dire::CloneBatch(aC, 100, arena);
+	REQUIRE(clones.Size() == 100);
+	for (size_t iClone = 0; iClone < clones.Size(); ++iClone)
+	{
+		REQUIRE(clones[iClone]->IsA<c>());
+		auto* clone = static_cast<c*>(clones[iClone]);
+		REQUIRE((clone->ctoto == 0x1337 && clone->aVector == aC.aVector && clone->mega.compleet.leet == 42));
+
+		// contiguous in memory
+		if (iClone != 0)
+		{
+			REQUIRE(reinterpret_cast<std::byte*>(clones[iClone]) == reinterpret_cast<std::byte*>(clones[iClone - 1]) + sizeof(c));
+		}
+	}
+
+	dire::DestroyBatch(clones);
+
+	REQUIRE(dire::CloneBatch(aC, 0, arena).Empty());
 }
 
 TEST_CASE("IsA", "[Reflectable]")
@@ -100,6 +165,22 @@ TEST_CASE("IsA", "[Reflectable]")
 	REQUIRE((!notPartOfTheFamily.IsA<a>() && !notPartOfTheFamily.IsA<b>() && !notPartOfTheFamily.IsA<c>() && notPartOfTheFamily.IsA<SuperCompound>()));
 }
 
+TEST_CASE("Cast", "[Reflectable]")
+{
+	b aB;
+	dire::Reflectable* reflectable = &aB;
+	const dire::Reflectable* constReflectable = &aB;
+
+	REQUIRE((dire::Cast<a>(reflectable) == &aB && dire::Cast<b>(reflectable) == &aB && dire::Cast<dire::Reflectable>(reflectable) == &aB));
+	REQUIRE((dire::Cast<c>(reflectable) == nullptr && dire::Cast<SuperCompound>(reflectable) == nullptr));
+	REQUIRE((dire::Cast<b>(constReflectable) == &aB && dire::Cast<c>(constReflectable) == nullptr));
+	REQUIRE(dire::Cast<a>(static_cast<dire::Reflectable*>(nullptr)) == nullptr);
+
+	REQUIRE((a::GetTypeInfo().IsParentOf(c::GetTypeInfo()) && !c::GetTypeInfo().IsParentOf(a::GetTypeInfo())));
+	REQUIRE((b::GetTypeInfo().IsParentOf(b::GetTypeInfo()) && !b::GetTypeInfo().IsParentOf(b::GetTypeInfo(), false)));
+	REQUIRE(!a::GetTypeInfo().IsParentOf(SuperCompound::GetTypeInfo()));
+}
+
 TEST_CASE("TypeInfo Name", "[Reflectable]")
 {
 	REQUIRE(a::GetTypeInfo().GetName() == "a");
@@ -110,6 +191,69 @@ TEST_CASE("TypeInfo Name", "[Reflectable]")
 	REQUIRE(testNS::Nested2::GetTypeInfo().GetName() == "testNS::Nested2");
 }
 
+TEST_CASE("TypeInfo Lookup", "[Reflectable]")
+{
+	using Scope = dire::TypeInfoCache::LookupScope;
+	const dire::TypeInfoCache& cache = Shadowing::GetTypeInfo().GetCache();
+
+	// the child's property takes precedence over the parent's one
+	auto [owner, prop] = cache.FindProperty("ctoto", Scope::Hierarchy);
+	REQUIRE((owner == &Shadowing::GetTypeInfo() && prop != nullptr && prop->GetMetatype() == dire::MetaType::Int));
+	std::tie(owner, prop) = cache.FindProperty("ctoto", Scope::Parents);
+	REQUIRE((owner == &c::GetTypeInfo() && prop != nullptr && prop->GetMetatype() == dire::MetaType::Uint));
+
+	// properties of every level of the hierarchy are found
+	std::tie(owner, prop) = cache.FindProperty("atoto", Scope::Hierarchy);
+	REQUIRE((owner == &a::GetTypeInfo() && prop != nullptr && prop->GetName() == "atoto"));
+	std::tie(owner, prop) = cache.FindProperty("atoto", Scope::Self);
+	REQUIRE((owner == nullptr && prop == nullptr));
+	std::tie(owner, prop) = cache.FindProperty("nope", Scope::Hierarchy);
+	REQUIRE((owner == nullptr && prop == nullptr));
+
+	Shadowing shadow;
+	shadow.ctoto = 7;
+	REQUIRE(shadow.GetSafeProperty<int>("ctoto") == 7);
+	REQUIRE(shadow.GetProperty<double>("bdouble") == &shadow.bdouble);
+
+	// same rules for functions
+	auto [funcOwner, func] = cache.FindFunction("test", Scope::Hierarchy);
+	REQUIRE((funcOwner == &Shadowing::GetTypeInfo() && func != nullptr));
+	std::tie(funcOwner, func) = cache.FindFunction("test", Scope::Parents);
+	REQUIRE((funcOwner == &a::GetTypeInfo() && func != nullptr));
+	REQUIRE(shadow.TypedInvokeFunction<int>("test") == 1337);
+	REQUIRE(shadow.GetFunction("Roger") == b::GetTypeInfo().FindFunction("Roger"));
+}
+
+TEST_CASE("TypeInfo PropertyLayout", "[Reflectable]")
+{
+	// The layout must flatten the hierarchy in the same order as ForEachPropertyInHierarchy
+	const dire::PropertyLayout& layout = d::GetTypeInfo().GetPropertyLayout();
+	size_t iProp = 0;
+	d::GetTypeInfo().ForEachPropertyInHierarchy([&](const dire::PropertyTypeInfo& pProperty)
+	{
+		REQUIRE(iProp < layout.GetCount());
+		REQUIRE(&layout.GetProperty(iProp) == &pProperty);
+		REQUIRE(layout.GetOffset(iProp) == pProperty.GetOffset());
+		REQUIRE(layout.GetMetatype(iProp) == pProperty.GetMetatype());
+		REQUIRE(layout.GetSize(iProp) == pProperty.GetSize());
+		REQUIRE(layout.GetDataStructureHandler(iProp).GetArrayHandler() == pProperty.GetDataStructureHandler().GetArrayHandler());
+		REQUIRE(layout.GetCopyFunction(iProp) == pProperty.GetCopyConstructorFunction());
+		iProp++;
+	});
+	REQUIRE(iProp == layout.GetCount());
+
+	// Farthest parent first
+	REQUIRE(layout.GetProperty(0).GetName() == (*a::GetTypeInfo().GetPropertyList().begin()).GetName());
+
+	// Lookup by name
+	for (iProp = 0; iProp < layout.GetCount(); ++iProp)
+	{
+		REQUIRE(layout.FindIndexByName(layout.GetProperty(iProp).GetName()) == iProp);
+	}
+	REQUIRE(layout.FindIndexByName("doesNotExist") == layout.GetCount());
+	REQUIRE(layout.FindIndexByName("") == layout.GetCount());
+}
+
 TEST_CASE("Reflectable Instantiate", "[Reflectable]")
 {
 	// use default constructor as instantiator
@@ -138,3 +282,76 @@ static_assert(std::is_same_v<a::Super, dire::Reflectable>);
 
 // multiple inheritance: Super is the first type in the inheritance list.
 static_assert(std::is_same_v<b::Super, a >);
+
+#ifdef DIRE_STATS_ENABLED
+TEST_CASE("Reflection stats", "[Reflectable]")
+{
+	dire::TypeInfoDatabase& database = dire::TypeInfoDatabase::EditSingleton();
+	database.ResetStats();
+	database.SetPropertyPathSamplingPeriod(1); // sample every lookup
+
+	auto findStats = [](const dire::ReflectionStats& pStats, const dire::TypeInfo& pTypeInfo) -> const dire::TypeStatsSnapshot*
+	{
+		for (const dire::TypeStatsSnapshot& typeStats : pStats.Types)
+		{
+			if (typeStats.ID == pTypeInfo.GetID())
+				return &typeStats;
+		}
+		return nullptr;
+	};
+
+	Copyable copyable;
+	for (int iLookup = 0; iLookup < 3; ++iLookup)
+	{
+		REQUIRE(copyable.GetProperty<float>("aUselessProp") != nullptr);
+	}
+	REQUIRE(copyable.GetProperty<float>("doesNotExist") == nullptr);
+
+	Copyable* clone = copyable.Clone<Copyable>();
+	REQUIRE(clone != nullptr);
+	delete clone;
+
+	a anA;
+	REQUIRE(std::any_cast<int>(anA.InvokeFunction("test")) == 42);
+	REQUIRE(!anA.InvokeFunction("doesNotExist").has_value()); // not an invocation
+
+#ifdef DIRE_COMPILE_BINARY_SERIALIZATION
+	dire::BinaryReflectorSerializer serializer;
+	const size_t nbBytes = serializer.Serialize(copyable).GetBytes().size();
+#endif
+
+	dire::ReflectionStats stats = database.GetStatsSnapshot();
+
+	const dire::TypeStatsSnapshot* copyableStats = findStats(stats, Copyable::GetTypeInfo());
+	REQUIRE(copyableStats != nullptr);
+	REQUIRE(copyableStats->TypeName == "Copyable");
+	REQUIRE(copyableStats->Get(dire::TypeCounter::PropertyLookups) == 4);
+	REQUIRE(copyableStats->Get(dire::TypeCounter::FailedPropertyLookups) == 1);
+	REQUIRE(copyableStats->Get(dire::TypeCounter::Clones) == 1);
+	REQUIRE(copyableStats->Get(dire::TypeCounter::Instantiations) == 1); // by the clone
+#ifdef DIRE_COMPILE_BINARY_SERIALIZATION
+	REQUIRE(copyableStats->Get(dire::TypeCounter::BinaryBytesSerialized) == nbBytes);
+#endif
+
+	const dire::TypeStatsSnapshot* aStats = findStats(stats, a::GetTypeInfo());
+	REQUIRE(aStats != nullptr);
+	REQUIRE(aStats->Get(dire::TypeCounter::FunctionInvocations) == 1);
+
+	// Types that counted nothing are left out
+	REQUIRE(findStats(stats, b::GetTypeInfo()) == nullptr);
+
+	REQUIRE(stats.TopPropertyPaths.size() == 2);
+	REQUIRE(stats.TopPropertyPaths[0].Path == "aUselessProp");
+	REQUIRE(stats.TopPropertyPaths[0].Count == 3);
+	REQUIRE(stats.TopPropertyPaths[1].Path == "doesNotExist");
+
+	REQUIRE(std::string(dire::GetTypeCounterName(dire::TypeCounter::Clones)) == "Clones");
+
+	database.ResetStats();
+	stats = database.GetStatsSnapshot();
+	REQUIRE(stats.Types.empty());
+	REQUIRE(stats.TopPropertyPaths.empty());
+
+	database.SetPropertyPathSamplingPeriod(dire::PropertyPathSampler::DEFAULT_SAMPLING_PERIOD);
+}
+#endif
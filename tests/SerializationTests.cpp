@@ -1,12 +1,64 @@
 #include "DireDefines.h"
 #ifdef DIRE_SERIALIZATION_ENABLED
+#	include <algorithm>
+#	include <atomic>
+#	include <cstdio>
+#	include <deque>
+#	include <filesystem>
+#	include <fstream>
 #	include <iomanip>
 #	include <iostream>
+#	include <iterator>
+#	include <memory>
 
 #	include "catch2/catch_test_macros.hpp"
 
 #	include "TestClasses.h"
 
+#	include "dire/Serialization/DireBatchSerialization.h"
+#	include "dire/Serialization/DireDelta.h"
+
+/* Concatenates the chunks of a chunked buffer sink */
+[[maybe_unused]] static std::string ChunksToString(const dire::ChunkedBufferSink& pSink)
+{
+	std::string concatenated;
+	for (const auto& chunk : pSink.GetChunks())
+	{
+		concatenated.append(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+	}
+	return concatenated;
+}
+
+
+TEST_CASE("Map keys and metadata names for serialization", "[Serialization]")
+{
+	const dire::PropertyTypeInfo* xpProperty = metadatas::GetTypeInfo().FindPropertyInHierarchy("xp");
+	REQUIRE(xpProperty->GetMetadataName() == "xp_metadata");
+
+	// Integer keys are formatted in the given buffer
+	const dire::IMapDataStructureHandler* intMapHandler = d::GetTypeInfo().FindPropertyInHierarchy("aMap")->GetMapHandler();
+	char keyChars[16];
+	const int intKey = -1234567;
+	DIRE_STRING_VIEW keyStr = intMapHandler->KeyToChars(&intKey, keyChars, sizeof(keyChars));
+	REQUIRE(keyStr == "-1234567");
+	REQUIRE(keyStr.data() == keyChars);
+	REQUIRE(keyStr == intMapHandler->KeyToString(&intKey));
+	REQUIRE(intMapHandler->KeyToChars(&intKey, keyChars, 4).data() == nullptr); // too small
+
+	// Enum keys write their name
+	const dire::IMapDataStructureHandler* enumMapHandler = enumTestType::GetTypeInfo().FindPropertyInHierarchy("allowedQueens")->GetMapHandler();
+	const Queens enumKey = Queens::Rachel;
+	REQUIRE(enumMapHandler->KeyToChars(&enumKey, keyChars, sizeof(keyChars)) == "Rachel");
+	REQUIRE(enumMapHandler->KeyToChars(&enumKey, keyChars, sizeof(keyChars)).data() == keyChars);
+	REQUIRE(enumMapHandler->KeyToChars(&enumKey, keyChars, 2).data() == nullptr);
+
+	// Floating point keys are formatted like KeyToString does
+	const dire::IMapDataStructureHandler& floatMapHandler = dire::TypedMapDataStructureHandler<std::map<double, int>>::GetInstance();
+	const double floatKey = -12.5;
+	REQUIRE(floatMapHandler.KeyToChars(&floatKey, keyChars, sizeof(keyChars)) == floatMapHandler.KeyToString(&floatKey));
+	REQUIRE(floatMapHandler.KeyToChars(&floatKey, keyChars, 5).data() == nullptr);
+}
+
 
 #	ifdef DIRE_SERIALIZATION_RAPIDJSON_ENABLED
 #		include "dire/Serialization/DireJSONSerializer.h"
@@ -172,6 +224,74 @@ TEST_CASE("JSON Serialize enumerations", "[Serialization]")
 	REQUIRE(enums == deserializedEnums);
 }
 
+TEST_CASE("JSON streaming deserialization", "[Serialization]")
+{
+	dire::JsonReflectorDeserializer deserializer;
+
+	// Unknown members (like metadata) and values of another type are skipped, missing properties keep their value
+	const std::string json = R"({"xp":7,"unknown":{"a":[1,{"b":[2]}],"c":"d"},"xp_metadata":{"x":1},"bdouble":2,"ctoto":"wrong",)"
+		R"("aVector":[4,5,6,7],"anArray":[9,8],"aMultiArray":[[1,2],[3]],"compvar":{"compint":-3,"compleet":{"leet":12}},)"
+		R"("aBoolMap":{"1":true,"2":false},"aFatMap":{"5":{"leet":55}},"aStruct":{"aSuperMap":{"3":{"titi":[1,2,3,4,5]}}},"mega":{"toto":[{"titi":[7]}]}})";
+
+	d expected;
+	expected.xp = 7;
+	expected.bdouble = 2.;
+	expected.aVector = { 4, 5, 6, 7 };
+	expected.anArray[0] = 9;
+	expected.anArray[1] = 8;
+	expected.aMultiArray[0][0] = 1;
+	expected.aMultiArray[0][1] = 2;
+	expected.aMultiArray[1][0] = 3;
+	expected.compvar.compint = -3;
+	expected.compvar.compleet.leet = 12;
+	expected.aBoolMap = { {1, true}, {2, false} };
+	expected.aFatMap[5].leet = 55;
+	expected.aStruct.aSuperMap[3].titi[4] = 5;
+	for (int i = 0; i < 4; ++i)
+		expected.aStruct.aSuperMap[3].titi[i] = i + 1;
+	expected.mega.toto[0].titi[0] = 7;
+
+	d deserialized;
+	REQUIRE_FALSE(deserializer.DeserializeInto(json.data(), deserialized).HasError());
+	REQUIRE(dire::AreReflectablesEqual(deserialized, expected));
+
+	// Into a replica with more: resizable arrays are shrunk, and maps lose the entries that were not serialized
+	d replica = expected;
+	replica.aVector = { 1, 2, 3, 4, 5, 6 };
+	replica.aBoolMap[42] = true;
+	REQUIRE_FALSE(deserializer.DeserializeInto(json.data(), replica).HasError());
+	REQUIRE(replica.aVector == expected.aVector);
+	REQUIRE(replica.aBoolMap == expected.aBoolMap);
+	REQUIRE(dire::AreReflectablesEqual(replica, expected));
+
+	// In situ: same result, the deserializer state is reused
+	std::string buffer = json;
+	d deserializedInsitu;
+	REQUIRE_FALSE(deserializer.DeserializeInsitu(buffer.data(), deserializedInsitu).HasError());
+	REQUIRE(dire::AreReflectablesEqual(deserializedInsitu, expected));
+
+	enumTestType enums;
+	REQUIRE_FALSE(deserializer.DeserializeInto(R"({"bestKing":"Cesar","worstKings":["Charles","Philippe"],"allowedQueens":{"Pallas":true}})", enums).HasError());
+	REQUIRE((enums.bestKing == Kings::Cesar && enums.worstKings[0] == Kings::Charles && enums.worstKings[1] == Kings::Philippe));
+	REQUIRE(enums.allowedQueens == std::map<Queens, bool>{ {Queens::Pallas, true} });
+
+	// Errors
+	d broken;
+	REQUIRE(deserializer.DeserializeInto(R"({"xp":1,"aVector":[1,)", broken).HasError());
+	REQUIRE(deserializer.DeserializeInto("[1,2]", broken).HasError());
+	REQUIRE(deserializer.DeserializeInto("", broken).HasError());
+	REQUIRE_FALSE(deserializer.DeserializeInto(R"({"xp":3})", broken).HasError());
+	REQUIRE(broken.xp == 3);
+
+	// Sized: the parsing stops at the given size, whatever follows
+	const std::string concatenated = R"({"xp":4}{"xp":5})";
+	REQUIRE_FALSE(deserializer.DeserializeInto(concatenated.data(), 8, broken).HasError());
+	REQUIRE(broken.xp == 4);
+	REQUIRE_FALSE(deserializer.DeserializeInto(concatenated.data() + 8, 8, broken).HasError());
+	REQUIRE(broken.xp == 5);
+	REQUIRE(deserializer.DeserializeInto(concatenated.data(), 6, broken).HasError());
+}
+
 TEST_CASE("JSON Serialize Metadatas", "[Serialization]")
 {
 	dire::JsonReflectorSerializer serializer;
@@ -189,6 +309,67 @@ TEST_CASE("JSON Serialize Metadatas", "[Serialization]")
 #endif
 }
 
+
+TEST_CASE("JSON Serialize to sinks", "[Serialization]")
+{
+	dire::JsonReflectorSerializer serializer;
+
+	d aD;
+	aD.aVector.resize(1000, 42);
+	const std::string serialized = serializer.Serialize(aD).AsString();
+
+	// Tiny chunks and staging block to flush a lot
+	serializer.SetStagingSize(0);
+	dire::ChunkedBufferSink chunkedSink(100);
+	REQUIRE_FALSE(serializer.SerializeTo(aD, chunkedSink).HasError());
+	REQUIRE(chunkedSink.GetChunks().size() > 1);
+	REQUIRE(ChunksToString(chunkedSink) == serialized);
+
+	std::string tooSmall(serialized.size() - 1, '\0');
+	dire::FixedBufferSink fixedSink(tooSmall.data(), tooSmall.size());
+	REQUIRE(serializer.SerializeTo(aD, fixedSink).HasError());
+
+	const std::string jsonPath = (std::filesystem::temp_directory_path() / "dire_json_serialization.json").string();
+	REQUIRE_FALSE(serializer.SerializeToFile(aD, jsonPath).HasError());
+	std::string writtenJson;
+	{
+		std::ifstream jsonFile(jsonPath, std::ios::binary);
+		writtenJson.assign(std::istreambuf_iterator<char>(jsonFile), std::istreambuf_iterator<char>());
+	}
+	std::remove(jsonPath.c_str());
+	REQUIRE(writtenJson == serialized);
+
+	// The serializer is still usable in memory afterwards
+	REQUIRE(serializer.Serialize(aD).AsString() == serialized);
+}
+
+TEST_CASE("JSON delta serialization", "[Serialization]")
+{
+	dire::JsonReflectorSerializer serializer;
+	dire::JsonReflectorDeserializer deserializer;
+
+	d baseline;
+	baseline.aVector = { 1, 2, 3 };
+	baseline.aFatMap[1].leet = 1;
+	baseline.aBoolMap[4] = true;
+
+	d aD = baseline;
+	REQUIRE(serializer.SerializeDelta(aD, baseline).AsString() == "{}");
+
+	aD.xp = 1000;
+	aD.aVector[1] = 20;
+	aD.aVector.push_back(4);
+	aD.aFatMap[1].leet = 10;
+	aD.aBoolMap.erase(4);
+	REQUIRE(serializer.SerializeDelta(aD, baseline).AsString() ==
+		R"({"aVector":{"size":4,"1":20,"3":4},"xp":1000,"aBoolMap":{"erase":["4"]},"aFatMap":{"patch":{"1":{"leet":10}}}})");
+
+	const std::string delta = serializer.SerializeDelta(aD, baseline).AsString();
+	d patched = baseline;
+	REQUIRE_FALSE(deserializer.ApplyDelta(delta.data(), patched).HasError());
+	REQUIRE(dire::AreReflectablesEqual(patched, aD));
+}
+
 #	endif // DIRE_SERIALIZATION_RAPIDJSON_ENABLED
 
 #	ifdef DIRE_SERIALIZATION_BINARY_ENABLED
@@ -463,6 +644,605 @@ TEST_CASE("Binary Serialize enumerations", "[Serialization]")
 	deserializer.DeserializeInto((const char*)binarized.data(), deserializedEnums);
 	REQUIRE(enums == deserializedEnums);
 }
+
+TEST_CASE("Binary contiguous arrays", "[Serialization]")
+{
+	// Contiguous data query of the array handlers
+	const auto& vectorHandler = dire::TypedArrayDataStructureHandler<std::vector<int>>::GetInstance();
+	const auto& dequeHandler = dire::TypedArrayDataStructureHandler<std::deque<int>>::GetInstance();
+	const auto& staticArrayHandler = dire::TypedArrayDataStructureHandler<int[4]>::GetInstance();
+
+	std::vector<int> ints{ 1, 2, 3 };
+	std::deque<int> deque{ 1, 2 };
+	int staticInts[4]{};
+	REQUIRE(vectorHandler.ContiguousData(&ints) == ints.data());
+	REQUIRE(dequeHandler.ContiguousData(&deque) == nullptr);
+	REQUIRE(staticArrayHandler.ContiguousData(&staticInts) == &staticInts[0]);
+
+	vectorHandler.Resize(&ints, 5);
+	REQUIRE(ints.size() == 5);
+	staticArrayHandler.Resize(&staticInts, 5); // no-op
+	REQUIRE(staticArrayHandler.Size(&staticInts) == 4);
+
+	dire::BinaryReflectorSerializer serializer;
+	dire::BinaryReflectorDeserializer deserializer;
+
+	// Deserialized arrays get the serialized size, even when it's smaller than the current one
+	c serializedC;
+	serializedC.aVector = { 7, 8 };
+	auto binarized = serializer.Serialize(serializedC).GetBytes();
+
+	c deserializedC;
+	deserializedC.aVector = { 1, 2, 3, 4, 5, 6 };
+	REQUIRE_FALSE(deserializer.DeserializeInto((const char*)binarized.data(), binarized.size(), deserializedC).HasError());
+	REQUIRE(deserializedC.aVector == serializedC.aVector);
+
+	serializedC.aVector.clear();
+	binarized = serializer.Serialize(serializedC).GetBytes();
+	REQUIRE_FALSE(deserializer.DeserializeInto((const char*)binarized.data(), binarized.size(), deserializedC).HasError());
+	REQUIRE(deserializedC.aVector.empty());
+}
+
+TEST_CASE("Binary bounds-checked and memory-mapped deserialization", "[Serialization]")
+{
+	dire::BinaryReflectorSerializer serializer;
+	dire::BinaryReflectorDeserializer deserializer;
+
+	c serializedC;
+	serializedC.aVector = { 42, 43, 44, 45, 46 };
+	for (int i = 0; i < 10; i++)
+	{
+		serializedC.anArray[i] = i + 1;
+	}
+
+	const auto binarized = serializer.Serialize(serializedC).GetBytes();
+	const char* binaryData = reinterpret_cast<const char*>(binarized.data());
+
+	c deserializedC;
+	auto result = deserializer.DeserializeInto(binaryData, binarized.size(), deserializedC);
+	REQUIRE_FALSE(result.HasError());
+	REQUIRE(deserializedC.aVector == serializedC.aVector);
+	REQUIRE(memcmp(&serializedC.anArray, &deserializedC.anArray, sizeof(serializedC.anArray)) == 0);
+
+	// Any truncation of the data is detected
+	for (size_t truncatedSize = 0; truncatedSize < binarized.size(); ++truncatedSize)
+	{
+		c truncatedC;
+		result = deserializer.DeserializeInto(binaryData, truncatedSize, truncatedC);
+		REQUIRE(result.HasError());
+	}
+
+	// A corrupted array size is an error too, even for elements that are not read in bulk: it must not make us grow the array first
+	enumTestType enums;
+	enums.playableKings = { Kings::Alexandre, Kings::Cesar, Kings::Charles };
+	std::string enumBytes = serializer.Serialize(enums).AsString();
+	const size_t sizeofKings = sizeof(Kings);
+	size_t arraySize = enums.playableKings.size();
+	std::string arrayHeaderEnd(2 * sizeof(size_t), '\0'); // SizeofElement then ArraySize
+	memcpy(arrayHeaderEnd.data(), &sizeofKings, sizeof(size_t));
+	memcpy(arrayHeaderEnd.data() + sizeof(size_t), &arraySize, sizeof(size_t));
+	const size_t arrayHeaderPos = enumBytes.find(arrayHeaderEnd);
+	REQUIRE(arrayHeaderPos != std::string::npos);
+	arraySize = size_t(1) << 40;
+	memcpy(enumBytes.data() + arrayHeaderPos + sizeof(size_t), &arraySize, sizeof(size_t));
+	enumTestType corruptedEnums;
+	REQUIRE(deserializer.DeserializeInto(enumBytes.data(), enumBytes.size(), corruptedEnums).HasError());
+
+	// So is a property whose type in the data is not its type in the layout: it is not read with the type of the data
+	std::string mismatchedBytes(binaryData, binarized.size());
+	const size_t firstPropertyTypePos = sizeof(dire::ReflectableID) + sizeof(uint32_t); // right after the object header
+	dire::MetaType::Values firstPropertyType;
+	memcpy(&firstPropertyType, mismatchedBytes.data() + firstPropertyTypePos, sizeof(firstPropertyType));
+	const dire::MetaType::Values mismatchedType = (firstPropertyType == dire::MetaType::Map ? dire::MetaType::Object : dire::MetaType::Map);
+	memcpy(mismatchedBytes.data() + firstPropertyTypePos, &mismatchedType, sizeof(mismatchedType));
+	c mismatchedC;
+	result = deserializer.DeserializeInto(mismatchedBytes.data(), mismatchedBytes.size(), mismatchedC);
+	REQUIRE((result.HasError() && result.GetError() == "The binary data does not match the properties of the reflectable to be deserialized into."));
+
+	// Deserialize from a mapped file
+	const std::string mappedPath = (std::filesystem::temp_directory_path() / "dire_binary_deserialization.bin").string();
+	{
+		std::ofstream binaryFile(mappedPath, std::ios::binary);
+		binaryFile.write(binaryData, std::streamsize(binarized.size()));
+	}
+
+	c mappedC;
+	result = deserializer.DeserializeFileInto(mappedPath, mappedC);
+	std::remove(mappedPath.c_str()); // the file is unmapped once deserialized
+	REQUIRE_FALSE(result.HasError());
+	REQUIRE(result.GetReflectable<c>() == &mappedC);
+	REQUIRE(mappedC.aVector == serializedC.aVector);
+	REQUIRE(memcmp(&serializedC.anArray, &mappedC.anArray, sizeof(serializedC.anArray)) == 0);
+
+	result = deserializer.DeserializeFileInto("this_file_does_not_exist.bin", mappedC);
+	REQUIRE(result.HasError());
+}
+TEST_CASE("Binary Serialize to sinks", "[Serialization]")
+{
+	dire::BinaryReflectorSerializer serializer;
+	dire::BinaryReflectorDeserializer deserializer;
+
+	d aD;
+	aD.SetProperty<int>("ultra.mega.toto[0].titi[2]", 0x1234);
+	aD.aVector.resize(1000, 42); // bigger than the staging block: written straight to the sink
+
+	const dire::ISerializer::Result inMemory = serializer.Serialize(aD);
+	const std::string serialized = inMemory.AsString();
+
+	serializer.SetStagingSize(0); // minimum staging size, to flush a lot
+
+	dire::ChunkedBufferSink chunkedSink(100);
+	REQUIRE_FALSE(serializer.SerializeTo(aD, chunkedSink).HasError());
+	REQUIRE(chunkedSink.GetSize() == serialized.size());
+	for (const auto& chunk : chunkedSink.GetChunks())
+	{
+		REQUIRE(chunk.size() <= 100);
+	}
+	REQUIRE(ChunksToString(chunkedSink) == serialized);
+
+	struct CallbackData
+	{
+		std::string	Bytes;
+		size_t		NbCalls = 0;
+		size_t		BiggestWrite = 0;
+	} callbackData;
+	dire::CallbackSink callbackSink([](void* pUserData, const char* pBytes, size_t pNbBytes)
+	{
+		auto* data = static_cast<CallbackData*>(pUserData);
+		data->Bytes.append(pBytes, pNbBytes);
+		data->NbCalls++;
+		data->BiggestWrite = std::max(data->BiggestWrite, pNbBytes);
+		return true;
+	}, &callbackData);
+	REQUIRE_FALSE(serializer.SerializeTo(aD, callbackSink).HasError());
+	REQUIRE(callbackData.Bytes == serialized);
+	REQUIRE(callbackData.NbCalls > 1);
+	REQUIRE(callbackData.BiggestWrite == aD.aVector.size() * sizeof(int));
+
+	// A sink refusing the data makes the serialization fail
+	dire::CallbackSink refusingSink([](void*, const char*, size_t) { return false; }, nullptr);
+	REQUIRE(serializer.SerializeTo(aD, refusingSink).HasError());
+
+	std::string fixedBuffer(serialized.size(), '\0');
+	dire::FixedBufferSink fixedSink(fixedBuffer.data(), fixedBuffer.size());
+	REQUIRE_FALSE(serializer.SerializeTo(aD, fixedSink).HasError());
+	REQUIRE(fixedSink.GetSize() == serialized.size());
+	REQUIRE(fixedBuffer == serialized);
+
+	d deserializedD;
+	REQUIRE_FALSE(deserializer.DeserializeInto(fixedBuffer.data(), fixedBuffer.size(), deserializedD).HasError());
+	REQUIRE(deserializedD.aVector == aD.aVector);
+	REQUIRE(*deserializedD.GetProperty<int>("ultra.mega.toto[0].titi[2]") == 0x1234);
+
+	fixedSink.Clear();
+	REQUIRE_FALSE(serializer.SerializeTo(aD, fixedSink).HasError());
+	REQUIRE(serializer.SerializeTo(aD, fixedSink).HasError()); // no space left
+
+	FILE* file = std::tmpfile();
+	REQUIRE(file != nullptr);
+#ifdef _WIN32
+	dire::FileDescriptorSink fileSink(_fileno(file));
+#else
+	dire::FileDescriptorSink fileSink(fileno(file));
+#endif
+	REQUIRE_FALSE(serializer.SerializeTo(aD, fileSink).HasError());
+	std::rewind(file);
+	std::string fileBytes(serialized.size() + 1, '\0');
+	REQUIRE(std::fread(fileBytes.data(), 1, fileBytes.size(), file) == serialized.size());
+	fileBytes.resize(serialized.size());
+	REQUIRE(fileBytes == serialized);
+	std::fclose(file);
+
+	const std::string binaryPath = (std::filesystem::temp_directory_path() / "dire_binary_serialization.bin").string();
+	REQUIRE_FALSE(serializer.SerializeToFile(aD, binaryPath).HasError());
+	std::string writtenBytes;
+	{
+		std::ifstream binaryFile(binaryPath, std::ios::binary);
+		writtenBytes.assign(std::istreambuf_iterator<char>(binaryFile), std::istreambuf_iterator<char>());
+	}
+	std::remove(binaryPath.c_str());
+	REQUIRE(writtenBytes == serialized);
+	REQUIRE(serializer.SerializeToFile(aD, "this_directory_does_not_exist/binary_serialization.bin").HasError());
+
+	// The serializer is still usable in memory afterwards
+	REQUIRE(serializer.Serialize(aD).AsString() == serialized);
+}
+TEST_CASE("Binary compact format", "[Serialization]")
+{
+	// Varints
+	char varintBytes[dire::Varint::MAX_SIZE + 1];
+	for (uint64_t value : { uint64_t(0), uint64_t(1), uint64_t(127), uint64_t(128), uint64_t(300), uint64_t(UINT32_MAX), UINT64_MAX })
+	{
+		const size_t encodedSize = dire::Varint::Encode(value, varintBytes);
+		uint64_t decoded = 0;
+		REQUIRE(dire::Varint::Decode(varintBytes, encodedSize, decoded) == encodedSize);
+		REQUIRE(decoded == value);
+		REQUIRE(dire::Varint::Decode(varintBytes, encodedSize - 1, decoded) == 0); // truncated
+	}
+	REQUIRE(dire::Varint::Encode(127, varintBytes) == 1);
+	REQUIRE(dire::Varint::Encode(128, varintBytes) == 2);
+	REQUIRE(dire::Varint::Encode(UINT64_MAX, varintBytes) == dire::Varint::MAX_SIZE);
+
+	memset(varintBytes, 0x80, sizeof(varintBytes)); // never ending varint
+	uint64_t overlong = 0;
+	REQUIRE(dire::Varint::Decode(varintBytes, sizeof(varintBytes), overlong) == 0);
+
+	for (int64_t value : { int64_t(0), int64_t(-1), int64_t(1), int64_t(-64), int64_t(63), INT64_MIN, INT64_MAX })
+	{
+		REQUIRE(dire::Varint::ZigZagDecode(dire::Varint::ZigZagEncode(value)) == value);
+	}
+	REQUIRE(dire::Varint::ZigZagEncode(-1) == 1);
+	REQUIRE(dire::Varint::ZigZagEncode(1) == 2);
+
+	dire::BinaryReflectorSerializer serializer;
+	dire::BinaryReflectorDeserializer deserializer;
+	serializer.SetFormat(dire::BinaryFormat::Compact);
+	deserializer.SetFormat(dire::BinaryFormat::Compact);
+
+	// Object ID, property count, property offset, map size, then zigzag keys followed by their bool value
+	mapType serializedMap;
+	for (int i = 0; i < 10; i++)
+	{
+		serializedMap.aEvenOddMap[i] = (i % 2 == 0);
+	}
+	const dire::ISerializer::Result compactMap = serializer.Serialize(serializedMap);
+	const char expectedResult[] = "\x0d\x01\x08\x0a\x00\x01\x02\x00\x04\x01\x06\x00\x08\x01\x0a\x00\x0c\x01\x0e\x00\x10\x01\x12\x00";
+	REQUIRE(compactMap.AsString() == std::string(expectedResult, sizeof expectedResult - 1));
+
+	mapType deserializedMap;
+	REQUIRE_FALSE(deserializer.DeserializeInto(compactMap.AsString().data(), deserializedMap).HasError());
+	REQUIRE(deserializedMap.aEvenOddMap == serializedMap.aEvenOddMap);
+
+	// Compounds, arrays, maps in maps, negative numbers... round trip, and are smaller than in the native format
+	d aD;
+	aD.SetProperty<int>("ultra.mega.toto[0].titi[2]", -0x1234);
+	aD.aVector = { -1, 0, 1, 1 << 20, -(1 << 30) };
+	aD.aFatMap[-5].leet = -1337;
+	aD.aMapInMap[3][true] = -42;
+	aD.xp = 123456;
+
+	const dire::ISerializer::Result compactD = serializer.Serialize(aD);
+	const std::string compactBytes = compactD.AsString();
+
+	dire::BinaryReflectorSerializer nativeSerializer;
+	const std::string nativeBytes = nativeSerializer.Serialize(aD).AsString();
+	REQUIRE(compactBytes.size() * 3 < nativeBytes.size());
+
+	d deserializedD;
+	REQUIRE_FALSE(deserializer.DeserializeInto(compactBytes.data(), compactBytes.size(), deserializedD).HasError());
+	REQUIRE(nativeSerializer.Serialize(deserializedD).AsString() == nativeBytes);
+
+	for (size_t truncatedSize = 0; truncatedSize < compactBytes.size(); ++truncatedSize)
+	{
+		d truncatedD;
+		REQUIRE(deserializer.DeserializeInto(compactBytes.data(), truncatedSize, truncatedD).HasError());
+	}
+
+	// Enums are written as their underlying integer type, in keys and values too
+	enumTestType enums;
+	enums.aTestFace = Faces::Queen;
+	enums.playableKings = { Kings::Cesar, Kings::Alexandre };
+	enums.allowedQueens = { {Queens::Judith, true}, {Queens::Rachel, false} };
+	enums.pointsPerJack = { {10, Jacks::Ogier}, {-20, Jacks::Lahire} };
+
+	const dire::ISerializer::Result compactEnums = serializer.Serialize(enums);
+	enumTestType deserializedEnums;
+	REQUIRE_FALSE(deserializer.DeserializeInto(compactEnums.AsString().data(), compactEnums.GetBytes().size(), deserializedEnums).HasError());
+	REQUIRE(enums == deserializedEnums);
+
+	// Also through a sink
+	dire::ChunkedBufferSink sink(64);
+	REQUIRE_FALSE(serializer.SerializeTo(aD, sink).HasError());
+	REQUIRE(ChunksToString(sink) == compactBytes);
+}
+
+TEST_CASE("Binary schema format", "[Serialization]")
+{
+	dire::BinaryReflectorSerializer serializer;
+	dire::BinaryReflectorDeserializer deserializer;
+	serializer.SetFormat(dire::BinaryFormat::Schema);
+	deserializer.SetFormat(dire::BinaryFormat::Schema);
+
+	d aD;
+	aD.SetProperty<int>("ultra.mega.toto[0].titi[2]", -0x1234);
+	aD.aVector = { -1, 0, 1, 1 << 20, -(1 << 30) };
+	aD.aFatMap[-5].leet = -1337;
+	aD.aMapInMap[3][true] = -42;
+	aD.aBoolMap[7] = true;
+	aD.aStruct.aBoolMap[8] = false;
+	aD.xp = 123456;
+
+	const dire::ISerializer::Result schemaD = serializer.Serialize(aD);
+	const std::string schemaBytes = schemaD.AsString();
+
+	// Round trip
+	dire::BinaryReflectorSerializer nativeSerializer;
+	const std::string nativeBytes = nativeSerializer.Serialize(aD).AsString();
+	REQUIRE(schemaBytes.size() < nativeBytes.size());
+
+	d deserializedD;
+	REQUIRE_FALSE(deserializer.DeserializeInto(schemaBytes.data(), schemaBytes.size(), deserializedD).HasError());
+	REQUIRE(nativeSerializer.Serialize(deserializedD).AsString() == nativeBytes);
+
+	// Serializing again gives the same data: schemas don't leak from a serialization to the next
+	REQUIRE(serializer.Serialize(aD).AsString() == schemaBytes);
+
+	enumTestType enums;
+	enums.aTestFace = Faces::Queen;
+	enums.playableKings = { Kings::Cesar, Kings::Alexandre };
+	enums.allowedQueens = { {Queens::Judith, true}, {Queens::Rachel, false} };
+	enums.pointsPerJack = { {10, Jacks::Ogier}, {-20, Jacks::Lahire} };
+
+	const dire::ISerializer::Result schemaEnums = serializer.Serialize(enums);
+	enumTestType deserializedEnums;
+	REQUIRE_FALSE(deserializer.DeserializeInto(schemaEnums.AsString().data(), schemaEnums.GetBytes().size(), deserializedEnums).HasError());
+	REQUIRE(enums == deserializedEnums);
+
+	// Properties are matched by name: records of properties the type doesn't have are skipped (including the compounds in them),
+	// and properties the data doesn't have keep their value.
+	MapCompound fromD;
+	REQUIRE_FALSE(deserializer.DeserializeInto(schemaBytes.data(), schemaBytes.size(), fromD).HasError());
+	REQUIRE(fromD.aBoolMap == aD.aBoolMap);
+	REQUIRE(fromD.aSuperMap.empty());
+
+	metadatas aMetadatas;
+	aMetadatas.aMap[1] = true;
+	aMetadatas.xp = 7;
+	aMetadatas.shouldNeverBeIgnored.aTestFace = Faces::King;
+
+	const dire::ISerializer::Result schemaMetadatas = serializer.Serialize(aMetadatas);
+	d fromMetadatas;
+	fromMetadatas.aBoolMap[2] = true;
+	REQUIRE_FALSE(deserializer.DeserializeInto(schemaMetadatas.AsString().data(), schemaMetadatas.GetBytes().size(), fromMetadatas).HasError());
+	REQUIRE(fromMetadatas.aMap == aMetadatas.aMap);
+	REQUIRE(fromMetadatas.xp == 7);
+	REQUIRE(fromMetadatas.aBoolMap.size() == 1);
+
+	// Truncated data is an error, and so is data of unknown size
+	for (size_t truncatedSize = 0; truncatedSize < schemaBytes.size(); ++truncatedSize)
+	{
+		d truncatedD;
+		REQUIRE(deserializer.DeserializeInto(schemaBytes.data(), truncatedSize, truncatedD).HasError());
+	}
+	REQUIRE(deserializer.DeserializeInto(schemaBytes.data(), deserializedD).HasError());
+
+	// Also through a sink, with records bigger than the staging block
+	aD.aVector.assign(1000, -1);
+	aD.aFatMap[42].leet = 42;
+	const std::string bigSchemaBytes = serializer.Serialize(aD).AsString();
+
+	dire::ChunkedBufferSink sink(64);
+	serializer.SetStagingSize(dire::SerializationWriter::MIN_STAGING_SIZE);
+	REQUIRE_FALSE(serializer.SerializeTo(aD, sink).HasError());
+	REQUIRE(ChunksToString(sink) == bigSchemaBytes);
+
+	d bigD;
+	REQUIRE_FALSE(deserializer.DeserializeInto(bigSchemaBytes.data(), bigSchemaBytes.size(), bigD).HasError());
+	REQUIRE(bigD.aVector == aD.aVector);
+	REQUIRE(bigD.aFatMap[42].leet == 42);
+
+	// Record sizes are varints: the ones only known after writing the record give back the bytes their varint does not need
+	for (int iEntry = 0; iEntry < 100; ++iEntry)
+	{
+		aD.aFatMap[iEntry].leet = iEntry;
+	}
+	const std::string fatMapBytes = serializer.Serialize(aD).AsString();
+	dire::ChunkedBufferSink fatMapSink(64);
+	REQUIRE_FALSE(serializer.SerializeTo(aD, fatMapSink).HasError());
+	REQUIRE(ChunksToString(fatMapSink) == fatMapBytes);
+
+	// Translations can be forgotten at any time between two deserializations
+	deserializer.ClearSchemaTranslations();
+	d fatMapD;
+	REQUIRE_FALSE(deserializer.DeserializeInto(fatMapBytes.data(), fatMapBytes.size(), fatMapD).HasError());
+	REQUIRE(fatMapD.aFatMap.size() == aD.aFatMap.size());
+	REQUIRE(fatMapD.aFatMap[99].leet == 99);
+	REQUIRE(nativeSerializer.Serialize(fatMapD).AsString() == nativeSerializer.Serialize(aD).AsString());
+}
+
+TEST_CASE("Binary delta serialization", "[Serialization]")
+{
+	dire::BinaryReflectorSerializer serializer;
+	dire::BinaryReflectorDeserializer deserializer;
+	dire::BinaryReflectorSerializer nativeSerializer;
+
+	d baseline;
+	baseline.aVector = { 1, 2, 3, 4, 5, 6, 7, 8 };
+	baseline.aFatMap[1].leet = 1;
+	baseline.aFatMap[2].leet = 2;
+	baseline.aMapInMap[3][true] = 3;
+	baseline.aBoolMap[4] = true;
+	baseline.aBoolMap[5] = false;
+
+	// Nothing changed: only the end of the object is written
+	d aD = baseline;
+	REQUIRE(dire::AreReflectablesEqual(aD, baseline));
+	REQUIRE(serializer.SerializeDelta(aD, baseline).GetBytes().size() == 1);
+
+	aD.xp = 1000;
+	aD.bdouble = 42.0;
+	aD.compvar.compleet.leet = -1;
+	aD.anArray[3] = 33;
+	aD.SetProperty<int>("ultra.mega.toto[0].titi[2]", -0x1234);
+	aD.aVector[2] = 30;
+	aD.aVector[3] = 40;
+	aD.aVector.push_back(9);
+	aD.aFatMap[2].leet = 20; // patched
+	aD.aFatMap[3].leet = 3; // set
+	aD.aBoolMap[4] = false; // set
+	aD.aBoolMap.erase(5);
+	aD.aMapInMap[3][false] = 4;
+	aD.aStruct.aBoolMap[6] = true;
+	REQUIRE_FALSE(dire::AreReflectablesEqual(aD, baseline));
+
+	for (dire::BinaryFormat format : { dire::BinaryFormat::Native, dire::BinaryFormat::Compact })
+	{
+		serializer.SetFormat(format);
+		deserializer.SetFormat(format);
+
+		const std::string full = serializer.Serialize(aD).AsString();
+		const std::string delta = serializer.SerializeDelta(aD, baseline).AsString();
+		REQUIRE(delta.size() < full.size());
+
+		d patched = baseline;
+		REQUIRE_FALSE(deserializer.ApplyDelta(delta.data(), delta.size(), patched).HasError());
+		REQUIRE(dire::AreReflectablesEqual(patched, aD));
+		REQUIRE(nativeSerializer.Serialize(patched).AsString() == nativeSerializer.Serialize(aD).AsString());
+
+		// The other way around: arrays shrink and map entries get erased
+		const std::string reverseDelta = serializer.SerializeDelta(baseline, aD).AsString();
+		REQUIRE_FALSE(deserializer.ApplyDelta(reverseDelta.data(), reverseDelta.size(), patched).HasError());
+		REQUIRE(dire::AreReflectablesEqual(patched, baseline));
+		REQUIRE(patched.aVector.size() == 8);
+		REQUIRE(patched.aFatMap.count(3) == 0);
+
+		// Truncated deltas are errors
+		for (size_t truncatedSize = 0; truncatedSize < delta.size(); ++truncatedSize)
+		{
+			d truncatedD = baseline;
+			REQUIRE(deserializer.ApplyDelta(delta.data(), truncatedSize, truncatedD).HasError());
+		}
+
+		// Through a sink
+		dire::ChunkedBufferSink sink(16);
+		serializer.SetStagingSize(dire::SerializationWriter::MIN_STAGING_SIZE);
+		REQUIRE_FALSE(serializer.SerializeDeltaTo(aD, baseline, sink).HasError());
+		REQUIRE(ChunksToString(sink) == delta);
+	}
+
+	// The baseline has to be of the same type, and the schema format does not support deltas
+	c aC;
+	REQUIRE(serializer.SerializeDelta(aD, aC).HasError());
+	serializer.SetFormat(dire::BinaryFormat::Schema);
+	REQUIRE(serializer.SerializeDelta(aD, baseline).HasError());
+}
+
+TEST_CASE("ThreadPool ParallelFor", "[Serialization]")
+{
+	for (size_t nbThreads : { size_t(1), size_t(4) })
+	{
+		dire::ThreadPool pool(nbThreads);
+		REQUIRE(pool.GetThreadCount() == nbThreads);
+
+		// Every iteration runs once, whatever the chunk size and however uneven the chunks cost
+		for (size_t chunkSize : { size_t(1), size_t(7), size_t(1000) })
+		{
+			std::vector<std::atomic<int>> runs(1000);
+			std::atomic<bool> badWorker = false;
+			pool.ParallelFor(runs.size(), chunkSize, [&](size_t pWorker, size_t pBegin, size_t pEnd)
+			{
+				badWorker = badWorker || pWorker >= nbThreads || pEnd > runs.size() || pEnd - pBegin > chunkSize;
+				for (size_t iRun = pBegin; iRun < pEnd; ++iRun)
+				{
+					volatile size_t work = 0;
+					for (size_t iWork = 0; iWork < (iRun % 100) * 100; ++iWork)
+						work = work + iWork;
+					runs[iRun]++;
+				}
+			});
+			REQUIRE_FALSE(badWorker);
+			REQUIRE(std::all_of(runs.begin(), runs.end(), [](const std::atomic<int>& pRuns) { return pRuns == 1; }));
+		}
+
+		bool ranEmptyLoop = false;
+		pool.ParallelFor(0, 1, [&](size_t, size_t, size_t) { ranEmptyLoop = true; });
+		REQUIRE_FALSE(ranEmptyLoop);
+	}
+}
+
+TEST_CASE("Binary batch serialization", "[Serialization]")
+{
+	// A mix of types and sizes
+	std::vector<std::unique_ptr<dire::Reflectable>> objects;
+	for (int iObject = 0; iObject < 500; ++iObject)
+	{
+		switch (iObject % 3)
+		{
+		case 0:
+		{
+			auto aD = std::make_unique<d>();
+			aD->xp = iObject;
+			aD->aVector.resize(size_t(iObject % 50), iObject);
+			aD->aFatMap[iObject].leet = -iObject;
+			objects.push_back(std::move(aD));
+			break;
+		}
+		case 1:
+		{
+			auto aC = std::make_unique<c>();
+			aC->ctoto = unsigned(iObject);
+			aC->anArray[iObject % 10] = iObject;
+			objects.push_back(std::move(aC));
+			break;
+		}
+		default:
+		{
+			auto compound = std::make_unique<testcompound2>();
+			compound->leet = iObject;
+			objects.push_back(std::move(compound));
+			break;
+		}
+		}
+	}
+	std::vector<const dire::Reflectable*> objectPtrs;
+	for (const auto& object : objects)
+		objectPtrs.push_back(object.get());
+
+	dire::ThreadPool pool(4);
+	dire::BatchSerializer batchSerializer(pool, []() -> std::unique_ptr<dire::ISerializer> { return std::make_unique<dire::BinaryReflectorSerializer>(); });
+	dire::BatchDeserializer batchDeserializer(pool, []() -> std::unique_ptr<dire::IDeserializer> { return std::make_unique<dire::BinaryReflectorDeserializer>(); });
+	batchSerializer.SetChunkSize(7);
+	batchDeserializer.SetChunkSize(5);
+
+	dire::SerializedBatch batch;
+	for (dire::BinaryFormat format : { dire::BinaryFormat::Native, dire::BinaryFormat::Compact })
+	{
+		for (size_t iWorker = 0; iWorker < pool.GetThreadCount(); ++iWorker)
+		{
+			static_cast<dire::BinaryReflectorSerializer&>(batchSerializer.EditSerializer(iWorker)).SetFormat(format);
+			static_cast<dire::BinaryReflectorDeserializer&>(batchDeserializer.EditDeserializer(iWorker)).SetFormat(format);
+		}
+
+		// The stream is the same as with a single serializer
+		REQUIRE_FALSE(batchSerializer.Serialize({ objectPtrs.data(), objectPtrs.size() }, batch).HasError());
+		REQUIRE(batch.GetCount() == objects.size());
+		dire::BinaryReflectorSerializer serializer;
+		serializer.SetFormat(format);
+		std::string expected;
+		for (size_t iObject = 0; iObject < objects.size(); ++iObject)
+		{
+			REQUIRE(batch.Offsets[iObject] == expected.size());
+			expected += serializer.Serialize(*objects[iObject]).AsString();
+		}
+		REQUIRE(std::string(reinterpret_cast<const char*>(batch.Bytes.data()), batch.Bytes.size()) == expected);
+
+		std::vector<dire::Reflectable*> deserialized(batch.GetCount());
+		REQUIRE_FALSE(batchDeserializer.Deserialize(batch, { deserialized.data(), deserialized.size() }).HasError());
+		for (size_t iObject = 0; iObject < objects.size(); ++iObject)
+		{
+			REQUIRE(deserialized[iObject] != nullptr);
+			REQUIRE(dire::AreReflectablesEqual(*deserialized[iObject], *objects[iObject]));
+			delete deserialized[iObject];
+		}
+	}
+
+	// Chunks have at least one object
+	batchSerializer.SetChunkSize(0);
+	batchDeserializer.SetChunkSize(0);
+	REQUIRE_FALSE(batchSerializer.Serialize({ objectPtrs.data(), objectPtrs.size() }, batch).HasError());
+	REQUIRE(batch.GetCount() == objects.size());
+
+	// Objects that cannot be instantiated or deserialized are errors
+	batch.ClassIDs[3] = dire::INVALID_REFLECTABLE_ID;
+	batch.Offsets[10] = batch.Offsets[11];
+	std::vector<dire::Reflectable*> deserialized(batch.GetCount());
+	REQUIRE(batchDeserializer.Deserialize(batch, { deserialized.data(), deserialized.size() }).HasError());
+	REQUIRE(deserialized[3] == nullptr);
+	REQUIRE(deserialized[10] == nullptr);
+	for (dire::Reflectable* object : deserialized)
+		delete object;
+}
+
 #	endif // DIRE_SERIALIZATION_BINARY_ENABLED
 
 #endif // DIRE_SERIALIZATION_ENABLED
\ No newline at end of file
@@ -3,7 +3,11 @@
 #include "dire/Types/DireTypeInfo.h"
 #include "dire/Types/DireTypeInfoDatabase.h"
 
+#include <atomic>
+#include <deque>
 #include <iomanip>
+#include <thread>
+#include <vector>
 
 #include <iostream>
 
@@ -154,27 +158,17 @@ TEST_CASE("Binary Import", "[TypeInfoDatabase]")
 
 	SECTION("Case study 3 : New types appeared")
 	{
-		// Insert newcomers at the beginning, middle, and end
+		// Register newcomers at the beginning, middle, and end
+		dire::TypeInfoDatabase newcomersDatabase;
 		dire::TypeInfo tyty("tyty");
-		tyty.SetID(0);
-		aDatabase.myReflectableTypeInfos.insert(aDatabase.myReflectableTypeInfos.begin(), &tyty);
-
 		dire::TypeInfo toutou("toutou");
-		toutou.SetID(3);
-		aDatabase.myReflectableTypeInfos.insert(aDatabase.myReflectableTypeInfos.begin() + 3, &toutou);
-
 		dire::TypeInfo teetee("teetee");
-		teetee.SetID(7);
-		aDatabase.myReflectableTypeInfos.insert(aDatabase.myReflectableTypeInfos.begin() + 7, &teetee);
-
-
-		for (unsigned i = 1; i < aDatabase.myReflectableTypeInfos.size(); ++i)
+		for (dire::TypeInfo* typeInfo : { &tyty, &tata, &tete, &toutou, &titi, &toto, &tutu, &teetee })
 		{
-			if (aDatabase.myReflectableTypeInfos[i] != &toutou && aDatabase.myReflectableTypeInfos[i] != &teetee)
-				aDatabase.myReflectableTypeInfos[i]->SetID(i);
+			typeInfo->SetID(newcomersDatabase.RegisterTypeInfo(typeInfo));
 		}
 
-		success = aDatabase.ImportFromBinaryFile("database.bin");
+		success = newcomersDatabase.ImportFromBinaryFile("database.bin");
 		REQUIRE(success);
 
 		// The database is supposed to be authoritative and reset all old types to their original ID.
@@ -182,6 +176,10 @@ TEST_CASE("Binary Import", "[TypeInfoDatabase]")
 
 		// newcomers get new IDs
 		REQUIRE((tyty.GetID() == 5 && toutou.GetID() == 6 && teetee.GetID() == 7));
+
+		// and lookups follow the new IDs
+		REQUIRE((newcomersDatabase.GetTypeInfo(0) == &tata && newcomersDatabase.GetTypeInfo(4) == &tutu && newcomersDatabase.GetTypeInfo(6) == &toutou));
+		REQUIRE(newcomersDatabase.GetTypeInfo(8) == nullptr);
 	}
 
 
@@ -212,4 +210,225 @@ TEST_CASE("Binary Import", "[TypeInfoDatabase]")
 		success = !std::remove("database.bin");
 		CHECK(success);
 	}
-}
\ No newline at end of file
+}
+
+namespace
+{
+	std::atomic<int>	theNbInstantiations{ 0 };
+
+	dire::Reflectable*	CountingInstantiator(std::any const&, void*)
+	{
+		++theNbInstantiations;
+		return nullptr;
+	}
+
+	// A type built at runtime and registered in a local database only, so that stress tests leave the singleton alone.
+	class StressTypeInfo : public dire::TypeInfo
+	{
+	public:
+		StressTypeInfo(const char* pTypename, dire::TypeInfo* pParent, dire::TypeInfoDatabase& pDatabase) :
+			TypeInfo(pTypename, DeferredRegistration{})
+		{
+			if (pParent != nullptr)
+			{
+				// Like the reflectable types, it lists all its ancestors, from the direct parent to the root.
+				AddParentClass(pParent);
+				for (dire::TypeInfo* ancestor : pParent->GetParentClasses())
+				{
+					AddParentClass(ancestor);
+				}
+			}
+
+			Register(pDatabase);
+		}
+	};
+
+	class StressProperty : public dire::PropertyTypeInfo
+	{
+	public:
+		StressProperty(const char* pName, std::ptrdiff_t pOffset) :
+			PropertyTypeInfo(pName, pOffset, sizeof(int))
+		{
+			SetType(dire::MetaType::Int);
+		}
+
+#ifdef DIRE_SERIALIZATION_ENABLED
+		void	SerializeAttributes(dire::ISerializer&) const override
+		{}
+
+		SerializationState	GetSerializableState() const override
+		{
+			return {};
+		}
+#endif
+	};
+}
+
+TEST_CASE("Concurrent lookups and registrations", "[TypeInfoDatabase]")
+{
+	const unsigned NB_TYPES = 1000;
+	const unsigned NB_READERS = 3;
+	const char* const PROPERTY_NAMES[] = { "first", "second" };
+
+	// Declared before the types, so that it outlives them.
+	dire::TypeInfoDatabase aDatabase;
+	// A deque does not move its elements when growing.
+	std::deque<StressTypeInfo> typeInfos;
+	std::deque<StressProperty> properties;
+
+	std::atomic<bool> isRegistering{ true };
+	std::atomic<unsigned> nbMismatches{ 0 };
+	std::vector<std::thread> readers;
+	for (unsigned iReader = 0; iReader < NB_READERS; ++iReader)
+	{
+		readers.emplace_back([&]()
+		{
+			while (isRegistering.load())
+			{
+				const size_t nbTypeInfos = aDatabase.GetTypeInfoCount();
+				for (size_t iType = 0; iType < nbTypeInfos; ++iType)
+				{
+					// Everything counted is fully registered.
+					const dire::TypeInfo* typeInfo = aDatabase.GetTypeInfo(dire::ReflectableID(iType));
+					if (typeInfo == nullptr || typeInfo->GetID() != iType)
+					{
+						++nbMismatches;
+						continue;
+					}
+					(void)aDatabase.TryInstantiate(dire::ReflectableID(iType), {});
+
+					// Builds the caches while properties are added to the hierarchy.
+					const dire::PropertyTypeInfo* prop = typeInfo->FindPropertyInHierarchy("first");
+					if (prop != nullptr && prop->GetName() != "first")
+					{
+						++nbMismatches;
+					}
+					if (typeInfo->GetPropertyLayout().GetCount() > 2 * (typeInfo->GetParentClasses().size() + 1))
+					{
+						++nbMismatches;
+					}
+
+					for (const dire::TypeInfo* parent : typeInfo->GetParentClasses())
+					{
+						if (!parent->IsParentOf(*typeInfo) || typeInfo->IsParentOf(*parent))
+						{
+							++nbMismatches;
+						}
+					}
+				}
+			}
+		});
+	}
+
+	for (unsigned iType = 0; iType < NB_TYPES; ++iType)
+	{
+		// Small hierarchies of various depths, with a new root every 16 types.
+		dire::TypeInfo* parent = (iType % 16 == 0 ? nullptr : &typeInfos[iType - 1 - (iType % 16 - 1) % 3]);
+		StressTypeInfo& typeInfo = typeInfos.emplace_back("StressType", parent, aDatabase);
+		aDatabase.RegisterInstantiateFunction(typeInfo.GetID(), &CountingInstantiator);
+
+		// Properties come after the type is published, like the ones of the reflectable types.
+		for (std::ptrdiff_t iProp = 0; iProp < 2; ++iProp)
+		{
+			typeInfo.PushTypeInfo(properties.emplace_back(PROPERTY_NAMES[iProp], iProp * std::ptrdiff_t(sizeof(int))));
+		}
+	}
+	isRegistering = false;
+
+	for (std::thread& reader : readers)
+	{
+		reader.join();
+	}
+
+	REQUIRE(nbMismatches == 0);
+	REQUIRE(aDatabase.GetTypeInfoCount() == NB_TYPES);
+	REQUIRE(aDatabase.GetTypeInfo(NB_TYPES - 1) == &typeInfos.back());
+
+	// No cache missed a property: all of them see the whole hierarchy.
+	const dire::TypeInfo& deepest = typeInfos[15];
+	REQUIRE(deepest.GetPropertyLayout().GetCount() == 2 * (deepest.GetParentClasses().size() + 1));
+
+	const int nbInstantiations = theNbInstantiations;
+	(void)aDatabase.TryInstantiate(NB_TYPES - 1, {});
+	REQUIRE(theNbInstantiations == nbInstantiations + 1);
+}
+
+TEST_CASE("Adding a property rebuilds the caches of all the descendants", "[TypeInfoDatabase]")
+{
+	dire::TypeInfoDatabase aDatabase;
+	StressTypeInfo grandParent("GrandParent", nullptr, aDatabase);
+	StressTypeInfo parent("Parent", &grandParent, aDatabase);
+	StressTypeInfo child("Child", &parent, aDatabase);
+
+	REQUIRE(child.FindPropertyInHierarchy("first") == nullptr);
+	const dire::TypeInfoCache& oldCache = child.GetCache();
+
+	StressProperty prop("first", 0);
+	grandParent.PushTypeInfo(prop);
+
+	REQUIRE(child.FindPropertyInHierarchy("first") == &prop);
+	REQUIRE(child.GetPropertyLayout().GetCount() == 1);
+	// The old cache is kept alive, as other threads could still be reading it.
+	REQUIRE(&child.GetCache() != &oldCache);
+	REQUIRE(oldCache.GetPropertyLayout().GetCount() == 0);
+}
+
+TEST_CASE("Concurrent IsA and registrations", "[TypeInfoDatabase]")
+{
+	const unsigned NB_TYPES = 500;
+	const unsigned NB_READERS = 3;
+
+	dire::TypeInfoDatabase aDatabase;
+	std::deque<StressTypeInfo> typeInfos;
+	StressTypeInfo& otherRoot = typeInfos.emplace_back("OtherRoot", nullptr, aDatabase);
+	StressTypeInfo& root = typeInfos.emplace_back("Root", nullptr, aDatabase);
+
+	std::atomic<bool> isRegistering{ true };
+	std::atomic<unsigned> nbMismatches{ 0 };
+	std::vector<std::thread> readers;
+	for (unsigned iReader = 0; iReader < NB_READERS; ++iReader)
+	{
+		readers.emplace_back([&]()
+		{
+			while (isRegistering.load())
+			{
+				const size_t nbTypeInfos = aDatabase.GetTypeInfoCount();
+				for (size_t iType = 0; iType < nbTypeInfos; ++iType)
+				{
+					// Every registration renumbers the hierarchy: the answers must not change while it happens.
+					const dire::TypeInfo& typeInfo = *aDatabase.GetTypeInfo(dire::ReflectableID(iType));
+					for (const dire::TypeInfo* ancestor : typeInfo.GetParentClasses())
+					{
+						if (!ancestor->IsParentOf(typeInfo) || typeInfo.IsParentOf(*ancestor))
+						{
+							++nbMismatches;
+						}
+					}
+
+					if (&typeInfo != &root && &typeInfo != &otherRoot && (otherRoot.IsParentOf(typeInfo) || !root.IsParentOf(typeInfo, false)))
+					{
+						++nbMismatches;
+					}
+				}
+			}
+		});
+	}
+
+	for (unsigned iType = 0; iType < NB_TYPES; ++iType)
+	{
+		// Subclasses of types all over the hierarchy, so that the intervals of existing types keep moving.
+		StressTypeInfo& parent = typeInfos[1 + (iType * 7) % (typeInfos.size() - 1)];
+		typeInfos.emplace_back("SubType", &parent, aDatabase);
+	}
+	isRegistering = false;
+
+	for (std::thread& reader : readers)
+	{
+		reader.join();
+	}
+
+	REQUIRE(nbMismatches == 0);
+	REQUIRE(root.GetChildrenClasses().size() == NB_TYPES);
+	REQUIRE(root.IsParentOf(typeInfos.back()));
+	REQUIRE(!otherRoot.IsParentOf(typeInfos.back()));
+}